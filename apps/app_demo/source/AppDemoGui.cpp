@@ -18,6 +18,7 @@
 #include <CVImage.h>
 #include <CVTrackedFeatures.h>
 #include <SLAssetManager.h>
+#include <SLAssetLoader.h>
 #include <SLAnimPlayback.h>
 #include <SLGLDepthBuffer.h>
 #include <SLGLProgramManager.h>
@@ -255,7 +256,14 @@ void AppDemoGui::build(SLScene* s, SLSceneView* sv)
         drawList->PathArcTo(center, 50, offset, offset + 0.25f * 2 * PI);
         drawList->PathStroke(IM_COL32(250, 165, 0, 255), 0, 10.0f);
 
-        const char* text = loadingString.c_str();
+        // Show the progress of the parallel loading tasks
+        SLstring       loadingText = loadingString;
+        SLAssetLoader* al          = AppCommon::assetLoader;
+        if (al && al->isLoading() && al->numTasks() > 1)
+            loadingText += " " + std::to_string(al->numTasksDone()) +
+                           " / " + std::to_string(al->numTasks());
+
+        const char* text = loadingText.c_str();
         ImGui::SetCursorPosX(0.5f * (width - ImGui::CalcTextSize(text).x));
         ImGui::SetCursorPosY(0.5f * height + 100.0f);
         ImGui::Text(text);
@@ -425,13 +433,18 @@ void AppDemoGui::build(SLScene* s, SLSceneView* sv)
                     SLfloat captureTime = CVCapture::instance()->captureTimesMS().average();
                     SLfloat updateTime  = s->updateTimesMS().average();
 #ifndef SL_EMSCRIPTEN
+                    // The sub timings are taken from the tracker itself because trackers
+                    // may run on the worker threads of gTrackingScheduler (read under lock)
+                    auto    trackerTime  = [](CVTrackedTiming t) { return gVideoTracker ? gVideoTracker->timesMS(t) : 0.0f; };
                     SLfloat trackingTime = CVTracked::trackingTimesMS.average();
-                    SLfloat detectTime   = CVTracked::detectTimesMS.average();
-                    SLfloat detect1Time  = CVTracked::detect1TimesMS.average();
-                    SLfloat detect2Time  = CVTracked::detect2TimesMS.average();
-                    SLfloat matchTime    = CVTracked::matchTimesMS.average();
-                    SLfloat optFlowTime  = CVTracked::optFlowTimesMS.average();
-                    SLfloat poseTime     = CVTracked::poseTimesMS.average();
+                    SLfloat latencyTime  = trackerTime(TT_track);
+                    SLfloat detectTime   = trackerTime(TT_detect);
+                    SLfloat savedTime    = trackerTime(TT_detectSaved);
+                    SLfloat detect1Time  = trackerTime(TT_detect1);
+                    SLfloat detect2Time  = trackerTime(TT_detect2);
+                    SLfloat matchTime    = trackerTime(TT_match);
+                    SLfloat optFlowTime  = trackerTime(TT_optFlow);
+                    SLfloat poseTime     = trackerTime(TT_pose);
 #endif
                     SLfloat updateAnimTime = s->updateAnimTimesMS().average();
                     SLfloat updateAABBTime = s->updateAABBTimesMS().average();
@@ -467,6 +480,8 @@ void AppDemoGui::build(SLScene* s, SLSceneView* sv)
                     snprintf(m + strlen(m), sizeof(m), "FPS        : %5.1f\n", s->fps());
                     snprintf(m + strlen(m), sizeof(m), "Frame time : %5.1f ms (100%%)\n", ft);
                     snprintf(m + strlen(m), sizeof(m), " Capture   : %5.1f ms (%3d%%)\n", captureTime, (SLint)captureTimePC);
+                    if (vt != VT_NONE)
+                        snprintf(m + strlen(m), sizeof(m), "  Copies   : %5.1f per frame\n", CVCapture::instance()->copiesPerFrame().average());
                     snprintf(m + strlen(m), sizeof(m), " Update    : %5.1f ms (%3d%%)\n", updateTime, (SLint)updateTimePC);
 #ifdef SL_USE_ENTITIES
                     SLfloat updateDODTime   = s->updateDODTimesMS().average();
@@ -483,7 +498,10 @@ void AppDemoGui::build(SLScene* s, SLSceneView* sv)
                     if (vt != VT_NONE && gVideoTracker != nullptr && gVideoTrackedNode != nullptr)
                     {
                         snprintf(m + strlen(m), sizeof(m), "  Tracking : %5.1f ms (%3d%%)\n", trackingTime, (SLint)trackingTimePC);
+                        snprintf(m + strlen(m), sizeof(m), "   Latency : %5.1f ms\n", latencyTime);
                         snprintf(m + strlen(m), sizeof(m), "   Detect  : %5.1f ms (%3d%%)\n", detectTime, (SLint)detectTimePC);
+                        if (savedTime != 0.0f)
+                            snprintf(m + strlen(m), sizeof(m), "    Saved  : %5.1f ms\n", savedTime);
                         snprintf(m + strlen(m), sizeof(m), "    Det1   : %5.1f ms\n", detect1Time);
                         snprintf(m + strlen(m), sizeof(m), "    Det2   : %5.1f ms\n", detect2Time);
                         snprintf(m + strlen(m), sizeof(m), "   Match   : %5.1f ms (%3d%%)\n", matchTime, (SLint)matchTimePC);
@@ -1978,6 +1996,8 @@ void AppDemoGui::buildMenuBar(SLScene* s, SLSceneView* sv)
                         AppCommon::sceneToLoad = SID_Benchmark_ParticleSystemComplexFire;
                     if (ImGui::MenuItem("Particle System w. 1 mio. particle", nullptr, sid == SID_ParticleSystem_Many))
                         AppCommon::sceneToLoad = SID_ParticleSystem_Many;
+                    if (ImGui::MenuItem("CVImage 8K Pixel Operations"))
+                        CVImage::benchmark();
                     ImGui::EndMenu();
                 }
 
@@ -2290,6 +2310,12 @@ void AppDemoGui::buildMenuBar(SLScene* s, SLSceneView* sv)
                     if (ImGui::MenuItem("Force Relocation", nullptr, featureTracker->forceRelocation()))
                         featureTracker->forceRelocation(!featureTracker->forceRelocation());
 
+                    if (ImGui::MenuItem("Async. Relocation", nullptr, featureTracker->asyncRelocation()))
+                        featureTracker->asyncRelocation(!featureTracker->asyncRelocation());
+
+                    if (ImGui::MenuItem("Half Res. Detection", nullptr, featureTracker->detectScale() < 1.0f))
+                        featureTracker->detectScale(featureTracker->detectScale() < 1.0f ? 1.0f : 0.5f);
+
                     if (ImGui::BeginMenu("Detector/Descriptor", featureTracker != nullptr))
                     {
                         CVDetectDescribeType type = featureTracker->type();
@@ -98,13 +98,15 @@
 #else
 #    include <CVTracked.h>
 #endif
+#include <CVTrackingScheduler.h>
 
 //-----------------------------------------------------------------------------
 // Global pointers and functions declared in AppDemoVideo
-extern SLGLTexture* gVideoTexture;
-extern CVTracked*   gVideoTracker;
-extern SLNode*      gVideoTrackedNode;
-bool                onUpdateVideo();
+extern SLGLTexture*        gVideoTexture;
+extern CVTracked*          gVideoTracker;
+extern CVTrackingScheduler gTrackingScheduler;
+extern SLNode*             gVideoTrackedNode;
+bool                       onUpdateVideo();
 
 //-----------------------------------------------------------------------------
 static SLSceneView* createSceneView(SLScene*        scene,
@@ -224,6 +226,7 @@ static void onBeforeSceneDelete(SLSceneView* sv, SLScene* s)
     // Reset video and trackers
     CVCapture::instance()->videoType(VT_NONE); // turn off any video
     CVTracked::resetTimes();                   // delete all gVideoTracker times
+    gTrackingScheduler.clear();                // wait for running tracking jobs
     delete gVideoTracker;                      // delete the tracker deep
     gVideoTracker     = nullptr;
     gVideoTexture     = nullptr; // The video texture will be deleted by scene uninit
@@ -17,6 +17,7 @@
 #include <CVCapture.h>
 #include <CVTracked.h>
 #include <CVTrackedAruco.h>
+#include <CVTrackingScheduler.h>
 #include <SLGLTexture.h>
 #include <CVCalibrationEstimator.h>
 #include <GlobalTimer.h>
@@ -42,6 +43,11 @@ CVTracked* gVideoTracker = nullptr;
  */
 SLNode* gVideoTrackedNode = nullptr;
 
+/*! Global tracking scheduler that runs the trackers on a worker pool.
+ The trackers must be removed from it before they get deleted.
+ */
+CVTrackingScheduler gTrackingScheduler;
+
 //-----------------------------------------------------------------------------
 /*! always update scene camera fovV from calibration because the calibration
  may have been adapted in adjustForSL after a change of aspect ratio!
@@ -97,6 +103,9 @@ void runCalibrationEstimator(CVCamera* ac, SLScene* s, SLSceneView* sv)
             ss << "Click on the screen to create a calibration photo. Created "
                << AppCommon::calibrationEstimator->numCapturedImgs()
                << " of " << AppCommon::calibrationEstimator->numImgsToCapture();
+            if (AppCommon::calibrationEstimator->hasIntermediateCalibration())
+                ss << ". Current reproj. error: "
+                   << AppCommon::calibrationEstimator->intermediateReprojError();
             s->info(ss.str());
         }
         else if (AppCommon::calibrationEstimator->isBusyExtracting())
@@ -257,36 +266,55 @@ bool onUpdateVideo()
 
             if (gVideoTracker && gVideoTrackedNode)
             {
-                bool foundPose = gVideoTracker->track(CVCapture::instance()->lastFrameGray,
-                                                      CVCapture::instance()->lastFrame,
-                                                      &ac->calibration);
-                if (foundPose)
+                if (!gTrackingScheduler.contains(gVideoTracker))
                 {
-                    // clang-format off
-                    // convert matrix type CVMatx44f to SLMat4f
-                    CVMatx44f cvOVM = gVideoTracker->objectViewMat();
-                    SLMat4f glOVM(cvOVM.val[0], cvOVM.val[1], cvOVM.val[2], cvOVM.val[3],
-                                  cvOVM.val[4], cvOVM.val[5], cvOVM.val[6], cvOVM.val[7],
-                                  cvOVM.val[8], cvOVM.val[9], cvOVM.val[10],cvOVM.val[11],
-                                  cvOVM.val[12],cvOVM.val[13],cvOVM.val[14],cvOVM.val[15]);
-                    // clang-format on
-
-                    // set the object matrix depending if the
-                    // tracked node is attached to a camera or not
-                    if (typeid(*gVideoTrackedNode) == typeid(SLCamera))
+                    gTrackingScheduler.clear();
+
+                    // The demo has a single tracker that draws its detection by
+                    // default, so it runs on this thread. Only trackers with
+                    // Draw Detection switched off in the Video menu use the pool.
+                    gTrackingScheduler.addTracker(gVideoTracker);
+                }
+
+                gTrackingScheduler.submitFrame(CVCapture::instance()->lastFrameGray,
+                                               CVCapture::instance()->lastFrame,
+                                               &ac->calibration);
+
+                // Wait for all trackers so that the poses belong to the displayed frame
+                CVVTrackingResult results = gTrackingScheduler.collectResults(true);
+                for (const CVTrackingResult& result : results)
+                {
+                    if (result.tracker != gVideoTracker)
+                        continue;
+
+                    if (result.foundPose)
                     {
-                        gVideoTrackedNode->om(glOVM.inverted());
-                        gVideoTrackedNode->setDrawBitsRec(SL_DB_HIDDEN, true);
+                        // clang-format off
+                        // convert matrix type CVMatx44f to SLMat4f
+                        const CVMatx44f& cvOVM = result.objectViewMat;
+                        SLMat4f glOVM(cvOVM.val[0], cvOVM.val[1], cvOVM.val[2], cvOVM.val[3],
+                                      cvOVM.val[4], cvOVM.val[5], cvOVM.val[6], cvOVM.val[7],
+                                      cvOVM.val[8], cvOVM.val[9], cvOVM.val[10],cvOVM.val[11],
+                                      cvOVM.val[12],cvOVM.val[13],cvOVM.val[14],cvOVM.val[15]);
+                        // clang-format on
+
+                        // set the object matrix depending if the
+                        // tracked node is attached to a camera or not
+                        if (typeid(*gVideoTrackedNode) == typeid(SLCamera))
+                        {
+                            gVideoTrackedNode->om(glOVM.inverted());
+                            gVideoTrackedNode->setDrawBitsRec(SL_DB_HIDDEN, true);
+                        }
+                        else
+                        {
+                            // see comments in CVTracked::calcObjectMatrix
+                            gVideoTrackedNode->om(sv->camera()->om() * glOVM);
+                            gVideoTrackedNode->setDrawBitsRec(SL_DB_HIDDEN, false);
+                        }
                     }
                     else
-                    {
-                        // see comments in CVTracked::calcObjectMatrix
-                        gVideoTrackedNode->om(sv->camera()->om() * glOVM);
                         gVideoTrackedNode->setDrawBitsRec(SL_DB_HIDDEN, false);
-                    }
                 }
-                else
-                    gVideoTrackedNode->setDrawBitsRec(SL_DB_HIDDEN, false);
             }
 
             // Update info text only for chessboard scene
@@ -313,25 +341,23 @@ bool onUpdateVideo()
         {
             //SL_LOG("glFormat: %s\n", CVImage::formatString(CVCapture::instance()->format).c_str());
                 
-            if (ac->calibration.state() == CS_calibrated && ac->showUndistorted())
-            {
-                CVMat undistorted;
-                ac->calibration.remap(CVCapture::instance()->lastFrame, undistorted);
-                gVideoTexture->copyVideoImage(undistorted.cols,
-                                              undistorted.rows,
-                                              CVCapture::instance()->format,
-                                              undistorted.data,
-                                              undistorted.isContinuous(),
-                                              true);
-            }
+            // The cached remap tables follow calibration changes automatically
+            CVMat undistorted;
+            bool  isUndistorted = ac->calibration.state() == CS_calibrated &&
+                                  ac->showUndistorted() &&
+                                  ac->calibration.undistortCropResize(CVCapture::instance()->lastFrame,
+                                                                      CVRect(),
+                                                                      CVSize(),
+                                                                      undistorted);
+            if (isUndistorted)
+                gVideoTexture->streamVideoImage(undistorted,
+                                                CVCapture::instance()->format);
             else
             {
-                gVideoTexture->copyVideoImage(CVCapture::instance()->lastFrame.cols,
-                                              CVCapture::instance()->lastFrame.rows,
-                                              CVCapture::instance()->format,
-                                              CVCapture::instance()->lastFrame.data,
-                                              CVCapture::instance()->lastFrame.isContinuous(),
-                                              true);
+                // Fall back to the distorted frame if the undistortion failed.
+                // lastFrame can be a cropped view, streamVideoImage respects its row step
+                gVideoTexture->streamVideoImage(CVCapture::instance()->lastFrame,
+                                                CVCapture::instance()->format);
             }
         }
         else
@@ -63,7 +63,9 @@ void AppDemoSceneVideoTrackAruco::registerAssetsToLoad(SLAssetLoader& al)
     // Create an ArUco tracker
     al.addLoadTask([]()
                    {
-        gVideoTracker = new CVTrackedAruco(9, AppCommon::calibIniPath);
+        CVTrackedAruco* arucoTracker = new CVTrackedAruco(9, AppCommon::calibIniPath);
+        arucoTracker->roiDetection(true);
+        gVideoTracker = arucoTracker;
         gVideoTracker->drawDetection(true); });
 }
 //-----------------------------------------------------------------------------
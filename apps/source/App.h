@@ -62,6 +62,9 @@ struct Config
     SLstring                      windowTitle           = "SLProject Application";
     SLint                         numSamples            = 4;
     SLSceneID                     startSceneID          = SL_EMPTY_SCENE_ID;
+    SLbool                        warmUpPrograms        = true;
+    SLbool                        transcodeTextures     = false;
+    SLbool                        streamTextures        = false;
     OnNewSceneViewCallback        onNewSceneView        = nullptr;
     OnNewSceneCallback            onNewScene            = nullptr;
     OnBeforeSceneDeleteCallback   onBeforeSceneDelete   = nullptr;
@@ -227,6 +227,14 @@ void AppCommon::switchScene(SLSceneView* sv, SLSceneID sceneID)
     // Prepare for async loading //
     ///////////////////////////////
 
+    // Image textures get transcoded once to KTX2 and are loaded from the cache
+    SLGLTexture::ktxCachePath = App::config.transcodeTextures
+                                  ? AppCommon::configPath + "cache/textures/"
+                                  : "";
+
+    // Mipmapped textures get streamed in from their mip tail
+    SLGLTexture::streamingEnabled = App::config.streamTextures;
+
     // Register assets on the loader that have to be loaded before assembly.
     al->scene(s);
     s->registerAssetsToLoad(*al);
@@ -281,6 +289,11 @@ void AppCommon::onDoneAssembling(SLSceneView* sv, SLScene* s, SLfloat startLoadM
         if (sceneView != nullptr)
             sceneView->onInitialize();
 
+    // Compile or load from the program binary cache all shader programs
+    // now instead of when they get visible the first time.
+    if (App::config.warmUpPrograms)
+        s->warmUpPrograms();
+
     AppCommon::scene = s;
 
     if (App::config.onAfterSceneAssembly)
@@ -331,6 +344,7 @@ void AppCommon::deleteApp()
     // delete default stuff:
     SLGLProgramManager::deletePrograms();
     SLMaterialDefaultGray::deleteInstance();
+    SLGLTexture::deleteStreamPBO();
 #endif
 
     // Delete the default materials
@@ -43,13 +43,16 @@ CVCapture::CVCapture()
 #else
     hasSecondaryCamera = true;
 #endif
-    videoFilename      = "";
-    videoLoops         = true;
-    fps                = 1;
-    frameCount         = 0;
-    activeCamSizeIndex = -1;
-    activeCamera       = nullptr;
+    videoFilename       = "";
+    videoLoops          = true;
+    fps                 = 1;
+    frameCount          = 0;
+    videoPrefetchFrames = 8;
+    videoCacheSizeMB    = 0;
+    activeCamSizeIndex  = -1;
+    activeCamera        = nullptr;
     _captureTimesMS.init(60, 0);
+    _copiesPerFrame.init(60, 0);
 
     // Silences OpenCV debug logging
     cv::utils::logging::setLogLevel(cv::utils::logging::LogLevel::LOG_LEVEL_SILENT);
@@ -140,26 +143,19 @@ CVSize2i CVCapture::openFile()
             Utils::exitMsg("SLProject", msg.c_str(), __LINE__, __FILE__);
         }
 
-        _captureDevice.open(videoFilename);
-
-        if (!_captureDevice.isOpened())
+        if (!_videoDecoder.open(videoFilename,
+                                videoPrefetchFrames,
+                                videoCacheSizeMB))
         {
             Utils::log("SLProject", "CVCapture::openFile: Failed to open video file.");
             return CVSize2i(0, 0);
         }
 
-        // Utils::log("SLProject", "Capture devices created with video.");
-
-        int w = (int)_captureDevice.get(cv::CAP_PROP_FRAME_WIDTH);
-        int h = (int)_captureDevice.get(cv::CAP_PROP_FRAME_HEIGHT);
-        // Utils::log("SLProject", "CV_CAP_PROP_FRAME_WIDTH : %d", w);
-        // Utils::log("SLProject", "CV_CAP_PROP_FRAME_HEIGHT: %d", h);
-
         hasSecondaryCamera = false;
-        fps                = (float)_captureDevice.get(cv::CAP_PROP_FPS);
-        frameCount         = (int)_captureDevice.get(cv::CAP_PROP_FRAME_COUNT);
+        fps                = _videoDecoder.fps();
+        frameCount         = _videoDecoder.frameCount();
 
-        return CVSize2i(w, h);
+        return _videoDecoder.frameSize();
     }
     catch (exception& e)
     {
@@ -206,7 +202,7 @@ void CVCapture::start(float viewportWdivH)
 bool CVCapture::isOpened()
 {
 #ifndef SL_EMSCRIPTEN
-    return _captureDevice.isOpened();
+    return _captureDevice.isOpened() || _videoDecoder.isOpened();
 #else
     return _webCamera.isOpened();
 #endif
@@ -217,6 +213,8 @@ void CVCapture::release()
 #ifndef SL_EMSCRIPTEN
     if (_captureDevice.isOpened())
         _captureDevice.release();
+    if (_videoDecoder.isOpened())
+        _videoDecoder.close();
 #else
     if (_webCamera.isOpened())
         _webCamera.close();
@@ -241,23 +239,63 @@ bool CVCapture::grabAndAdjustForSL(float viewportWdivH)
 #ifndef SL_EMSCRIPTEN
     try
     {
-        if (_captureDevice.isOpened())
+        if (_videoDecoder.isOpened())
+        {
+            CVMat decoded;
+            if (!_videoDecoder.read(decoded))
+            {
+                // Try to loop the video
+                if (!videoLoops)
+                    return false;
+                _videoDecoder.seek(0);
+                if (!_videoDecoder.read(decoded))
+                    return false;
+            }
+
+            // Cached frames are shared with the decoder and must not be changed
+            if (videoCacheSizeMB > 0)
+            {
+                lastFrame = poolFrame(_grabPool, decoded.rows, decoded.cols, decoded.type());
+                decoded.copyTo(lastFrame);
+            }
+            else
+                lastFrame = decoded;
+
+            // The exact frame count is known after the first pass
+            frameCount = _videoDecoder.frameCount();
+            _numCopies = 1;
+#    if defined(ANDROID)
+            // Convert BGR to RGB on mobile phones
+            cvtColor(CVCapture::lastFrame, CVCapture::lastFrame, cv::COLOR_BGR2RGB, 3);
+            _numCopies++;
+#    endif
+            adjustForSL(viewportWdivH);
+        }
+        else if (_captureDevice.isOpened())
         {
-            if (!_captureDevice.read(lastFrame))
+            // Decode into a free buffer of the pool. If the size changed read reallocates it.
+            CVMat grabbed;
+            if (captureSize.area() > 0)
+                grabbed = poolFrame(_grabPool, captureSize.height, captureSize.width, CV_8UC3);
+
+            if (!_captureDevice.read(grabbed))
             {
                 // Try to loop the video
                 if (!videoFilename.empty() && videoLoops)
                 {
                     _captureDevice.set(cv::CAP_PROP_POS_FRAMES, 0);
-                    if (!_captureDevice.read(lastFrame))
+                    if (!_captureDevice.read(grabbed))
                         return false;
                 }
                 else
                     return false;
             }
+            lastFrame  = grabbed;
+            _numCopies = 1;
 #    if defined(ANDROID)
             // Convert BGR to RGB on mobile phones
             cvtColor(CVCapture::lastFrame, CVCapture::lastFrame, cv::COLOR_BGR2RGB, 3);
+            _numCopies++;
 #    endif
             adjustForSL(viewportWdivH);
         }
@@ -287,7 +325,8 @@ bool CVCapture::grabAndAdjustForSL(float viewportWdivH)
     if (activeCamera->camSizeIndex() != -1)
         _webCamera.setSize(camSizes[activeCamera->camSizeIndex()]);
 
-    lastFrame = _webCamera.read();
+    lastFrame  = _webCamera.read();
+    _numCopies = 1;
     adjustForSL(viewportWdivH);
 #endif
 
@@ -306,6 +345,7 @@ void CVCapture::loadIntoLastFrame(const float           viewportWdivH,
                                   const bool            isContinuous)
 {
     CVCapture::startCaptureTimeMS = _timer.elapsedTimeInMilliSec();
+    _numCopies                    = 0;
 
     // treat Android YUV to RGB conversion special
     if (newFormat == PF_yuv_420_888)
@@ -313,13 +353,21 @@ void CVCapture::loadIntoLastFrame(const float           viewportWdivH,
         CVMat yuv(height + height / 2, width, CV_8UC1, (void*)data);
 
         // Android image copy loop #1
+        CVCapture::lastFrame = poolFrame(_framePool, height, width, CV_8UC3);
         cvtColor(yuv, CVCapture::lastFrame, cv::COLOR_YUV2RGB_NV21, 3);
+        _numCopies++;
+
+        // The Y plane is the grayscale image. adjustForSL only crops and mirrors it.
+        // The view is valid until adjustForSL returns because data belongs to the caller.
+        _srcGray = yuv.rowRange(0, height);
     }
     // convert 4 channel images to 3 channel
     else if (newFormat == PF_bgra || format == PF_rgba)
     {
         CVMat rgba(height, width, CV_8UC4, (void*)data);
+        CVCapture::lastFrame = poolFrame(_framePool, height, width, CV_8UC3);
         cvtColor(rgba, CVCapture::lastFrame, cv::COLOR_RGBA2RGB, 3);
+        _numCopies++;
     }
     else
     {
@@ -423,7 +471,7 @@ void CVCapture::adjustForSL(float viewportWdivH)
     //////////////////////////////////////////////////////////////////
 
     // Cropping is done almost always.
-    // So this is Android image copy loop #2
+    // It only creates a view (ROI) and copies nothing.
 
     float inWdivH = (float)lastFrame.cols / (float)lastFrame.rows;
     // viewportWdivH is negative the viewport aspect will be the same
@@ -471,8 +519,11 @@ void CVCapture::adjustForSL(float viewportWdivH)
             if (hModulo4 == 3) height++;
         }
 
-        lastFrame(CVRect(cropW, cropH, width, height)).copyTo(lastFrame);
-        // imwrite("AfterCropping.bmp", lastFrame);
+        // The cropped image is only a view into the captured buffer (no copy).
+        CVRect roi(cropW, cropH, width, height);
+        lastFrame = lastFrame(roi);
+        if (!_srcGray.empty())
+            _srcGray = _srcGray(roi);
     }
 
     //////////////////
@@ -480,37 +531,44 @@ void CVCapture::adjustForSL(float viewportWdivH)
     //////////////////
 
     // Mirroring is done for most selfie cameras.
-    // So this is Android image copy loop #3
+    // The flip reads the cropped view and writes into a pooled buffer,
+    // so cropping and mirroring together cost only one copy.
 
-    if (activeCamera->calibration.isMirroredH())
-    {
-        CVMat mirrored;
-        if (activeCamera->calibration.isMirroredV())
-            cv::flip(lastFrame, mirrored, -1);
-        else
-            cv::flip(lastFrame, mirrored, 1);
-        lastFrame = mirrored;
-    }
-    else if (activeCamera->calibration.isMirroredV())
+    bool mirrorH  = activeCamera->calibration.isMirroredH();
+    bool mirrorV  = activeCamera->calibration.isMirroredV();
+    int  flipCode = mirrorH && mirrorV ? -1 : mirrorH ? 1 : 0;
+
+    if (mirrorH || mirrorV)
     {
-        CVMat mirrored;
-        if (activeCamera->calibration.isMirroredH())
-            cv::flip(lastFrame, mirrored, -1);
-        else
-            cv::flip(lastFrame, mirrored, 0);
+        CVMat mirrored = poolFrame(_framePool, lastFrame.rows, lastFrame.cols, lastFrame.type());
+        cv::flip(lastFrame, mirrored, flipCode);
         lastFrame = mirrored;
+        _numCopies++;
     }
 
     /////////////////////////
     // 4) Create grayscale //
     /////////////////////////
 
-    // Creating a grayscale version from an YUV input source is stupid.
-    // We just could take the Y channel.
-    // Android image copy loop #4
+    // If the source had a grayscale plane (Y of YUV) it is only cropped
+    // and mirrored. Otherwise the color image gets converted.
 
     if (!lastFrame.empty())
-        cv::cvtColor(lastFrame, lastFrameGray, cv::COLOR_BGR2GRAY);
+    {
+        CVMat gray = poolFrame(_grayPool, lastFrame.rows, lastFrame.cols, CV_8UC1);
+        if (!_srcGray.empty())
+        {
+            if (mirrorH || mirrorV)
+                cv::flip(_srcGray, gray, flipCode);
+            else
+                _srcGray.copyTo(gray);
+        }
+        else
+            cv::cvtColor(lastFrame, gray, cv::COLOR_BGR2GRAY);
+        lastFrameGray = gray;
+        _numCopies++;
+    }
+    _srcGray.release();
 
 #ifndef SL_EMSCRIPTEN
     // Reset calibrated image size
@@ -520,9 +578,40 @@ void CVCapture::adjustForSL(float viewportWdivH)
     }
 #endif
 
+    _copiesPerFrame.set((float)_numCopies);
     _captureTimesMS.set(_timer.elapsedTimeInMilliSec() - startCaptureTimeMS);
 }
 //-----------------------------------------------------------------------------
+//! Returns a buffer of the pool that nobody outside of the pool references
+/*! cv::Mat is reference counted: a pooled buffer with a reference count of 1
+is only held by the pool and can be overwritten. A consumer that keeps a frame
+(e.g. a copy of lastFrame for a tracking thread) keeps its buffer out of the
+pool until it releases it. The pool grows to at most 4 buffers. After that new
+buffers are allocated and freed as before.
+*/
+CVMat CVCapture::poolFrame(CVVMat& pool, int rows, int cols, int type)
+{
+    for (CVMat& buffer : pool)
+        if (buffer.u && buffer.u->refcount == 1 &&
+            buffer.rows == rows && buffer.cols == cols && buffer.type() == type)
+            return buffer;
+
+    // Reallocate a free buffer of another size or add a new one
+    for (CVMat& buffer : pool)
+    {
+        if (buffer.u && buffer.u->refcount == 1)
+        {
+            buffer.create(rows, cols, type);
+            return buffer;
+        }
+    }
+
+    CVMat buffer(rows, cols, type);
+    if (pool.size() < 4)
+        pool.push_back(buffer);
+    return buffer;
+}
+//-----------------------------------------------------------------------------
 //! YUV to RGB image infos. Offset value can be negative for mirrored copy.
 inline void
 yuv2rbg(uchar y, uchar u, uchar v, uchar& r, uchar& g, uchar& b)
@@ -740,9 +829,9 @@ void CVCapture::copyYUVPlanes(float  scrWdivH,
     bool mirrorH = CVCapture::activeCamera->mirrorH();
     bool mirrorV = CVCapture::activeCamera->mirrorV();
 
-    // Create output color (BGR) and grayscale images
-    lastFrame     = CVMat(dstH, dstW, CV_8UC(3));
-    lastFrameGray = CVMat(dstH, dstW, CV_8UC(1));
+    // Get output color (BGR) and grayscale images from the pools
+    lastFrame     = poolFrame(_framePool, dstH, dstW, CV_8UC(3));
+    lastFrameGray = poolFrame(_grayPool, dstH, dstW, CV_8UC(1));
     format        = CVImage::cvType2glPixelFormat(lastFrame.type());
 
     // Bugfix on some devices with wrong pixel offsets
@@ -852,6 +941,9 @@ void CVCapture::copyYUVPlanes(float  scrWdivH,
     for (auto& thread : threads)
         thread.join();
 
+    // Crop, mirror, color conversion and grayscale are done in one pass
+    _copiesPerFrame.set(1.0f);
+
     // Stop the capture time displayed in the statistics info
     _captureTimesMS.set(_timer.elapsedTimeInMilliSec() - startCaptureTimeMS);
 }
@@ -986,13 +1078,13 @@ void CVCapture::moveCapturePosition(int n)
 #ifndef SL_EMSCRIPTEN
     if (_videoType != VT_FILE) return;
 
-    int frameIndex = (int)_captureDevice.get(cv::CAP_PROP_POS_FRAMES);
+    int frameIndex = _videoDecoder.nextFrameIndex();
     frameIndex += n;
 
     if (frameIndex < 0) frameIndex = 0;
     if (frameIndex > frameCount) frameIndex = frameCount;
 
-    _captureDevice.set(cv::CAP_PROP_POS_FRAMES, frameIndex);
+    _videoDecoder.seek(frameIndex);
 #endif
 }
 //-----------------------------------------------------------------------------
@@ -1003,7 +1095,7 @@ int CVCapture::nextFrameIndex()
     int result = 0;
 
     if (_videoType == VT_FILE)
-        result = (int)_captureDevice.get(cv::CAP_PROP_POS_FRAMES);
+        result = _videoDecoder.nextFrameIndex();
 
     return result;
 #else
@@ -1017,7 +1109,7 @@ int CVCapture::videoLength()
     int result = 0;
 
     if (_videoType == VT_FILE)
-        result = (int)_captureDevice.get(cv::CAP_PROP_FRAME_COUNT);
+        result = _videoDecoder.frameCount();
 
     return result;
 #else
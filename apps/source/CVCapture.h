@@ -23,6 +23,7 @@ for a good top down information.
 #include <SL.h>
 #include <CVTypedefs.h>
 #include <CVImage.h>
+#include <CVVideoDecoder.h>
 #include <Averaged.h>
 #include <opencv2/opencv.hpp>
 #include <CVCamera.h>
@@ -54,8 +55,15 @@ top level application with its own video grabbing functionality. This is e.g.
 used in the iOS or Android examples.
 The CVCapture::lastFrame and CVCapture::lastFrameGray are on the other
 hand used in all applications as the buffer for the last captured image.\n
+The frame buffers come from small pools and are reused as soon as nobody else
+holds a reference to them (cv::Mat is reference counted). CVCapture::lastFrame
+can therefore be a cropped view (ROI) into a larger buffer: use its step and
+not its width to address rows, e.g. with SLGLTexture::streamVideoImage.\n
 Alternatively CVCapture can open a video file by a given videoFilename.
-This feature can be used across all platforms.
+This feature can be used across all platforms. Video files are read by a
+CVVideoDecoder that decodes videoPrefetchFrames frames ahead on its own thread.
+With videoCacheSizeMB greater than zero the decoded frames are cached, so
+stepping back with moveCapturePosition does not decode them again.
 For more information on video and capture see:\n
 https://docs.opencv.org/3.0-beta/modules/videoio/doc/reading_and_writing_video.html
 */
@@ -107,6 +115,7 @@ public: //! Public static instance getter for singleton pattern
     int         nextFrameIndex();
     int         videoLength(); //! get number of frames in video
     AvgFloat&   captureTimesMS() { return _captureTimesMS; }
+    AvgFloat&   copiesPerFrame() { return _copiesPerFrame; }
     void        loadCalibrations(const string& computerInfo,
                                  const string& configPath);
     void        setCameraSize(int sizeIndex,
@@ -127,6 +136,8 @@ public: //! Public static instance getter for singleton pattern
     bool            videoLoops;         //!< flag if video should loop
     float           fps;
     int             frameCount;
+    int             videoPrefetchFrames; //!< No. of video file frames decoded ahead
+    size_t          videoCacheSizeMB;    //!< Cache size for decoded video file frames (0 = off)
 
     /*! A requestedSizeIndex of -1 returns on Android the default size of 640x480.
     This is the default size index if the camera resolutions are unknown.*/
@@ -145,13 +156,23 @@ private:
 
 #ifndef SL_EMSCRIPTEN
     CVVideoCapture _captureDevice; //!< OpenCV capture device
+    CVVideoDecoder _videoDecoder;  //!< Prefetching decoder for video files
 #else
     WebCamera _webCamera; //!< Browser capture stream
 #endif
 
+    CVMat poolFrame(CVVMat& pool, int rows, int cols, int type);
+
     CVVideoType  _videoType = VT_NONE; //!< Flag for using the live video image
     AvgFloat     _captureTimesMS;      //!< Averaged time for video capturing in ms
+    AvgFloat     _copiesPerFrame;      //!< Averaged NO. of full image copies & conversions per frame
+    int          _numCopies = 0;       //!< NO. of full image copies & conversions of the current frame
     HighResTimer _timer;               //!< High resolution timer
+
+    CVVMat _grabPool;  //!< reusable buffers for grabbed frames
+    CVVMat _framePool; //!< reusable buffers for converted or mirrored color frames
+    CVVMat _grayPool;  //!< reusable buffers for grayscale frames
+    CVMat  _srcGray;   //!< grayscale plane of the source (e.g. Y of NV21) that replaces the gray conversion
 };
 //-----------------------------------------------------------------------------
 #endif // CVCapture_H
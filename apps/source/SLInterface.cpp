@@ -22,6 +22,7 @@
 #include <SLAssimpImporter.h>
 #include <SLAssetManager.h>
 #include <SLAssetLoader.h>
+#include <SLGLTextureIBL.h>
 #include <SLInputManager.h>
 #include <SLScene.h>
 #include <SLSceneView.h>
@@ -88,6 +89,11 @@ void slCreateApp(SLVstring&      cmdLineArgs,
     AppCommon::videoPath   = videoPath;
     AppCommon::configPath  = configPath;
 
+#ifdef SL_BUILD_WITH_ASSIMP
+    SLAssimpImporter::cachePath = configPath + "cache/models/";
+#endif
+    SLGLTextureIBL::cachePath = configPath + "cache/ibl/";
+
     SLGLState* stateGL = SLGLState::instance();
     SL_LOG("Path to exe      : %s", AppCommon::exePath.c_str());
     SL_LOG("Path to Models   : %s", modelPath.c_str());
@@ -308,6 +314,10 @@ bool slPaintAllViews()
             needUpdate = true;
     }
 
+    // Upload the next mip levels of streamed textures after rendering
+    if (SLGLTexture::updateStreaming())
+        needUpdate = true;
+
     return needUpdate;
 }
 //-----------------------------------------------------------------------------
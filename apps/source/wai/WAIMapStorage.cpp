@@ -1,4 +1,5 @@
 #include <WAIMapStorage.h>
+#include <SLFileStorage.h>
 #include <Profiler.h>
 
 cv::Mat WAIMapStorage::convertToCVMat(const SLMat4f slMat)
@@ -696,24 +697,19 @@ bool WAIMapStorage::loadMapBinary(WAIMap*           waiMap,
         imgDir          = dir + Utils::getFileNameWOExt(path) + "/";
     }
 
-    FILE* f = fopen(path.c_str(), "rb");
-    if (!f)
+    if (!SLFileStorage::exists(path, IOK_generic))
         return false;
 
-    fseek(f, 0, SEEK_END);
-    uint32_t contentSize = ftell(f);
-    rewind(f);
-
-    uint8_t* fContent      = (uint8_t*)malloc(sizeof(uint8_t*) * contentSize);
-    uint8_t* fContentStart = fContent;
-    if (!fContent)
-        return false;
-
-    size_t readResult = fread(fContent, 1, contentSize, f);
-    if (readResult != contentSize)
+    // The map is parsed directly from the memory mapped file. The content is
+    // only read: all matrices and vectors are copied into the new objects.
+    SLIOView view = SLFileStorage::readIntoView(path, IOK_generic);
+    if (view.size < sizeof(MapInfo))
+    {
+        view.release();
         return false;
+    }
 
-    fclose(f);
+    uint8_t* fContent = (uint8_t*)view.data;
 
     MapInfo* mapInfo = (MapInfo*)fContent;
     fContent += sizeof(MapInfo);
@@ -807,7 +803,7 @@ bool WAIMapStorage::loadMapBinary(WAIMap*           waiMap,
                                              keyPtsUndist.size(),
                                              keyPtsUndist,
                                              featureDescriptors,
-                                             voc,
+                                             nullptr,
                                              nScaleLevels,
                                              scaleFactor,
                                              vScaleFactor,
@@ -851,6 +847,9 @@ bool WAIMapStorage::loadMapBinary(WAIMap*           waiMap,
         bestCovisibleWeightsMap[newKf->mnId]     = bestCovisibleWeights;
     }
 
+    // compute the bag of words of all keyframes in parallel
+    WAIKeyFrame::ComputeBoW(keyFrames, voc);
+
     // set parent keyframe pointers into keyframes
     for (WAIKeyFrame* kf : keyFrames)
     {
@@ -1082,7 +1081,7 @@ bool WAIMapStorage::loadMapBinary(WAIMap*           waiMap,
 
     waiMap->setNumLoopClosings(numLoopClosings);
 
-    free(fContentStart);
+    view.release();
 
     return true;
 }
@@ -1216,7 +1215,7 @@ bool WAIMapStorage::loadMap(WAIMap*           waiMap,
                                              keyPtsUndist.size(),
                                              keyPtsUndist,
                                              featureDescriptors,
-                                             voc,
+                                             nullptr,
                                              nScaleLevels,
                                              scaleFactor,
                                              vScaleFactor,
@@ -1266,6 +1265,9 @@ bool WAIMapStorage::loadMap(WAIMap*           waiMap,
         }
     }
 
+    // compute the bag of words of all keyframes in parallel
+    WAIKeyFrame::ComputeBoW(keyFrames, voc);
+
     // set parent keyframe pointers into keyframes
     for (WAIKeyFrame* kf : keyFrames)
     {
@@ -392,6 +392,32 @@ void CVCalibration::remap(CVMat& inDistorted,
               cv::INTER_LINEAR);
 }
 //-----------------------------------------------------------------------------
+/*! Undistorts, crops and resizes the inDistorted image in one pass into
+outBgr and optionally its gray version into outGray. The crop rectangle is in
+the pixels of the undistorted image, an empty crop means the full image and an
+empty targetSize the size of the crop. The remap tables are cached and rebuilt
+automatically if the calibration, the crop or the target size changes. The
+camera matrix of the output image is returned by cameraMatCropResized.
+*/
+bool CVCalibration::undistortCropResize(const CVMat&  inDistorted,
+                                        const CVRect& crop,
+                                        const CVSize& targetSize,
+                                        CVMat&        outBgr,
+                                        CVMat*        outGray)
+{
+    assert(inDistorted.size() == _imageSize &&
+           "Input image size differs from calibration image size!");
+
+    return _undistortMap.apply(_cameraMat,
+                               _distortion,
+                               _cameraMatUndistorted,
+                               inDistorted,
+                               crop,
+                               targetSize,
+                               outBgr,
+                               outGray);
+}
+//-----------------------------------------------------------------------------
 //! Calculates camera intrinsics from a guessed FOV angle
 /*! Most laptop-, webcam- or mobile camera have a horizontal view angle or
 so called field of view (FOV) of around 65 degrees. From this parameter we
@@ -21,6 +21,7 @@ for a good top down information.
 
 #include <CVTypedefs.h>
 #include <CVTypes.h>
+#include <CVUndistortMap.h>
 
 using std::string;
 using std::vector;
@@ -117,6 +118,11 @@ public:
 
     void remap(CVMat& inDistorted,
                CVMat& outUndistorted);
+    bool undistortCropResize(const CVMat&  inDistorted,
+                             const CVRect& crop,
+                             const CVSize& targetSize,
+                             CVMat&        outBgr,
+                             CVMat*        outGray = nullptr);
 
     //! Adapts an already calibrated camera to a new resolution (cropping and scaling)
     void adaptForNewResolution(const CVSize& newSize, bool calcUndistortionMaps);
@@ -131,6 +137,7 @@ public:
     const CVMat& cameraMat() const { return _cameraMat; }
     const CVMat& cameraMatUndistorted() const { return _cameraMatUndistorted; }
     const CVMat& distortion() const { return _distortion; }
+    const CVMat& cameraMatCropResized() const { return _undistortMap.targetCameraMat(); }
     float        cameraFovVDeg() const { return _cameraFovVDeg; }
     float        cameraFovHDeg() const { return _cameraFovHDeg; }
 
@@ -213,12 +220,13 @@ private:
     CVSize _imageSize;                             //!< Input image size in pixels (after cropping)
     int    _camSizeIndex = -1;                     //!< The requested camera size index
 
-    CVMat        _undistortMapX;                   //!< Undistortion float map in x-direction
-    CVMat        _undistortMapY;                   //!< Undistortion float map in y-direction
-    CVMat        _cameraMatUndistorted;            //!< Camera matrix that defines scene camera and may also be used for reprojection of undistorted image
-    string       _calibrationTime = "-";           //!< Time stamp string of calibration
-    string       _computerInfos;
-    CVCameraType _camType = CVCameraType::FRONTFACING;
+    CVMat          _undistortMapX;                 //!< Undistortion float map in x-direction
+    CVMat          _undistortMapY;                 //!< Undistortion float map in y-direction
+    CVMat          _cameraMatUndistorted;          //!< Camera matrix that defines scene camera and may also be used for reprojection of undistorted image
+    CVUndistortMap _undistortMap;                  //!< Cached fused undistort-crop-resize tables
+    string         _calibrationTime = "-";         //!< Time stamp string of calibration
+    string         _computerInfos;
+    CVCameraType   _camType = CVCameraType::FRONTFACING;
 
     static const int _CALIBFILEVERSION; //!< Global const file format version
 };
@@ -10,6 +10,7 @@
 #include <CVCalibrationEstimator.h>
 #include <CVCalibration.h>
 #include <Utils.h>
+#include <Profiler.h>
 
 //-----------------------------------------------------------------------------
 CVCalibrationEstimator::CVCalibrationEstimator(CVCalibrationEstimatorParams params,
@@ -33,6 +34,9 @@ CVCalibrationEstimator::CVCalibrationEstimator(CVCalibrationEstimatorParams para
     _calibDataPath(calibDataPath),
     _exePath(exePath)
 {
+    // keep one core for the ui and the video thread
+    _maxExtractTasks = std::max(1, (int)Utils::maxThreads() - 1);
+
     if (!loadCalibParams())
     {
         throw CVCalibrationEstimatorException("Could not load calibration parameter!",
@@ -69,7 +73,11 @@ CVCalibrationEstimator::CVCalibrationEstimator(CVCalibrationEstimatorParams para
 //-----------------------------------------------------------------------------
 CVCalibrationEstimator::~CVCalibrationEstimator()
 {
-    // wait for the async task to finish
+    // wait for the async tasks to finish
+    for (auto& task : _extractTasks)
+        task.wait();
+    if (_intermediateTask.valid())
+        _intermediateTask.wait();
     if (_calibrationTask.valid())
         _calibrationTask.wait();
 }
@@ -80,7 +88,7 @@ bool CVCalibrationEstimator::calculate()
     bool calibrationSuccessful = false;
     if (!_calibrationTask.valid())
     {
-        _calibrationTask = std::async(std::launch::async, &CVCalibrationEstimator::calibrateAsync, this);
+        startCalibration();
     }
     else if (_calibrationTask.wait_for(std::chrono::milliseconds(1)) == std::future_status::ready)
     {
@@ -99,61 +107,238 @@ bool CVCalibrationEstimator::calculate()
     return calibrationSuccessful;
 }
 //-----------------------------------------------------------------------------
-bool CVCalibrationEstimator::extractAsync()
+/*! Finds the inner chessboard corners with subpixel precision. Large images
+ are searched at a reduced resolution first and only the found corners are
+ refined in the full resolution image. If the reduced search fails, the full
+ resolution image is searched. This function is thread safe and used by the
+ extraction tasks as well as by the batch calibration.
+*/
+bool CVCalibrationEstimator::extractCorners(const CVMat&  imageGray,
+                                            const CVSize& boardSize,
+                                            CVVPoint2f&   corners2D)
+{
+    PROFILE_FUNCTION();
+
+    int  flags = cv::CALIB_CB_ADAPTIVE_THRESH | cv::CALIB_CB_NORMALIZE_IMAGE;
+    bool found = false;
+
+    const int maxSearchWidth = 1280;
+    if (imageGray.cols > maxSearchWidth)
+    {
+        float scale = (float)imageGray.cols / (float)maxSearchWidth;
+        CVMat imageSmall;
+        cv::resize(imageGray, imageSmall, cv::Size(), 1.0 / scale, 1.0 / scale, cv::INTER_AREA);
+        found = cv::findChessboardCorners(imageSmall, boardSize, corners2D, flags);
+        if (found)
+        {
+            for (cv::Point2f& pt : corners2D)
+                pt *= scale;
+        }
+    }
+
+    if (!found)
+        found = cv::findChessboardCorners(imageGray, boardSize, corners2D, flags);
+
+    if (found)
+    {
+        cv::cornerSubPix(imageGray,
+                         corners2D,
+                         CVSize(11, 11),
+                         CVSize(-1, -1),
+                         cv::TermCriteria(cv::TermCriteria::EPS + cv::TermCriteria::COUNT,
+                                          30,
+                                          0.0001));
+    }
+    else
+        corners2D.clear();
+
+    return found;
+}
+//-----------------------------------------------------------------------------
+//! Starts the corner extraction of a grabbed frame on a worker thread
+void CVCalibrationEstimator::startExtraction(const CVMat& imageGray)
 {
     if (_imageSize.width == 0 && _imageSize.height == 0)
-        _imageSize = _currentImgToExtract.size();
-    else if (_imageSize.width != _currentImgToExtract.size().width || _imageSize.height != _currentImgToExtract.size().height)
+        _imageSize = imageGray.size();
+    else if (_imageSize != imageGray.size())
     {
-        _hasAsyncError = true;
-        _exception     = CVCalibrationEstimatorException("Image size changed during capturing process!",
-                                                     __LINE__,
-                                                     __FILE__);
-        return false;
+        _state = State::Error;
+        throw CVCalibrationEstimatorException("Image size changed during capturing process!",
+                                              __LINE__,
+                                              __FILE__);
     }
 
-    bool foundPrecisely = false;
-    try
+    CVSize boardSize = _boardSize;
+    _extractTasks.push_back(std::async(std::launch::async,
+                                       [boardSize](CVMat image) {
+                                           CVVPoint2f corners2D;
+                                           extractCorners(image, boardSize, corners2D);
+                                           return corners2D;
+                                       },
+                                       imageGray.clone()));
+}
+//-----------------------------------------------------------------------------
+/*! Adds the corners of all finished extraction tasks to the image points.
+ The image points are only modified on the calling thread, so the extraction
+ tasks need no synchronisation.
+*/
+void CVCalibrationEstimator::collectExtractions()
+{
+    for (auto it = _extractTasks.begin(); it != _extractTasks.end();)
     {
-        CVVPoint2f preciseCorners2D;
-        int        flags          = cv::CALIB_CB_ADAPTIVE_THRESH | cv::CALIB_CB_NORMALIZE_IMAGE;
-        bool       foundPrecisely = cv::findChessboardCorners(_currentImgToExtract,
-                                                        _boardSize,
-                                                        preciseCorners2D,
-                                                        flags);
-
-        if (foundPrecisely)
+        if (it->wait_for(std::chrono::milliseconds(0)) != std::future_status::ready)
         {
-            cv::cornerSubPix(_currentImgToExtract,
-                             preciseCorners2D,
-                             CVSize(11, 11),
-                             CVSize(-1, -1),
-                             cv::TermCriteria(cv::TermCriteria::EPS + cv::TermCriteria::COUNT,
-                                              30,
-                                              0.0001));
-
-            // add detected points
-            _imagePoints.push_back(preciseCorners2D);
-            _numCaptured++;
+            ++it;
+            continue;
         }
+
+        try
+        {
+            CVVPoint2f corners2D = it->get();
+            if (!corners2D.empty())
+            {
+                _imagePoints.push_back(corners2D);
+                _numCaptured++;
+            }
+        }
+        catch (std::exception& e)
+        {
+            _hasAsyncError = true;
+            _exception     = CVCalibrationEstimatorException(e.what(), __LINE__, __FILE__);
+        }
+        it = _extractTasks.erase(it);
     }
-    catch (std::exception& e)
-    {
-        _hasAsyncError = true;
-        _exception     = CVCalibrationEstimatorException(e.what(), __LINE__, __FILE__);
-        return false;
-    }
-    catch (...)
+}
+//-----------------------------------------------------------------------------
+/*! Takes over a finished background calibration update and starts a new one
+ if enough new views were captured since the last one. An update starts from
+ the intrinsics of the previous update, so calibrateCamera converges in a few
+ iterations. The update works on a copy of the image points.
+*/
+void CVCalibrationEstimator::updateIntermediate()
+{
+    if (_intermediateTask.valid())
     {
-        _hasAsyncError = true;
-        _exception     = CVCalibrationEstimatorException("Unknown exception during calibration!", __LINE__, __FILE__);
-        return false;
+        if (_intermediateTask.wait_for(std::chrono::milliseconds(0)) != std::future_status::ready)
+            return;
+
+        try
+        {
+            CalibrationUpdate update = _intermediateTask.get();
+            if (update.ok)
+                _intermediate = update;
+        }
+        catch (std::exception& e)
+        {
+            // an intermediate update is optional, only the final calibration counts
+            Utils::log("SLProject", "Intermediate calibration failed: %s", e.what());
+        }
     }
 
-    return foundPrecisely;
+    int numViews = (int)_imagePoints.size();
+    if (numViews < _intermediateStep ||
+        numViews < _intermediate.numViews + _intermediateStep)
+        return;
+
+    _intermediateTask = std::async(std::launch::async,
+                                   &CVCalibrationEstimator::calcCalibrationUpdate,
+                                   _imagePoints,
+                                   _imageSize,
+                                   _boardSize,
+                                   _boardSquareMM,
+                                   _params.calibrationFlags(),
+                                   _intermediate.cameraMat,
+                                   _intermediate.distortion);
 }
 //-----------------------------------------------------------------------------
-bool CVCalibrationEstimator::calibrateAsync()
+//! Calculates a calibration update on a worker thread
+CVCalibrationEstimator::CalibrationUpdate
+CVCalibrationEstimator::calcCalibrationUpdate(CVVVPoint2f imagePoints,
+                                              CVSize      imageSize,
+                                              CVSize      boardSize,
+                                              float       squareSize,
+                                              int         flag,
+                                              CVMat       cameraMatrixGuess,
+                                              CVMat       distCoeffsGuess)
+{
+    PROFILE_FUNCTION();
+
+    CalibrationUpdate update;
+    CVVMat            rvecs, tvecs;
+    vector<float>     reprojErrs;
+
+    update.ok       = calcCalibration(imageSize,
+                                update.cameraMat,
+                                update.distortion,
+                                imagePoints,
+                                rvecs,
+                                tvecs,
+                                reprojErrs,
+                                update.reprojError,
+                                boardSize,
+                                squareSize,
+                                flag,
+                                false,
+                                cameraMatrixGuess,
+                                distCoeffsGuess);
+    update.numViews = (int)imagePoints.size();
+    return update;
+}
+//-----------------------------------------------------------------------------
+//! Returns the latest intermediate calibration
+CVCalibration CVCalibrationEstimator::getIntermediateCalibration()
+{
+    if (!_intermediate.ok)
+        return CVCalibration(_camType, "");
+
+    return CVCalibration(_intermediate.cameraMat,
+                         _intermediate.distortion,
+                         _imageSize,
+                         _boardSize,
+                         _boardSquareMM,
+                         _intermediate.reprojError,
+                         _intermediate.numViews,
+                         Utils::getDateTime2String(),
+                         _camSizeIndex,
+                         _mirroredH,
+                         _mirroredV,
+                         _camType,
+                         _computerInfos,
+                         _params.calibrationFlags(),
+                         true);
+}
+//-----------------------------------------------------------------------------
+/*! Starts the final calibration on a worker thread. It is seeded with the
+ latest intermediate update. A running update is waited for on the worker
+ thread as well, so the calling UI thread never blocks on calibrateCamera.
+*/
+void CVCalibrationEstimator::startCalibration()
+{
+    auto              pending = std::make_shared<std::future<CalibrationUpdate>>(std::move(_intermediateTask));
+    CalibrationUpdate latest  = _intermediate;
+
+    _calibrationTask = std::async(std::launch::async,
+                                  [this, pending, latest]()
+                                  {
+                                      CalibrationUpdate seed = latest;
+                                      if (pending->valid())
+                                      {
+                                          try
+                                          {
+                                              CalibrationUpdate update = pending->get();
+                                              if (update.ok)
+                                                  seed = update;
+                                          }
+                                          catch (std::exception& e)
+                                          {
+                                              Utils::log("SLProject", "Intermediate calibration failed: %s", e.what());
+                                          }
+                                      }
+                                      return calibrateAsync(seed.cameraMat, seed.distortion);
+                                  });
+}
+//-----------------------------------------------------------------------------
+bool CVCalibrationEstimator::calibrateAsync(CVMat cameraMatGuess, CVMat distortionGuess)
 {
     bool ok = false;
     try
@@ -175,7 +360,9 @@ bool CVCalibrationEstimator::calibrateAsync()
                              _boardSize,
                              _boardSquareMM,
                              _params.calibrationFlags(),
-                             _params.useReleaseObjectMethod);
+                             _params.useReleaseObjectMethod,
+                             cameraMatGuess,
+                             distortionGuess);
         // correct number of caputured, extraction may have failed
         if (!rvecs.empty() || !reprojErrs.empty())
             _numCaptured = (int)std::max(rvecs.size(), reprojErrs.size());
@@ -218,7 +405,10 @@ bool CVCalibrationEstimator::calibrateAsync()
     return ok;
 }
 //-----------------------------------------------------------------------------
-//! Calculates the calibration with the given set of image points
+/*! Calculates the calibration with the given set of image points. If a
+ camera matrix and distortion guess are passed (e.g. from an intermediate
+ calibration with fewer views), calibrateCamera starts from them.
+*/
 bool CVCalibrationEstimator::calcCalibration(CVSize&            imageSize,
                                              CVMat&             cameraMatrix,
                                              CVMat&             distCoeffs,
@@ -230,17 +420,28 @@ bool CVCalibrationEstimator::calcCalibration(CVSize&            imageSize,
                                              CVSize&            boardSize,
                                              float              squareSize,
                                              int                flag,
-                                             bool               useReleaseObjectMethod)
+                                             bool               useReleaseObjectMethod,
+                                             const CVMat&       cameraMatrixGuess,
+                                             const CVMat&       distCoeffsGuess)
 {
-    // Init camera matrix with the eye setter
-    cameraMatrix = CVMat::eye(3, 3, CV_64F);
+    if (cameraMatrixGuess.rows == 3 && cameraMatrixGuess.cols == 3 && !distCoeffsGuess.empty())
+    {
+        cameraMatrix = cameraMatrixGuess.clone();
+        distCoeffs   = distCoeffsGuess.clone();
+        flag |= cv::CALIB_USE_INTRINSIC_GUESS;
+    }
+    else
+    {
+        // Init camera matrix with the eye setter
+        cameraMatrix = CVMat::eye(3, 3, CV_64F);
 
-    // We need to set eleme at 0,0 to 1 if we want a fix aspect ratio
-    if (flag & cv::CALIB_FIX_ASPECT_RATIO)
-        cameraMatrix.at<double>(0, 0) = 1.0;
+        // We need to set eleme at 0,0 to 1 if we want a fix aspect ratio
+        if (flag & cv::CALIB_FIX_ASPECT_RATIO)
+            cameraMatrix.at<double>(0, 0) = 1.0;
 
-    // init the distortion coeffitients to zero
-    distCoeffs = CVMat::zeros(8, 1, CV_64F);
+        // init the distortion coeffitients to zero
+        distCoeffs = CVMat::zeros(8, 1, CV_64F);
+    }
 
     CVVVPoint3f objectPoints(1);
 
@@ -364,42 +565,37 @@ void CVCalibrationEstimator::updateExtractAndCalc(bool found, bool grabFrame, cv
     switch (_state)
     {
         case State::Streaming:
+        case State::BusyExtracting:
         {
-            if (grabFrame && found)
+            collectExtractions();
+            if (_hasAsyncError)
             {
-                _currentImgToExtract = imageGray.clone();
-                // start async extraction
-                if (!_calibrationTask.valid())
-                {
-                    _calibrationTask = std::async(std::launch::async, &CVCalibrationEstimator::extractAsync, this);
-                }
+                _state = State::Error;
+                throw _exception;
+            }
+
+            // grabbed frames are extracted on worker threads while streaming
+            if (grabFrame && found && _state == State::Streaming)
+                startExtraction(imageGray);
+
+            updateIntermediate();
 
+            int numPending = (int)_extractTasks.size();
+            if (_numCaptured >= _numOfImgsToCapture && numPending == 0)
+            {
+                // if ready and number of capturings exceed number of required start calculation
+                startCalibration();
+                _state = State::Calculating;
+            }
+            else if (_numCaptured + numPending >= _numOfImgsToCapture ||
+                     numPending >= _maxExtractTasks)
+            {
+                // wait for the pending extractions, failed ones have to be grabbed again
                 _state = State::BusyExtracting;
             }
-            break;
-        }
-        case State::BusyExtracting:
-        {
-            // check if async task is ready
-            if (_calibrationTask.wait_for(std::chrono::milliseconds(1)) == std::future_status::ready)
+            else
             {
-                bool extractionSuccessful = _calibrationTask.get();
-
-                if (_hasAsyncError)
-                {
-                    _state = State::Error;
-                    throw _exception;
-                }
-                else if (_numCaptured >= _numOfImgsToCapture)
-                {
-                    // if ready and number of capturings exceed number of required start calculation
-                    _calibrationTask = std::async(std::launch::async, &CVCalibrationEstimator::calibrateAsync, this);
-                    _state           = State::Calculating;
-                }
-                else
-                {
-                    _state = State::Streaming;
-                }
+                _state = State::Streaming;
             }
             break;
         }
@@ -528,6 +724,93 @@ bool CVCalibrationEstimator::updateAndDecorate(CVMat        imageColor,
     return found;
 }
 //-----------------------------------------------------------------------------
+/*! Calibrates from all images in imageDir (e.g. the images stored in the
+ OnlyCaptureAndSave mode) as offline batch job. The corners of the images are
+ extracted in parallel on all cores. Images with another size than the first
+ one are skipped. Returns true if the calibration succeeded, the result is
+ available with getCalibration as in the interactive mode.
+*/
+bool CVCalibrationEstimator::calibrateImageFolder(const string& imageDir)
+{
+    PROFILE_FUNCTION();
+
+    vector<string> imageFiles;
+    for (const string& file : Utils::getFileNamesInDir(imageDir))
+    {
+        string ext = Utils::toLowerString(Utils::getFileExt(file));
+        if (ext == "jpg" || ext == "jpeg" || ext == "png" || ext == "bmp")
+            imageFiles.push_back(file);
+    }
+    std::sort(imageFiles.begin(), imageFiles.end());
+
+    if (imageFiles.empty())
+    {
+        Utils::log("SLProject", "No calibration images found in: %s", imageDir.c_str());
+        return false;
+    }
+
+    // extract the corners of the images in parallel, every thread takes the next image
+    vector<CVVPoint2f> corners(imageFiles.size());
+    vector<CVSize>     sizes(imageFiles.size());
+    CVSize             boardSize = _boardSize;
+
+    Utils::parallelFor((int)imageFiles.size(),
+                       [&](int i)
+                       {
+                           CVMat image = cv::imread(imageFiles[i], cv::IMREAD_GRAYSCALE);
+                           if (image.empty())
+                               return;
+                           sizes[i] = image.size();
+                           extractCorners(image, boardSize, corners[i]);
+                       },
+                       "CalibrationWorker");
+
+    _imagePoints.clear();
+    _imageSize = CVSize();
+    for (size_t i = 0; i < imageFiles.size(); ++i)
+    {
+        if (corners[i].empty())
+        {
+            Utils::log("SLProject", "No chessboard found in: %s", imageFiles[i].c_str());
+            continue;
+        }
+
+        if (_imageSize.area() == 0)
+            _imageSize = sizes[i];
+        else if (sizes[i] != _imageSize)
+        {
+            Utils::log("SLProject", "Skipped image with different size: %s", imageFiles[i].c_str());
+            continue;
+        }
+
+        _imagePoints.push_back(corners[i]);
+    }
+    _numCaptured = (int)_imagePoints.size();
+
+    Utils::log("SLProject",
+               "Found chessboard in %d of %d images.",
+               _numCaptured,
+               (int)imageFiles.size());
+
+    if (_imagePoints.empty())
+    {
+        _state = State::Done;
+        return false;
+    }
+
+    _calibrationSuccessful = calibrateAsync(_intermediate.cameraMat, _intermediate.distortion);
+    if (_hasAsyncError)
+    {
+        _state = State::Error;
+        throw _exception;
+    }
+
+    _state = State::Done;
+    if (_calibrationSuccessful)
+        Utils::log("SLProject", "Reproj. error: %f", _reprojectionError);
+    return _calibrationSuccessful;
+}
+//-----------------------------------------------------------------------------
 //! Calculates the 3D positions of the chessboard corners
 void CVCalibrationEstimator::calcBoardCorners3D(const CVSize& boardSize,
                                                 float         squareSize,
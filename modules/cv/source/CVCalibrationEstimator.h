@@ -69,6 +69,7 @@ public:
                            const CVMat& imageGray,
                            bool         grabFrame,
                            bool         drawCorners = true);
+    bool calibrateImageFolder(const string& imageDir);
 
     State state()
     {
@@ -85,6 +86,13 @@ public:
     bool          isStreaming() { return _state == State::Streaming; }
     bool          isDone() { return _state == State::Done; }
     bool          isDoneCaptureAndSave() { return _state == State::DoneCaptureAndSave; }
+    int           numPendingExtractions() { return (int)_extractTasks.size(); }
+
+    //! Intermediate calibration that is updated in the background while capturing
+    bool          hasIntermediateCalibration() { return _intermediate.ok; }
+    float         intermediateReprojError() { return _intermediate.reprojError; }
+    int           intermediateNumViews() { return _intermediate.numViews; }
+    CVCalibration getIntermediateCalibration();
 
     static bool calcCalibration(CVSize&            imageSize,
                                 CVMat&             cameraMatrix,
@@ -97,12 +105,30 @@ public:
                                 CVSize&            boardSize,
                                 float              squareSize,
                                 int                flag,
-                                bool               useReleaseObjectMethod);
+                                bool               useReleaseObjectMethod,
+                                const CVMat&       cameraMatrixGuess = CVMat(),
+                                const CVMat&       distCoeffsGuess   = CVMat());
+    static bool extractCorners(const CVMat&  imageGray,
+                               const CVSize& boardSize,
+                               CVVPoint2f&   corners2D);
 
 private:
-    bool calibrateAsync();
-    bool extractAsync();
+    //! Result of a background calibration update
+    struct CalibrationUpdate
+    {
+        bool  ok = false;
+        CVMat cameraMat;
+        CVMat distortion;
+        float reprojError = -1.f;
+        int   numViews    = 0;
+    };
+
+    bool calibrateAsync(CVMat cameraMatGuess, CVMat distortionGuess);
+    void startCalibration();
     bool loadCalibParams();
+    void startExtraction(const CVMat& imageGray);
+    void collectExtractions();
+    void updateIntermediate();
     void updateExtractAndCalc(bool found, bool grabFrame, cv::Mat imageGray);
     void updateOnlyCapture(bool found, bool grabFrame, cv::Mat imageGray);
     void saveImage(cv::Mat imageGray);
@@ -117,13 +143,25 @@ private:
     static void   calcBoardCorners3D(const CVSize& boardSize,
                                      float         squareSize,
                                      CVVPoint3f&   objectPoints3D);
+    static CalibrationUpdate calcCalibrationUpdate(CVVVPoint2f imagePoints,
+                                                   CVSize      imageSize,
+                                                   CVSize      boardSize,
+                                                   float       squareSize,
+                                                   int         flag,
+                                                   CVMat       cameraMatrixGuess,
+                                                   CVMat       distCoeffsGuess);
 
     State _state                 = State::Streaming;
     bool  _calibrationSuccessful = false;
 
     std::future<bool> _calibrationTask; //!< future object for calculation of calibration in async task
 
-    cv::Mat     _currentImgToExtract;
+    vector<std::future<CVVPoint2f>> _extractTasks;         //!< pending corner extractions of grabbed frames
+    int                             _maxExtractTasks;      //!< max. no. of parallel corner extractions
+    std::future<CalibrationUpdate>  _intermediateTask;     //!< pending background calibration update
+    CalibrationUpdate               _intermediate;         //!< latest background calibration update
+    int                             _intermediateStep = 3; //!< no. of new views that trigger an update
+
     CVVVPoint2f _imagePoints;               //!< 2D vector of corner points in chessboard
     CVSize      _boardSize;                 //!< NO. of inner chessboard corners.
     float       _boardSquareMM      = 10.f; //!< Size of chessboard square in mm
@@ -9,7 +9,10 @@
 
 #include <CVImage.h>
 #include <Utils.h>
+#include <Profiler.h>
+#include <HighResTimer.h>
 #include <algorithm> // std::max
+#include <functional>
 #include <SLFileStorage.h>
 
 #ifdef __EMSCRIPTEN__
@@ -17,6 +20,42 @@
 #    include "stb_image.h"
 #endif
 
+//-----------------------------------------------------------------------------
+//! Calls func(y0, y1) for stripes of rows in parallel
+/*! The stripes are small enough to stay in the cache and large enough to keep
+the scheduling overhead of cv::parallel_for_ low on big textures.
+*/
+static void parallelForRows(int numRows, const std::function<void(int, int)>& func)
+{
+    const int stripeRows = 64;
+    int       numStripes = (numRows + stripeRows - 1) / stripeRows;
+    cv::parallel_for_(cv::Range(0, numStripes), [&](const cv::Range& range) {
+        for (int s = range.start; s < range.end; ++s)
+            func(s * stripeRows, std::min(numRows, (s + 1) * stripeRows));
+    });
+}
+//-----------------------------------------------------------------------------
+//! Returns src converted to depth in parallel stripes
+static CVMat convertParallel(const CVMat& src, int depth, double alpha = 1.0)
+{
+    CVMat dst(src.rows, src.cols, CV_MAKETYPE(depth, src.channels()));
+    parallelForRows(src.rows, [&](int y0, int y1) {
+        CVMat dstRows = dst.rowRange(y0, y1);
+        src.rowRange(y0, y1).convertTo(dstRows, depth, alpha);
+    });
+    return dst;
+}
+//-----------------------------------------------------------------------------
+//! Reverses the pixels of the rows y0 to y1 in place
+template<typename T>
+static void reverseRows(CVMat& mat, int y0, int y1)
+{
+    for (int y = y0; y < y1; ++y)
+    {
+        T* row = mat.ptr<T>(y);
+        std::reverse(row, row + mat.cols);
+    }
+}
 //-----------------------------------------------------------------------------
 //! Default constructor
 CVImage::CVImage()
@@ -42,12 +81,13 @@ CVImage::CVImage(int             width,
 //! Constructor for image from file
 CVImage::CVImage(const string& filename,
                  bool          flipVertical,
-                 bool          loadGrayscaleIntoAlpha)
+                 bool          loadGrayscaleIntoAlpha,
+                 bool          loadPremultiplied)
   : _name(Utils::getFileName(filename))
 {
     assert(filename != "");
     clearData();
-    load(filename, flipVertical, loadGrayscaleIntoAlpha);
+    load(filename, flipVertical, loadGrayscaleIntoAlpha, loadPremultiplied);
 }
 //-----------------------------------------------------------------------------
 //! Copy constructor from a source image
@@ -224,161 +264,72 @@ bool CVImage::load(int             width,
                    bool            isTopLeft)
 {
 
+    PROFILE_FUNCTION();
+
     bool needsTextureRebuild = allocate(width,
                                         height,
                                         dstPixelFormatGL,
                                         false);
-    uint dstBPL              = _bytesPerLine;
-    uint dstBPP              = _bytesPerPixel;
-    uint srcBPP              = bytesPerPixel(srcPixelFormatGL);
-    uint srcBPL              = bytesPerLine((uint)width, srcPixelFormatGL, isContinuous);
 
-    if (isTopLeft)
+    // OpenCV color conversion code or -1 for a plain copy
+    int cvtCode = -1;
+    if (srcPixelFormatGL != dstPixelFormatGL)
     {
-        // copy lines and flip vertically
-        uchar* dstStart = _cvMat.data + _bytesPerImage - dstBPL;
-        uchar* srcStart = data;
-
-        if (srcPixelFormatGL == dstPixelFormatGL)
+        if (srcPixelFormatGL == PF_bgra && dstPixelFormatGL == PF_rgb)
+            cvtCode = cv::COLOR_BGRA2RGB;
+        else if (srcPixelFormatGL == PF_bgra && dstPixelFormatGL == PF_rgba)
+            cvtCode = cv::COLOR_BGRA2RGBA;
+        else if ((srcPixelFormatGL == PF_bgr || srcPixelFormatGL == PF_rgb) &&
+                 (dstPixelFormatGL == PF_rgb || dstPixelFormatGL == PF_bgr))
+            cvtCode = cv::COLOR_BGR2RGB;
+        else
         {
-            for (int h = 0; h < _cvMat.rows; ++h, srcStart += srcBPL, dstStart -= dstBPL)
-            {
-                memcpy(dstStart, srcStart, (unsigned long)dstBPL);
-            }
+            std::cout << "CVImage::load from memory: Pixel format conversion not allowed" << std::endl;
+            exit(1);
         }
-        else
+    }
+
+    uint  srcBPL = bytesPerLine((uint)width, srcPixelFormatGL, isContinuous);
+    CVMat src(height, width, glPixelFormat2cvType(srcPixelFormatGL), data, srcBPL);
+
+    // Copy or convert stripes of rows in parallel. Top-left images get
+    // flipped vertically: a stripe is converted into a temporary and flipped
+    // once into the mirrored stripe of the destination.
+    parallelForRows(height, [&](int y0, int y1) {
+        CVMat srcRows = src.rowRange(y0, y1);
+        if (isTopLeft)
         {
-            if (srcPixelFormatGL == PF_bgra)
-            {
-                if (dstPixelFormatGL == PF_rgb)
-                {
-                    for (int h = 0; h < _cvMat.rows; ++h, srcStart += srcBPL, dstStart -= dstBPL)
-                    {
-                        uchar* src = srcStart;
-                        uchar* dst = dstStart;
-                        for (int w = 0; w < _cvMat.cols - 1; ++w, dst += dstBPP, src += srcBPP)
-                        {
-                            dst[0] = src[2];
-                            dst[1] = src[1];
-                            dst[2] = src[0];
-                        }
-                    }
-                }
-                else if (dstPixelFormatGL == PF_rgba)
-                {
-                    for (int h = 0; h < _cvMat.rows; ++h, srcStart += srcBPL, dstStart -= dstBPL)
-                    {
-                        uchar* src = srcStart;
-                        uchar* dst = dstStart;
-                        for (int w = 0; w < _cvMat.cols - 1; ++w, dst += dstBPP, src += srcBPP)
-                        {
-                            dst[0] = src[2];
-                            dst[1] = src[1];
-                            dst[2] = src[0];
-                            dst[3] = src[3];
-                        }
-                    }
-                }
-            }
-            else if (srcPixelFormatGL == PF_bgr || srcPixelFormatGL == PF_rgb)
-            {
-                if (dstPixelFormatGL == PF_rgb || dstPixelFormatGL == PF_bgr)
-                {
-                    for (int h = 0; h < _cvMat.rows; ++h, srcStart += srcBPL, dstStart -= dstBPL)
-                    {
-                        uchar* src = srcStart;
-                        uchar* dst = dstStart;
-                        for (int w = 0; w < _cvMat.cols - 1; ++w, dst += dstBPP, src += srcBPP)
-                        {
-                            dst[0] = src[2];
-                            dst[1] = src[1];
-                            dst[2] = src[0];
-                        }
-                    }
-                }
-            }
+            CVMat dstRows = _cvMat.rowRange(height - y1, height - y0);
+            if (cvtCode < 0)
+                cv::flip(srcRows, dstRows, 0);
             else
             {
-                std::cout << "CVImage::load from memory: Pixel format conversion not allowed" << std::endl;
-                exit(1);
+                CVMat converted;
+                cv::cvtColor(srcRows, converted, cvtCode);
+                cv::flip(converted, dstRows, 0);
             }
         }
-    }
-    else // bottom left (no flipping)
-    {
-        if (srcPixelFormatGL == dstPixelFormatGL)
-        {
-            memcpy(_cvMat.data, data, (unsigned long)_bytesPerImage);
-        }
         else
         {
-            uchar* dstStart = _cvMat.data;
-            uchar* srcStart = data;
-
-            if (srcPixelFormatGL == PF_bgra)
-            {
-                if (dstPixelFormatGL == PF_rgb)
-                {
-                    for (int h = 0; h < _cvMat.rows - 1; ++h, srcStart += srcBPL, dstStart += dstBPL)
-                    {
-                        uchar* src = srcStart;
-                        uchar* dst = dstStart;
-                        for (int w = 0; w < _cvMat.cols - 1; ++w, dst += dstBPP, src += srcBPP)
-                        {
-                            dst[0] = src[2];
-                            dst[1] = src[1];
-                            dst[2] = src[0];
-                        }
-                    }
-                }
-                else if (dstPixelFormatGL == PF_rgba)
-                {
-                    for (int h = 0; h < _cvMat.rows - 1; ++h, srcStart += srcBPL, dstStart += dstBPL)
-                    {
-                        uchar* src = srcStart;
-                        uchar* dst = dstStart;
-                        for (int w = 0; w < _cvMat.cols - 1; ++w, dst += dstBPP, src += srcBPP)
-                        {
-                            dst[0] = src[2];
-                            dst[1] = src[1];
-                            dst[2] = src[0];
-                            dst[3] = src[3];
-                        }
-                    }
-                }
-            }
-            else if (srcPixelFormatGL == PF_bgr || srcPixelFormatGL == PF_rgb)
-            {
-                if (dstPixelFormatGL == PF_rgb || dstPixelFormatGL == PF_bgr)
-                {
-                    for (int h = 0; h < _cvMat.rows - 1; ++h, srcStart += srcBPL, dstStart += dstBPL)
-                    {
-                        uchar* src = srcStart;
-                        uchar* dst = dstStart;
-                        for (int w = 0; w < _cvMat.cols - 1; ++w, dst += dstBPP, src += srcBPP)
-                        {
-                            dst[0] = src[2];
-                            dst[1] = src[1];
-                            dst[2] = src[0];
-                        }
-                    }
-                }
-            }
+            CVMat dstRows = _cvMat.rowRange(y0, y1);
+            if (cvtCode < 0)
+                srcRows.copyTo(dstRows);
             else
-            {
-                std::cout << "CVImage::load from memory: Pixel format conversion not allowed" << std::endl;
-                exit(1);
-            }
+                cv::cvtColor(srcRows, dstRows, cvtCode);
         }
-    }
+    });
 
     return needsTextureRebuild;
 }
 //-----------------------------------------------------------------------------
-//! Loads the image with the appropriate image loader
+/*! Loads the image with the appropriate image loader. With loadPremultiplied
+the color channels of RGBA images get multiplied with the alpha channel. This
+is opt-in because the shaders of SLProject expect straight alpha.
+*/
 void CVImage::load(const string& filename,
                    bool          flipVertical,
-                   bool          loadGrayscaleIntoAlpha)
+                   bool          loadGrayscaleIntoAlpha,
+                   bool          loadPremultiplied)
 {
     string ext   = Utils::getFileExt(filename);
     _name        = Utils::getFileName(filename);
@@ -414,7 +365,7 @@ void CVImage::load(const string& filename,
 
     // Convert greater component depth than 8 bit to 8 bit, only if the image is not HDR
     if (_cvMat.depth() > CV_8U && ext != "hdr")
-        _cvMat.convertTo(_cvMat, CV_8U, 1.0 / 256.0);
+        _cvMat = convertParallel(_cvMat, CV_8U, 1.0 / 256.0);
 
 #ifndef __EMSCRIPTEN__
     _format = cvType2glPixelFormat(_cvMat.type());
@@ -448,26 +399,19 @@ void CVImage::load(const string& filename,
     }
     else if (_format == PF_red && loadGrayscaleIntoAlpha)
     {
-        CVMat rgbaImg;
-        rgbaImg.create(_cvMat.rows, _cvMat.cols, CV_8UC4);
-
-        // Copy grayscale into alpha channel
-        for (int y = 0; y < rgbaImg.rows; ++y)
-        {
-            uchar* dst = rgbaImg.ptr<uchar>(y);
-            uchar* src = _cvMat.ptr<uchar>(y);
-
-            for (int x = 0; x < rgbaImg.cols; ++x)
-            {
-                *dst++ = 0;      // B
-                *dst++ = 0;      // G
-                *dst++ = 0;      // R
-                *dst++ = *src++; // A
-            }
-        }
-
-        _cvMat = rgbaImg;
-        cv::cvtColor(_cvMat, _cvMat, cv::COLOR_BGRA2RGBA);
+        CVMat rgbaImg(_cvMat.rows, _cvMat.cols, CV_8UC4);
+
+        // Copy grayscale into alpha channel and clear RGB in parallel stripes
+        parallelForRows(rgbaImg.rows, [&](int y0, int y1) {
+            CVMat dst      = rgbaImg.rowRange(y0, y1);
+            CVMat src      = _cvMat.rowRange(y0, y1);
+            CVMat zero     = CVMat::zeros(y1 - y0, src.cols, CV_8UC1);
+            CVMat ins[]    = {zero, src};
+            int   fromTo[] = {0, 0, 0, 1, 0, 2, 1, 3};
+            cv::mixChannels(ins, 2, &dst, 1, fromTo, 4);
+        });
+
+        _cvMat  = rgbaImg;
         _format = PF_rgba;
 
         // for debug check
@@ -513,6 +457,9 @@ void CVImage::load(const string& filename,
     _bytesPerLine  = bytesPerLine((uint)_cvMat.cols, _format, _cvMat.isContinuous());
     _bytesPerImage = _bytesPerLine * (uint)_cvMat.rows;
 
+    if (loadPremultiplied)
+        premultiplyAlpha();
+
     // OpenCV loads top-left but OpenGL is bottom left
     if (flipVertical)
         flipY();
@@ -944,13 +891,19 @@ void CVImage::resize(int width, int height)
 
     cv::resize(_cvMat, dst, dst.size(), 0, 0, cv::INTER_LINEAR);
 
-    _cvMat = dst;
+    _cvMat         = dst;
+    _bytesPerLine  = bytesPerLine((uint)_cvMat.cols,
+                                 _format,
+                                 _cvMat.isContinuous());
+    _bytesPerImage = _bytesPerLine * (uint)_cvMat.rows;
 }
 //-----------------------------------------------------------------------------
-//! Converts the data type of the cvMat
+//! Converts the data type of the cvMat in parallel stripes
 void CVImage::convertTo(int cvDataType)
 {
-    _cvMat.convertTo(_cvMat, cvDataType);
+    PROFILE_FUNCTION();
+
+    _cvMat         = convertParallel(_cvMat, CV_MAT_DEPTH(cvDataType));
     _format        = cvType2glPixelFormat(cvDataType);
     _bytesPerPixel = bytesPerPixel(_format);
     _bytesPerLine  = bytesPerLine((uint)_cvMat.cols,
@@ -959,28 +912,186 @@ void CVImage::convertTo(int cvDataType)
     _bytesPerImage = _bytesPerLine * (uint)_cvMat.rows;
 }
 //-----------------------------------------------------------------------------
-//! Flip X coordinates used to make JPEGs from top-left to bottom-left images.
+//! Flips the image horizontally in place in parallel stripes
 void CVImage::flipX()
 {
-    if (_cvMat.cols > 0 && _cvMat.rows > 0)
-    {
-        CVMat dst = CVMat(_cvMat.rows, _cvMat.cols, _cvMat.type());
-        cv::flip(_cvMat, dst, 1);
-        _cvMat = dst;
-    }
+    PROFILE_FUNCTION();
+
+    if (_cvMat.cols < 2 || _cvMat.rows == 0)
+        return;
+
+    detach();
+
+    parallelForRows(_cvMat.rows, [&](int y0, int y1) {
+        switch (_cvMat.elemSize())
+        {
+            case 1: reverseRows<uchar>(_cvMat, y0, y1); break;
+            case 2: reverseRows<ushort>(_cvMat, y0, y1); break;
+            case 3: reverseRows<CVVec3b>(_cvMat, y0, y1); break;
+            case 4: reverseRows<uint32_t>(_cvMat, y0, y1); break;
+            case 8: reverseRows<uint64_t>(_cvMat, y0, y1); break;
+            case 12: reverseRows<CVVec3f>(_cvMat, y0, y1); break;
+            case 16: reverseRows<CVVec4f>(_cvMat, y0, y1); break;
+            default:
+            {
+                CVMat rows = _cvMat.rowRange(y0, y1);
+                CVMat flipped;
+                cv::flip(rows, flipped, 1);
+                flipped.copyTo(rows);
+            }
+        }
+    });
 }
 //-----------------------------------------------------------------------------
-//! Flip Y coordinates used to make JPEGs from top-left to bottom-left images.
+/*! Flips the image vertically in place. This converts top-left images (e.g.
+from JPEGs) to bottom-left images for OpenGL. The rows of the top half get
+swapped with the rows of the bottom half in parallel stripes without an
+extra image allocation.
+*/
 void CVImage::flipY()
 {
-    if (_cvMat.cols > 0 && _cvMat.rows > 0)
+    PROFILE_FUNCTION();
+
+    if (_cvMat.cols == 0 || _cvMat.rows < 2)
+        return;
+
+    detach();
+
+    size_t rowBytes = (size_t)_cvMat.cols * _cvMat.elemSize();
+    parallelForRows(_cvMat.rows / 2, [&](int y0, int y1) {
+        for (int y = y0; y < y1; ++y)
+        {
+            uchar* top    = _cvMat.ptr(y);
+            uchar* bottom = _cvMat.ptr(_cvMat.rows - 1 - y);
+            std::swap_ranges(top, top + rowBytes, bottom);
+        }
+    });
+}
+//-----------------------------------------------------------------------------
+/*! Multiplies the color channels with the alpha channel in place in parallel
+stripes. Premultiplied alpha avoids dark fringes when transparent textures
+get filtered or mipmapped. Only images with 4 channels of 8 bit or float
+are supported.
+*/
+void CVImage::premultiplyAlpha()
+{
+    PROFILE_FUNCTION();
+
+    if (_cvMat.channels() != 4 ||
+        (_cvMat.depth() != CV_8U && _cvMat.depth() != CV_32F))
+        return;
+
+    detach();
+
+    int numValues = _cvMat.cols * 4;
+    parallelForRows(_cvMat.rows, [&](int y0, int y1) {
+        for (int y = y0; y < y1; ++y)
+        {
+            if (_cvMat.depth() == CV_8U)
+            {
+                uchar* p = _cvMat.ptr<uchar>(y);
+                for (int i = 0; i < numValues; i += 4)
+                {
+                    uint a = p[i + 3];
+                    for (int c = 0; c < 3; ++c)
+                    {
+                        // Rounded division by 255 without a division
+                        uint v   = p[i + c] * a + 128;
+                        p[i + c] = (uchar)((v + (v >> 8)) >> 8);
+                    }
+                }
+            }
+            else
+            {
+                float* p = _cvMat.ptr<float>(y);
+                for (int i = 0; i < numValues; i += 4)
+                {
+                    p[i]     *= p[i + 3];
+                    p[i + 1] *= p[i + 3];
+                    p[i + 2] *= p[i + 3];
+                }
+            }
+        }
+    });
+}
+//-----------------------------------------------------------------------------
+/*! Builds the mip levels 1-n of an image with the GL size rule max(1, size/2).
+Every level is the area average of the previous level. For the downsampling
+by 2 OpenCV uses a SIMD fast path that is also multithreaded.
+*/
+void CVImage::buildMipmaps(const CVMat& image, CVVMat& levels)
+{
+    PROFILE_FUNCTION();
+
+    levels.clear();
+
+    CVMat level = image;
+    while (level.cols > 1 || level.rows > 1)
     {
-        CVMat dst = CVMat(_cvMat.rows, _cvMat.cols, _cvMat.type());
-        cv::flip(_cvMat, dst, 0);
-        _cvMat = dst;
+        CVMat next;
+        cv::resize(level,
+                   next,
+                   CVSize(std::max(1, level.cols / 2),
+                          std::max(1, level.rows / 2)),
+                   0,
+                   0,
+                   cv::INTER_AREA);
+        levels.push_back(next);
+        level = next;
     }
 }
 //-----------------------------------------------------------------------------
+/*! Runs the parallel pixel operations on a random RGBA image of the passed
+size (8K by default) and logs their times. Every operation has its own
+profiler scope, so the times also show up in the profiler trace.
+*/
+void CVImage::benchmark(int width, int height)
+{
+    PROFILE_FUNCTION();
+
+    CVMat bgra(height, width, CV_8UC4);
+    cv::randu(bgra, cv::Scalar::all(0), cv::Scalar::all(256));
+
+    CVImage      image;
+    HighResTimer timer;
+    auto         logTime = [&](const char* operation)
+    {
+        Utils::log("SLProject",
+                   "CVImage::benchmark %dx%d %-18s: %6.1f ms",
+                   width,
+                   height,
+                   operation,
+                   timer.elapsedTimeInMilliSec());
+        timer.start();
+    };
+
+    timer.start();
+    image.load(width, height, PF_bgra, PF_rgba, bgra.data, true, true);
+    logTime("load BGRA top-left");
+    image.flipY();
+    logTime("flipY");
+    image.flipX();
+    logTime("flipX");
+    image.premultiplyAlpha();
+    logTime("premultiplyAlpha");
+
+    CVVMat levels;
+    buildMipmaps(image.cvMat(), levels);
+    logTime("buildMipmaps");
+
+    image.convertTo(CV_32FC4);
+    logTime("convertTo 32F");
+    image.premultiplyAlpha();
+    logTime("premultiplyAlpha 32F");
+}
+//-----------------------------------------------------------------------------
+//! Clones the pixel data if it is shared with other matrices before in place changes
+void CVImage::detach()
+{
+    if (_cvMat.u && CV_XADD(&_cvMat.u->refcount, 0) > 1)
+        _cvMat = _cvMat.clone();
+}
+//-----------------------------------------------------------------------------
 //! Fills the image with a certain rgb color
 void CVImage::fill(uchar r, uchar g, uchar b)
 {
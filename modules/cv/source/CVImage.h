@@ -70,7 +70,8 @@ public:
             string          name);
     explicit CVImage(const string& imageFilename,
                      bool          flipVertical           = true,
-                     bool          loadGrayscaleIntoAlpha = false);
+                     bool          loadGrayscaleIntoAlpha = false,
+                     bool          loadPremultiplied      = false);
     CVImage(CVImage& srcImage);
     explicit CVImage(const CVVVec3f& colors);
     explicit CVImage(const CVVVec4f& colors);
@@ -84,7 +85,8 @@ public:
                                     bool            isContinuous = true);
     void                   load(const string& filename,
                                 bool          flipVertical           = true,
-                                bool          loadGrayscaleIntoAlpha = false);
+                                bool          loadGrayscaleIntoAlpha = false,
+                                bool          loadPremultiplied      = false);
     bool                   load(int             inWidth,
                                 int             inHeight,
                                 CVPixelFormatGL srcPixelFormatGL,
@@ -110,12 +112,15 @@ public:
     void                   convertTo(int cvDataType);
     void                   flipX();
     void                   flipY();
+    void                   premultiplyAlpha();
     void                   fill(uchar r, uchar g, uchar b);
     void                   fill(uchar r, uchar g, uchar b, uchar a);
     void                   crop(float targetWdivH, int& cropW, int& cropH);
     static CVPixelFormatGL cvType2glPixelFormat(int cvType);
     static int             glPixelFormat2cvType(CVPixelFormatGL pixelFormatGL);
     static string          formatString(CVPixelFormatGL pixelFormatGL);
+    static void            buildMipmaps(const CVMat& image, CVVMat& levels);
+    static void            benchmark(int width = 7680, int height = 4320);
 
     // Getters
     string          name() { return _name; }
@@ -138,6 +143,7 @@ protected:
     static uint bytesPerLine(uint            width,
                              CVPixelFormatGL pixelFormat,
                              bool            isContinuous = false);
+    void        detach();
 
     string          _name;          //!< Image name (e.g. from the filename)
     CVMat           _cvMat;         //!< OpenCV mat matrix image type
@@ -27,9 +27,13 @@ AvgFloat CVTracked::detect2TimesMS;
 AvgFloat CVTracked::matchTimesMS;
 AvgFloat CVTracked::optFlowTimesMS;
 AvgFloat CVTracked::poseTimesMS;
+AvgFloat CVTracked::detectSavedTimesMS;
+std::mutex CVTracked::_staticTimesMutex;
 //-----------------------------------------------------------------------------
 void CVTracked::resetTimes()
 {
+    std::lock_guard<std::mutex> lock(_staticTimesMutex);
+
     // Reset all timing variables
     CVTracked::trackingTimesMS.init(60, 0.0f);
     CVTracked::detectTimesMS.init(60, 0.0f);
@@ -38,6 +42,56 @@ void CVTracked::resetTimes()
     CVTracked::matchTimesMS.init(60, 0.0f);
     CVTracked::optFlowTimesMS.init(60, 0.0f);
     CVTracked::poseTimesMS.init(60, 0.0f);
+    CVTracked::detectSavedTimesMS.init(60, 0.0f);
+}
+//-----------------------------------------------------------------------------
+//! Calls track and measures its total time in the TT_track slot
+bool CVTracked::trackTimed(CVMat          imageGray,
+                           CVMat          imageBgr,
+                           CVCalibration* calib)
+{
+    HighResTimer timer;
+    bool         found = track(imageGray, imageBgr, calib);
+    float        ms    = timer.elapsedTimeInMilliSec();
+
+    std::lock_guard<std::mutex> lock(_timesMutex);
+    _timesMS[TT_track].set(ms);
+    return found;
+}
+//-----------------------------------------------------------------------------
+//! Returns the average of a timing slot of this tracker (thread safe)
+float CVTracked::timesMS(CVTrackedTiming timing)
+{
+    std::lock_guard<std::mutex> lock(_timesMutex);
+    return _timesMS[timing].average();
+}
+//-----------------------------------------------------------------------------
+/*! Sets the timing of this tracker and the corresponding static average.
+ The per tracker value is only written by the thread that runs the tracker but
+ may be read by the GUI thread, so it is set under _timesMutex. The static averages are shared by all trackers and therefore protected by a
+ mutex. The TT_track slot has no static counterpart: CVTracked::trackingTimesMS
+ is measured by the application over all trackers of a frame.
+*/
+void CVTracked::setTimeMS(CVTrackedTiming timing, float ms)
+{
+    {
+        std::lock_guard<std::mutex> lock(_timesMutex);
+        _timesMS[timing].set(ms);
+    }
+
+    static AvgFloat* staticTimes[TT_count] = {nullptr,
+                                              &detectTimesMS,
+                                              &detect1TimesMS,
+                                              &detect2TimesMS,
+                                              &matchTimesMS,
+                                              &optFlowTimesMS,
+                                              &poseTimesMS,
+                                              &detectSavedTimesMS};
+    if (staticTimes[timing])
+    {
+        std::lock_guard<std::mutex> lock(_staticTimesMutex);
+        staticTimes[timing]->set(ms);
+    }
 }
 //-----------------------------------------------------------------------------
 // clang-format off
@@ -30,9 +30,24 @@ for a good top down information.
 #endif
 
 #include <SLQuat4.h>
+#include <mutex>
 
 using Utils::AvgFloat;
 
+//-----------------------------------------------------------------------------
+//! Timing slots that every CVTracked instance measures for itself
+enum CVTrackedTiming
+{
+    TT_track = 0,   //!< Total time of one track call (latency of the tracker)
+    TT_detect,      //!< Feature detection & description
+    TT_detect1,     //!< Feature detection subpart 1
+    TT_detect2,     //!< Feature detection subpart 2
+    TT_match,       //!< Feature matching
+    TT_optFlow,     //!< Optical flow tracking
+    TT_pose,        //!< Pose estimation
+    TT_detectSaved, //!< Detection time saved against a full frame detection
+    TT_count        //!< Number of timing slots
+};
 //-----------------------------------------------------------------------------
 //! CVTracked is the pure virtual base class for tracking features in video.
 /*! The static vector trackers can hold multiple of CVTracked that are
@@ -43,26 +58,43 @@ using Utils::AvgFloat;
  tracker calculates the object matrix relative to the scene camera.
  See also the derived classes CVTrackedAruco, CVTrackedChessboard,
  CVTrackedFaces and CVTrackedFeature for example implementations.
- The update of the tracking per frame is implemented in onUpdateTracking in
- AppDemoTracking.cpp and called once per frame within the main render loop.
+ The update of the tracking per frame is implemented in onUpdateVideo in
+ AppDemoVideo.cpp and called once per frame within the main render loop.
+ Independent trackers can be run concurrently with CVTrackingScheduler.
+ Every tracker therefore measures its timings in its own averaged values
+ (see timesMS). They are written by the thread that runs the tracker and read
+ by the GUI, so both sides lock _timesMutex. The static averages are still
+ updated for the GUI.
 */
 class CVTracked
 {
 public:
-    explicit CVTracked() : _isVisible(false), _drawDetection(true) {}
+    explicit CVTracked() : _isVisible(false), _drawDetection(true)
+    {
+        for (auto& t : _timesMS)
+            t.init(60, 0.0f);
+    }
     virtual ~CVTracked() = default;
 
     virtual bool track(CVMat          imageGray,
                        CVMat          imageBgr,
                        CVCalibration* calib) = 0;
 
+    bool trackTimed(CVMat          imageGray,
+                    CVMat          imageBgr,
+                    CVCalibration* calib);
+
     // Setters
     void drawDetection(bool draw) { _drawDetection = draw; }
 
+    void name(const string& name) { _name = name; }
+
     // Getters
-    bool      isVisible() { return _isVisible; }
-    bool      drawDetection() { return _drawDetection; }
-    CVMatx44f objectViewMat() { return _objectViewMat; }
+    bool          isVisible() { return _isVisible; }
+    bool          drawDetection() { return _drawDetection; }
+    CVMatx44f     objectViewMat() { return _objectViewMat; }
+    const string& name() const { return _name; }
+    float         timesMS(CVTrackedTiming timing);
 
     // Static functions for commonly performed operations
     static cv::Matx44f createGLMatrix(const CVMat& tVec,
@@ -78,20 +110,29 @@ public:
                                          vector<float>    weights);
 
     // Statics: These statics are used directly in application code (e.g. in )
-    static void     resetTimes();    //!< Resets all static variables
-    static AvgFloat trackingTimesMS; //!< Averaged time for video tracking in ms
-    static AvgFloat detectTimesMS;   //!< Averaged time for video feature detection & description in ms
-    static AvgFloat detect1TimesMS;  //!< Averaged time for video feature detection subpart 1 in ms
-    static AvgFloat detect2TimesMS;  //!< Averaged time for video feature detection subpart 2 in ms
-    static AvgFloat matchTimesMS;    //!< Averaged time for video feature matching in ms
-    static AvgFloat optFlowTimesMS;  //!< Averaged time for video feature optical flow tracking in ms
-    static AvgFloat poseTimesMS;     //!< Averaged time for video feature pose estimation in ms
+    static void     resetTimes();       //!< Resets all static variables
+    static AvgFloat trackingTimesMS;    //!< Averaged time for video tracking in ms
+    static AvgFloat detectTimesMS;      //!< Averaged time for video feature detection & description in ms
+    static AvgFloat detect1TimesMS;     //!< Averaged time for video feature detection subpart 1 in ms
+    static AvgFloat detect2TimesMS;     //!< Averaged time for video feature detection subpart 2 in ms
+    static AvgFloat matchTimesMS;       //!< Averaged time for video feature matching in ms
+    static AvgFloat optFlowTimesMS;     //!< Averaged time for video feature optical flow tracking in ms
+    static AvgFloat poseTimesMS;        //!< Averaged time for video feature pose estimation in ms
+    static AvgFloat detectSavedTimesMS; //!< Averaged detection time saved by ROI detection in ms
 
 protected:
-    bool         _isVisible;     //!< Flag if marker is visible
-    bool         _drawDetection; //!< Flag if detection should be drawn into image
-    CVMatx44f    _objectViewMat; //!< view transformation matrix
-    HighResTimer _timer;         //!< High resolution timer
+    void setTimeMS(CVTrackedTiming timing, float ms);
+
+    bool         _isVisible;         //!< Flag if marker is visible
+    bool         _drawDetection;     //!< Flag if detection should be drawn into image
+    CVMatx44f    _objectViewMat;     //!< view transformation matrix
+    HighResTimer _timer;             //!< High resolution timer
+    string       _name;              //!< Optional name for statistics output
+    AvgFloat     _timesMS[TT_count]; //!< Averaged timings of this tracker in ms
+    std::mutex   _timesMutex;        //!< Protects _timesMS against reads from other threads
+
+private:
+    static std::mutex _staticTimesMutex; //!< Serializes the updates of the static averages
 };
 //-----------------------------------------------------------------------------
 #endif
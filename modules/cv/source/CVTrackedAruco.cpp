@@ -18,6 +18,7 @@ for a good top down information.
 #include <CVTrackedAruco.h>
 #include <Utils.h>
 #include <Profiler.h>
+#include <algorithm>
 
 //-----------------------------------------------------------------------------
 CVTrackedAruco::CVTrackedAruco(int arucoID, string calibIniPath)
@@ -31,6 +32,12 @@ CVTrackedAruco::CVTrackedAruco(int arucoID, string calibIniPath)
                        "CVTrackedAruco::track: Failed to load Aruco parameters.",
                        __LINE__,
                        __FILE__);
+
+#if CV_MAJOR_VERSION < 4 || CV_MINOR_VERSION < 7
+#else
+    _detector.setDictionary(_params.dictionary);
+    _detector.setDetectorParameters(_params.arucoParams);
+#endif
 }
 //-----------------------------------------------------------------------------
 //! Tracks the all Aruco markers in the given image for the first sceneview
@@ -85,39 +92,46 @@ bool CVTrackedAruco::trackAll(CVMat          imageGray,
     // Detect //
     ////////////
 
-    CVMat croppedImageGray = roi.empty() ? imageGray : imageGray(roi);
-
     float startMS = _timer.elapsedTimeInMilliSec();
 
     arucoIDs.clear();
     objectViewMats.clear();
-    CVVVPoint2f corners, rejected;
-
-#if CV_MAJOR_VERSION < 4 || CV_MINOR_VERSION < 7
-    cv::aruco::detectMarkers(croppedImageGray,
-                             _params.dictionary,
-                             corners,
-                             arucoIDs,
-                             _params.arucoParams,
-                             rejected);
-#else
-    cv::aruco::ArucoDetector detector(_params.dictionary, _params.arucoParams);
-    detector.detectMarkers(croppedImageGray,
-                           corners,
-                           arucoIDs,
-                           rejected);
-#endif
+    CVVVPoint2f corners;
+    CVRect      fullRect = roi.empty() ? CVRect(0, 0, imageGray.cols, imageGray.rows) : roi;
 
-    for (auto& corner : corners)
+    bool roiSearched = false;
+    if (_roiDetection && !_lastIDs.empty() && _framesSinceFullScan < _fullScanInterval)
     {
-        for (auto& j : corner)
+        for (const CVRect& rect : predictROIs(fullRect))
+            detect(imageGray, rect, corners, arucoIDs);
+
+        // Fall back to a full scan in the same frame if a marker got lost
+        roiSearched = arucoIDs.size() >= _lastIDs.size();
+        if (!roiSearched)
         {
-            j.x += (float)roi.x;
-            j.y += (float)roi.y;
+            corners.clear();
+            arucoIDs.clear();
         }
     }
 
-    CVTracked::detectTimesMS.set(_timer.elapsedTimeInMilliSec() - startMS);
+    if (roiSearched)
+        _framesSinceFullScan++;
+    else
+    {
+        float fullStartMS = _timer.elapsedTimeInMilliSec();
+        detect(imageGray, fullRect, corners, arucoIDs);
+        float fullMS = _timer.elapsedTimeInMilliSec() - fullStartMS;
+
+        _fullScanMS          = _fullScanMS > 0.0f ? 0.9f * _fullScanMS + 0.1f * fullMS : fullMS;
+        _framesSinceFullScan = 0;
+    }
+
+    updateLastDetection(corners);
+
+    float detectMS = _timer.elapsedTimeInMilliSec() - startMS;
+    setTimeMS(TT_detect, detectMS);
+    if (_roiDetection)
+        setTimeMS(TT_detectSaved, std::max(0.0f, _fullScanMS - detectMS));
 
     if (!arucoIDs.empty())
     {
@@ -142,7 +156,7 @@ bool CVTrackedAruco::trackAll(CVMat          imageGray,
                                              rVecs,
                                              tVecs);
 
-        CVTracked::poseTimesMS.set(_timer.elapsedTimeInMilliSec() - startMS);
+        setTimeMS(TT_pose, _timer.elapsedTimeInMilliSec() - startMS);
 
         // Get the object view matrix for all aruco markers
         for (size_t i = 0; i < arucoIDs.size(); ++i)
@@ -168,6 +182,126 @@ bool CVTrackedAruco::trackAll(CVMat          imageGray,
     return true;
 }
 //-----------------------------------------------------------------------------
+/*! Detects the markers within rect of imageGray and appends their corners in
+ full image coordinates. Markers already found in an overlapping region are
+ skipped.
+*/
+void CVTrackedAruco::detect(CVMat         imageGray,
+                            const CVRect& rect,
+                            CVVVPoint2f&  corners,
+                            vector<int>&  ids)
+{
+    CVMat       croppedImageGray = imageGray(rect);
+    CVVVPoint2f rectCorners, rejected;
+    vector<int> rectIDs;
+
+#if CV_MAJOR_VERSION < 4 || CV_MINOR_VERSION < 7
+    cv::aruco::detectMarkers(croppedImageGray,
+                             _params.dictionary,
+                             rectCorners,
+                             rectIDs,
+                             _params.arucoParams,
+                             rejected);
+#else
+    _detector.detectMarkers(croppedImageGray,
+                            rectCorners,
+                            rectIDs,
+                            rejected);
+#endif
+
+    for (size_t i = 0; i < rectIDs.size(); ++i)
+    {
+        if (std::find(ids.begin(), ids.end(), rectIDs[i]) != ids.end())
+            continue;
+
+        for (auto& corner : rectCorners[i])
+        {
+            corner.x += (float)rect.x;
+            corner.y += (float)rect.y;
+        }
+
+        ids.push_back(rectIDs[i]);
+        corners.push_back(rectCorners[i]);
+    }
+}
+//-----------------------------------------------------------------------------
+/*! Returns the regions where the markers of the last frame are expected. The
+ bounding box of every marker is moved by its last motion and expanded by
+ _roiMargin times its size plus the motion. Overlapping regions are merged so
+ that no image area is searched twice. All regions are clipped to roi.
+*/
+CVVRect CVTrackedAruco::predictROIs(const CVRect& roi)
+{
+    CVVRect rois;
+
+    for (size_t i = 0; i < _lastRects.size(); ++i)
+    {
+        const CVRect&    r      = _lastRects[i];
+        const CVPoint2f& motion = _lastMotion[i];
+
+        int marginX = (int)(_roiMargin * (float)std::max(r.width, r.height) + std::abs(motion.x));
+        int marginY = (int)(_roiMargin * (float)std::max(r.width, r.height) + std::abs(motion.y));
+
+        CVRect predicted((int)((float)r.x + motion.x) - marginX,
+                         (int)((float)r.y + motion.y) - marginY,
+                         r.width + 2 * marginX,
+                         r.height + 2 * marginY);
+        predicted &= roi;
+        if (predicted.empty())
+            continue;
+
+        // Merge with all overlapping regions until no overlap is left
+        bool merged = true;
+        while (merged)
+        {
+            merged = false;
+            for (auto it = rois.begin(); it != rois.end(); ++it)
+            {
+                if ((predicted & *it).area() > 0)
+                {
+                    predicted |= *it;
+                    rois.erase(it);
+                    merged = true;
+                    break;
+                }
+            }
+        }
+
+        rois.push_back(predicted);
+    }
+
+    return rois;
+}
+//-----------------------------------------------------------------------------
+//! Stores the bounding boxes and the center motion of the detected markers
+void CVTrackedAruco::updateLastDetection(const CVVVPoint2f& corners)
+{
+    CVVRect    rects;
+    CVVPoint2f motion;
+
+    for (size_t i = 0; i < arucoIDs.size(); ++i)
+    {
+        CVRect    rect = cv::boundingRect(corners[i]);
+        CVPoint2f delta(0.0f, 0.0f);
+
+        auto last = std::find(_lastIDs.begin(), _lastIDs.end(), arucoIDs[i]);
+        if (last != _lastIDs.end())
+        {
+            // The center motion is the mean motion of the box corners
+            const CVRect& lastRect = _lastRects[last - _lastIDs.begin()];
+            delta.x                = 0.5f * (float)((rect.x + rect.br().x) - (lastRect.x + lastRect.br().x));
+            delta.y                = 0.5f * (float)((rect.y + rect.br().y) - (lastRect.y + lastRect.br().y));
+        }
+
+        rects.push_back(rect);
+        motion.push_back(delta);
+    }
+
+    _lastIDs    = arucoIDs;
+    _lastRects  = rects;
+    _lastMotion = motion;
+}
+//-----------------------------------------------------------------------------
 /*! CVTrackedAruco::drawArucoMarkerBoard draws and saves an aruco board
 into an image.
 @param dictionaryId integer id of the dictionary
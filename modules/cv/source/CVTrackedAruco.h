@@ -126,14 +126,29 @@ The aruco marker used in the SLProject are printed in a PDF stored in the
 data/Calibration folder. They use the dictionary 0 and where generated with the
 functions CVTrackedAruco::drawArucoMarkerBoard and
 CVTrackedAruco::drawArucoMarker.
+The detector is created once and reused for all frames. With roiDetection
+enabled, the markers of the last frame are searched only in their predicted
+regions. The regions are the last bounding boxes moved by the last motion and
+expanded by roiMargin times their size. A full frame scan is done every
+fullScanInterval frames to find new markers and whenever a marker gets lost.
+The detection time saved against the average full scan time is reported in
+CVTracked::detectSavedTimesMS.
 */
 class CVTrackedAruco : public CVTracked
 {
 public:
     explicit CVTrackedAruco(int arucoID, string calibIniPath);
 
+    // Setters
+    void roiDetection(bool roiDetection) { _roiDetection = roiDetection; }
+    void fullScanInterval(int numFrames) { _fullScanInterval = numFrames; }
+    void roiMargin(float margin) { _roiMargin = margin; }
+
     // Getters
     const CVArucoParams& params() const { return _params; }
+    bool                 roiDetection() const { return _roiDetection; }
+    int                  fullScanInterval() const { return _fullScanInterval; }
+    float                roiMargin() const { return _roiMargin; }
 
     bool track(CVMat          imageGray,
                CVMat          imageBgr,
@@ -165,9 +180,30 @@ protected:
     CVVMatx44f  objectViewMats; //!< object view matrices for all found markers
 
 private:
+    void    detect(CVMat         imageGray,
+                   const CVRect& rect,
+                   CVVVPoint2f&  corners,
+                   vector<int>&  ids);
+    CVVRect predictROIs(const CVRect& roi);
+    void    updateLastDetection(const CVVVPoint2f& corners);
+
     CVArucoParams _params;  //!< Aruco parameters
     int           _arucoID; //!< Aruco Marker ID for this node
     string        _calibIniPath;
+
+#if CV_MAJOR_VERSION < 4 || CV_MINOR_VERSION < 7
+#else
+    cv::aruco::ArucoDetector _detector; //!< Detector reused for all frames
+#endif
+
+    bool        _roiDetection        = false; //!< Flag if markers are searched in predicted regions
+    int         _fullScanInterval    = 10;    //!< No. of frames between forced full frame scans
+    float       _roiMargin           = 0.5f;  //!< Region expansion relative to the marker size
+    int         _framesSinceFullScan = 0;     //!< No. of frames since the last full frame scan
+    float       _fullScanMS          = 0.0f;  //!< Smoothed time of a full frame scan
+    vector<int> _lastIDs;                     //!< Marker IDs of the last detection
+    CVVRect     _lastRects;                   //!< Bounding boxes of the last detection
+    CVVPoint2f  _lastMotion;                  //!< Motion of the marker centers in the last frame
 };
 //-----------------------------------------------------------------------------
 #endif // CVTrackedAruco_H
\ No newline at end of file
@@ -102,7 +102,7 @@ bool CVTrackedChessboard::track(CVMat          imageGray,
                                            corners2D,
                                            flags);
 
-    CVTracked::detectTimesMS.set(_timer.elapsedTimeInMilliSec() - startMS);
+    setTimeMS(TT_detect, _timer.elapsedTimeInMilliSec() - startMS);
 
     if (_isVisible)
     {
@@ -128,7 +128,7 @@ bool CVTrackedChessboard::track(CVMat          imageGray,
                            _solved,
                            cv::SOLVEPNP_ITERATIVE);
 
-        CVTracked::poseTimesMS.set(_timer.elapsedTimeInMilliSec() - startMS);
+        setTimeMS(TT_pose, _timer.elapsedTimeInMilliSec() - startMS);
 
         if (_solved)
         {
@@ -90,6 +90,11 @@ the OpenCV face module using the facemarkLBF detector. More information about
 OpenCV facial landmark detection can be found on:
 https://www.learnopencv.com/facemark-facial-landmark-detection-using-opencv
 \n
+The cascade detection only runs every _detectInterval frames. In between the
+face boxes are predicted from the last landmarks (see predictFaces). If the
+landmarks can't be fitted into the predicted boxes, the faces are detected
+again in the same frame.
+\n
 The pose estimation is done using cv::solvePnP with 9 facial landmarks in 3D
 and their corresponding 2D points detected by the cv::facemark detector. For
 smoothing out the jittering we average the last few detections.
@@ -111,39 +116,63 @@ bool CVTrackedFaces::track(CVMat          imageGray,
     // Detect Faces //
     //////////////////
 
-    float startMS = _timer.elapsedTimeInMilliSec();
+    float startMS   = _timer.elapsedTimeInMilliSec();
+    float detect1MS = 0.0f;
 
-    // Detect faces
+    // Detect the faces or predict them from the last landmarks
     CVVRect faces;
-    int     min = (int)((float)imageGray.rows * 0.4f); // the bigger min the faster
-    int     max = (int)((float)imageGray.rows * 0.8f); // the smaller max the faster
-    CVSize  minSize(min, min);
-    CVSize  maxSize(max, max);
-    _faceDetector->detectMultiScale(imageGray,
-                                    faces,
-                                    1.05,
-                                    3,
-                                    0,
-                                    minSize,
-                                    maxSize);
-
-    // Enlarge the face rect at the bottom to cover also the chin
-    for (auto& face : faces)
-        face.height = (int)(face.height * 1.2f);
+    bool    detected = _lastLandmarkRects.empty() ||
+                    _framesSinceDetection >= _detectInterval;
+    if (detected)
+        detectFaces(imageGray, faces);
+    else
+        faces = predictFaces(imageGray.size());
 
     float time2MS = _timer.elapsedTimeInMilliSec();
-    CVTracked::detect1TimesMS.set(time2MS - startMS);
+    detect1MS += time2MS - startMS;
 
     //////////////////////
     // Detect Landmarks //
     //////////////////////
 
     CVVVPoint2f lm;
-    bool        foundLandmarks = _facemark->fit(imageBgr, faces, lm);
+    bool        foundLandmarks = !faces.empty() && _facemark->fit(imageBgr, faces, lm);
+    bool        tracked        = foundLandmarks && updateLastFaces(lm, faces, detected);
+
+    // Fall back to a detection in the same frame if a predicted face got lost
+    if (!tracked && !detected)
+    {
+        float redetectMS = _timer.elapsedTimeInMilliSec();
+        detected         = true;
+        faces.clear();
+        lm.clear();
+        detectFaces(imageGray, faces);
+        detect1MS += _timer.elapsedTimeInMilliSec() - redetectMS;
+
+        foundLandmarks = !faces.empty() && _facemark->fit(imageBgr, faces, lm);
+        tracked        = foundLandmarks && updateLastFaces(lm, faces, true);
+    }
+
+    if (!tracked)
+    {
+        _lastLandmarkRects.clear();
+        _lastMotion.clear();
+        foundLandmarks = false;
+    }
+
+    if (detected)
+    {
+        _detectMS             = _detectMS > 0.0f ? 0.9f * _detectMS + 0.1f * detect1MS : detect1MS;
+        _framesSinceDetection = 0;
+    }
+    else
+        _framesSinceDetection++;
 
     float time3MS = _timer.elapsedTimeInMilliSec();
-    CVTracked::detect2TimesMS.set(time3MS - time2MS);
-    CVTracked::detectTimesMS.set(time3MS - startMS);
+    setTimeMS(TT_detect1, detect1MS);
+    setTimeMS(TT_detect2, time3MS - startMS - detect1MS);
+    setTimeMS(TT_detect, time3MS - startMS);
+    setTimeMS(TT_detectSaved, std::max(0.0f, _detectMS - detect1MS));
 
     if (foundLandmarks)
     {
@@ -218,7 +247,7 @@ bool CVTrackedFaces::track(CVMat          imageGray,
                                        false,
                                        cv::SOLVEPNP_EPNP);
 
-                CVTracked::poseTimesMS.set(_timer.elapsedTimeInMilliSec() - startMS);
+                setTimeMS(TT_pose, _timer.elapsedTimeInMilliSec() - startMS);
 
                 if (solved)
                 {
@@ -232,6 +261,134 @@ bool CVTrackedFaces::track(CVMat          imageGray,
     return false;
 }
 //-----------------------------------------------------------------------------
+//! Detects the faces with the cascade classifier on a downscaled image
+void CVTrackedFaces::detectFaces(const CVMat& imageGray, CVVRect& faces)
+{
+    PROFILE_FUNCTION();
+
+    CVMat detectImage = imageGray;
+    if (_detectScale < 1.0f)
+        cv::resize(imageGray,
+                   detectImage,
+                   CVSize(),
+                   _detectScale,
+                   _detectScale,
+                   cv::INTER_LINEAR);
+
+    int    min = (int)((float)detectImage.rows * 0.4f); // the bigger min the faster
+    int    max = (int)((float)detectImage.rows * 0.8f); // the smaller max the faster
+    CVSize minSize(min, min);
+    CVSize maxSize(max, max);
+    _faceDetector->detectMultiScale(detectImage,
+                                    faces,
+                                    1.05,
+                                    3,
+                                    0,
+                                    minSize,
+                                    maxSize);
+
+    // Scale the face rects back and enlarge them at the bottom to cover also the chin
+    float invScale = 1.0f / _detectScale;
+    for (auto& face : faces)
+    {
+        face.x      = (int)((float)face.x * invScale);
+        face.y      = (int)((float)face.y * invScale);
+        face.width  = (int)((float)face.width * invScale);
+        face.height = (int)((float)face.height * invScale * 1.2f);
+    }
+}
+//-----------------------------------------------------------------------------
+/*! Predicts the face boxes for the current frame. The landmark boxes of the
+last frame are moved by their last motion and converted to face boxes with the
+relation between face and landmark box of the last detection.
+*/
+CVVRect CVTrackedFaces::predictFaces(const CVSize& imageSize)
+{
+    CVVRect faces;
+    CVRect  imageRect(0, 0, imageSize.width, imageSize.height);
+
+    for (size_t i = 0; i < _lastLandmarkRects.size(); ++i)
+    {
+        const CVRect&    r      = _lastLandmarkRects[i];
+        const CVPoint2f& motion = _lastMotion[i];
+        const CVVec4f&   rel    = _faceFromLandmarks[i];
+
+        CVRect face((int)((float)r.x + motion.x + rel[0] * (float)r.width),
+                    (int)((float)r.y + motion.y + rel[1] * (float)r.height),
+                    (int)(rel[2] * (float)r.width),
+                    (int)(rel[3] * (float)r.height));
+
+        if ((face & imageRect).empty())
+            continue;
+
+        faces.push_back(face);
+    }
+
+    return faces;
+}
+//-----------------------------------------------------------------------------
+/*! Stores the bounding boxes of the landmarks and their motion for the
+prediction in the next frame. After a detection the relation between the
+face box and the landmark box is stored. After a prediction the landmarks are
+rejected if a face got lost or its landmark box changed its size by more than
+a factor of two, which indicates a wrong fit.
+*/
+bool CVTrackedFaces::updateLastFaces(const CVVVPoint2f& landmarks,
+                                     const CVVRect&     faces,
+                                     bool               detected)
+{
+    CVVRect rects;
+    for (const auto& points : landmarks)
+        rects.push_back(cv::boundingRect(points));
+
+    if (rects.empty() || rects.size() != faces.size())
+        return false;
+
+    bool sameFaces = rects.size() == _lastLandmarkRects.size();
+
+    if (!detected)
+    {
+        if (!sameFaces)
+            return false;
+
+        for (size_t i = 0; i < rects.size(); ++i)
+        {
+            float ratio = (float)rects[i].area() /
+                          (float)std::max(1, _lastLandmarkRects[i].area());
+            if (ratio < 0.5f || ratio > 2.0f)
+                return false;
+        }
+    }
+    else
+    {
+        _faceFromLandmarks.resize(rects.size());
+        for (size_t i = 0; i < rects.size(); ++i)
+        {
+            const CVRect& r       = rects[i];
+            const CVRect& face    = faces[i];
+            _faceFromLandmarks[i] = CVVec4f((float)(face.x - r.x) / (float)std::max(1, r.width),
+                                            (float)(face.y - r.y) / (float)std::max(1, r.height),
+                                            (float)face.width / (float)std::max(1, r.width),
+                                            (float)face.height / (float)std::max(1, r.height));
+        }
+    }
+
+    _lastMotion.assign(rects.size(), CVPoint2f(0, 0));
+    if (sameFaces)
+    {
+        for (size_t i = 0; i < rects.size(); ++i)
+        {
+            const CVRect& r    = rects[i];
+            const CVRect& last = _lastLandmarkRects[i];
+            _lastMotion[i]     = CVPoint2f((float)(r.x - last.x) + 0.5f * (float)(r.width - last.width),
+                                       (float)(r.y - last.y) + 0.5f * (float)(r.height - last.height));
+        }
+    }
+
+    _lastLandmarkRects = rects;
+    return true;
+}
+//-----------------------------------------------------------------------------
 /*!
  Returns the Delaunay triangulation on the points within the image
  @param imageBgr OpenCV BGR image
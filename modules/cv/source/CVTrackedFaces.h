@@ -30,6 +30,13 @@ typedef Utils::Averaged<CVVec2f> AvgCVVec2f;
 OpenCV face detection algorithm from Viola-Jones to find all faces in the image
 and the facial landmark detector provided in cv::facemark. For more details
 see the comments in CVTrackedFaces::track method.
+The cascade detection is the most expensive step. It runs only every
+detectInterval frames on an image downscaled by detectScale. In the frames
+between, the face boxes are predicted from the landmarks of the last frame
+moved by their last motion. If the landmark fit fails or the landmarks jump
+in size, the detection is repeated in the same frame. The detection time
+saved against the average detection time is reported in
+CVTracked::detectSavedTimesMS.
 */
 class CVTrackedFaces : public CVTracked
 {
@@ -47,7 +54,21 @@ public:
                                     const CVVPoint2f& points,
                                     bool              drawDetection);
 
+    // Setters
+    void detectInterval(int numFrames) { _detectInterval = std::max(1, numFrames); }
+    void detectScale(float scale) { _detectScale = std::min(1.0f, std::max(0.1f, scale)); }
+
+    // Getters
+    int   detectInterval() const { return _detectInterval; }
+    float detectScale() const { return _detectScale; }
+
 private:
+    void    detectFaces(const CVMat& imageGray, CVVRect& faces);
+    CVVRect predictFaces(const CVSize& imageSize);
+    bool    updateLastFaces(const CVVVPoint2f& landmarks,
+                            const CVVRect&     faces,
+                            bool               detected);
+
     CVCascadeClassifier* _faceDetector;    //!< Viola-Jones face detector
     cv::Ptr<CVFacemark>  _facemark;        //!< Facial landmarks detector smart pointer
     vector<AvgCVVec2f>   _avgPosePoints2D; //!< vector of averaged facial landmark 2D points
@@ -55,6 +76,14 @@ private:
     CVVPoint2f           _cvPosePoints2D;  //!< vector of OpenCV point2D
     CVVPoint3f           _cvPosePoints3D;  //!< vector of OpenCV point2D
     int                  _smoothLength;    //!< Smoothing filter lenght
+
+    int             _detectInterval       = 10;   //!< No. of frames between forced face detections
+    float           _detectScale          = 0.5f; //!< Image scale for the face detection
+    int             _framesSinceDetection = 0;    //!< No. of frames since the last face detection
+    float           _detectMS             = 0.0f; //!< Smoothed time of a face detection
+    CVVRect         _lastLandmarkRects;           //!< Bounding boxes of the last landmarks
+    CVVPoint2f      _lastMotion;                  //!< Motion of the landmark boxes in the last frame
+    vector<CVVec4f> _faceFromLandmarks;           //!< Per face: face box relative to the landmark box (x, y, w, h)
 };
 //-----------------------------------------------------------------------------
 #endif // CVTrackedFaces_H
\ No newline at end of file
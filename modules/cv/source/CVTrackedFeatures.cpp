@@ -71,6 +71,8 @@ CVTrackedFeatures::CVTrackedFeatures(string markerFilename)
 //! Show statistics if program terminates
 CVTrackedFeatures::~CVTrackedFeatures()
 {
+    waitForAsyncRelocation();
+
 #if DO_FEATURE_BENCHMARKING
     Utils::log("");
     Utils::log("");
@@ -199,6 +201,7 @@ void CVTrackedFeatures::initFeaturesOnMarker()
 //! Setter of the feature detector & descriptor type
 void CVTrackedFeatures::type(CVDetectDescribeType ddType)
 {
+    waitForAsyncRelocation();
     _featureManager.createDetectorDescriptor(ddType);
 
     _currentFrame.foundPose         = false;
@@ -223,27 +226,50 @@ bool CVTrackedFeatures::track(CVMat          imageGray,
     assert(!calib->cameraMat().empty() && "Calibration is empty");
     assert(!_marker.imageGray.empty());
 
+    // The calibration may be a per frame copy (see CVTrackingScheduler)
+    _calib = calib;
+
     // Initialize reference points if program just started
     if (_frameCount == 0)
-    {
-        _calib = calib;
         initFeaturesOnMarker();
-    }
 
     // Copy image matrix into current frame data
     _currentFrame.image     = image;
     _currentFrame.imageGray = imageGray;
 
+    bool asyncRelocation = _asyncRelocation && !_forceRelocation;
+    if (asyncRelocation)
+        collectAsyncRelocation();
+    else
+        waitForAsyncRelocation();
+
     // Determine if relocation or feature tracking should be performed
     bool relocationNeeded = _forceRelocation ||
                             !_prevFrame.foundPose ||
                             _prevFrame.inlierMatches.size() < 100 ||
                             frames_since_posefound < 3;
 
-    // If relocation condition meets, calculate the Pose with feature detection, otherwise
-    // track the previous determined features
-    if (relocationNeeded)
+    if (asyncRelocation)
+    {
+        // The relocation runs in the background, optical flow tracking
+        // continues as long as there is a previous pose to track from.
+        if (relocationNeeded)
+            startAsyncRelocation();
+
+        if (_prevFrame.foundPose)
+            tracking();
+        else
+        {
+            _isTracking             = false;
+            _currentFrame.foundPose = false;
+        }
+    }
+    else if (relocationNeeded)
+    {
+        // If relocation condition meets, calculate the Pose with feature detection, otherwise
+        // track the previous determined features
         relocate();
+    }
     else
         tracking();
 
@@ -273,12 +299,104 @@ bool CVTrackedFeatures::track(CVMat          imageGray,
 void CVTrackedFeatures::relocate()
 {
     _isTracking = false;
-    detectKeypointsAndDescriptors();
-    _currentFrame.matches   = getFeatureMatches();
-    _currentFrame.foundPose = calculatePose();
+
+    SLRelocTimes times;
+    relocate(_currentFrame, _calib, times);
+    setRelocTimes(times);
 
     // Zero time keeping on the tracking branch
-    CVTracked::optFlowTimesMS.set(0);
+    setTimeMS(TT_optFlow, 0);
+}
+//-----------------------------------------------------------------------------
+/*! Runs the relocation steps on the passed frame data. The function only
+reads the marker, the feature manager and the matcher, so it can run on a
+worker thread on its own frame data (see startAsyncRelocation).
+*/
+void CVTrackedFeatures::relocate(SLFrameData&   frame,
+                                 CVCalibration* calib,
+                                 SLRelocTimes&  times)
+{
+    HighResTimer timer;
+
+    detectKeypointsAndDescriptors(frame);
+    times.detectMS = timer.elapsedTimeInMilliSec();
+
+    frame.matches = getFeatureMatches(frame);
+    refineKeypoints(frame);
+    times.matchMS = timer.elapsedTimeInMilliSec() - times.detectMS;
+
+    frame.foundPose = calculatePose(frame, calib);
+    times.poseMS    = timer.elapsedTimeInMilliSec() - times.detectMS - times.matchMS;
+}
+//-----------------------------------------------------------------------------
+void CVTrackedFeatures::setRelocTimes(const SLRelocTimes& times)
+{
+    setTimeMS(TT_detect, times.detectMS);
+    setTimeMS(TT_match, times.matchMS);
+    setTimeMS(TT_pose, times.poseMS);
+}
+//-----------------------------------------------------------------------------
+/*! Starts a relocation on a copy of the current frame on a worker thread if
+none is running. Tracking with optical flow continues in the meantime.
+*/
+void CVTrackedFeatures::startAsyncRelocation()
+{
+    if (_relocFuture.valid())
+        return;
+
+    _relocFrame                   = SLFrameData();
+    _relocFrame.imageGray         = _currentFrame.imageGray.clone();
+    _relocFrame.rvec              = CVMat::zeros(3, 1, CV_64FC1);
+    _relocFrame.tvec              = CVMat::zeros(3, 1, CV_64FC1);
+    _relocFrame.foundPose         = false;
+    _relocFrame.reprojectionError = 0.0f;
+    _relocFrame.useExtrinsicGuess = false;
+
+    CVCalibration calib = *_calib;
+    _relocFuture        = std::async(std::launch::async,
+                                     [this, calib]() mutable
+                                     {
+                                         relocate(_relocFrame, &calib, _relocTimes);
+                                     });
+}
+//-----------------------------------------------------------------------------
+/*! Takes over the result of a finished asynchronous relocation. If a pose was
+found, the relocation frame becomes the previous frame, so the optical flow of
+the current frame continues from the freshly matched inliers.
+@return True if a relocation result was taken over
+*/
+bool CVTrackedFeatures::collectAsyncRelocation()
+{
+    if (!_relocFuture.valid() ||
+        _relocFuture.wait_for(std::chrono::seconds(0)) != std::future_status::ready)
+        return false;
+
+    _relocFuture.get();
+    setRelocTimes(_relocTimes);
+
+    if (!_relocFrame.foundPose)
+        return false;
+
+    _prevFrame.imageGray         = _relocFrame.imageGray;
+    _prevFrame.rvec              = _relocFrame.rvec;
+    _prevFrame.tvec              = _relocFrame.tvec;
+    _prevFrame.foundPose         = true;
+    _prevFrame.inlierMatches     = _relocFrame.inlierMatches;
+    _prevFrame.inlierPoints2D    = _relocFrame.inlierPoints2D;
+    _prevFrame.inlierPoints3D    = _relocFrame.inlierPoints3D;
+    _prevFrame.reprojectionError = _relocFrame.reprojectionError;
+    _prevPyramid.clear();
+
+    _currentFrame.rvec = _prevFrame.rvec.clone();
+    _currentFrame.tvec = _prevFrame.tvec.clone();
+    return true;
+}
+//-----------------------------------------------------------------------------
+//! Waits for a running asynchronous relocation and discards its result
+void CVTrackedFeatures::waitForAsyncRelocation()
+{
+    if (_relocFuture.valid())
+        _relocFuture.get();
 }
 
 //-----------------------------------------------------------------------------
@@ -290,9 +408,12 @@ void CVTrackedFeatures::tracking()
     _isTracking             = true;
     _currentFrame.foundPose = trackWithOptFlow(_prevFrame.rvec, _prevFrame.tvec);
 
-    // Zero time keeping on the relocation branch
-    CVTracked::detectTimesMS.set(0);
-    CVTracked::matchTimesMS.set(0);
+    // Zero time keeping on the relocation branch if it is not running in the background
+    if (!_relocFuture.valid())
+    {
+        setTimeMS(TT_detect, 0);
+        setTimeMS(TT_match, 0);
+    }
 }
 
 //-----------------------------------------------------------------------------
@@ -443,6 +564,13 @@ TODO: more elegant way to do this whole copy action
 */
 void CVTrackedFeatures::transferFrameData()
 {
+    // The pyramid of the current frame becomes the one of the previous frame.
+    // The swap keeps the allocated levels for the next buildOpticalFlowPyramid.
+    std::swap(_prevPyramid, _currPyramid);
+    if (!_currPyramidValid)
+        _prevPyramid.clear();
+    _currPyramidValid = false;
+
     _currentFrame.imageGray.copyTo(_prevFrame.imageGray);
     _currentFrame.image.copyTo(_prevFrame.image);
     _currentFrame.rvec.copyTo(_prevFrame.rvec);
@@ -482,15 +610,63 @@ since we have to build the scaling pyramide only once. If we detect and
 describe seperatly, it will lead in two scaling pyramids and is therefore less
 meaningful.
 */
-void CVTrackedFeatures::detectKeypointsAndDescriptors()
+void CVTrackedFeatures::detectKeypointsAndDescriptors(SLFrameData& frame)
 {
-    float startMS = _timer.elapsedTimeInMilliSec();
-
-    _featureManager.detectAndDescribe(_currentFrame.imageGray,
-                                      _currentFrame.keypoints,
-                                      _currentFrame.descriptors);
+    if (_detectScale >= 1.0f)
+    {
+        _featureManager.detectAndDescribe(frame.imageGray,
+                                          frame.keypoints,
+                                          frame.descriptors);
+        return;
+    }
 
-    CVTracked::detectTimesMS.set(_timer.elapsedTimeInMilliSec() - startMS);
+    // Coarse detection on the downscaled image. The keypoints are scaled back
+    // to full resolution and the matched ones get refined in refineKeypoints.
+    CVMat scaledGray;
+    cv::resize(frame.imageGray,
+               scaledGray,
+               CVSize(),
+               _detectScale,
+               _detectScale,
+               cv::INTER_AREA);
+
+    _featureManager.detectAndDescribe(scaledGray,
+                                      frame.keypoints,
+                                      frame.descriptors);
+
+    float toFull = 1.0f / _detectScale;
+    for (auto& keypoint : frame.keypoints)
+    {
+        keypoint.pt *= toFull;
+        keypoint.size *= toFull;
+    }
+}
+//-----------------------------------------------------------------------------
+/*! Refines the matched keypoints of a downscaled detection at full resolution.
+The keypoints are only accurate to about one pixel of the downscaled image.
+cornerSubPix moves them to the corner position in the full resolution image
+within a window of the size of one downscaled pixel.
+*/
+void CVTrackedFeatures::refineKeypoints(SLFrameData& frame)
+{
+    if (_detectScale >= 1.0f || frame.matches.empty())
+        return;
+
+    CVVPoint2f points(frame.matches.size());
+    for (size_t i = 0; i < frame.matches.size(); i++)
+        points[i] = frame.keypoints[(uint)frame.matches[i].queryIdx].pt;
+
+    int halfWin = std::max(2, (int)std::ceil(1.0f / _detectScale));
+    cv::cornerSubPix(frame.imageGray,
+                     points,
+                     CVSize(halfWin, halfWin),
+                     CVSize(-1, -1),
+                     cv::TermCriteria(cv::TermCriteria::COUNT | cv::TermCriteria::EPS,
+                                      10,
+                                      0.01));
+
+    for (size_t i = 0; i < frame.matches.size(); i++)
+        frame.keypoints[(uint)frame.matches[i].queryIdx].pt = points[i];
 }
 //-----------------------------------------------------------------------------
 /*! Get matching features with the defined feature matcher. Since we are using
@@ -498,13 +674,11 @@ the k-next-neighbour matcher, we check if the best and second best match are
 not too identical with the so called ratio test.
 @return Vector of found matches
 */
-CVVDMatch CVTrackedFeatures::getFeatureMatches()
+CVVDMatch CVTrackedFeatures::getFeatureMatches(SLFrameData& frame)
 {
-    float startMS = _timer.elapsedTimeInMilliSec();
-
     int        k = 2;
     CVVVDMatch matches;
-    _matcher->knnMatch(_currentFrame.descriptors, _marker.descriptors, matches, k);
+    _matcher->knnMatch(frame.descriptors, _marker.descriptors, matches, k);
 
     // Perform ratio test which determines if k matches from the knn matcher
     // are not too similar. If the ratio of the the distance of the two
@@ -519,7 +693,6 @@ CVVDMatch CVTrackedFeatures::getFeatureMatches()
             goodMatches.push_back(match1);
     }
 
-    CVTracked::matchTimesMS.set(_timer.elapsedTimeInMilliSec() - startMS);
     return goodMatches;
 }
 //-----------------------------------------------------------------------------
@@ -565,12 +738,10 @@ respect to world coordinates.
 
 @return True if the pose was found.
  */
-bool CVTrackedFeatures::calculatePose()
+bool CVTrackedFeatures::calculatePose(SLFrameData& frame, CVCalibration* calib)
 {
     // solvePnP crashes if less than 5 points are given
-    if (_currentFrame.matches.size() < 10) return false;
-
-    float startMS = _timer.elapsedTimeInMilliSec();
+    if (frame.matches.size() < 10) return false;
 
     // Find 2D/3D correspondences
     // At the moment we are using only the two correspondences like this:
@@ -578,16 +749,16 @@ bool CVTrackedFeatures::calculatePose()
     // Train index --> "CVPoint" in the model
     // Query index --> "CVPoint" in the actual frame
 
-    if (_currentFrame.matches.size() < 10)
+    if (frame.matches.size() < 10)
         return false;
 
-    CVVPoint3f modelPoints(_currentFrame.matches.size());
-    CVVPoint2f framePoints(_currentFrame.matches.size());
+    CVVPoint3f modelPoints(frame.matches.size());
+    CVVPoint2f framePoints(frame.matches.size());
 
-    for (size_t i = 0; i < _currentFrame.matches.size(); i++)
+    for (size_t i = 0; i < frame.matches.size(); i++)
     {
-        modelPoints[i] = _marker.keypoints3D[(uint)_currentFrame.matches[i].trainIdx];
-        framePoints[i] = _currentFrame.keypoints[(uint)_currentFrame.matches[i].queryIdx].pt;
+        modelPoints[i] = _marker.keypoints3D[(uint)frame.matches[i].trainIdx];
+        framePoints[i] = frame.keypoints[(uint)frame.matches[i].queryIdx].pt;
     }
 
     vector<uchar> inliersMask(modelPoints.size());
@@ -598,11 +769,11 @@ bool CVTrackedFeatures::calculatePose()
 
     bool foundPose = cv::solvePnPRansac(modelPoints,
                                         framePoints,
-                                        _calib->cameraMat(),
-                                        _calib->distortion(),
-                                        _currentFrame.rvec,
-                                        _currentFrame.tvec,
-                                        _currentFrame.useExtrinsicGuess,
+                                        calib->cameraMat(),
+                                        calib->distortion(),
+                                        frame.rvec,
+                                        frame.tvec,
+                                        frame.useExtrinsicGuess,
                                         iterations,
                                         reprojection_error,
                                         confidence,
@@ -612,47 +783,45 @@ bool CVTrackedFeatures::calculatePose()
     // Get matches with help of inlier indices
     for (size_t idx : inliersMask)
     {
-        _currentFrame.inlierMatches.push_back(_currentFrame.matches[idx]);
-        _currentFrame.inlierPoints2D.push_back(framePoints[idx]);
-        _currentFrame.inlierPoints3D.push_back(modelPoints[idx]);
+        frame.inlierMatches.push_back(frame.matches[idx]);
+        frame.inlierPoints2D.push_back(framePoints[idx]);
+        frame.inlierPoints3D.push_back(modelPoints[idx]);
     }
 
     // Pose optimization
     if (foundPose)
     {
-        // float matchesBefore = (float)_currentFrame.inlierMatches.size();
+        // float matchesBefore = (float)frame.inlierMatches.size();
 
         /////////////////////
         // 2. Optimze Matches
         /////////////////////
 
-        optimizeMatches();
+        optimizeMatches(frame, calib);
 
         ///////////////////////
         // 3. solvePnP Iterativ
         ///////////////////////
 
-        foundPose = cv::solvePnP(_currentFrame.inlierPoints3D,
-                                 _currentFrame.inlierPoints2D,
-                                 _calib->cameraMat(),
-                                 _calib->distortion(),
-                                 _currentFrame.rvec,
-                                 _currentFrame.tvec,
+        foundPose = cv::solvePnP(frame.inlierPoints3D,
+                                 frame.inlierPoints2D,
+                                 calib->cameraMat(),
+                                 calib->distortion(),
+                                 frame.rvec,
+                                 frame.tvec,
                                  true,
                                  cv::SOLVEPNP_ITERATIVE);
 
 #if DO_FEATURE_BENCHMARKING
-        sum_matches += _currentFrame.matches.size();
-        sum_inlier_matches += _currentFrame.inlierMatches.size();
-        sum_allmatches_to_inliers += _currentFrame.inlierMatches.size() /
-                                     _currentFrame.matches.size();
-        sum_poseopt_difference += _currentFrame.inlierMatches.size() /
+        sum_matches += frame.matches.size();
+        sum_inlier_matches += frame.inlierMatches.size();
+        sum_allmatches_to_inliers += frame.inlierMatches.size() /
+                                     frame.matches.size();
+        sum_poseopt_difference += frame.inlierMatches.size() /
                                   matchesBefore;
 #endif
     }
 
-    CVTracked::poseTimesMS.set(_timer.elapsedTimeInMilliSec() - startMS);
-
     return foundPose;
 }
 //-----------------------------------------------------------------------------
@@ -661,7 +830,7 @@ points to our current frame. Within a predefined patch, we try to rematch not
 matched features with the reprojected point. If not possible, we increase the
 patch size until we found a match for the point or we reach a threshold.
 */
-void CVTrackedFeatures::optimizeMatches()
+void CVTrackedFeatures::optimizeMatches(SLFrameData& frame, CVCalibration* calib)
 {
 #if DO_FEATURE_BENCHMARKING
     float reprojectionError = 0;
@@ -670,10 +839,10 @@ void CVTrackedFeatures::optimizeMatches()
     // 1. Reproject the model points with the calculated POSE
     CVVPoint2f projectedPoints(_marker.keypoints3D.size());
     cv::projectPoints(_marker.keypoints3D,
-                      _currentFrame.rvec,
-                      _currentFrame.tvec,
-                      _calib->cameraMat(),
-                      _calib->distortion(),
+                      frame.rvec,
+                      frame.tvec,
+                      calib->cameraMat(),
+                      calib->distortion(),
                       projectedPoints);
 
     CVVKeyPoint    bboxFrameKeypoints;
@@ -689,9 +858,9 @@ void CVTrackedFeatures::optimizeMatches()
         int alreadyMatched = 0;
         // todo: this is bad, because for every marker keypoint we have to iterate all inlierMatches!
         // better: iterate inlierMatches once at the beginning and mark all marker keypoints as inliers or not!
-        for (size_t j = 0; j < _currentFrame.inlierMatches.size(); j++)
+        for (size_t j = 0; j < frame.inlierMatches.size(); j++)
         {
-            if (_currentFrame.inlierMatches[(uint)j].trainIdx == (int)i)
+            if (frame.inlierMatches[(uint)j].trainIdx == (int)i)
                 alreadyMatched++;
         }
 
@@ -720,14 +889,14 @@ void CVTrackedFeatures::optimizeMatches()
             int xDownRight = xTopLeft + patchSize;
             int yDownRight = yTopLeft + patchSize;
 
-            for (size_t j = 0; j < _currentFrame.keypoints.size(); j++)
+            for (size_t j = 0; j < frame.keypoints.size(); j++)
             { // bbox check
-                if (_currentFrame.keypoints[j].pt.x > xTopLeft &&
-                    _currentFrame.keypoints[j].pt.x < xDownRight &&
-                    _currentFrame.keypoints[j].pt.y > yTopLeft &&
-                    _currentFrame.keypoints[j].pt.y < yDownRight)
+                if (frame.keypoints[j].pt.x > xTopLeft &&
+                    frame.keypoints[j].pt.x < xDownRight &&
+                    frame.keypoints[j].pt.y > yTopLeft &&
+                    frame.keypoints[j].pt.y < yDownRight)
                 {
-                    bboxFrameKeypoints.push_back(_currentFrame.keypoints[j]);
+                    bboxFrameKeypoints.push_back(frame.keypoints[j]);
                     frameIndicesInsideRect.push_back(j);
                 }
             }
@@ -743,7 +912,7 @@ void CVTrackedFeatures::optimizeMatches()
             // inside the rectangle around the projected map point
             CVMat bboxPointsDescriptors;
             for (size_t j : frameIndicesInsideRect)
-                bboxPointsDescriptors.push_back(_currentFrame.descriptors.row((int)j));
+                bboxPointsDescriptors.push_back(frame.descriptors.row((int)j));
 
             // 4. Match the frame key points inside the rectangle with the projected model point
             _matcher->match(bboxPointsDescriptors, modelPointDescriptor, newMatches);
@@ -766,11 +935,11 @@ void CVTrackedFeatures::optimizeMatches()
                     bestNewMatch = newMatch;
 
             // 6. Only add the best new match to matches vector
-            _currentFrame.inlierMatches.push_back(bestNewMatch);
+            frame.inlierMatches.push_back(bestNewMatch);
         }
 
         // Get the keypoint which was used for pose estimation
-        CVPoint2f keypointForPose = _currentFrame.keypoints[(uint)_currentFrame.inlierMatches.back().queryIdx].pt;
+        CVPoint2f keypointForPose = frame.keypoints[(uint)frame.inlierMatches.back().queryIdx].pt;
 
 #if DO_FEATURE_BENCHMARKING
         reprojectionError += (float)norm(CVMat(projectedModelPoint),
@@ -779,7 +948,7 @@ void CVTrackedFeatures::optimizeMatches()
 
 #if DRAW_PATCHES
         // draw green rectangle around every map point
-        rectangle(_currentFrame.image,
+        rectangle(frame.image,
                   Point2f(projectedModelPoint.x - (float)patchSize / 2.0f,
                           projectedModelPoint.y - (float)patchSize / 2.0f),
                   Point2f(projectedModelPoint.x + (float)patchSize / 2.0f,
@@ -788,7 +957,7 @@ void CVTrackedFeatures::optimizeMatches()
 
         // draw key points, that lie inside this rectangle
         for (const auto& kPt : bboxFrameKeypoints)
-            circle(_currentFrame.image,
+            circle(frame.image,
                    kPt.pt,
                    1,
                    CV_RGB(0, 0, 255),
@@ -806,16 +975,16 @@ void CVTrackedFeatures::optimizeMatches()
     if (_prevFrame.foundPose)
     {
         Rodrigues(_prevFrame.rvec, prevRmat);
-        Rodrigues(_currentFrame.rvec, currRmat);
+        Rodrigues(frame.rvec, currRmat);
         double rotationError_rad = acos((trace(prevRmat * currRmat).val[0] - 1.0) / 2.0);
         rotationError += rotationError_rad * 180 / 3.14;
-        translationError += cv::norm(_prevFrame.tvec, _currentFrame.tvec);
+        translationError += cv::norm(_prevFrame.tvec, frame.tvec);
     }
 #endif
 
 #if DRAW_REPROJECTION_POINTS
     // Draw the projection error for the current frame
-    putText(_currentFrame.image,
+    putText(frame.image,
             "Reprojection error: " + to_string(reprojectionError / _marker.keypoints3D.size()),
             Point2f(20, 20),
             FONT_HERSHEY_SIMPLEX,
@@ -825,17 +994,35 @@ void CVTrackedFeatures::optimizeMatches()
 #endif
 
     // Optimize POSE
-    vector<cv::Point3f> modelPoints = vector<cv::Point3f>(_currentFrame.inlierMatches.size());
-    vector<cv::Point2f> framePoints = vector<cv::Point2f>(_currentFrame.inlierMatches.size());
-    for (size_t i = 0; i < _currentFrame.inlierMatches.size(); i++)
+    vector<cv::Point3f> modelPoints = vector<cv::Point3f>(frame.inlierMatches.size());
+    vector<cv::Point2f> framePoints = vector<cv::Point2f>(frame.inlierMatches.size());
+    for (size_t i = 0; i < frame.inlierMatches.size(); i++)
     {
-        modelPoints[i] = _marker.keypoints3D[(uint)_currentFrame.inlierMatches[i].trainIdx];
-        framePoints[i] = _currentFrame.keypoints[(uint)_currentFrame.inlierMatches[i].queryIdx].pt;
+        modelPoints[i] = _marker.keypoints3D[(uint)frame.inlierMatches[i].trainIdx];
+        framePoints[i] = frame.keypoints[(uint)frame.inlierMatches[i].queryIdx].pt;
     }
 
     if (modelPoints.empty()) return;
-    _currentFrame.inlierPoints3D = modelPoints;
-    _currentFrame.inlierPoints2D = framePoints;
+    frame.inlierPoints3D = modelPoints;
+    frame.inlierPoints2D = framePoints;
+}
+//-----------------------------------------------------------------------------
+/*! Builds the optical flow pyramid with 3 levels for calcOpticalFlowPyrLK.
+The input image is always copied so that the pyramid stays valid if the
+caller reuses the frame buffer.
+*/
+void CVTrackedFeatures::buildPyramid(const CVMat& imageGray,
+                                     CVVMat&      pyramid,
+                                     CVSize       winSize)
+{
+    cv::buildOpticalFlowPyramid(imageGray,
+                                pyramid,
+                                winSize,
+                                3,
+                                true,
+                                cv::BORDER_REFLECT_101,
+                                cv::BORDER_CONSTANT,
+                                false);
 }
 //-----------------------------------------------------------------------------
 /*! Tracks the features with Optical Flow (Lucas Kanade). This will only try to
@@ -864,10 +1051,17 @@ bool CVTrackedFeatures::trackWithOptFlow(CVMat rvec, CVMat tvec)
     // Find closest possible feature points based on optical flow
     CVVPoint2f pred2DPoints(_prevFrame.inlierPoints2D.size());
 
+    // The pyramid of the previous frame is cached from the last call and
+    // only has to be built after a relocation
+    if (_prevPyramid.empty())
+        buildPyramid(_prevFrame.imageGray, _prevPyramid, winSize);
+    buildPyramid(_currentFrame.imageGray, _currPyramid, winSize);
+    _currPyramidValid = true;
+
     // todo: do not relate optical flow to previous frame! better to original marker image, otherwise we will drift
     cv::calcOpticalFlowPyrLK(
-      _prevFrame.imageGray,      // Previous frame
-      _currentFrame.imageGray,   // Current frame
+      _prevPyramid,              // Previous frame pyramid
+      _currPyramid,              // Current frame pyramid
       _prevFrame.inlierPoints2D, // Previous and current keypoints coordinates.The latter will be
       pred2DPoints,              // expanded if more good coordinates are detected during OptFlow
       status,                    // Output vector for keypoint correspondences (1 = match found)
@@ -892,7 +1086,7 @@ bool CVTrackedFeatures::trackWithOptFlow(CVMat rvec, CVMat tvec)
         }
     }
 
-    CVTracked::optFlowTimesMS.set(_timer.elapsedTimeInMilliSec() - startMS);
+    setTimeMS(TT_optFlow, _timer.elapsedTimeInMilliSec() - startMS);
 
     _currentFrame.inlierPoints2D = frame2DPoints;
     _currentFrame.inlierPoints3D = model3DPoints;
@@ -941,7 +1135,7 @@ bool CVTrackedFeatures::trackWithOptFlow(CVMat rvec, CVMat tvec)
         tvec.copyTo(_currentFrame.tvec);
     }
 
-    CVTracked::poseTimesMS.set(_timer.elapsedTimeInMilliSec() - startMS);
+    setTimeMS(TT_pose, _timer.elapsedTimeInMilliSec() - startMS);
 
     return foundPose && poseValid;
 }
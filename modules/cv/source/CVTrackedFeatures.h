@@ -22,6 +22,7 @@ for a good top down information.
 #include <CVFeatureManager.h>
 #include <CVRaulMurOrb.h>
 #include <CVTracked.h>
+#include <future>
 
 #define SL_SPLIT_DETECT_COMPUTE 0
 #define SL_DO_FEATURE_BENCHMARKING 0
@@ -62,6 +63,10 @@ frame with against a reference. There are two important parts of this procedure:
 The relocalisation, which will be called if we have to find the pose with no hint
 where the camera could be. The other one is called feature tracking: If a pose
 was found, the implementation tries to track them and update the pose respectively.
+With detectScale < 1 the relocation detects the features on a downscaled image
+and refines the matched keypoints at full resolution. The optical flow pyramid
+of a frame is kept for the next frame. With asyncRelocation the relocation runs
+on a worker thread while optical flow tracking continues on the new frames.
 */
 class CVTrackedFeatures : public CVTracked
 {
@@ -74,23 +79,44 @@ public:
     // Getters
     bool                 forceRelocation() { return _forceRelocation; }
     CVDetectDescribeType type() { return _featureManager.type(); }
+    float                detectScale() { return _detectScale; }
+    bool                 asyncRelocation() { return _asyncRelocation; }
 
     // Setters
     void forceRelocation(bool fR) { _forceRelocation = fR; }
     void type(CVDetectDescribeType ddType);
+    void detectScale(float scale) { _detectScale = std::min(std::max(scale, 0.1f), 1.0f); }
+    void asyncRelocation(bool async) { _asyncRelocation = async; }
 
 private:
+    struct SLFrameData;
+
+    //! Timings of one relocation in ms
+    struct SLRelocTimes
+    {
+        float detectMS = 0.0f;
+        float matchMS  = 0.0f;
+        float poseMS   = 0.0f;
+    };
+
     void      loadMarker(string markerFilename);
     void      initFeaturesOnMarker();
     void      relocate();
+    void      relocate(SLFrameData& frame, CVCalibration* calib, SLRelocTimes& times);
+    void      setRelocTimes(const SLRelocTimes& times);
+    void      startAsyncRelocation();
+    bool      collectAsyncRelocation();
+    void      waitForAsyncRelocation();
     void      tracking();
     void      drawDebugInformation(bool drawDetection);
     void      transferFrameData();
-    void      detectKeypointsAndDescriptors();
-    CVVDMatch getFeatureMatches();
-    bool      calculatePose();
-    void      optimizeMatches();
+    void      detectKeypointsAndDescriptors(SLFrameData& frame);
+    void      refineKeypoints(SLFrameData& frame);
+    CVVDMatch getFeatureMatches(SLFrameData& frame);
+    bool      calculatePose(SLFrameData& frame, CVCalibration* calib);
+    void      optimizeMatches(SLFrameData& frame, CVCalibration* calib);
     bool      trackWithOptFlow(CVMat rvec, CVMat tvec);
+    void      buildPyramid(const CVMat& imageGray, CVVMat& pyramid, CVSize winSize);
 
     cv::Ptr<cv::DescriptorMatcher> _matcher;    //!< Descriptor matching algorithm
     CVCalibration*                 _calib;      //!< Current calibration in use
@@ -130,6 +156,15 @@ private:
     SLFrameData       _prevFrame;       //!< The previous video frame data
     bool              _forceRelocation; //!< Force relocation every frame (no opt. flow tracking)
     CVFeatureManager  _featureManager;  //!< Feature detector-descriptor wrapper instance
+
+    float             _detectScale      = 1.0f;  //!< Image scale for the relocation detection (1 = full resolution)
+    CVVMat            _prevPyramid;              //!< Cached optical flow pyramid of the previous frame
+    CVVMat            _currPyramid;              //!< Optical flow pyramid of the current frame
+    bool              _currPyramidValid = false; //!< Flag if _currPyramid was built for the current frame
+    bool              _asyncRelocation  = false; //!< Flag if the relocation runs on a worker thread
+    std::future<void> _relocFuture;              //!< Future of the running asynchronous relocation
+    SLFrameData       _relocFrame;               //!< Frame data of the asynchronous relocation
+    SLRelocTimes      _relocTimes;               //!< Timings of the asynchronous relocation
 };
 //-----------------------------------------------------------------------------
 #endif // CVTrackedFeatures_H
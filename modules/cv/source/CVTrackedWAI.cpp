@@ -86,6 +86,8 @@ bool CVTrackedWAI::track(CVMat          imageGray,
         params.retainImg           = false;
         params.serial              = false;
         params.trackOptFlow        = false;
+        params.frameQueueSize      = 1;
+        params.dropOldestFrame     = true; // live video: keep the latency low
 
         _waiSlamer = new WAISlam(calib->cameraMat(),
                                  calib->distortion(),
@@ -121,8 +123,8 @@ bool CVTrackedWAI::track(CVMat          imageGray,
 
     // TODO(dgj1): at the moment we cant differentiate between these two
     // as they are both done in the same call to WAI
-    CVTracked::detectTimesMS.set(_timer.elapsedTimeInMilliSec() - startMS);
-    CVTracked::poseTimesMS.set(_timer.elapsedTimeInMilliSec() - startMS);
+    setTimeMS(TT_detect, _timer.elapsedTimeInMilliSec() - startMS);
+    setTimeMS(TT_pose, _timer.elapsedTimeInMilliSec() - startMS);
 
     return result;
 }
@@ -0,0 +1,281 @@
+/**
+ * \file      CVTrackingScheduler.cpp
+ * \date      October 2026
+ * \remarks   Please use clangformat to format the code. See more code style on
+ *            https://github.com/cpvrlab/SLProject4/wiki/SLProject-Coding-Style
+ * \copyright http://opensource.org/licenses/GPL-3.0
+*/
+
+#include <CVTrackingScheduler.h>
+#include <Utils.h>
+#include <Profiler.h>
+
+//-----------------------------------------------------------------------------
+/*! The number of worker threads defaults to the number of hardware threads
+ minus one for the main thread. Without thread support (emscripten) all
+ trackers are run on the calling thread.
+*/
+CVTrackingScheduler::CVTrackingScheduler(int numThreads)
+  : _frameCounter(0)
+{
+#ifdef __EMSCRIPTEN__
+    _numThreads = 0;
+#else
+    if (numThreads < 0)
+        _numThreads = std::max(1, (int)Utils::maxThreads() - 1);
+    else
+        _numThreads = numThreads;
+#endif
+}
+//-----------------------------------------------------------------------------
+CVTrackingScheduler::~CVTrackingScheduler()
+{
+    {
+        std::lock_guard<std::mutex> lock(_mutex);
+        _stop = true;
+    }
+    _jobCV.notify_all();
+
+    for (auto& thread : _threads)
+        thread.join();
+}
+//-----------------------------------------------------------------------------
+//! Starts the worker threads on first use so that idle apps have no threads
+void CVTrackingScheduler::startThreads()
+{
+    if (!_threads.empty() || _numThreads == 0)
+        return;
+
+    for (int i = 0; i < _numThreads; ++i)
+        _threads.emplace_back(&CVTrackingScheduler::workerLoop, this);
+}
+//-----------------------------------------------------------------------------
+void CVTrackingScheduler::addTracker(CVTracked* tracker)
+{
+    assert(tracker && "CVTrackingScheduler::addTracker: tracker is null");
+
+    std::lock_guard<std::mutex> lock(_mutex);
+    if (findEntry(tracker))
+        return;
+
+    Entry entry;
+    entry.tracker = tracker;
+    _entries.push_back(entry);
+}
+//-----------------------------------------------------------------------------
+/*! Removes the tracker after its running or queued job has finished. Pending
+ results of the tracker are discarded. After the call the tracker can be
+ deleted safely.
+*/
+void CVTrackingScheduler::removeTracker(CVTracked* tracker)
+{
+    std::unique_lock<std::mutex> lock(_mutex);
+    _idleCV.wait(lock, [&] {
+        Entry* entry = findEntry(tracker);
+        return !entry || !entry->busy;
+    });
+
+    for (auto it = _entries.begin(); it != _entries.end(); ++it)
+    {
+        if (it->tracker == tracker)
+        {
+            _entries.erase(it);
+            break;
+        }
+    }
+
+    for (auto it = _results.begin(); it != _results.end();)
+    {
+        if (it->tracker == tracker)
+            it = _results.erase(it);
+        else
+            ++it;
+    }
+}
+//-----------------------------------------------------------------------------
+//! Removes all trackers after their jobs have finished
+void CVTrackingScheduler::clear()
+{
+    std::unique_lock<std::mutex> lock(_mutex);
+    _idleCV.wait(lock, [&] { return !anyBusy(); });
+    _entries.clear();
+    _results.clear();
+}
+//-----------------------------------------------------------------------------
+bool CVTrackingScheduler::contains(CVTracked* tracker)
+{
+    std::lock_guard<std::mutex> lock(_mutex);
+    return findEntry(tracker) != nullptr;
+}
+//-----------------------------------------------------------------------------
+uint64_t CVTrackingScheduler::numFramesSkipped(CVTracked* tracker)
+{
+    std::lock_guard<std::mutex> lock(_mutex);
+    Entry*                      entry = findEntry(tracker);
+    return entry ? entry->numSkipped : 0;
+}
+//-----------------------------------------------------------------------------
+/*! Submits a new frame to all registered trackers and returns its id.
+ Trackers that are idle get a job on the worker pool. Trackers that draw their
+ detection into imageBgr are run on the calling thread before the function
+ returns. The gray image is shared by reference and must not be modified by
+ the caller until the jobs of the frame are finished. CVCapture never writes
+ into a pooled buffer that is still referenced.
+*/
+uint64_t CVTrackingScheduler::submitFrame(CVMat          imageGray,
+                                          CVMat          imageBgr,
+                                          CVCalibration* calib)
+{
+    PROFILE_FUNCTION();
+
+    assert(calib && "CVTrackingScheduler::submitFrame: calib is null");
+
+    vector<CVTracked*> callerTrackers;
+    vector<CVTracked*> poolTrackers;
+    uint64_t           frameID;
+
+    {
+        std::lock_guard<std::mutex> lock(_mutex);
+        frameID = ++_frameCounter;
+
+        for (auto& entry : _entries)
+        {
+            if (_numThreads == 0 || entry.tracker->drawDetection())
+                callerTrackers.push_back(entry.tracker);
+            else if (entry.busy)
+                entry.numSkipped++;
+            else
+            {
+                entry.busy = true;
+                poolTrackers.push_back(entry.tracker);
+            }
+        }
+    }
+
+    float submitTimeMS = _clock.elapsedTimeInMilliSec();
+
+    if (!poolTrackers.empty())
+    {
+        auto frame          = std::make_shared<CVTrackingFrame>(*calib);
+        frame->id           = frameID;
+        frame->imageGray    = imageGray;
+        frame->submitTimeMS = submitTimeMS;
+
+        // The caller trackers draw into imageBgr, the pool needs its own copy
+        frame->imageBgr = callerTrackers.empty() ? imageBgr : imageBgr.clone();
+
+        std::lock_guard<std::mutex> lock(_mutex);
+        startThreads();
+        for (auto* tracker : poolTrackers)
+            _jobs.push_back({tracker, frame});
+    }
+    _jobCV.notify_all();
+
+    for (auto* tracker : callerTrackers)
+    {
+        CVTrackingResult result;
+        result.tracker   = tracker;
+        result.frameID   = frameID;
+        result.foundPose = tracker->trackTimed(imageGray, imageBgr, calib);
+        if (result.foundPose)
+            result.objectViewMat = tracker->objectViewMat();
+        result.latencyMS    = tracker->timesMS(TT_track);
+        result.submitTimeMS = submitTimeMS;
+
+        std::lock_guard<std::mutex> lock(_mutex);
+        _results.push_back(result);
+    }
+
+    return frameID;
+}
+//-----------------------------------------------------------------------------
+void CVTrackingScheduler::workerLoop()
+{
+    while (true)
+    {
+        Job job;
+        {
+            std::unique_lock<std::mutex> lock(_mutex);
+            _jobCV.wait(lock, [&] { return _stop || !_jobs.empty(); });
+            if (_stop && _jobs.empty())
+                return;
+
+            job = _jobs.front();
+            _jobs.pop_front();
+        }
+
+        CVTrackingFrame& frame = *job.frame;
+
+        HighResTimer     timer;
+        CVTrackingResult result;
+        result.tracker   = job.tracker;
+        result.frameID   = frame.id;
+        result.foundPose = job.tracker->trackTimed(frame.imageGray,
+                                                   frame.imageBgr,
+                                                   &frame.calib);
+        if (result.foundPose)
+            result.objectViewMat = job.tracker->objectViewMat();
+        result.latencyMS    = timer.elapsedTimeInMilliSec();
+        result.submitTimeMS = frame.submitTimeMS;
+
+        {
+            std::lock_guard<std::mutex> lock(_mutex);
+            _results.push_back(result);
+            Entry* entry = findEntry(job.tracker);
+            if (entry)
+                entry->busy = false;
+        }
+        _idleCV.notify_all();
+    }
+}
+//-----------------------------------------------------------------------------
+//! Blocks until no job is queued or running
+void CVTrackingScheduler::waitIdle()
+{
+    std::unique_lock<std::mutex> lock(_mutex);
+    _idleCV.wait(lock, [&] { return !anyBusy(); });
+}
+//-----------------------------------------------------------------------------
+/*! Returns all results that arrived since the last call in the order of their
+ completion. If a tracker delivered more than one result, the last one is the
+ newest. The frame age is measured up to this call.
+*/
+CVVTrackingResult CVTrackingScheduler::collectResults(bool waitForAll)
+{
+    PROFILE_FUNCTION();
+
+    std::unique_lock<std::mutex> lock(_mutex);
+    if (waitForAll)
+        _idleCV.wait(lock, [&] { return !anyBusy(); });
+
+    CVVTrackingResult results;
+    results.swap(_results);
+    uint64_t lastFrameID = _frameCounter;
+    lock.unlock();
+
+    float nowMS = _clock.elapsedTimeInMilliSec();
+    for (auto& result : results)
+    {
+        result.frameAge   = lastFrameID - result.frameID;
+        result.frameAgeMS = nowMS - result.submitTimeMS;
+    }
+
+    return results;
+}
+//-----------------------------------------------------------------------------
+CVTrackingScheduler::Entry* CVTrackingScheduler::findEntry(CVTracked* tracker)
+{
+    for (auto& entry : _entries)
+        if (entry.tracker == tracker)
+            return &entry;
+    return nullptr;
+}
+//-----------------------------------------------------------------------------
+bool CVTrackingScheduler::anyBusy()
+{
+    for (auto& entry : _entries)
+        if (entry.busy)
+            return true;
+    return false;
+}
+//-----------------------------------------------------------------------------
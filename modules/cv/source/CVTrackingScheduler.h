@@ -0,0 +1,127 @@
+/**
+ * \file      CVTrackingScheduler.h
+ * \date      October 2026
+ * \remarks   Please use clangformat to format the code. See more code style on
+ *            https://github.com/cpvrlab/SLProject4/wiki/SLProject-Coding-Style
+ * \copyright http://opensource.org/licenses/GPL-3.0
+*/
+
+#ifndef CVTRACKINGSCHEDULER_H
+#define CVTRACKINGSCHEDULER_H
+
+#include <atomic>
+#include <condition_variable>
+#include <deque>
+#include <memory>
+#include <mutex>
+#include <thread>
+#include <CVTypedefs.h>
+#include <CVCalibration.h>
+#include <CVTracked.h>
+#include <HighResTimer.h>
+
+//-----------------------------------------------------------------------------
+//! Immutable snapshot of one video frame shared by all trackers of a frame
+/*! The images are shallow copies of the captured frame. Holding them keeps the
+ capture buffers alive, so a pooled buffer of CVCapture is not overwritten
+ while a tracker still reads it. The calibration is copied by value so that a
+ calibration change on the main thread does not affect running trackers.
+*/
+struct CVTrackingFrame
+{
+    explicit CVTrackingFrame(const CVCalibration& calibration) : calib(calibration) {}
+
+    uint64_t      id = 0;            //!< Consecutive frame number (starts at 1)
+    CVMat         imageGray;         //!< Gray image of the frame (read only)
+    CVMat         imageBgr;          //!< Color image of the frame (read only)
+    CVCalibration calib;             //!< Calibration at the time of submission
+    float         submitTimeMS = 0;  //!< Time of submission on the scheduler clock
+};
+//-----------------------------------------------------------------------------
+//! Pose of one tracker for one frame delivered back to the main thread
+struct CVTrackingResult
+{
+    CVTracked* tracker      = nullptr; //!< Tracker that produced the result
+    bool       foundPose    = false;   //!< Flag if the tracker found a pose
+    CVMatx44f  objectViewMat;          //!< Object view matrix if foundPose is true
+    uint64_t   frameID      = 0;       //!< Id of the frame the pose was computed on
+    uint64_t   frameAge     = 0;       //!< No. of frames submitted after the tracked frame
+    float      submitTimeMS = 0.0f;    //!< Time of frame submission on the scheduler clock
+    float      frameAgeMS   = 0.0f;    //!< Time from frame submission to result collection
+    float      latencyMS    = 0.0f;    //!< Duration of the track call
+};
+typedef vector<CVTrackingResult> CVVTrackingResult;
+//-----------------------------------------------------------------------------
+//! CVTrackingScheduler runs independent CVTracked instances on a worker pool
+/*! Every frame is submitted once with submitFrame. Each registered tracker
+ gets a job that runs its track method on the shared, immutable frame. A
+ tracker that is still busy with an older frame skips the new one, so slow
+ trackers (e.g. features or WAI) don't hold back fast ones (e.g. ArUco).
+ Trackers with drawDetection enabled draw into the color image and are
+ therefore run on the calling thread with the caller's image, concurrently to
+ the pool jobs, which then read a private copy of the color image.
+ The results are collected on the main thread with collectResults, where the
+ poses can be applied to the scene nodes. Each result carries the frame id and
+ the age of the frame, so the caller can decide how to handle late poses.
+ With waitForAll the call blocks until all jobs of the last frame are done,
+ which keeps the behavior of a synchronous tracking loop. Trackers only run
+ in parallel if more than one of them is registered or if the caller does
+ other work between submitFrame and collectResults.
+ The latency of each tracker is averaged in CVTracked::timesMS(TT_track).
+*/
+class CVTrackingScheduler
+{
+public:
+    explicit CVTrackingScheduler(int numThreads = -1);
+    ~CVTrackingScheduler();
+
+    void              addTracker(CVTracked* tracker);
+    void              removeTracker(CVTracked* tracker);
+    void              clear();
+    bool              contains(CVTracked* tracker);
+    uint64_t          submitFrame(CVMat          imageGray,
+                                  CVMat          imageBgr,
+                                  CVCalibration* calib);
+    CVVTrackingResult collectResults(bool waitForAll = false);
+    void              waitIdle();
+
+    // Getters
+    int      numThreads() const { return _numThreads; }
+    uint64_t numFramesSubmitted() const { return _frameCounter; }
+    uint64_t numFramesSkipped(CVTracked* tracker);
+
+private:
+    //! Registered tracker with its scheduling state
+    struct Entry
+    {
+        CVTracked* tracker    = nullptr;
+        bool       busy       = false; //!< Flag if a job of this tracker is queued or running
+        uint64_t   numSkipped = 0;     //!< No. of frames skipped because the tracker was busy
+    };
+
+    //! Tracking job of one tracker on one frame
+    struct Job
+    {
+        CVTracked*                       tracker = nullptr;
+        std::shared_ptr<CVTrackingFrame> frame;
+    };
+
+    void   startThreads();
+    void   workerLoop();
+    Entry* findEntry(CVTracked* tracker);
+    bool   anyBusy();
+
+    int                      _numThreads;   //!< No. of worker threads (0 = run all on caller)
+    vector<std::thread>      _threads;      //!< Worker threads (started on first use)
+    vector<Entry>            _entries;      //!< Registered trackers
+    std::deque<Job>          _jobs;         //!< Queued jobs
+    CVVTrackingResult        _results;      //!< Results not yet collected
+    std::mutex               _mutex;        //!< Protects entries, jobs and results
+    std::condition_variable  _jobCV;        //!< Signals new jobs or stop to the workers
+    std::condition_variable  _idleCV;       //!< Signals finished jobs
+    bool                     _stop = false; //!< Flag to stop the worker threads
+    std::atomic<uint64_t>    _frameCounter; //!< No. of submitted frames
+    HighResTimer             _clock;        //!< Clock for frame age measurement
+};
+//-----------------------------------------------------------------------------
+#endif // CVTRACKINGSCHEDULER_H
@@ -0,0 +1,142 @@
+/**
+ * \file      CVUndistortMap.cpp
+ * \date      October 2026
+ * \remarks   Please use clangformat to format the code. See more code style on
+ *            https://github.com/cpvrlab/SLProject4/wiki/SLProject-Coding-Style
+ * \copyright http://opensource.org/licenses/GPL-3.0
+*/
+
+#include <CVUndistortMap.h>
+#include <Profiler.h>
+#include <Utils.h>
+#include <algorithm>
+
+//-----------------------------------------------------------------------------
+/*! Undistorts the crop rectangle of inDistorted and resizes it to targetSize
+ in one remap pass. An empty crop means the full image, an empty targetSize
+ means the size of the crop. If outGray is given it receives the gray version
+ of outBgr. The camera matrices and the distortion are the ones of the input
+ image size. Returns false if the calibration is incomplete.
+*/
+bool CVUndistortMap::apply(const CVMat&  cameraMat,
+                           const CVMat&  distortion,
+                           const CVMat&  cameraMatUndistorted,
+                           const CVMat&  inDistorted,
+                           const CVRect& crop,
+                           const CVSize& targetSize,
+                           CVMat&        outBgr,
+                           CVMat*        outGray)
+{
+    PROFILE_FUNCTION();
+
+    if (inDistorted.empty() ||
+        cameraMat.rows != 3 || cameraMat.cols != 3 ||
+        cameraMatUndistorted.rows != 3 || cameraMatUndistorted.cols != 3)
+        return false;
+
+    CVRect full(0, 0, inDistorted.cols, inDistorted.rows);
+    CVRect roi = crop.area() > 0 ? crop & full : full;
+    if (roi.area() == 0)
+        return false;
+    CVSize outSize = targetSize.area() > 0 ? targetSize : roi.size();
+
+    // FNV-1a over all parameters that define the table
+    int      sizes[] = {inDistorted.cols, inDistorted.rows, roi.x, roi.y, roi.width, roi.height, outSize.width, outSize.height};
+    uint64_t key     = Utils::hashFNV1a(sizes, sizeof(sizes));
+    key              = hashMat(key, cameraMat);
+    key              = hashMat(key, distortion);
+    key              = hashMat(key, cameraMatUndistorted);
+
+    auto it = std::find_if(_entries.begin(),
+                           _entries.end(),
+                           [key](const Entry& e) { return e.key == key; });
+
+    if (it != _entries.end())
+        std::rotate(_entries.begin(), it, it + 1);
+    else
+    {
+        // Apply crop and scale to the camera matrix of the undistorted image
+        // with the pixel center convention of cv::resize
+        Entry  entry;
+        double sx = (double)outSize.width / (double)roi.width;
+        double sy = (double)outSize.height / (double)roi.height;
+        cameraMatUndistorted.convertTo(entry.targetCameraMat, CV_64F);
+
+        CVMat& K = entry.targetCameraMat;
+        K.at<double>(0, 0) *= sx;
+        K.at<double>(0, 1) *= sx;
+        K.at<double>(0, 2) = (K.at<double>(0, 2) - roi.x + 0.5) * sx - 0.5;
+        K.at<double>(1, 1) *= sy;
+        K.at<double>(1, 2) = (K.at<double>(1, 2) - roi.y + 0.5) * sy - 0.5;
+
+        cv::initUndistortRectifyMap(cameraMat,
+                                    distortion,
+                                    CVMat(),
+                                    K,
+                                    outSize,
+                                    CV_16SC2,
+                                    entry.mapXY,
+                                    entry.mapWeights);
+        entry.key = key;
+
+        _entries.insert(_entries.begin(), entry);
+        if (_entries.size() > _maxEntries)
+            _entries.pop_back();
+    }
+
+    const Entry& entry = _entries.front();
+    _targetCameraMat   = entry.targetCameraMat;
+
+    // The output must not share its buffer with the input
+    if (outBgr.data == inDistorted.data)
+        outBgr = CVMat();
+    outBgr.create(outSize, inDistorted.type());
+
+    bool needsGray = outGray && inDistorted.channels() > 1;
+    if (needsGray)
+        outGray->create(outSize, CV_MAKETYPE(inDistorted.depth(), 1));
+    int grayCode = inDistorted.channels() == 4 ? cv::COLOR_BGRA2GRAY : cv::COLOR_BGR2GRAY;
+
+    // Remap and convert in stripes that stay in the cache
+    const int stripeRows = 32;
+    int       numStripes = (outSize.height + stripeRows - 1) / stripeRows;
+    cv::parallel_for_(cv::Range(0, numStripes), [&](const cv::Range& range) {
+        for (int s = range.start; s < range.end; ++s)
+        {
+            int   y0  = s * stripeRows;
+            int   y1  = std::min(outSize.height, y0 + stripeRows);
+            CVMat dst = outBgr.rowRange(y0, y1);
+            cv::remap(inDistorted,
+                      dst,
+                      entry.mapXY.rowRange(y0, y1),
+                      entry.mapWeights.rowRange(y0, y1),
+                      cv::INTER_LINEAR,
+                      cv::BORDER_CONSTANT);
+
+            if (needsGray)
+            {
+                CVMat gray = outGray->rowRange(y0, y1);
+                cv::cvtColor(dst, gray, grayCode);
+            }
+        }
+    });
+
+    if (outGray && !needsGray)
+        *outGray = outBgr;
+
+    return true;
+}
+//-----------------------------------------------------------------------------
+uint64_t CVUndistortMap::hashMat(uint64_t hash, const CVMat& mat)
+{
+    CVMat m = mat.isContinuous() ? mat : mat.clone();
+    hash    = hashInts(hash, {m.rows, m.cols, m.type()});
+
+    return Utils::hashFNV1a(m.data, m.total() * m.elemSize(), hash);
+}
+//-----------------------------------------------------------------------------
+uint64_t CVUndistortMap::hashInts(uint64_t hash, std::initializer_list<int> values)
+{
+    return Utils::hashFNV1a(values.begin(), values.size() * sizeof(int), hash);
+}
+//-----------------------------------------------------------------------------
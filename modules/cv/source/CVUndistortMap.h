@@ -0,0 +1,65 @@
+/**
+ * \file      CVUndistortMap.h
+ * \date      October 2026
+ * \remarks   Please use clangformat to format the code. See more code style on
+ *            https://github.com/cpvrlab/SLProject4/wiki/SLProject-Coding-Style
+ * \copyright http://opensource.org/licenses/GPL-3.0
+*/
+
+#ifndef CVUNDISTORTMAP_H
+#define CVUNDISTORTMAP_H
+
+#include <CVTypedefs.h>
+
+//-----------------------------------------------------------------------------
+//! Cached remap tables for a fused undistort, crop and resize in one pass
+/*! Undistorting an image, cropping it and resizing it for tracking are usually
+ three passes over the image. All three are coordinate mappings, so they can be
+ folded into one remap table: the crop and the scale are applied to the camera
+ matrix of the undistorted image, and cv::initUndistortRectifyMap computes for
+ every target pixel the source position in the distorted input image.
+ The table is stored in the fixed-point format of OpenCV (CV_16SC2 with
+ CV_16UC1 interpolation weights), for which cv::remap uses its SIMD code path.
+ apply writes the color image and optionally the gray image stripe by stripe,
+ so the gray conversion reads the color stripe while it is still in the cache.
+ The tables are cached per key of calibration parameters, input size, crop
+ rectangle and target size. A changed calibration gives a new key, so stale
+ tables are never used and no explicit invalidation is needed. The least
+ recently used table is dropped if more than _maxEntries are cached.
+*/
+class CVUndistortMap
+{
+public:
+    bool apply(const CVMat&  cameraMat,
+               const CVMat&  distortion,
+               const CVMat&  cameraMatUndistorted,
+               const CVMat&  inDistorted,
+               const CVRect& crop,
+               const CVSize& targetSize,
+               CVMat&        outBgr,
+               CVMat*        outGray = nullptr);
+    void clear() { _entries.clear(); }
+
+    //! Camera matrix of the output image of the last apply call
+    const CVMat& targetCameraMat() const { return _targetCameraMat; }
+
+private:
+    //! One cached remap table
+    struct Entry
+    {
+        uint64_t key = 0;
+        CVMat    mapXY;           //!< Integer source positions (CV_16SC2)
+        CVMat    mapWeights;      //!< Interpolation table indices (CV_16UC1)
+        CVMat    targetCameraMat; //!< Camera matrix of the output image
+    };
+
+    static uint64_t hashMat(uint64_t hash, const CVMat& mat);
+    static uint64_t hashInts(uint64_t hash, std::initializer_list<int> values);
+
+    vector<Entry> _entries;         //!< Cached tables (front = most recently used)
+    CVMat         _targetCameraMat; //!< Camera matrix of the last output
+
+    static const size_t _maxEntries = 4;
+};
+//-----------------------------------------------------------------------------
+#endif // CVUNDISTORTMAP_H
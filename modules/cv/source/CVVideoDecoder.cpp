@@ -0,0 +1,369 @@
+/**
+ * \file      CVVideoDecoder.cpp
+ * \date      October 2026
+ * \remarks   Please use clangformat to format the code. See more code style on
+ *            https://github.com/cpvrlab/SLProject4/wiki/SLProject-Coding-Style
+ * \copyright http://opensource.org/licenses/GPL-3.0
+*/
+
+#include <CVVideoDecoder.h>
+#include <Utils.h>
+#include <Profiler.h>
+#include <algorithm>
+
+//-----------------------------------------------------------------------------
+CVVideoDecoder::CVVideoDecoder()
+  : _prefetchSize(8),
+    _nextIndex(0),
+    _decodeIndex(0),
+    _seekRequest(-1),
+    _endOfStream(false),
+    _stop(false),
+    _frameCount(0),
+    _fps(0.0f),
+    _numTimesKnown(0),
+    _verifySeek(false),
+    _cacheBytes(0),
+    _cacheMaxBytes(0),
+    _numCacheHits(0),
+    _numDecoderSeeks(0)
+{
+}
+//-----------------------------------------------------------------------------
+CVVideoDecoder::~CVVideoDecoder()
+{
+    close();
+}
+//-----------------------------------------------------------------------------
+/*! Opens the video file and starts the decode thread. prefetchSize is the
+ number of frames decoded ahead. With a cacheSizeMB greater than zero the
+ decoded frames are kept in a LRU cache of this size.
+*/
+bool CVVideoDecoder::open(const string& filename,
+                          int           prefetchSize,
+                          size_t        cacheSizeMB)
+{
+    close();
+
+    if (!_cap.open(filename))
+    {
+        Utils::log("SLProject", "CVVideoDecoder::open: Failed to open video file: %s", filename.c_str());
+        return false;
+    }
+
+    _frameSize  = CVSize2i((int)_cap.get(cv::CAP_PROP_FRAME_WIDTH),
+                          (int)_cap.get(cv::CAP_PROP_FRAME_HEIGHT));
+    _fps        = (float)_cap.get(cv::CAP_PROP_FPS);
+    _frameCount = std::max(0, (int)_cap.get(cv::CAP_PROP_FRAME_COUNT));
+    _frameTimesMS.assign((size_t)_frameCount, -1.0);
+
+    _prefetchSize  = std::max(1, prefetchSize);
+    _cacheMaxBytes = cacheSizeMB * 1024 * 1024;
+
+    _thread = std::thread(&CVVideoDecoder::decodeLoop, this);
+    return true;
+}
+//-----------------------------------------------------------------------------
+//! Stops the decode thread, closes the file and clears queue and cache
+void CVVideoDecoder::close()
+{
+    {
+        std::lock_guard<std::mutex> lock(_mutex);
+        _stop = true;
+    }
+    _decodeCV.notify_all();
+
+    if (_thread.joinable())
+        _thread.join();
+
+    if (_cap.isOpened())
+        _cap.release();
+
+    _queue.clear();
+    _cache.clear();
+    _cacheMap.clear();
+    _frameTimesMS.clear();
+    _numTimesKnown   = 0;
+    _verifySeek      = false;
+    _cacheBytes      = 0;
+    _nextIndex       = 0;
+    _decodeIndex     = 0;
+    _seekRequest     = -1;
+    _endOfStream     = false;
+    _stop            = false;
+    _numCacheHits    = 0;
+    _numDecoderSeeks = 0;
+}
+//-----------------------------------------------------------------------------
+/*! Returns the frame with the index nextFrameIndex and advances the index.
+ Blocks until the frame is decoded. Returns false at the end of the video.
+*/
+bool CVVideoDecoder::read(CVMat& frame)
+{
+    PROFILE_FUNCTION();
+
+    std::unique_lock<std::mutex> lock(_mutex);
+    if (!_thread.joinable())
+        return false;
+
+    int index = _nextIndex;
+
+    if (findInCache(index, frame))
+    {
+        _numCacheHits++;
+    }
+    else
+    {
+        while (true)
+        {
+            // Drop prefetched frames the consumer has jumped over
+            while (!_queue.empty() && _queue.front().first < index)
+                _queue.pop_front();
+
+            if (!_queue.empty() && _queue.front().first == index)
+            {
+                frame = _queue.front().second;
+                _queue.pop_front();
+                addToCache(index, frame);
+                break;
+            }
+
+            if (_seekRequest < 0 && _endOfStream && index >= _decodeIndex)
+                return false;
+
+            requestSeekIfNeeded(index);
+            _decodeCV.notify_one();
+            _frameCV.wait(lock);
+        }
+    }
+
+    _nextIndex = index + 1;
+    lock.unlock();
+    _decodeCV.notify_one();
+    return true;
+}
+//-----------------------------------------------------------------------------
+/*! Sets the index of the next frame returned by read. The decoder is only
+ repositioned if the frame is neither cached, prefetched nor a few frames
+ ahead of the decoder.
+*/
+void CVVideoDecoder::seek(int frameIndex)
+{
+    std::unique_lock<std::mutex> lock(_mutex);
+    if (!_thread.joinable())
+        return;
+
+    _nextIndex = std::max(0, frameIndex);
+    if (_frameCount > 0)
+        _nextIndex = std::min(_nextIndex, _frameCount);
+
+    if (_cacheMap.find(_nextIndex) == _cacheMap.end())
+        requestSeekIfNeeded(_nextIndex);
+
+    lock.unlock();
+    _decodeCV.notify_one();
+}
+//-----------------------------------------------------------------------------
+//! Returns the number of frames (exact after the decoder reached the end once)
+int CVVideoDecoder::frameCount()
+{
+    std::lock_guard<std::mutex> lock(_mutex);
+    return _frameCount;
+}
+//-----------------------------------------------------------------------------
+//! Returns the time stamp of a frame in ms or -1 if it was not decoded yet
+double CVVideoDecoder::frameTimeMS(int frameIndex)
+{
+    std::lock_guard<std::mutex> lock(_mutex);
+    if (frameIndex < 0 || frameIndex >= (int)_frameTimesMS.size())
+        return -1.0;
+    return _frameTimesMS[(size_t)frameIndex];
+}
+//-----------------------------------------------------------------------------
+//! Asks the decode thread to reposition if it can't deliver the frame soon
+void CVVideoDecoder::requestSeekIfNeeded(int frameIndex)
+{
+    if (_seekRequest == frameIndex)
+        return;
+
+    int  decodeIndex = _seekRequest >= 0 ? _seekRequest : _decodeIndex;
+    bool inQueue     = !_queue.empty() &&
+                   _queue.front().first <= frameIndex &&
+                   _queue.back().first >= frameIndex;
+    bool reachable   = decodeIndex <= frameIndex &&
+                     frameIndex - decodeIndex <= _maxDecodeThrough;
+
+    if (inQueue || reachable)
+        return;
+
+    _seekRequest = frameIndex;
+    _queue.clear();
+}
+//-----------------------------------------------------------------------------
+/*! Decodes the frames in order into the prefetch queue as long as there is
+ space. Frames the consumer has already jumped over are only grabbed and not
+ converted. The time stamp of every frame is stored in the frame index.
+*/
+void CVVideoDecoder::decodeLoop()
+{
+    PROFILE_THREAD("CVVideoDecoder");
+
+    while (true)
+    {
+        std::unique_lock<std::mutex> lock(_mutex);
+        _decodeCV.wait(lock, [&] {
+            return _stop ||
+                   _seekRequest >= 0 ||
+                   (!_endOfStream && (int)_queue.size() < _prefetchSize);
+        });
+
+        if (_stop)
+            return;
+
+        if (_seekRequest >= 0)
+        {
+            int frameIndex = _seekRequest;
+            _seekRequest   = -1;
+            _endOfStream   = false;
+            _queue.clear();
+
+            // Frames behind the known time stamps are reached by decoding
+            // forward, if the decoder is already at the end of the known part
+            if (frameIndex >= _numTimesKnown && _decodeIndex == _numTimesKnown)
+                continue;
+
+            // Position on the frame or on the last frame with a known time
+            // stamp. The frames before frameIndex are then only grabbed.
+            int    startIndex = std::min(frameIndex, _numTimesKnown - 1);
+            double startMS    = startIndex > 0 ? _frameTimesMS[(size_t)startIndex] : 0.0;
+            _decodeIndex      = std::max(0, startIndex);
+            _verifySeek       = startIndex > 0;
+            _numDecoderSeeks++;
+            lock.unlock();
+
+            if (startIndex > 0)
+                _cap.set(cv::CAP_PROP_POS_MSEC, startMS);
+            else
+                _cap.set(cv::CAP_PROP_POS_FRAMES, 0);
+            continue;
+        }
+
+        int  index    = _decodeIndex;
+        bool skipOnly = index < _nextIndex;
+        lock.unlock();
+
+        CVMat  frame;
+        bool   decoded = skipOnly ? _cap.grab() : _cap.read(frame);
+        double timeMS  = _cap.get(cv::CAP_PROP_POS_MSEC);
+
+        lock.lock();
+
+        // A seek request arrived while decoding: the frame is outdated
+        if (_seekRequest >= 0)
+            continue;
+
+        // After a time based seek the first frame must have the time stamp of
+        // its index. If the container landed on an earlier known frame, the
+        // index is corrected and decoding continues forward from there.
+        // Otherwise the decoder is rewound to the start, which is always exact.
+        if (_verifySeek)
+        {
+            _verifySeek = false;
+            if (decoded)
+            {
+                int actual = findFrameByTimeMS(timeMS);
+                if (actual != index)
+                {
+                    if (actual >= 0 && actual < index)
+                    {
+                        index    = actual;
+                        skipOnly = actual < _nextIndex;
+                    }
+                    else
+                    {
+                        _decodeIndex = 0;
+                        _numDecoderSeeks++;
+                        lock.unlock();
+                        _cap.set(cv::CAP_PROP_POS_FRAMES, 0);
+                        continue;
+                    }
+                }
+            }
+        }
+
+        if (!decoded)
+        {
+            // The first pass to the end gives the exact number of frames
+            _endOfStream = true;
+            _frameCount  = index;
+            _frameTimesMS.resize((size_t)index, -1.0);
+        }
+        else
+        {
+            if (index >= (int)_frameTimesMS.size())
+                _frameTimesMS.resize((size_t)index + 1, -1.0);
+            _frameTimesMS[(size_t)index] = timeMS;
+            _decodeIndex                 = index + 1;
+            if (index == _numTimesKnown)
+                _numTimesKnown++;
+
+            if (!skipOnly)
+                _queue.emplace_back(index, frame);
+        }
+
+        lock.unlock();
+        _frameCV.notify_all();
+    }
+}
+//-----------------------------------------------------------------------------
+/*! Returns the index of the frame with the time stamp timeMS within half a
+ frame duration or -1. Only the time stamps from the start of the video are
+ searched. They are increasing, so a binary search is used.
+*/
+int CVVideoDecoder::findFrameByTimeMS(double timeMS)
+{
+    double tolMS = _fps > 0.0f ? 500.0 / _fps : 1.0;
+    auto   begin = _frameTimesMS.begin();
+    auto   end   = begin + _numTimesKnown;
+    auto   it    = std::lower_bound(begin, end, timeMS - tolMS);
+
+    if (it == end || *it > timeMS + tolMS)
+        return -1;
+    return (int)(it - begin);
+}
+//-----------------------------------------------------------------------------
+//! Returns a cached frame and marks it as most recently used
+bool CVVideoDecoder::findInCache(int frameIndex, CVMat& frame)
+{
+    auto it = _cacheMap.find(frameIndex);
+    if (it == _cacheMap.end())
+        return false;
+
+    _cache.splice(_cache.begin(), _cache, it->second);
+    frame = it->second->second;
+    return true;
+}
+//-----------------------------------------------------------------------------
+//! Adds a frame to the cache and evicts the least recently used frames
+void CVVideoDecoder::addToCache(int frameIndex, const CVMat& frame)
+{
+    size_t bytes = frame.total() * frame.elemSize();
+    if (_cacheMaxBytes == 0 || bytes > _cacheMaxBytes)
+        return;
+
+    if (_cacheMap.find(frameIndex) != _cacheMap.end())
+        return;
+
+    _cache.emplace_front(frameIndex, frame);
+    _cacheMap[frameIndex] = _cache.begin();
+    _cacheBytes += bytes;
+
+    while (_cacheBytes > _cacheMaxBytes)
+    {
+        CVIndexedFrame& oldest = _cache.back();
+        _cacheBytes -= oldest.second.total() * oldest.second.elemSize();
+        _cacheMap.erase(oldest.first);
+        _cache.pop_back();
+    }
+}
+//-----------------------------------------------------------------------------
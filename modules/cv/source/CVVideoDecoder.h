@@ -0,0 +1,103 @@
+/**
+ * \file      CVVideoDecoder.h
+ * \date      October 2026
+ * \remarks   Please use clangformat to format the code. See more code style on
+ *            https://github.com/cpvrlab/SLProject4/wiki/SLProject-Coding-Style
+ * \copyright http://opensource.org/licenses/GPL-3.0
+*/
+
+#ifndef CVVIDEODECODER_H
+#define CVVIDEODECODER_H
+
+#include <condition_variable>
+#include <deque>
+#include <list>
+#include <mutex>
+#include <thread>
+#include <unordered_map>
+#include <CVTypedefs.h>
+
+//-----------------------------------------------------------------------------
+//! CVVideoDecoder reads a video file on a decode thread ahead of the consumer
+/*! The decode thread reads the frames in order into a bounded prefetch queue,
+ so the consumer only waits if decoding is slower than the consumption.
+ The frames are addressed by their index. The frame index of the file with
+ the time stamp of each frame is built once while decoding and gives the exact
+ number of frames after the first pass (the container value of
+ CAP_PROP_FRAME_COUNT is often only an estimate).
+ Seeking with seek(index) is answered without touching the decoder if the
+ frame is in the cache or in the prefetch queue. Short forward jumps are
+ decoded through, only larger jumps or backward jumps reposition the decoder.
+ The decoder is never positioned by frame number, because many containers
+ seek inaccurately by frames. Frames with a known time stamp are sought by
+ this time stamp, and the first decoded frame is checked against the frame
+ index. Frames behind the known part of the index are reached by decoding
+ forward from the last known frame.
+ Optionally the decoded frames are kept in a LRU cache with a memory budget,
+ so repeatedly replayed segments (e.g. stepping back and forth in an offline
+ evaluation) are not decoded again.
+ The frames returned by read are shared with the cache and must be treated
+ as read only.
+*/
+class CVVideoDecoder
+{
+public:
+    CVVideoDecoder();
+    ~CVVideoDecoder();
+
+    bool open(const string& filename,
+              int           prefetchSize = 8,
+              size_t        cacheSizeMB  = 0);
+    void close();
+    bool read(CVMat& frame);
+    void seek(int frameIndex);
+
+    // Getters
+    bool     isOpened() const { return _thread.joinable(); }
+    int      nextFrameIndex() const { return _nextIndex; }
+    int      frameCount();
+    float    fps() const { return _fps; }
+    CVSize2i frameSize() const { return _frameSize; }
+    double   frameTimeMS(int frameIndex);
+    uint64_t numCacheHits() const { return _numCacheHits; }
+    uint64_t numDecoderSeeks() const { return _numDecoderSeeks; }
+
+private:
+    void decodeLoop();
+    void requestSeekIfNeeded(int frameIndex);
+    bool findInCache(int frameIndex, CVMat& frame);
+    void addToCache(int frameIndex, const CVMat& frame);
+    int  findFrameByTimeMS(double timeMS);
+
+    typedef std::pair<int, CVMat> CVIndexedFrame;
+
+    CVVideoCapture             _cap;             //!< Capture device only used by the decode thread
+    std::thread                _thread;          //!< Decode thread
+    std::mutex                 _mutex;           //!< Protects all members below
+    std::condition_variable    _decodeCV;        //!< Signals space, seeks or stop to the decode thread
+    std::condition_variable    _frameCV;         //!< Signals new frames to the consumer
+    std::deque<CVIndexedFrame> _queue;           //!< Prefetched frames in order
+    int                        _prefetchSize;    //!< Max. no. of prefetched frames
+    int                        _nextIndex;       //!< Index of the next frame returned by read
+    int                        _decodeIndex;     //!< Index of the next frame the decoder reads
+    int                        _seekRequest;     //!< Frame index to seek to or -1
+    bool                       _endOfStream;     //!< Flag if the decoder reached the end
+    bool                       _stop;            //!< Flag to stop the decode thread
+    int                        _frameCount;      //!< Exact no. of frames after the first pass
+    float                      _fps;             //!< Frames per second
+    CVSize2i                   _frameSize;       //!< Frame size in pixels
+    vector<double>             _frameTimesMS;    //!< Frame index: time stamp per frame or -1
+    int                        _numTimesKnown;   //!< No. of frames from the start with a known time stamp
+    bool                       _verifySeek;      //!< Flag if the next decoded frame is checked against its time stamp
+    std::list<CVIndexedFrame>  _cache;           //!< Cached frames in LRU order (front = newest)
+    std::unordered_map<int, std::list<CVIndexedFrame>::iterator>
+                               _cacheMap;        //!< Frame index to cache entry
+    size_t                     _cacheBytes;      //!< Memory used by cached frames
+    size_t                     _cacheMaxBytes;   //!< Memory budget of the cache (0 = no cache)
+    uint64_t                   _numCacheHits;    //!< No. of frames read from the cache
+    uint64_t                   _numDecoderSeeks; //!< No. of decoder repositionings
+
+    static const int _maxDecodeThrough = 16; //!< Max. forward jump that is decoded through
+};
+//-----------------------------------------------------------------------------
+#endif // CVVIDEODECODER_H
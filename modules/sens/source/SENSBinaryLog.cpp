@@ -0,0 +1,188 @@
+#include "SENSBinaryLog.h"
+#include <cstring>
+#include <fstream>
+#include <iomanip>
+
+//-----------------------------------------------------------------------------
+static int64_t toMicroseconds(const SENSTimePt& timePt)
+{
+    return std::chrono::time_point_cast<SENSMicroseconds>(timePt).time_since_epoch().count();
+}
+
+static SENSTimePt fromMicroseconds(int64_t timeUS)
+{
+    return SENSTimePt(SENSMicroseconds(timeUS));
+}
+
+//-----------------------------------------------------------------------------
+void SENSBinaryLog::writeHeader(std::ostream& os, RecordType type)
+{
+    Header header;
+    std::memset(&header, 0, sizeof(Header));
+    std::strncpy(header.magic, "SENSLOG", sizeof(header.magic));
+    header.version    = _version;
+    header.recordType = (uint32_t)type;
+    header.recordSize = type == RecordType::GPS ? sizeof(GpsRecord) : sizeof(OrientationRecord);
+    os.write((const char*)&header, sizeof(Header));
+}
+
+void SENSBinaryLog::writeGps(std::ostream& os, const SENSTimePt& timePt, const SENSGps::Location& loc)
+{
+    GpsRecord record;
+    record.timeUS       = toMicroseconds(timePt);
+    record.latitudeDEG  = loc.latitudeDEG;
+    record.longitudeDEG = loc.longitudeDEG;
+    record.altitudeM    = loc.altitudeM;
+    record.accuracyM    = loc.accuracyM;
+    record.padding      = 0.f;
+    os.write((const char*)&record, sizeof(GpsRecord));
+}
+
+void SENSBinaryLog::writeOrientation(std::ostream& os, const SENSTimePt& timePt, const SENSOrientation::Quat& quat)
+{
+    OrientationRecord record;
+    record.timeUS = toMicroseconds(timePt);
+    record.quatX  = quat.quatX;
+    record.quatY  = quat.quatY;
+    record.quatZ  = quat.quatZ;
+    record.quatW  = quat.quatW;
+    os.write((const char*)&record, sizeof(OrientationRecord));
+}
+
+//-----------------------------------------------------------------------------
+bool SENSBinaryLog::readHeader(std::istream& is, Header& header)
+{
+    if (!is.read((char*)&header, sizeof(Header)))
+        return false;
+
+    if (std::strncmp(header.magic, "SENSLOG", sizeof(header.magic)) != 0)
+    {
+        Utils::log("SENS", "SENSBinaryLog: not a binary sensor log");
+        return false;
+    }
+
+    if (header.version != _version)
+    {
+        Utils::log("SENS", "SENSBinaryLog: unsupported version %d", header.version);
+        return false;
+    }
+
+    return true;
+}
+
+bool SENSBinaryLog::readGps(const std::string&                                     fileName,
+                            std::vector<std::pair<SENSTimePt, SENSGps::Location>>& data)
+{
+    std::ifstream file(fileName, std::ios::binary);
+    Header        header;
+    if (!file.is_open() || !readHeader(file, header))
+        return false;
+
+    if (header.recordType != (uint32_t)RecordType::GPS || header.recordSize != sizeof(GpsRecord))
+    {
+        Utils::log("SENS", "SENSBinaryLog: %s is not a gps log", fileName.c_str());
+        return false;
+    }
+
+    //read all records in one block
+    file.seekg(0, std::ios::end);
+    size_t numRecords = ((size_t)file.tellg() - sizeof(Header)) / sizeof(GpsRecord);
+    file.seekg(sizeof(Header), std::ios::beg);
+
+    std::vector<GpsRecord> records(numRecords);
+    file.read((char*)records.data(), (std::streamsize)(numRecords * sizeof(GpsRecord)));
+
+    data.reserve(data.size() + numRecords);
+    for (const GpsRecord& record : records)
+    {
+        SENSGps::Location loc;
+        loc.latitudeDEG  = record.latitudeDEG;
+        loc.longitudeDEG = record.longitudeDEG;
+        loc.altitudeM    = record.altitudeM;
+        loc.accuracyM    = record.accuracyM;
+        data.push_back(std::make_pair(fromMicroseconds(record.timeUS), loc));
+    }
+
+    return true;
+}
+
+bool SENSBinaryLog::readOrientation(const std::string&                                         fileName,
+                                    std::vector<std::pair<SENSTimePt, SENSOrientation::Quat>>& data)
+{
+    std::ifstream file(fileName, std::ios::binary);
+    Header        header;
+    if (!file.is_open() || !readHeader(file, header))
+        return false;
+
+    if (header.recordType != (uint32_t)RecordType::ORIENTATION || header.recordSize != sizeof(OrientationRecord))
+    {
+        Utils::log("SENS", "SENSBinaryLog: %s is not an orientation log", fileName.c_str());
+        return false;
+    }
+
+    //read all records in one block
+    file.seekg(0, std::ios::end);
+    size_t numRecords = ((size_t)file.tellg() - sizeof(Header)) / sizeof(OrientationRecord);
+    file.seekg(sizeof(Header), std::ios::beg);
+
+    std::vector<OrientationRecord> records(numRecords);
+    file.read((char*)records.data(), (std::streamsize)(numRecords * sizeof(OrientationRecord)));
+
+    data.reserve(data.size() + numRecords);
+    for (const OrientationRecord& record : records)
+    {
+        SENSOrientation::Quat quat(record.quatX, record.quatY, record.quatZ, record.quatW);
+        data.push_back(std::make_pair(fromMicroseconds(record.timeUS), quat));
+    }
+
+    return true;
+}
+
+//-----------------------------------------------------------------------------
+bool SENSBinaryLog::exportToText(const std::string& binFileName, const std::string& textFileName)
+{
+    std::ifstream binFile(binFileName, std::ios::binary);
+    Header        header;
+    if (!binFile.is_open() || !readHeader(binFile, header))
+        return false;
+    binFile.close();
+
+    std::ofstream textFile(textFileName);
+    if (!textFile.is_open())
+        return false;
+
+    if (header.recordType == (uint32_t)RecordType::GPS)
+    {
+        std::vector<std::pair<SENSTimePt, SENSGps::Location>> data;
+        if (!readGps(binFileName, data))
+            return false;
+
+        textFile << std::setprecision(10);
+        for (const auto& value : data)
+            textFile << toMicroseconds(value.first) << " "
+                     << value.second.latitudeDEG << " "
+                     << value.second.longitudeDEG << " "
+                     << value.second.altitudeM << " "
+                     << value.second.accuracyM << "\n";
+    }
+    else if (header.recordType == (uint32_t)RecordType::ORIENTATION)
+    {
+        std::vector<std::pair<SENSTimePt, SENSOrientation::Quat>> data;
+        if (!readOrientation(binFileName, data))
+            return false;
+
+        for (const auto& value : data)
+            textFile << toMicroseconds(value.first) << " "
+                     << value.second.quatX << " "
+                     << value.second.quatY << " "
+                     << value.second.quatZ << " "
+                     << value.second.quatW << "\n";
+    }
+    else
+    {
+        Utils::log("SENS", "SENSBinaryLog: unknown record type %d in %s", header.recordType, binFileName.c_str());
+        return false;
+    }
+
+    return true;
+}
@@ -0,0 +1,84 @@
+#ifndef SENS_BINARYLOG_H
+#define SENS_BINARYLOG_H
+
+#include <cstdint>
+#include <string>
+#include <vector>
+#include <utility>
+#include <iostream>
+
+#include <SENS.h>
+#include <SENSGps.h>
+#include <SENSOrientation.h>
+
+//-----------------------------------------------------------------------------
+/*! SENSBinaryLog
+ Compact binary log format for timestamped gps and orientation values recorded by SENSRecorder.
+ A log file starts with a Header followed by fixed size records of the type given in the header.
+ All values are stored in the native (little endian) byte order of the recording device. Time points
+ are stored as microseconds since the epoch of SENSClock, like in the text logs.
+ A gps record needs 40 bytes instead of about 60 characters in the text log and is written without
+ any number formatting. Use exportToText to convert a binary log to the text format read by older tools.
+ */
+class SENSBinaryLog
+{
+public:
+    enum class RecordType : uint32_t
+    {
+        GPS         = 1,
+        ORIENTATION = 2
+    };
+
+    struct Header
+    {
+        char     magic[8];   //!< "SENSLOG" with terminating zero
+        uint32_t version;    //!< format version (currently 1)
+        uint32_t recordType; //!< RecordType of all records in the file
+        uint32_t recordSize; //!< size of one record in bytes
+        uint32_t reserved;
+    };
+
+    struct GpsRecord
+    {
+        int64_t timeUS;
+        double  latitudeDEG;
+        double  longitudeDEG;
+        double  altitudeM;
+        float   accuracyM;
+        float   padding;
+    };
+
+    struct OrientationRecord
+    {
+        int64_t timeUS;
+        float   quatX;
+        float   quatY;
+        float   quatZ;
+        float   quatW;
+    };
+
+    static void writeHeader(std::ostream& os, RecordType type);
+    static void writeGps(std::ostream& os, const SENSTimePt& timePt, const SENSGps::Location& loc);
+    static void writeOrientation(std::ostream& os, const SENSTimePt& timePt, const SENSOrientation::Quat& quat);
+
+    //!read all records of a binary gps log, returns false if the file could not be opened or has a wrong header
+    static bool readGps(const std::string&                                     fileName,
+                        std::vector<std::pair<SENSTimePt, SENSGps::Location>>& data);
+    //!read all records of a binary orientation log, returns false if the file could not be opened or has a wrong header
+    static bool readOrientation(const std::string&                                         fileName,
+                                std::vector<std::pair<SENSTimePt, SENSOrientation::Quat>>& data);
+
+    //!convert a binary gps or orientation log to the text format of the former text logs
+    static bool exportToText(const std::string& binFileName, const std::string& textFileName);
+
+private:
+    static bool readHeader(std::istream& is, Header& header);
+
+    static constexpr uint32_t _version = 1;
+};
+
+static_assert(sizeof(SENSBinaryLog::Header) == 24, "SENSBinaryLog::Header must be packed");
+static_assert(sizeof(SENSBinaryLog::GpsRecord) == 40, "SENSBinaryLog::GpsRecord must be packed");
+static_assert(sizeof(SENSBinaryLog::OrientationRecord) == 24, "SENSBinaryLog::OrientationRecord must be packed");
+
+#endif
@@ -37,6 +37,9 @@ SENSCalibrationEstimator::SENSCalibrationEstimator(SENSCalibrationEstimatorParam
     _calibDataPath(calibDataPath),
     _exePath(exePath)
 {
+    //keep one core for the ui and the camera thread
+    _maxExtractTasks = std::max(1, (int)Utils::maxThreads() - 1);
+
     if (!loadCalibParams())
     {
         throw SENSCalibrationEstimatorException("Could not load calibration parameter!",
@@ -73,7 +76,11 @@ SENSCalibrationEstimator::SENSCalibrationEstimator(SENSCalibrationEstimatorParam
 //-----------------------------------------------------------------------------
 SENSCalibrationEstimator::~SENSCalibrationEstimator()
 {
-    //wait for the async task to finish
+    //wait for the async tasks to finish
+    for (auto& task : _extractTasks)
+        task.wait();
+    if (_intermediateTask.valid())
+        _intermediateTask.wait();
     if (_calibrationTask.valid())
         _calibrationTask.wait();
 }
@@ -84,7 +91,7 @@ bool SENSCalibrationEstimator::calculate()
     bool calibrationSuccessful = false;
     if (!_calibrationTask.valid())
     {
-        _calibrationTask = std::async(std::launch::async, &SENSCalibrationEstimator::calibrateAsync, this);
+        startCalibration();
     }
     else if (_calibrationTask.wait_for(std::chrono::milliseconds(1)) == std::future_status::ready)
     {
@@ -103,61 +110,234 @@ bool SENSCalibrationEstimator::calculate()
     return calibrationSuccessful;
 }
 //-----------------------------------------------------------------------------
-bool SENSCalibrationEstimator::extractAsync()
+/*! Finds the inner chessboard corners with subpixel precision. Large images
+ are searched at a reduced resolution first and only the found corners are
+ refined in the full resolution image. If the reduced search fails, the full
+ resolution image is searched. Thread safe, used by the extraction tasks and
+ by the batch calibration.
+*/
+bool SENSCalibrationEstimator::extractCorners(const cv::Mat&            imageGray,
+                                              const cv::Size&           boardSize,
+                                              std::vector<cv::Point2f>& corners2D)
+{
+    int  flags = CALIB_CB_ADAPTIVE_THRESH | CALIB_CB_NORMALIZE_IMAGE;
+    bool found = false;
+
+    const int maxSearchWidth = 1280;
+    if (imageGray.cols > maxSearchWidth)
+    {
+        float   scale = (float)imageGray.cols / (float)maxSearchWidth;
+        cv::Mat imageSmall;
+        cv::resize(imageGray, imageSmall, cv::Size(), 1.0 / scale, 1.0 / scale, INTER_AREA);
+        found = cv::findChessboardCorners(imageSmall, boardSize, corners2D, flags);
+        if (found)
+        {
+            for (cv::Point2f& pt : corners2D)
+                pt *= scale;
+        }
+    }
+
+    if (!found)
+        found = cv::findChessboardCorners(imageGray, boardSize, corners2D, flags);
+
+    if (found)
+    {
+        cv::cornerSubPix(imageGray,
+                         corners2D,
+                         cv::Size(11, 11),
+                         cv::Size(-1, -1),
+                         TermCriteria(TermCriteria::EPS + TermCriteria::COUNT,
+                                      30,
+                                      0.0001));
+    }
+    else
+        corners2D.clear();
+
+    return found;
+}
+//-----------------------------------------------------------------------------
+//!Starts the corner extraction of a grabbed frame on a worker thread
+void SENSCalibrationEstimator::startExtraction(const cv::Mat& imageGray)
 {
     if (_imageSize.width == 0 && _imageSize.height == 0)
-        _imageSize = _currentImgToExtract.size();
-    else if (_imageSize.width != _currentImgToExtract.size().width || _imageSize.height != _currentImgToExtract.size().height)
+        _imageSize = imageGray.size();
+    else if (_imageSize != imageGray.size())
     {
-        _hasAsyncError = true;
-        _exception     = SENSCalibrationEstimatorException("Image size changed during capturing process!",
-                                                       __LINE__,
-                                                       __FILE__);
-        return false;
+        _state = State::Error;
+        throw SENSCalibrationEstimatorException("Image size changed during capturing process!",
+                                                __LINE__,
+                                                __FILE__);
     }
 
-    bool foundPrecisely = false;
-    try
+    cv::Size boardSize = _boardSize;
+    _extractTasks.push_back(std::async(std::launch::async,
+                                       [boardSize](cv::Mat image) {
+                                           std::vector<cv::Point2f> corners2D;
+                                           extractCorners(image, boardSize, corners2D);
+                                           return corners2D;
+                                       },
+                                       imageGray.clone()));
+}
+//-----------------------------------------------------------------------------
+/*! Adds the corners of all finished extraction tasks to the image points.
+ The image points are only modified on the calling thread, so the extraction
+ tasks need no synchronisation.
+*/
+void SENSCalibrationEstimator::collectExtractions()
+{
+    for (auto it = _extractTasks.begin(); it != _extractTasks.end();)
     {
-        std::vector<cv::Point2f> preciseCorners2D;
-        int                      flags          = CALIB_CB_ADAPTIVE_THRESH | CALIB_CB_NORMALIZE_IMAGE;
-        bool                     foundPrecisely = cv::findChessboardCorners(_currentImgToExtract,
-                                                        _boardSize,
-                                                        preciseCorners2D,
-                                                        flags);
-
-        if (foundPrecisely)
+        if (it->wait_for(std::chrono::milliseconds(0)) != std::future_status::ready)
         {
-            cv::cornerSubPix(_currentImgToExtract,
-                             preciseCorners2D,
-                             cv::Size(11, 11),
-                             cv::Size(-1, -1),
-                             TermCriteria(TermCriteria::EPS + TermCriteria::COUNT,
-                                          30,
-                                          0.0001));
-
-            //add detected points
-            _imagePoints.push_back(preciseCorners2D);
-            _numCaptured++;
+            ++it;
+            continue;
         }
+
+        try
+        {
+            std::vector<cv::Point2f> corners2D = it->get();
+            if (!corners2D.empty())
+            {
+                _imagePoints.push_back(corners2D);
+                _numCaptured++;
+            }
+        }
+        catch (std::exception& e)
+        {
+            _hasAsyncError = true;
+            _exception     = SENSCalibrationEstimatorException(e.what(), __LINE__, __FILE__);
+        }
+        it = _extractTasks.erase(it);
     }
-    catch (std::exception& e)
-    {
-        _hasAsyncError = true;
-        _exception     = SENSCalibrationEstimatorException(e.what(), __LINE__, __FILE__);
-        return false;
-    }
-    catch (...)
+}
+//-----------------------------------------------------------------------------
+/*! Takes over a finished background calibration update and starts a new one
+ if enough new views were captured since the last one. An update starts from
+ the intrinsics of the previous update, so calibrateCamera converges in a few
+ iterations. The update works on a copy of the image points.
+*/
+void SENSCalibrationEstimator::updateIntermediate()
+{
+    if (_intermediateTask.valid())
     {
-        _hasAsyncError = true;
-        _exception     = SENSCalibrationEstimatorException("Unknown exception during calibration!", __LINE__, __FILE__);
-        return false;
+        if (_intermediateTask.wait_for(std::chrono::milliseconds(0)) != std::future_status::ready)
+            return;
+
+        try
+        {
+            CalibrationUpdate update = _intermediateTask.get();
+            if (update.ok)
+                _intermediate = update;
+        }
+        catch (std::exception& e)
+        {
+            //an intermediate update is optional, only the final calibration counts
+            Utils::log("SLProject", "Intermediate calibration failed: %s", e.what());
+        }
     }
 
-    return foundPrecisely;
+    int numViews = (int)_imagePoints.size();
+    if (numViews < _intermediateStep ||
+        numViews < _intermediate.numViews + _intermediateStep)
+        return;
+
+    _intermediateTask = std::async(std::launch::async,
+                                   &SENSCalibrationEstimator::calcCalibrationUpdate,
+                                   _imagePoints,
+                                   _imageSize,
+                                   _boardSize,
+                                   _boardSquareMM,
+                                   _params.calibrationFlags(),
+                                   _intermediate.cameraMat,
+                                   _intermediate.distortion);
 }
 //-----------------------------------------------------------------------------
-bool SENSCalibrationEstimator::calibrateAsync()
+//!Calculates a calibration update on a worker thread
+SENSCalibrationEstimator::CalibrationUpdate
+SENSCalibrationEstimator::calcCalibrationUpdate(vector<vector<cv::Point2f>> imagePoints,
+                                                cv::Size                    imageSize,
+                                                cv::Size                    boardSize,
+                                                float                       squareSize,
+                                                int                         flag,
+                                                cv::Mat                     cameraMatrixGuess,
+                                                cv::Mat                     distCoeffsGuess)
+{
+    CalibrationUpdate    update;
+    std::vector<cv::Mat> rvecs, tvecs;
+    vector<float>        reprojErrs;
+
+    update.ok       = calcCalibration(imageSize,
+                                update.cameraMat,
+                                update.distortion,
+                                imagePoints,
+                                rvecs,
+                                tvecs,
+                                reprojErrs,
+                                update.reprojError,
+                                boardSize,
+                                squareSize,
+                                flag,
+                                false,
+                                cameraMatrixGuess,
+                                distCoeffsGuess);
+    update.numViews = (int)imagePoints.size();
+    return update;
+}
+//-----------------------------------------------------------------------------
+//!Returns the latest intermediate calibration or nullptr if there is none yet
+std::unique_ptr<SENSCalibration> SENSCalibrationEstimator::getIntermediateCalibration()
+{
+    if (!_intermediate.ok)
+        return nullptr;
+
+    return std::make_unique<SENSCalibration>(_intermediate.cameraMat,
+                                             _intermediate.distortion,
+                                             _imageSize,
+                                             _boardSize,
+                                             _boardSquareMM,
+                                             _intermediate.reprojError,
+                                             _intermediate.numViews,
+                                             Utils::getDateTime2String(),
+                                             _camSizeIndex,
+                                             _mirroredH,
+                                             _mirroredV,
+                                             _camType,
+                                             _computerInfos,
+                                             _params.calibrationFlags(),
+                                             true);
+}
+//-----------------------------------------------------------------------------
+/*! Starts the final calibration on a worker thread. It is seeded with the
+ latest intermediate update. A running update is waited for on the worker
+ thread as well, so the calling UI thread never blocks on calibrateCamera.
+*/
+void SENSCalibrationEstimator::startCalibration()
+{
+    auto              pending = std::make_shared<std::future<CalibrationUpdate>>(std::move(_intermediateTask));
+    CalibrationUpdate latest  = _intermediate;
+
+    _calibrationTask = std::async(std::launch::async,
+                                  [this, pending, latest]()
+                                  {
+                                      CalibrationUpdate seed = latest;
+                                      if (pending->valid())
+                                      {
+                                          try
+                                          {
+                                              CalibrationUpdate update = pending->get();
+                                              if (update.ok)
+                                                  seed = update;
+                                          }
+                                          catch (std::exception& e)
+                                          {
+                                              Utils::log("SLProject", "Intermediate calibration failed: %s", e.what());
+                                          }
+                                      }
+                                      return calibrateAsync(seed.cameraMat, seed.distortion);
+                                  });
+}
+//-----------------------------------------------------------------------------
+bool SENSCalibrationEstimator::calibrateAsync(cv::Mat cameraMatGuess, cv::Mat distortionGuess)
 {
     bool ok = false;
     try
@@ -179,7 +359,9 @@ bool SENSCalibrationEstimator::calibrateAsync()
                              _boardSize,
                              _boardSquareMM,
                              _params.calibrationFlags(),
-                             _params.useReleaseObjectMethod);
+                             _params.useReleaseObjectMethod,
+                             cameraMatGuess,
+                             distortionGuess);
         //correct number of caputured, extraction may have failed
         if (!rvecs.empty() || !reprojErrs.empty())
             _numCaptured = (int)std::max(rvecs.size(), reprojErrs.size());
@@ -222,7 +404,10 @@ bool SENSCalibrationEstimator::calibrateAsync()
     return ok;
 }
 //-----------------------------------------------------------------------------
-//! Calculates the calibration with the given set of image points
+/*! Calculates the calibration with the given set of image points. If a
+ camera matrix and distortion guess are passed (e.g. from an intermediate
+ calibration with fewer views), calibrateCamera starts from them.
+*/
 bool SENSCalibrationEstimator::calcCalibration(cv::Size&                          imageSize,
                                                cv::Mat&                           cameraMatrix,
                                                cv::Mat&                           distCoeffs,
@@ -234,17 +419,28 @@ bool SENSCalibrationEstimator::calcCalibration(cv::Size&
                                                cv::Size&                          boardSize,
                                                float                              squareSize,
                                                int                                flag,
-                                               bool                               useReleaseObjectMethod)
+                                               bool                               useReleaseObjectMethod,
+                                               const cv::Mat&                     cameraMatrixGuess,
+                                               const cv::Mat&                     distCoeffsGuess)
 {
-    // Init camera matrix with the eye setter
-    cameraMatrix = cv::Mat::eye(3, 3, CV_64F);
+    if (cameraMatrixGuess.rows == 3 && cameraMatrixGuess.cols == 3 && !distCoeffsGuess.empty())
+    {
+        cameraMatrix = cameraMatrixGuess.clone();
+        distCoeffs   = distCoeffsGuess.clone();
+        flag |= CALIB_USE_INTRINSIC_GUESS;
+    }
+    else
+    {
+        // Init camera matrix with the eye setter
+        cameraMatrix = cv::Mat::eye(3, 3, CV_64F);
 
-    // We need to set eleme at 0,0 to 1 if we want a fix aspect ratio
-    if (flag & CALIB_FIX_ASPECT_RATIO)
-        cameraMatrix.at<double>(0, 0) = 1.0;
+        // We need to set eleme at 0,0 to 1 if we want a fix aspect ratio
+        if (flag & CALIB_FIX_ASPECT_RATIO)
+            cameraMatrix.at<double>(0, 0) = 1.0;
 
-    // init the distortion coeffitients to zero
-    distCoeffs = cv::Mat::zeros(8, 1, CV_64F);
+        // init the distortion coeffitients to zero
+        distCoeffs = cv::Mat::zeros(8, 1, CV_64F);
+    }
 
     vector<vector<cv::Point3f>> objectPoints(1);
 
@@ -366,42 +562,37 @@ void SENSCalibrationEstimator::updateExtractAndCalc(bool found, bool grabFrame,
     switch (_state)
     {
         case State::Streaming:
+        case State::BusyExtracting:
         {
-            if (grabFrame && found)
+            collectExtractions();
+            if (_hasAsyncError)
             {
-                _currentImgToExtract = imageGray.clone();
-                //start async extraction
-                if (!_calibrationTask.valid())
-                {
-                    _calibrationTask = std::async(std::launch::async, &SENSCalibrationEstimator::extractAsync, this);
-                }
+                _state = State::Error;
+                throw _exception;
+            }
+
+            //grabbed frames are extracted on worker threads while streaming
+            if (grabFrame && found && _state == State::Streaming)
+                startExtraction(imageGray);
+
+            updateIntermediate();
 
+            int numPending = (int)_extractTasks.size();
+            if (_numCaptured >= _numOfImgsToCapture && numPending == 0)
+            {
+                //if ready and number of capturings exceed number of required start calculation
+                startCalibration();
+                _state = State::Calculating;
+            }
+            else if (_numCaptured + numPending >= _numOfImgsToCapture ||
+                     numPending >= _maxExtractTasks)
+            {
+                //wait for the pending extractions, failed ones have to be grabbed again
                 _state = State::BusyExtracting;
             }
-            break;
-        }
-        case State::BusyExtracting:
-        {
-            //check if async task is ready
-            if (_calibrationTask.wait_for(std::chrono::milliseconds(1)) == std::future_status::ready)
+            else
             {
-                bool extractionSuccessful = _calibrationTask.get();
-
-                if (_hasAsyncError)
-                {
-                    _state = State::Error;
-                    throw _exception;
-                }
-                else if (_numCaptured >= _numOfImgsToCapture)
-                {
-                    //if ready and number of capturings exceed number of required start calculation
-                    _calibrationTask = std::async(std::launch::async, &SENSCalibrationEstimator::calibrateAsync, this);
-                    _state           = State::Calculating;
-                }
-                else
-                {
-                    _state = State::Streaming;
-                }
+                _state = State::Streaming;
             }
             break;
         }
@@ -530,6 +721,91 @@ bool SENSCalibrationEstimator::updateAndDecorate(cv::Mat        imageColor,
     return found;
 }
 //-----------------------------------------------------------------------------
+/*! Calibrates from all images in imageDir (e.g. the images stored in the
+ OnlyCaptureAndSave mode) as offline batch job. The corners of the images are
+ extracted in parallel on all cores. Images with another size than the first
+ one are skipped. Returns true if the calibration succeeded, the result is
+ available with getCalibration as in the interactive mode.
+*/
+bool SENSCalibrationEstimator::calibrateImageFolder(const std::string& imageDir)
+{
+    std::vector<std::string> imageFiles;
+    for (const std::string& file : Utils::getFileNamesInDir(imageDir))
+    {
+        std::string ext = Utils::toLowerString(Utils::getFileExt(file));
+        if (ext == "jpg" || ext == "jpeg" || ext == "png" || ext == "bmp")
+            imageFiles.push_back(file);
+    }
+    std::sort(imageFiles.begin(), imageFiles.end());
+
+    if (imageFiles.empty())
+    {
+        Utils::log("SLProject", "No calibration images found in: %s", imageDir.c_str());
+        return false;
+    }
+
+    //extract the corners of the images in parallel, every thread takes the next image
+    vector<vector<cv::Point2f>> corners(imageFiles.size());
+    vector<cv::Size>            sizes(imageFiles.size());
+    cv::Size                    boardSize = _boardSize;
+
+    Utils::parallelFor((int)imageFiles.size(),
+                       [&](int i)
+                       {
+                           cv::Mat image = cv::imread(imageFiles[i], IMREAD_GRAYSCALE);
+                           if (image.empty())
+                               return;
+                           sizes[i] = image.size();
+                           extractCorners(image, boardSize, corners[i]);
+                       },
+                       "CalibrationWorker");
+
+    _imagePoints.clear();
+    _imageSize = cv::Size();
+    for (size_t i = 0; i < imageFiles.size(); ++i)
+    {
+        if (corners[i].empty())
+        {
+            Utils::log("SLProject", "No chessboard found in: %s", imageFiles[i].c_str());
+            continue;
+        }
+
+        if (_imageSize.area() == 0)
+            _imageSize = sizes[i];
+        else if (sizes[i] != _imageSize)
+        {
+            Utils::log("SLProject", "Skipped image with different size: %s", imageFiles[i].c_str());
+            continue;
+        }
+
+        _imagePoints.push_back(corners[i]);
+    }
+    _numCaptured = (int)_imagePoints.size();
+
+    Utils::log("SLProject",
+               "Found chessboard in %d of %d images.",
+               _numCaptured,
+               (int)imageFiles.size());
+
+    if (_imagePoints.empty())
+    {
+        _state = State::Done;
+        return false;
+    }
+
+    _calibrationSuccessful = calibrateAsync(_intermediate.cameraMat, _intermediate.distortion);
+    if (_hasAsyncError)
+    {
+        _state = State::Error;
+        throw _exception;
+    }
+
+    _state = State::Done;
+    if (_calibrationSuccessful)
+        Utils::log("SLProject", "Reproj. error: %f", _reprojectionError);
+    return _calibrationSuccessful;
+}
+//-----------------------------------------------------------------------------
 //! Calculates the 3D positions of the chessboard corners
 void SENSCalibrationEstimator::calcBoardCorners3D(const cv::Size&           boardSize,
                                                   float                     squareSize,
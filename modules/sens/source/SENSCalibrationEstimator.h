@@ -11,6 +11,7 @@
 #define SENSCALIBRATIONESTIMATOR_H
 
 #include <future>
+#include <memory>
 #include <SENSCalibration.h>
 
 using namespace std;
@@ -63,6 +64,7 @@ public:
                            const cv::Mat& imageGray,
                            bool           grabFrame,
                            bool           drawCorners = true);
+    bool calibrateImageFolder(const std::string& imageDir);
 
     State state()
     {
@@ -79,6 +81,13 @@ public:
     bool            isStreaming() { return _state == State::Streaming; }
     bool            isDone() { return _state == State::Done; }
     bool            isDoneCaptureAndSave() { return _state == State::DoneCaptureAndSave; }
+    int             numPendingExtractions() { return (int)_extractTasks.size(); }
+
+    //!Intermediate calibration that is updated in the background while capturing (nullptr if there is none yet)
+    std::unique_ptr<SENSCalibration> getIntermediateCalibration();
+    bool                             hasIntermediateCalibration() { return _intermediate.ok; }
+    float                            intermediateReprojError() { return _intermediate.reprojError; }
+    int                              intermediateNumViews() { return _intermediate.numViews; }
 
     static bool calcCalibration(cv::Size&                          imageSize,
                                 cv::Mat&                           cameraMatrix,
@@ -91,12 +100,30 @@ public:
                                 cv::Size&                          boardSize,
                                 float                              squareSize,
                                 int                                flag,
-                                bool                               useReleaseObjectMethod);
+                                bool                               useReleaseObjectMethod,
+                                const cv::Mat&                     cameraMatrixGuess = cv::Mat(),
+                                const cv::Mat&                     distCoeffsGuess   = cv::Mat());
+    static bool extractCorners(const cv::Mat&            imageGray,
+                               const cv::Size&           boardSize,
+                               std::vector<cv::Point2f>& corners2D);
 
 private:
-    bool calibrateAsync();
-    bool extractAsync();
+    //!Result of a background calibration update
+    struct CalibrationUpdate
+    {
+        bool    ok = false;
+        cv::Mat cameraMat;
+        cv::Mat distortion;
+        float   reprojError = -1.f;
+        int     numViews    = 0;
+    };
+
+    bool calibrateAsync(cv::Mat cameraMatGuess, cv::Mat distortionGuess);
+    void startCalibration();
     bool loadCalibParams();
+    void startExtraction(const cv::Mat& imageGray);
+    void collectExtractions();
+    void updateIntermediate();
     void updateExtractAndCalc(bool found, bool grabFrame, cv::Mat imageGray);
     void updateOnlyCapture(bool found, bool grabFrame, cv::Mat imageGray);
     void saveImage(cv::Mat imageGray);
@@ -111,13 +138,25 @@ private:
     static void   calcBoardCorners3D(const cv::Size&           boardSize,
                                      float                     squareSize,
                                      std::vector<cv::Point3f>& objectPoints3D);
+    static CalibrationUpdate calcCalibrationUpdate(vector<vector<cv::Point2f>> imagePoints,
+                                                   cv::Size                    imageSize,
+                                                   cv::Size                    boardSize,
+                                                   float                       squareSize,
+                                                   int                         flag,
+                                                   cv::Mat                     cameraMatrixGuess,
+                                                   cv::Mat                     distCoeffsGuess);
 
     State _state                 = State::Streaming;
     bool  _calibrationSuccessful = false;
 
     std::future<bool> _calibrationTask; //!< future object for calculation of calibration in async task
 
-    cv::Mat                     _currentImgToExtract;
+    vector<std::future<std::vector<cv::Point2f>>> _extractTasks;         //!< pending corner extractions of grabbed frames
+    int                                           _maxExtractTasks;      //!< max. no. of parallel corner extractions
+    std::future<CalibrationUpdate>                _intermediateTask;     //!< pending background calibration update
+    CalibrationUpdate                             _intermediate;         //!< latest background calibration update
+    int                                           _intermediateStep = 3; //!< no. of new views that trigger an update
+
     vector<vector<cv::Point2f>> _imagePoints;               //!< 2D vector of corner points in chessboard
     cv::Size                    _boardSize;                 //!< NO. of inner chessboard corners.
     float                       _boardSquareMM      = 10.f; //!< Size of chessboard square in mm
@@ -1,5 +1,6 @@
 #include "SENSRecorder.h"
 #include <Utils.h>
+#include <SENSBinaryLog.h>
 
 SENSRecorder::SENSRecorder(const std::string& outputDir)
   : _outputDir(outputDir)
@@ -182,6 +183,38 @@ bool SENSRecorder::getCameraHandlerError(std::string& errorMsg)
         return false;
 }
 
+SENSRecorderStats SENSRecorder::getGpsHandlerStats()
+{
+    return _gpsDataHandler ? _gpsDataHandler->stats() : SENSRecorderStats();
+}
+
+SENSRecorderStats SENSRecorder::getOrientationHandlerStats()
+{
+    return _orientationDataHandler ? _orientationDataHandler->stats() : SENSRecorderStats();
+}
+
+SENSRecorderStats SENSRecorder::getCameraHandlerStats()
+{
+    return _cameraDataHandler ? _cameraDataHandler->stats() : SENSRecorderStats();
+}
+
+bool SENSRecorder::exportToText(const std::string& recordDir)
+{
+    std::string dir     = Utils::unifySlashes(recordDir);
+    bool        success = true;
+    for (const char* name : {"gps", "orientation"})
+    {
+        std::string binFileName = dir + name + ".bin";
+        if (Utils::fileExists(binFileName) &&
+            !SENSBinaryLog::exportToText(binFileName, dir + name + ".txt"))
+        {
+            Utils::log("SENS", "SENSRecorder: could not export %s", binFileName.c_str());
+            success = false;
+        }
+    }
+    return success;
+}
+
 void SENSRecorder::onGps(const SENSTimePt& timePt, const SENSGps::Location& loc)
 {
     auto newData = std::make_pair(loc, timePt);
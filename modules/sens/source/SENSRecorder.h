@@ -40,6 +40,14 @@ public:
     bool getOrientationHandlerError(std::string& errorMsg);
     bool getCameraHandlerError(std::string& errorMsg);
 
+    //!statistics of the data handlers (queue depth, dropped values, write throughput)
+    SENSRecorderStats getGpsHandlerStats();
+    SENSRecorderStats getOrientationHandlerStats();
+    SENSRecorderStats getCameraHandlerStats();
+
+    //!Converts the binary gps and orientation logs in a record directory to text files (gps.txt, orientation.txt)
+    static bool exportToText(const std::string& recordDir);
+
     bool               isRunning() const { return _running; }
     const std::string& outputDir() const { return _outputDir; }
 
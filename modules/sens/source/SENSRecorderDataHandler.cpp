@@ -1,9 +1,19 @@
 #include "SENSRecorderDataHandler.h"
 #include <HighResTimer.h>
+#include <SENSBinaryLog.h>
+#include <algorithm>
 //-----------------------------------------------------------------------------
 template<typename T>
-SENSRecorderDataHandler<T>::SENSRecorderDataHandler(const std::string& name)
-  : _name(name)
+SENSRecorderDataHandler<T>::SENSRecorderDataHandler(const std::string&      name,
+                                                    size_t                  capacity,
+                                                    SENSRecorderQueuePolicy policy,
+                                                    const std::string&      fileExtension,
+                                                    bool                    binary)
+  : _ring(std::max<size_t>(capacity, 1)),
+    _policy(policy),
+    _name(name),
+    _fileExtension(fileExtension),
+    _binary(binary)
 {
 }
 
@@ -18,7 +28,16 @@ void SENSRecorderDataHandler<T>::start(const std::string& outputDir)
 {
     stop();
     //start writer thread
-    _errorMsg.clear();
+    {
+        std::lock_guard<std::mutex> lock(_msgMutex);
+        _errorMsg.clear();
+    }
+    {
+        std::lock_guard<std::mutex> lock(_mutex);
+        _stats               = SENSRecorderStats();
+        _stats.queueCapacity = _ring.size();
+        _running             = true;
+    }
     _outputDir = outputDir;
     _thread    = std::thread(&SENSRecorderDataHandler::store, this);
 }
@@ -35,8 +54,51 @@ void SENSRecorderDataHandler<T>::stop()
         _thread.join();
 
     lock.lock();
-    _queue.clear();
-    _stop = false;
+    //values left over if the file could not be opened
+    for (size_t i = 0; i < _ringCount; ++i)
+        _ring[(_ringHead + i) % _ring.size()] = T();
+    _ringHead  = 0;
+    _ringCount = 0;
+    _stop      = false;
+    _running   = false;
+    lock.unlock();
+    _spaceCondVar.notify_all();
+}
+
+template<typename T>
+bool SENSRecorderDataHandler<T>::capacity(size_t capacity)
+{
+    std::lock_guard<std::mutex> lock(_mutex);
+    if (_running)
+        return false;
+
+    _ring.assign(std::max<size_t>(capacity, 1), T());
+    return true;
+}
+
+template<typename T>
+bool SENSRecorderDataHandler<T>::policy(SENSRecorderQueuePolicy policy)
+{
+    std::lock_guard<std::mutex> lock(_mutex);
+    if (_running)
+        return false;
+
+    _policy = policy;
+    return true;
+}
+
+template<typename T>
+size_t SENSRecorderDataHandler<T>::capacity()
+{
+    std::lock_guard<std::mutex> lock(_mutex);
+    return _ring.size();
+}
+
+template<typename T>
+SENSRecorderQueuePolicy SENSRecorderDataHandler<T>::policy()
+{
+    std::lock_guard<std::mutex> lock(_mutex);
+    return _policy;
 }
 
 template<typename T>
@@ -45,65 +107,121 @@ void SENSRecorderDataHandler<T>::store()
     SENS_DEBUG("SENSRecorderDataHandler: starting store");
     writeOnThreadStart();
     //open file
-    std::string fileName = _outputDir + _name + ".txt";
+    std::string fileName = _outputDir + _name + _fileExtension;
     ofstream    file;
-    file.open(fileName);
+    file.open(fileName, _binary ? std::ios::out | std::ios::binary : std::ios::out);
     if (file.is_open())
     {
         writeHeaderToFile(file);
+
+        //values are moved from the ring buffer to this batch and written without holding the lock
+        std::vector<T> batch;
+        batch.reserve(_ring.size());
+
         while (true)
         {
             std::unique_lock<std::mutex> lock(_mutex);
 
             _condVar.wait(lock, [&]
-                          { return (_stop == true || _queue.size() != 0); });
-            if (_stop)
+                          { return (_stop == true || _ringCount != 0); });
+            //on stop the remaining values are written before leaving
+            if (_stop && _ringCount == 0)
                 break;
 
-            SENS_DEBUG("SENSRecorderDataHandler: queue size: %d", _queue.size());
+            SENS_DEBUG("SENSRecorderDataHandler: queue size: %d", _ringCount);
 
-            std::deque<T> localQueue;
-            while (_queue.size())
-            {
-                localQueue.push_back(_queue.front());
-                _queue.pop_front();
-            }
+            for (size_t i = 0; i < _ringCount; ++i)
+                batch.push_back(std::move(_ring[(_ringHead + i) % _ring.size()]));
+            _ringHead  = 0;
+            _ringCount = 0;
 
             lock.unlock();
+            _spaceCondVar.notify_all();
 
-            //write data
-            if (localQueue.size())
-            {
-                writeLineToFile(file, localQueue.front());
-                localQueue.pop_front();
-            }
-
-            if (localQueue.size())
-            {
-                std::stringstream ss;
-                ss << "Data writing is too slow. Skipping " << localQueue.size() << " values from queue!";
-                SENS_WARN("SENSRecorderDataHandler store: %s", ss.str().c_str());
-                //if buffer is running full, warn and skip values
-                {
-                    std::lock_guard<std::mutex> lock(_msgMutex);
-                    _errorMsg = ss.str();
-                }
-                localQueue.clear();
-            }
+            writeBatch(file, batch);
         }
     }
+    else
+    {
+        setErrorMsg("Could not open file: " + fileName);
+        SENS_WARN("SENSRecorderDataHandler store: could not open file: %s", fileName.c_str());
+
+        //release blocked producers, nothing will be written
+        std::lock_guard<std::mutex> lock(_mutex);
+        _running = false;
+    }
+    _spaceCondVar.notify_all();
+
     writeOnThreadFinish();
     //close file
     file.close();
 }
 
+template<typename T>
+void SENSRecorderDataHandler<T>::writeBatch(ofstream& file, std::vector<T>& batch)
+{
+    HighResTimer   t;
+    std::streampos startPos = file.tellp();
+    for (const T& item : batch)
+        writeLineToFile(file, item);
+    file.flush();
+    std::streampos endPos  = file.tellp();
+    double         seconds = t.elapsedTimeInSec();
+
+    std::lock_guard<std::mutex> lock(_mutex);
+    _stats.numWritten += batch.size();
+    _stats.numBatches++;
+    _stats.writeSeconds += seconds;
+    if (startPos != std::streampos(-1) && endPos != std::streampos(-1))
+        _stats.bytesWritten += (uint64_t)(endPos - startPos);
+
+    batch.clear();
+}
+
 template<typename T>
 void SENSRecorderDataHandler<T>::add(T&& item)
 {
     std::unique_lock<std::mutex> lock(_mutex);
-    _queue.push_back(std::move(item));
+    if (!_running)
+        return;
+
+    bool droppedOldest = false;
+    if (_ringCount == _ring.size())
+    {
+        if (_policy == SENSRecorderQueuePolicy::BLOCK)
+        {
+            _spaceCondVar.wait(lock, [&]
+                               { return !_running || _ringCount < _ring.size(); });
+            if (!_running)
+                return;
+        }
+        else if (_policy == SENSRecorderQueuePolicy::DROP_NEWEST)
+        {
+            _stats.numDropped++;
+            uint64_t numDropped = _stats.numDropped;
+            lock.unlock();
+            setErrorMsg("Data writing is too slow. Dropped " + std::to_string(numDropped) + " values!");
+            return;
+        }
+        else //DROP_OLDEST
+        {
+            _ringHead = (_ringHead + 1) % _ring.size();
+            _ringCount--;
+            _stats.numDropped++;
+            droppedOldest = true;
+        }
+    }
+
+    _ring[(_ringHead + _ringCount) % _ring.size()] = std::move(item);
+    _ringCount++;
+    _stats.numAdded++;
+    _stats.maxQueueDepth = std::max(_stats.maxQueueDepth, _ringCount);
+    uint64_t numDropped  = _stats.numDropped;
     lock.unlock();
     _condVar.notify_one();
+
+    if (droppedOldest)
+        setErrorMsg("Data writing is too slow. Dropped " + std::to_string(numDropped) + " values!");
 }
 
 template<typename T>
@@ -119,6 +237,23 @@ bool SENSRecorderDataHandler<T>::getErrorMsg(std::string& msg)
     }
 }
 
+template<typename T>
+void SENSRecorderDataHandler<T>::setErrorMsg(const std::string& msg)
+{
+    std::lock_guard<std::mutex> lock(_msgMutex);
+    _errorMsg = msg;
+}
+
+template<typename T>
+SENSRecorderStats SENSRecorderDataHandler<T>::stats()
+{
+    std::lock_guard<std::mutex> lock(_mutex);
+    SENSRecorderStats           stats = _stats;
+    stats.queueDepth                  = _ringCount;
+    stats.queueCapacity               = _ring.size();
+    return stats;
+}
+
 //explicit instantiation
 template class SENSRecorderDataHandler<GpsInfo>;
 template class SENSRecorderDataHandler<OrientationInfo>;
@@ -126,42 +261,40 @@ template class SENSRecorderDataHandler<FrameInfo>;
 
 //-----------------------------------------------------------------------------
 SENSGpsRecorderDataHandler::SENSGpsRecorderDataHandler()
-  : SENSRecorderDataHandler("gps")
+  : SENSRecorderDataHandler("gps", 256, SENSRecorderQueuePolicy::DROP_OLDEST, ".bin", true)
+{
+}
+
+void SENSGpsRecorderDataHandler::writeHeaderToFile(ofstream& file)
 {
+    SENSBinaryLog::writeHeader(file, SENSBinaryLog::RecordType::GPS);
 }
 
 void SENSGpsRecorderDataHandler::writeLineToFile(ofstream& file, const GpsInfo& data)
 {
-    file << std::chrono::time_point_cast<SENSMicroseconds>(data.second).time_since_epoch().count() << " "
-         << data.first.latitudeDEG << " "
-         << data.first.longitudeDEG << " "
-         << data.first.altitudeM << " "
-         << data.first.accuracyM << "\n";
+    SENSBinaryLog::writeGps(file, data.second, data.first);
 }
 
 //-----------------------------------------------------------------------------
 SENSOrientationRecorderDataHandler::SENSOrientationRecorderDataHandler()
-  : SENSRecorderDataHandler("orientation")
+  : SENSRecorderDataHandler("orientation", 1024, SENSRecorderQueuePolicy::DROP_OLDEST, ".bin", true)
 {
 }
 
-void SENSOrientationRecorderDataHandler::writeLineToFile(ofstream& file, const OrientationInfo& data)
+void SENSOrientationRecorderDataHandler::writeHeaderToFile(ofstream& file)
 {
-    //reading (https://stackoverflow.com/questions/31255486/c-how-do-i-convert-a-stdchronotime-point-to-long-and-back)
-    //long readTimePt;
-    //microseconds readTimePtUs(readTimePt);
-    //time_point<high_resolution_clock> dt(readTimePt);
+    SENSBinaryLog::writeHeader(file, SENSBinaryLog::RecordType::ORIENTATION);
+}
 
-    file << std::chrono::time_point_cast<SENSMicroseconds>(data.second).time_since_epoch().count() << " "
-         << data.first.quatX << " "
-         << data.first.quatY << " "
-         << data.first.quatZ << " "
-         << data.first.quatW << "\n";
+void SENSOrientationRecorderDataHandler::writeLineToFile(ofstream& file, const OrientationInfo& data)
+{
+    SENSBinaryLog::writeOrientation(file, data.second, data.first);
 }
 
 //-----------------------------------------------------------------------------
+//frames are large, so only a few are buffered. New frames are dropped if encoding is too slow.
 SENSCameraRecorderDataHandler::SENSCameraRecorderDataHandler()
-  : SENSRecorderDataHandler("camera")
+  : SENSRecorderDataHandler("camera", 8, SENSRecorderQueuePolicy::DROP_NEWEST)
 {
 }
 
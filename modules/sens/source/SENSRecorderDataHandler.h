@@ -4,7 +4,7 @@
 #include <string>
 #include <thread>
 #include <atomic>
-#include <deque>
+#include <vector>
 #include <utility>
 #include <mutex>
 #include <fstream>
@@ -23,26 +23,71 @@ using GpsInfo         = std::pair<SENSGps::Location, SENSTimePt>;
 using OrientationInfo = std::pair<SENSOrientation::Quat, SENSTimePt>;
 using FrameInfo       = std::pair<cv::Mat, SENSTimePt>;
 
+//-----------------------------------------------------------------------------
+//!Behaviour of SENSRecorderDataHandler::add if the queue is full
+enum class SENSRecorderQueuePolicy
+{
+    DROP_OLDEST = 0, //!<overwrite the oldest queued value (keeps the newest data)
+    DROP_NEWEST,     //!<discard the value that should be added
+    BLOCK            //!<block the sensor thread until the store thread made space
+};
+
+//-----------------------------------------------------------------------------
+//!Statistics of a SENSRecorderDataHandler since the last start
+struct SENSRecorderStats
+{
+    size_t   queueDepth    = 0; //!<current number of queued values
+    size_t   maxQueueDepth = 0; //!<maximum number of queued values
+    size_t   queueCapacity = 0; //!<capacity of the ring buffer
+    uint64_t numAdded      = 0; //!<number of values added to the queue
+    uint64_t numWritten    = 0; //!<number of values written to file
+    uint64_t numDropped    = 0; //!<number of values dropped because the queue was full
+    uint64_t numBatches    = 0; //!<number of write batches (one flush per batch)
+    uint64_t bytesWritten  = 0; //!<bytes written to the data file
+    double   writeSeconds  = 0; //!<time spent in writing batches
+
+    double valuesPerSecond() const { return writeSeconds > 0.0 ? (double)numWritten / writeSeconds : 0.0; }
+    double bytesPerSecond() const { return writeSeconds > 0.0 ? (double)bytesWritten / writeSeconds : 0.0; }
+};
+
 //-----------------------------------------------------------------------------
 /*! SENSRecorderDataHandler
  This class is meant to be used exclusively by the SENSRecorder class. The SENSRecorder listens to sensors
  and informs SENSRecorderDataHandler backends about new data. The SENSRecorderDataHandler stores values to file.
+ New values are queued in a bounded ring buffer. If the buffer is full, the SENSRecorderQueuePolicy decides
+ whether the oldest or the newest value is dropped or whether add blocks. The store thread takes all queued
+ values at once and writes them as one batch with a single flush. On stop the remaining values are written
+ before the thread finishes. Use stats() to monitor queue depth, dropped values and write throughput.
  */
 template<typename T>
 class SENSRecorderDataHandler
 {
 public:
-    SENSRecorderDataHandler(const std::string& name);
+    SENSRecorderDataHandler(const std::string&      name,
+                            size_t                  capacity,
+                            SENSRecorderQueuePolicy policy,
+                            const std::string&      fileExtension = ".txt",
+                            bool                    binary        = false);
     virtual ~SENSRecorderDataHandler();
 
     //!start the store thread
     void start(const std::string& outputDir);
-    //!stop the store thread and clear values in queue
+    //!stop the store thread after all queued values are written
     void stop();
-    //!add new value to store queue
+    //!add new value to store queue (drops a value or blocks if the queue is full, depending on the policy)
     void add(T&& item);
     //!get error msg (valid if function returns true)
     bool getErrorMsg(std::string& msg);
+    //!get a copy of the current statistics
+    SENSRecorderStats stats();
+
+    //!set capacity of the ring buffer (only possible if the store thread is not running)
+    bool capacity(size_t capacity);
+    //!set policy for a full queue (only possible if the store thread is not running)
+    bool policy(SENSRecorderQueuePolicy policy);
+
+    size_t                  capacity();
+    SENSRecorderQueuePolicy policy();
 
 protected:
     //!called in thread store routine when thread starts
@@ -59,19 +104,32 @@ protected:
 
 private:
     void store();
+    void writeBatch(ofstream& file, std::vector<T>& batch);
+    void setErrorMsg(const std::string& msg);
 
-    //new data queue: values are added by SENSRecorder and retrieved and
+    //new data ring buffer: values are added by SENSRecorder and retrieved and
     //written by store thread
-    std::deque<T> _queue;
-    //condition variable and mutex for store thread
+    std::vector<T> _ring;
+    size_t         _ringHead  = 0; //index of the oldest value
+    size_t         _ringCount = 0; //number of queued values
+    //policy if ring buffer is full
+    SENSRecorderQueuePolicy _policy;
+    //condition variables and mutex for store thread
     std::mutex              _mutex;
     std::condition_variable _condVar;
+    std::condition_variable _spaceCondVar;
     //store thread
     std::thread _thread;
     //stop store thread
-    bool _stop = false;
+    bool _stop    = false;
+    bool _running = false;
     //name of this handler (e.g. gps)
     std::string _name;
+    std::string _fileExtension;
+    bool        _binary;
+
+    //statistics (protected by _mutex)
+    SENSRecorderStats _stats;
 
     std::mutex  _msgMutex;
     std::string _errorMsg;
@@ -79,21 +137,25 @@ private:
 
 //-----------------------------------------------------------------------------
 /*! SENSGpsRecorderDataHandler
+ Writes gps values to gps.bin in the SENSBinaryLog format.
  */
 class SENSGpsRecorderDataHandler : public SENSRecorderDataHandler<GpsInfo>
 {
 public:
     SENSGpsRecorderDataHandler();
+    void writeHeaderToFile(ofstream& file) override;
     void writeLineToFile(ofstream& file, const GpsInfo& data) override;
 };
 
 //-----------------------------------------------------------------------------
 /*! SENSOrientationRecorderDataHandler
+ Writes orientation values to orientation.bin in the SENSBinaryLog format.
  */
 class SENSOrientationRecorderDataHandler : public SENSRecorderDataHandler<OrientationInfo>
 {
 public:
     SENSOrientationRecorderDataHandler();
+    void writeHeaderToFile(ofstream& file) override;
     void writeLineToFile(ofstream& file, const OrientationInfo& data) override;
 };
 
@@ -6,7 +6,9 @@
 #include <SENS.h>
 
 /*! SENSSimClock
-Clock used for sensor simulation in SENSSimulator and SENSSimulated
+Clock used for sensor simulation in SENSSimulator and SENSSimulated.
+In virtual mode (fast replay) the clock does not follow the real time. It only moves when
+SENSSimulator calls advanceTo, so the simulation runs as fast as the consumer processes the data.
 */
 class SENSSimClock
 {
@@ -44,15 +46,47 @@ public:
     //!(we switch to pause when setting new start, in this way now becomes thread save and we increase performance of now() (no mutex in nomal use))
     void reset()
     {
+        //a virtual clock restarts at the seek position
+        _virtualPassedTimeUS = _virtualStartTimeUS.load();
+
         pause();
         _startTimePt = SENSClock::now();
         _pauseTime   = SENSMicroseconds(0);
         resume();
     }
 
+    //!switch between real time and virtual time (only change it when no simulated sensor is running)
+    void setVirtual(bool isVirtual)
+    {
+        _virtual = isVirtual;
+    }
+
+    bool isVirtual() const
+    {
+        return _virtual;
+    }
+
+    //!set the virtual time (only used in virtual mode, time points before the current time are ignored)
+    void advanceTo(SENSTimePt simTimePt)
+    {
+        long long passedTimeUS = std::chrono::duration_cast<SENSMicroseconds>(simTimePt - _simStartTimePt).count();
+        if (passedTimeUS > _virtualPassedTimeUS)
+            _virtualPassedTimeUS = passedTimeUS;
+    }
+
+    //!set the virtual time to an offset from the simulation start (only used in virtual mode)
+    void seek(SENSMicroseconds offset)
+    {
+        _virtualStartTimeUS  = offset.count();
+        _virtualPassedTimeUS = offset.count();
+    }
+
     //!get passed simulation time
     SENSMicroseconds passedTime() const
     {
+        if (_virtual)
+            return SENSMicroseconds(_virtualPassedTimeUS.load());
+
         SENSMicroseconds passedSimTime;
         if (_pause)
         {
@@ -70,6 +104,9 @@ public:
     //!get current simulation time (const function which should be thread save)
     SENSTimePt now() const
     {
+        if (_virtual)
+            return _simStartTimePt + SENSMicroseconds(_virtualPassedTimeUS.load());
+
         SENSMicroseconds passedSimTime;
         if (_pause)
         {
@@ -97,6 +134,13 @@ private:
     SENSTimePt _startTimePt;
     //!start time point of simulation in the past
     SENSTimePt _simStartTimePt;
+
+    //!virtual mode: passed simulation time is set by advanceTo and not by the real clock
+    std::atomic_bool _virtual{false};
+    //!virtual passed simulation time in microseconds
+    std::atomic<long long> _virtualPassedTimeUS{0};
+    //!virtual passed simulation time at reset (seek position)
+    std::atomic<long long> _virtualStartTimeUS{0};
 };
 
 #endif //SENS_SIMCLOCK_H
@@ -1,5 +1,6 @@
 #include "SENSSimulated.h"
 #include "HighResTimer.h"
+#include <algorithm>
 
 //-----------------------------------------------------------------------------
 template<typename T>
@@ -24,6 +25,15 @@ void SENSSimulated<T>::startSim()
     //stop the local simulation thread if running
     stopSim();
     _errorMsg.clear();
+
+    //in fast replay mode the values are fed by SENSSimulator::step
+    if (_clock.isVirtual())
+    {
+        replaySeek(_clock.now());
+        _threadIsRunning = true;
+        return;
+    }
+
     //start the simulation thread
     _thread = std::thread(&SENSSimulated::feedSensor, this);
 }
@@ -38,6 +48,8 @@ void SENSSimulated<T>::stopSim()
 
     if (_thread.joinable())
         _thread.join();
+    else if (_threadIsRunning)
+        replayEnd();
 
     lock.lock();
     _stop = false;
@@ -144,6 +156,55 @@ void SENSSimulated<T>::feedSensor()
     _sensorSimStoppedCB();
 }
 
+template<typename T>
+bool SENSSimulated<T>::replayNextTimePt(SENSTimePt& timePt, int stride)
+{
+    if (!_threadIsRunning || _replayCounter >= _data.size())
+        return false;
+
+    //skip stride - 1 values but always deliver the last one
+    size_t index = std::min(_data.size() - 1, (size_t)_replayCounter + std::max(stride, 1) - 1);
+    timePt       = _data[index].first;
+    return true;
+}
+
+template<typename T>
+void SENSSimulated<T>::replayFeedUntil(SENSTimePt timePt, bool feedAll)
+{
+    int lastIndex = -1;
+    while (_replayCounter < _data.size() && _data[_replayCounter].first <= timePt)
+    {
+        if (feedAll)
+            feedSensorData(_replayCounter);
+        lastIndex = _replayCounter;
+        _replayCounter++;
+    }
+
+    if (!feedAll && lastIndex >= 0)
+        feedSensorData(lastIndex);
+}
+
+template<typename T>
+void SENSSimulated<T>::replaySeek(SENSTimePt timePt)
+{
+    auto it = std::lower_bound(_data.begin(),
+                               _data.end(),
+                               timePt,
+                               [](const std::pair<SENSTimePt, T>& value, const SENSTimePt& t)
+                               { return value.first < t; });
+    _replayCounter = (int)(it - _data.begin());
+}
+
+template<typename T>
+void SENSSimulated<T>::replayEnd()
+{
+    if (_threadIsRunning)
+    {
+        _threadIsRunning = false;
+        _sensorSimStoppedCB();
+    }
+}
+
 //explicit template instantiation
 template class SENSSimulated<SENSGps::Location>;
 template class SENSSimulated<SENSOrientation::Quat>;
@@ -291,17 +352,28 @@ const SENSCaptureProps& SENSSimulatedCamera::captureProperties()
 
 SENSSimulatedCamera::SENSSimulatedCamera(StartSimCB                                startSimCB,
                                          SensorSimStoppedCB                        sensorSimStoppedCB,
+                                         ReplayStepCB                              replayStepCB,
                                          std::vector<std::pair<SENSTimePt, int>>&& data,
                                          std::string                               videoFileName,
                                          SENSCameraConfig                          cameraConfig,
                                          const SENSSimClock&                       clock)
   : SENSSimulated("camera", startSimCB, sensorSimStoppedCB, std::move(data), clock),
-    _videoFileName(videoFileName)
+    _videoFileName(videoFileName),
+    _replayStepCB(replayStepCB)
 {
     _config            = cameraConfig;
     _permissionGranted = true;
 }
 
+SENSFrameBasePtr SENSSimulatedCamera::latestFrame()
+{
+    //in fast replay mode the consumer asks for the next frame when it has processed the last one
+    if (_started && _clock.isVirtual() && _replayStepCB && !_replayStepCB())
+        return SENSFrameBasePtr();
+
+    return SENSBaseCamera::latestFrame();
+}
+
 void SENSSimulatedCamera::feedSensorData(const int counter)
 {
     HighResTimer t;
@@ -329,7 +401,14 @@ void SENSSimulatedCamera::prepareSensorData(const int counter)
     HighResTimer t;
 
     int nextFramePos = _cap.get(cv::CAP_PROP_POS_FRAMES);
-    if (nextFramePos != frameIndex)
+    if (nextFramePos < frameIndex && frameIndex - nextFramePos <= _maxGrabSkip)
+    {
+        //skipping a few frames (e.g. with frame decimation) by grabbing without decoding
+        //is much faster than setting the frame position, which seeks to the last key frame
+        for (int i = nextFramePos; i < frameIndex; ++i)
+            _cap.grab();
+    }
+    else if (nextFramePos != frameIndex)
     {
         SENS_DEBUG("updating frame pos");
         _cap.set(cv::CAP_PROP_POS_FRAMES, frameIndex);
@@ -26,6 +26,16 @@ public:
     virtual bool isThreadRunning() const = 0;
 
     virtual bool getErrorMsg(std::string& msg) = 0;
+
+    //fast replay interface used by SENSSimulator::step (only valid if the SENSSimClock is virtual)
+    //!get time point of the next value to feed, skipping stride - 1 values (returns false at the end of data)
+    virtual bool replayNextTimePt(SENSTimePt& timePt, int stride) = 0;
+    //!feed values up to timePt in order (feedAll) or only the last one of them
+    virtual void replayFeedUntil(SENSTimePt timePt, bool feedAll) = 0;
+    //!move the replay position to the first value at or after timePt
+    virtual void replaySeek(SENSTimePt timePt) = 0;
+    //!end the replay of this sensor (informs SENSSimulator like the end of the simulation thread)
+    virtual void replayEnd() = 0;
 };
 
 //-----------------------------------------------------------------------------
@@ -34,6 +44,8 @@ Implements the sensor simulation backend. SENSSimulated runs a thread (see feedS
 function which feeds the next data value to a sensor (e.g. SENSGps). The current simulation time is retrieved from
 the SENSSimulator clock and depending on this the next data value is selected and fed a the respective time.
 This class contains common functionality for SENSSimulated implementations.
+In fast replay mode (virtual SENSSimClock) no thread is started. The values are fed on the calling thread
+of SENSSimulator::step in the order of their time points, which makes a replay deterministic.
  */
 template<typename T>
 class SENSSimulated : public SENSSimulatedBase
@@ -63,6 +75,11 @@ protected:
 
     bool isThreadRunning() const override { return _threadIsRunning; }
 
+    bool replayNextTimePt(SENSTimePt& timePt, int stride) override;
+    void replayFeedUntil(SENSTimePt timePt, bool feedAll) override;
+    void replaySeek(SENSTimePt timePt) override;
+    void replayEnd() override;
+
     //!feed new sensor data to sensor
     virtual void feedSensorData(const int counter) = 0;
     //!prepare things that may take some time for the next writing of sensor data
@@ -89,7 +106,9 @@ protected:
 
     SENSTimePt _commonSimStartTimePt;
 
-    bool _threadIsRunning = false;
+    std::atomic_bool _threadIsRunning{false};
+    //!index of the next value to feed in fast replay mode
+    int _replayCounter = 0;
 
     const SENSSimClock& _clock;
 
@@ -171,9 +190,15 @@ public:
 
     const SENSCaptureProps& captureProperties() override;
 
+    //!in fast replay mode every call releases the next frame (returns an empty pointer at the end of the replay)
+    SENSFrameBasePtr latestFrame() override;
+
 private:
+    using ReplayStepCB = std::function<bool(void)>;
+
     SENSSimulatedCamera(StartSimCB                                startSimCB,
                         SensorSimStoppedCB                        sensorSimStoppedCB,
+                        ReplayStepCB                              replayStepCB,
                         std::vector<std::pair<SENSTimePt, int>>&& data,
                         std::string                               videoFileName,
                         SENSCameraConfig                          cameraConfig,
@@ -186,11 +211,16 @@ private:
 
     std::string      _videoFileName;
     cv::VideoCapture _cap;
+    //!advances the simulation by one frame in fast replay mode
+    ReplayStepCB _replayStepCB;
 
     cv::Mat    _preparedFrame;
     int        _preparedFrameIndex = -1;
     cv::Mat    _frame;
     std::mutex _frameMutex;
+
+    //!max. number of frames that are skipped with grab instead of setting the frame position
+    static constexpr int _maxGrabSkip = 16;
 };
 
 #endif
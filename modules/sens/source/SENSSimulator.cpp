@@ -1,4 +1,5 @@
 #include "SENSSimulator.h"
+#include <SENSBinaryLog.h>
 
 SENSSimulator::~SENSSimulator()
 {
@@ -53,6 +54,76 @@ SENSTimePt SENSSimulator::now()
     return simNow;
 }
 
+bool SENSSimulator::setFastReplay(bool enable)
+{
+    if (!_clock || _running)
+        return false;
+
+    _clock->setVirtual(enable);
+    return true;
+}
+
+bool SENSSimulator::seek(SENSMicroseconds offset)
+{
+    if (!_clock || !_clock->isVirtual())
+        return false;
+
+    std::lock_guard<std::mutex> lock(_stepMutex);
+    _clock->seek(offset);
+    SENSTimePt seekTimePt = _clock->now();
+    for (int i = 0; i < _activeSensors.size(); ++i)
+        _activeSensors[i]->replaySeek(seekTimePt);
+
+    return true;
+}
+
+bool SENSSimulator::step()
+{
+    if (!_clock || !_clock->isVirtual())
+        return false;
+
+    std::lock_guard<std::mutex> lock(_stepMutex);
+
+    //the camera defines the steps, without camera we step from value to value
+    SENSSimulatedBase* camera = getCameraSensorPtr();
+    SENSTimePt         stepTimePt;
+    bool               found = false;
+    if (camera && camera->isThreadRunning())
+        found = camera->replayNextTimePt(stepTimePt, _frameDecimation);
+    else
+    {
+        for (int i = 0; i < _activeSensors.size(); ++i)
+        {
+            SENSTimePt timePt;
+            if (_activeSensors[i]->replayNextTimePt(timePt, 1) && (!found || timePt < stepTimePt))
+            {
+                stepTimePt = timePt;
+                found      = true;
+            }
+        }
+    }
+
+    if (!found)
+    {
+        //end of recording: stop all sensors like at the end of the simulation threads
+        for (int i = 0; i < _activeSensors.size(); ++i)
+            _activeSensors[i]->replayEnd();
+        return false;
+    }
+
+    _clock->advanceTo(stepTimePt);
+
+    //feed all gps and orientation values in order before the frame
+    for (int i = 0; i < _activeSensors.size(); ++i)
+        if (_activeSensors[i].get() != camera)
+            _activeSensors[i]->replayFeedUntil(stepTimePt, true);
+
+    if (camera)
+        camera->replayFeedUntil(stepTimePt, false);
+
+    return true;
+}
+
 void findSimStartTimePt(SENSTimePt& simStartTimePt, bool& initialized, SENSTimePt tp)
 {
     if (!initialized)
@@ -126,6 +197,7 @@ SENSSimulator::SENSSimulator(const std::string& simDirName)
                     _activeSensors.push_back(std::unique_ptr<SENSSimulatedCamera>(
                       new SENSSimulatedCamera(std::bind(&SENSSimulator::onStart, this),
                                               std::bind(&SENSSimulator::onSensorSimStopped, this),
+                                              std::bind(&SENSSimulator::step, this),
                                               std::move(cameraData),
                                               videoFileName,
                                               cameraConfig,
@@ -184,6 +256,15 @@ void SENSSimulator::onSensorSimStopped()
 
 void SENSSimulator::loadGpsData(const std::string& dirName, std::vector<std::pair<SENSTimePt, SENSGps::Location>>& data)
 {
+    //binary logs of newer recordings are preferred
+    std::string binFileName = dirName + "gps.bin";
+    if (Utils::fileExists(binFileName))
+    {
+        if (SENSBinaryLog::readGps(binFileName, data))
+            return;
+        Utils::log("SENS", "SENSSimulator: Unable to read file: %s", binFileName.c_str());
+    }
+
     std::string gpsFileName = dirName + "gps.txt";
     //check if directory contains gps.txt
     if (Utils::fileExists(gpsFileName))
@@ -221,6 +302,15 @@ void SENSSimulator::loadGpsData(const std::string& dirName, std::vector<std::pai
 
 void SENSSimulator::loadOrientationData(const std::string& dirName, std::vector<std::pair<SENSTimePt, SENSOrientation::Quat>>& data)
 {
+    //binary logs of newer recordings are preferred
+    std::string binFileName = dirName + "orientation.bin";
+    if (Utils::fileExists(binFileName))
+    {
+        if (SENSBinaryLog::readOrientation(binFileName, data))
+            return;
+        Utils::log("SENS", "SENSSimulator: Unable to read file: %s", binFileName.c_str());
+    }
+
     std::string orientationFileName = dirName + "orientation.txt";
     //check if directory contains orientation.txt
     if (Utils::fileExists(orientationFileName))
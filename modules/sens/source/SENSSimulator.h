@@ -4,6 +4,8 @@
 #include <functional>
 #include <memory>
 #include <chrono>
+#include <mutex>
+#include <algorithm>
 
 #include <Utils.h>
 #include <SENSSimulated.h>
@@ -19,6 +21,12 @@
  depending on this time. The idea is to provide sensor data exactly as it was recorded.
  ATTENTION: Simulation time starts, as soon as one simulated sensor was started and is resetted when all simulated
  sensors are stopped.
+ Fast replay: With setFastReplay(true) the simulation time is virtual and only advances with step(). Every step
+ feeds all gps and orientation values up to the next camera frame in time order and then the frame itself, all on
+ the calling thread. A simulated camera calls step() itself in latestFrame(), so a consumer gets the next frame only
+ after it processed the last one. A recording is replayed as fast as the consumer can process it and always
+ produces the same sequence of sensor values. Use setFrameDecimation to process only every n-th frame and seek
+ to start at an offset into the recording.
  */
 class SENSSimulator
 {
@@ -48,6 +56,18 @@ public:
     //!get passed simulation time
     SENSMicroseconds passedTime();
 
+    //!enable the deterministic fast replay mode (returns false if the simulation is running)
+    bool setFastReplay(bool enable);
+    bool isFastReplay() const { return _clock && _clock->isVirtual(); }
+    //!in fast replay mode feed only every n-th camera frame (n >= 1)
+    void setFrameDecimation(int n) { _frameDecimation = std::max(1, n); }
+    int  frameDecimation() const { return _frameDecimation; }
+    //!in fast replay mode move the replay position to an offset from the start of the recording
+    bool seek(SENSMicroseconds offset);
+    //!in fast replay mode feed the values up to the next camera frame (or the next value without camera).
+    //!Returns false at the end of the recording.
+    bool step();
+
 private:
     template<typename T>
     T* getActiveSensor()
@@ -80,6 +100,11 @@ private:
     std::unique_ptr<SENSSimClock> _clock;
     //!flags if simulator is currently running
     std::atomic_bool _running{false};
+
+    //!feed only every n-th camera frame in fast replay mode
+    int _frameDecimation = 1;
+    //!serializes step and seek in fast replay mode
+    std::mutex _stepMutex;
 };
 
 #endif
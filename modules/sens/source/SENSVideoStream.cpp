@@ -9,23 +9,25 @@ SENSVideoStream::SENSVideoStream(const std::string& videoFileName,
                                  bool               videoLoops,
                                  bool               mirrorH,
                                  bool               mirrorV,
-                                 float              targetFps)
+                                 float              targetFps,
+                                 int                prefetchSize,
+                                 size_t             cacheSizeMB)
   : _videoLoops(videoLoops),
     _mirrorH(mirrorH),
-    _mirrorV(mirrorV)
+    _mirrorV(mirrorV),
+    _cacheSizeMB(cacheSizeMB)
 {
     if (!Utils::fileExists(videoFileName))
     {
         throw SENSException(SENSType::VIDEO, "Video file does not exist: " + videoFileName, __LINE__, __FILE__);
     }
 
-    _cap.open(videoFileName);
-    if (!_cap.isOpened())
+    if (!_decoder.open(videoFileName, prefetchSize, cacheSizeMB))
         throw SENSException(SENSType::VIDEO, "Could not open video file stream: " + videoFileName, __LINE__, __FILE__);
 
-    _videoFrameSize = {(int)_cap.get(cv::CAP_PROP_FRAME_WIDTH), (int)_cap.get(cv::CAP_PROP_FRAME_HEIGHT)};
-    _frameCount     = (int)_cap.get(cv::CAP_PROP_FRAME_COUNT);
-    _fps            = (float)_cap.get(cv::CAP_PROP_FPS);
+    _videoFrameSize = _decoder.frameSize();
+    _frameCount     = _decoder.frameCount();
+    _fps            = _decoder.fps();
 
     if (targetFps == 0)
         _targetFps = _fps;
@@ -37,23 +39,23 @@ SENSVideoStream::SENSVideoStream(const std::string& videoFileName,
 
 SENSFramePtr SENSVideoStream::grabNextFrame()
 {
-    if (!_cap.isOpened())
+    if (!_decoder.isOpened())
         throw SENSException(SENSType::VIDEO, "Video file stream is not open!", __LINE__, __FILE__);
 
     if (_videoLoops)
     {
-        if (_cap.get(cv::CAP_PROP_POS_FRAMES) == _frameCount)
-            _cap.set(cv::CAP_PROP_POS_FRAMES, 0);
+        if (_decoder.nextFrameIndex() >= _frameCount)
+            _decoder.seek(0);
     }
 
     SENSFramePtr sensFrame;
     cv::Mat      bgrImg;
     cv::Mat      grayImg;
+    cv::Mat      intrinsics;
 
-    if (_cap.read(bgrImg))
+    if (readFrame(bgrImg))
     {
-        SENS::mirrorImage(bgrImg, _mirrorH, _mirrorV);
-        cv::cvtColor(bgrImg, grayImg, cv::COLOR_BGR2GRAY);
+        processFrame(bgrImg, grayImg, intrinsics);
 
         sensFrame = std::make_unique<SENSFrame>(
           SENSClock::now(),
@@ -62,7 +64,7 @@ SENSFramePtr SENSVideoStream::grabNextFrame()
           _mirrorH,
           _mirrorV,
           1.0f,
-          cv::Mat(),
+          intrinsics,
           bgrImg.cols,
           bgrImg.rows);
     }
@@ -72,13 +74,13 @@ SENSFramePtr SENSVideoStream::grabNextFrame()
 
 SENSFramePtr SENSVideoStream::grabNextResampledFrame()
 {
-    if (!_cap.isOpened())
+    if (!_decoder.isOpened())
         throw SENSException(SENSType::VIDEO, "Video file stream is not open!", __LINE__, __FILE__);
 
     if (_videoLoops)
     {
-        if (_cap.get(cv::CAP_PROP_POS_FRAMES) == _frameCount)
-            _cap.set(cv::CAP_PROP_POS_FRAMES, 0);
+        if (_decoder.nextFrameIndex() >= _frameCount)
+            _decoder.seek(0);
     }
 
     SENSFramePtr sensFrame;
@@ -86,7 +88,7 @@ SENSFramePtr SENSVideoStream::grabNextResampledFrame()
     cv::Mat      grayImg;
 
     float frameDuration = 1.0f / _targetFps;
-    int   frameIndex    = (int)_cap.get(cv::CAP_PROP_POS_FRAMES);
+    int   frameIndex    = _decoder.nextFrameIndex();
     int   skippedFrame  = 0;
     float frameTime;
     float lastFrameTime = frameIndex / _fps;
@@ -106,10 +108,10 @@ SENSFramePtr SENSVideoStream::grabNextResampledFrame()
 
     moveCapturePosition(skippedFrame);
 
-    if (_cap.read(bgrImg))
+    if (readFrame(bgrImg))
     {
-        SENS::mirrorImage(bgrImg, _mirrorH, _mirrorV);
-        cv::cvtColor(bgrImg, grayImg, cv::COLOR_BGR2GRAY);
+        cv::Mat intrinsics;
+        processFrame(bgrImg, grayImg, intrinsics);
 
         sensFrame = std::make_unique<SENSFrame>(
           SENSClock::now(),
@@ -118,7 +120,7 @@ SENSFramePtr SENSVideoStream::grabNextResampledFrame()
           _mirrorH,
           _mirrorV,
           1.0,
-          cv::Mat(),
+          intrinsics,
           bgrImg.cols,
           bgrImg.rows);
     }
@@ -128,7 +130,7 @@ SENSFramePtr SENSVideoStream::grabNextResampledFrame()
 
 SENSFramePtr SENSVideoStream::grabPreviousResampledFrame()
 {
-    int   frameIndex   = (int)_cap.get(cv::CAP_PROP_POS_FRAMES);
+    int   frameIndex   = _decoder.nextFrameIndex();
     int   skippedFrame = 0;
     float frameTime;
     float currentFrameTime = frameIndex / _fps;
@@ -151,7 +153,7 @@ SENSFramePtr SENSVideoStream::grabPreviousFrame()
 
 void SENSVideoStream::moveCapturePosition(int n)
 {
-    int frameIndex = (int)_cap.get(cv::CAP_PROP_POS_FRAMES);
+    int frameIndex = _decoder.nextFrameIndex();
     frameIndex += n;
 
     if (frameIndex < 0)
@@ -159,12 +161,61 @@ void SENSVideoStream::moveCapturePosition(int n)
     else if (frameIndex > _frameCount)
         frameIndex = _frameCount;
 
-    _cap.set(cv::CAP_PROP_POS_FRAMES, frameIndex);
+    _decoder.seek(frameIndex);
+}
+
+bool SENSVideoStream::readFrame(cv::Mat& bgrImg)
+{
+    if (!_decoder.read(bgrImg))
+        return false;
+
+    //cached frames are shared with the decoder and must not be changed by consumers
+    if (_cacheSizeMB > 0)
+        bgrImg = bgrImg.clone();
+
+    //the exact frame count is known after the first pass
+    _frameCount = _decoder.frameCount();
+    return true;
+}
+
+void SENSVideoStream::processFrame(cv::Mat& bgrImg, cv::Mat& grayImg, cv::Mat& intrinsics)
+{
+    SENS::mirrorImage(bgrImg, _mirrorH, _mirrorV);
+
+    if (_undistort && _calibration)
+    {
+        //one pass for undistortion, crop, resize and gray conversion
+        cv::Mat undistorted;
+        if (_undistortMap.apply(_calibration->cameraMat(),
+                                _calibration->distortion(),
+                                _calibration->cameraMatUndistorted(),
+                                bgrImg,
+                                _undistortCrop,
+                                _undistortTargetSize,
+                                undistorted,
+                                &grayImg))
+        {
+            bgrImg     = undistorted;
+            intrinsics = _undistortMap.targetCameraMat();
+            return;
+        }
+    }
+
+    cv::cvtColor(bgrImg, grayImg, cv::COLOR_BGR2GRAY);
+}
+
+void SENSVideoStream::setUndistortion(bool undistort, const cv::Size& targetSize, const cv::Rect& crop)
+{
+    _undistort           = undistort;
+    _undistortTargetSize = targetSize;
+    _undistortCrop       = crop;
+    if (!undistort)
+        _undistortMap.clear();
 }
 
 void SENSVideoStream::setCalibration(SENSCalibration calibration, bool buildUndistortionMaps)
 {
-    if (!_cap.isOpened())
+    if (!_decoder.isOpened())
         throw SENSException(SENSType::CAM, "setCalibration not possible if video stream is not started!", __LINE__, __FILE__);
 
     _calibration = std::make_unique<SENSCalibration>(calibration);
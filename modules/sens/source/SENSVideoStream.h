@@ -4,11 +4,26 @@
 #include <opencv2/opencv.hpp>
 #include "SENSFrame.h"
 #include "SENSCalibration.h"
+#include <CVVideoDecoder.h>
+#include <CVUndistortMap.h>
 
+/*! SENSVideoStream
+ Reads frames of a video file. The frames are decoded ahead on a decode thread by CVVideoDecoder.
+ Moving the capture position only repositions the decoder for larger or backward jumps. With a
+ cacheSizeMB greater than zero decoded frames are cached, so replayed segments are not decoded again.
+ With setUndistortion the frames are undistorted, cropped and resized in one remap pass that also produces
+ the gray image. The remap tables are cached and follow changes of the calibration.
+ */
 class SENSVideoStream
 {
 public:
-    SENSVideoStream(const std::string& videoFileName, bool videoLoops, bool mirrorH, bool mirrorV, float targetFps = 0);
+    SENSVideoStream(const std::string& videoFileName,
+                    bool               videoLoops,
+                    bool               mirrorH,
+                    bool               mirrorV,
+                    float              targetFps    = 0,
+                    int                prefetchSize = 8,
+                    size_t             cacheSizeMB  = 0);
     SENSFramePtr grabNextFrame();
     SENSFramePtr grabNextResampledFrame();
     SENSFramePtr grabPreviousResampledFrame();
@@ -17,11 +32,11 @@ public:
     cv::Size getFrameSize() const { return _videoFrameSize; }
 
     const std::string& videoFilename() const { return _videoFileName; }
-    int                nextFrameIndex() const { return (int)_cap.get(cv::CAP_PROP_POS_FRAMES); }
+    int                nextFrameIndex() const { return _decoder.nextFrameIndex(); }
     int                frameCount() const { return _frameCount; }
     float              fps() const { return _fps; }
 
-    bool isOpened() const { return _cap.isOpened(); }
+    bool isOpened() const { return _decoder.isOpened(); }
 
     const SENSCalibration* const calibration() const
     {
@@ -30,11 +45,16 @@ public:
 
     void setCalibration(SENSCalibration calibration, bool buildUndistortionMaps);
     void guessAndSetCalibration(float fovGuess);
+    //!undistort, crop and resize frames with the calibration in one pass (empty crop = full image, empty size = crop size)
+    void setUndistortion(bool undistort, const cv::Size& targetSize = cv::Size(), const cv::Rect& crop = cv::Rect());
 
 private:
     void moveCapturePosition(int n);
+    bool readFrame(cv::Mat& bgrImg);
+    void processFrame(cv::Mat& bgrImg, cv::Mat& grayImg, cv::Mat& intrinsics);
 
-    cv::VideoCapture _cap;
+    CVVideoDecoder   _decoder;
+    size_t           _cacheSizeMB = 0;
     cv::Size2i       _videoFrameSize;
     int              _frameCount = 0;
     std::string      _videoFileName;
@@ -47,6 +67,11 @@ private:
     bool _mirrorV = false;
 
     std::unique_ptr<SENSCalibration> _calibration;
+
+    bool           _undistort = false;
+    cv::Size       _undistortTargetSize;
+    cv::Rect       _undistortCrop;
+    CVUndistortMap _undistortMap;
 };
 
 #endif //SENS_VIDEOSTREAM_H
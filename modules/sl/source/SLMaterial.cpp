@@ -494,6 +494,37 @@ void SLMaterial::generateProgramPS(bool drawInstanced)
     }
 }
 //-----------------------------------------------------------------------------
+/*!
+ If this material has not yet a shader program assigned (SLMaterial::_program)
+ a suitable program will be generated with an instance of SLGLProgramGenerated.
+ The program is not yet compiled. This is done at its first use or in
+ SLScene::warmUpPrograms.
+ @param lights Pointer to the scene vector of lights
+ @param supportGPUSkinning flag if skinning in shader should be supported
+ */
+void SLMaterial::generateProgram(SLVLight* lights, SLbool supportGPUSkinning)
+{
+    // A 3D object can be stored without material or shader program information.
+    if (!_program)
+    {
+        // Check first the asset manager if the requested program type already exists
+        string programName;
+        SLGLProgramGenerated::buildProgramName(this,
+                                               lights,
+                                               supportGPUSkinning,
+                                               programName);
+        _program = _assetManager->getProgramByName(programName);
+
+        // If the program was not found by name generate a new one
+        if (!_program)
+            _program = new SLGLProgramGenerated(_assetManager,
+                                                programName,
+                                                this,
+                                                lights,
+                                                supportGPUSkinning);
+    }
+}
+//-----------------------------------------------------------------------------
 /*!
  SLMaterial::activate activates this material for rendering if it is not yet
  the active one and set as SLGLState::currentMaterial. If this material has
@@ -522,25 +553,7 @@ void SLMaterial::activate(SLCamera* cam,
     stateGL->currentMaterial(this);
 
     // If no shader program is attached add a generated shader program
-    // A 3D object can be stored without material or shader program information.
-    if (!_program)
-    {
-        // Check first the asset manager if the requested program type already exists
-        string programName;
-        SLGLProgramGenerated::buildProgramName(this,
-                                               lights,
-                                               supportGPUSkinning,
-                                               programName);
-        _program = _assetManager->getProgramByName(programName);
-
-        // If the program was not found by name generate a new one
-        if (!_program)
-            _program = new SLGLProgramGenerated(_assetManager,
-                                                programName,
-                                                this,
-                                                lights,
-                                                supportGPUSkinning);
-    }
+    generateProgram(lights, supportGPUSkinning);
 
     // Check if shader had a compile error and the error texture should be shown
     if (_program && _program->name().find("ErrorTex") != string::npos)
@@ -116,6 +116,7 @@ public:
 
     ~SLMaterial() override;
     void  generateProgramPS(bool drawInstanced = false);
+    void  generateProgram(SLVLight* lights, SLbool supportGPUSkinning);
     void  activate(SLCamera* cam, SLVLight* lights, SLbool supportGPUSkinning);
     SLint passToUniforms(SLGLProgram* program, SLint nextTexUnit);
 
@@ -13,7 +13,9 @@
 #include <SLKeyframeCamera.h>
 #include <SLGLProgramManager.h>
 #include <SLSkybox.h>
+#include <SLParticleSystem.h>
 #include <GlobalTimer.h>
+#include <HighResTimer.h>
 #include <Profiler.h>
 #include <SLEntities.h>
 
@@ -349,6 +351,50 @@ void SLScene::deselectAllNodesAndMeshes()
     _selectedMeshes.clear();
 }
 //-----------------------------------------------------------------------------
+/*! Generates and initializes the shader programs of all meshes in the 3D
+scene graph. Programs in the program binary cache get loaded, all others get
+compiled and linked now instead of during the first frames they are visible.
+Must be called in the main thread with a current OpenGL context after the
+scene assembly. Particle systems generate their programs when drawn.
+*/
+void SLScene::warmUpPrograms()
+{
+    PROFILE_FUNCTION();
+
+    if (!_root3D) return;
+
+    HighResTimer   timer;
+    SLint          numPrograms = 0;
+    deque<SLNode*> nodes       = {_root3D};
+
+    while (!nodes.empty())
+    {
+        SLNode* node = nodes.front();
+        nodes.pop_front();
+        for (SLNode* child : node->children())
+            nodes.push_back(child);
+
+        SLMesh* mesh = node->mesh();
+        if (!mesh || !mesh->mat() || dynamic_cast<SLParticleSystem*>(mesh))
+            continue;
+
+        SLMaterial* mat = mesh->mat();
+        if (!mat->program() && !mat->assetManager())
+            continue;
+
+        mat->generateProgram(&_lights, !mesh->Ji.empty() && !mesh->Jw.empty());
+
+        SLGLProgram* program = mat->program();
+        if (program && !program->progID() && !program->shaders().empty())
+        {
+            program->init(&_lights);
+            numPrograms++;
+        }
+    }
+
+    SL_LOG("Warm up programs : %d in %.1f ms", numPrograms, timer.elapsedTimeInMilliSec());
+}
+//-----------------------------------------------------------------------------
 //! Returns the number of camera nodes in the scene
 SLint SLScene::numSceneCameras()
 {
@@ -134,6 +134,7 @@ public:
                           bool forceCPUSkinning);
     void         init(SLAssetManager* am);
     virtual void unInit();
+    void         warmUpPrograms();
     void         selectNodeMesh(SLNode* nodeToSelect, SLMesh* meshToSelect);
     void         deselectAllNodesAndMeshes();
 
@@ -10,10 +10,13 @@
 #include <SLAssetManager.h>
 #include <SLGLDepthBuffer.h>
 #include <SLGLProgram.h>
+#include <SLGLProgramManager.h>
 #include <SLGLShader.h>
 #include <SLGLState.h>
 #include <SLScene.h>
 #include <SLSkybox.h>
+#include <SLFileStorage.h>
+#include <cstring>
 
 //-----------------------------------------------------------------------------
 // Error Strings defined in SLGLShader.h
@@ -68,7 +71,8 @@ SLGLProgram::~SLGLProgram()
     // SL_LOG("~SLGLProgram");
     for (auto shader : _shaders)
     {
-        if (_isLinked)
+        // shaders of a program loaded from a binary are not compiled
+        if (_isLinked && shader->_shaderID)
         {
             glDetachShader(_progID, shader->_shaderID);
             GET_GL_ERROR;
@@ -99,8 +103,11 @@ void SLGLProgram::deleteDataGpu()
     {
         for (auto shader : _shaders)
         {
-            glDetachShader(_progID, shader->_shaderID);
-            GET_GL_ERROR;
+            if (shader->_shaderID)
+            {
+                glDetachShader(_progID, shader->_shaderID);
+                GET_GL_ERROR;
+            }
         }
         _isLinked = false;
     }
@@ -134,7 +141,7 @@ void SLGLProgram::initTF(const char* writeBackAttrib[], int size)
     {
         for (auto* shader : _shaders)
         {
-            if (_isLinked)
+            if (_isLinked && shader->_shaderID)
             {
                 glDetachShader(_progID, shader->_shaderID);
                 GET_GL_ERROR;
@@ -220,7 +227,8 @@ void SLGLProgram::initTF(const char* writeBackAttrib[], int size)
 /*! SLGLProgram::init creates the OpenGL shader program object, compiles all
 shader objects and attaches them to the shader program. At the end all shaders
 are linked. If a shader fails to compile a simple texture only shader is
-compiled that shows an error message in the texture.
+compiled that shows an error message in the texture. If the program binary
+is in the program binary cache it is loaded instead of compiled and linked.
 */
 void SLGLProgram::init(SLVLight* lights)
 {
@@ -233,7 +241,7 @@ void SLGLProgram::init(SLVLight* lights)
     {
         for (auto* shader : _shaders)
         {
-            if (_isLinked)
+            if (_isLinked && shader->_shaderID)
             {
                 glDetachShader(_progID, shader->_shaderID);
                 GET_GL_ERROR;
@@ -242,6 +250,19 @@ void SLGLProgram::init(SLVLight* lights)
         _isLinked = false;
     }
 
+    // try to load the program from the program binary cache
+    SLstring cacheFile = binaryCacheFile(lights);
+    if (!cacheFile.empty() && loadBinary(cacheFile))
+    {
+        _isLinked = true;
+
+        // if name is empty concatenate shader names
+        if (_name.empty())
+            for (auto* shader : _shaders)
+                _name += shader->name() + ", ";
+        return;
+    }
+
     // compile all shader objects
     SLbool allSuccuessfullyCompiled = true;
     for (auto* shader : _shaders)
@@ -284,6 +305,11 @@ void SLGLProgram::init(SLVLight* lights)
         SL_EXIT_MSG("No successfully compiled shaders attached!");
     }
 
+#ifndef SL_EMSCRIPTEN
+    if (!cacheFile.empty())
+        glProgramParameteri(_progID, GL_PROGRAM_BINARY_RETRIEVABLE_HINT, GL_TRUE);
+#endif
+
     int linked = 0;
     glLinkProgram(_progID);
     GET_GL_ERROR;
@@ -298,6 +324,9 @@ void SLGLProgram::init(SLVLight* lights)
         if (_name.empty())
             for (auto* shader : _shaders)
                 _name += shader->name() + ", ";
+
+        if (!cacheFile.empty())
+            saveBinary(cacheFile);
     }
     else
     {
@@ -312,6 +341,107 @@ void SLGLProgram::init(SLVLight* lights)
     }
 }
 //-----------------------------------------------------------------------------
+/*! Returns the file of the program binary cache for the current shader code
+or an empty string if the cache is not available. The cache needs a config
+path and a driver with at least one program binary format (not in WebGL).
+*/
+SLstring SLGLProgram::binaryCacheFile(SLVLight* lights)
+{
+#ifndef SL_EMSCRIPTEN
+    if (SLGLProgramManager::configPath.empty() || _shaders.empty())
+        return "";
+
+    SLint numFormats = 0;
+    glGetIntegerv(GL_NUM_PROGRAM_BINARY_FORMATS, &numFormats);
+    GET_GL_ERROR;
+    if (numFormats < 1)
+        return "";
+
+    // FNV-1a hash over the final code of all shaders and the driver
+    SLGLState* stateGL = SLGLState::instance();
+    SLstring   key;
+    for (auto* shader : _shaders)
+        key += shader->finalCode(lights);
+    key += stateGL->glVendor();
+    key += stateGL->glRenderer();
+    key += stateGL->glVersion();
+    uint64_t hash = Utils::hashFNV1a(key.data(), key.size());
+
+    char hex[17];
+    snprintf(hex, sizeof(hex), "%016llx", (unsigned long long)hash);
+    return SLGLProgramManager::configPath + "cache/programs/" + hex + ".bin";
+#else
+    return "";
+#endif
+}
+//-----------------------------------------------------------------------------
+/*! Loads the program binary from the cache file. Returns false if the file
+does not exist or the driver rejects the binary (e.g. after a driver update).
+The cache file starts with the binary format as 32-bit integer.
+*/
+SLbool SLGLProgram::loadBinary(const SLstring& cacheFile)
+{
+#ifndef SL_EMSCRIPTEN
+    if (!SLFileStorage::exists(cacheFile, IOK_config))
+        return false;
+
+    SLIOView view   = SLFileStorage::readIntoView(cacheFile, IOK_config);
+    SLint    linked = 0;
+    if (view.size > sizeof(GLenum))
+    {
+        GLenum format;
+        memcpy(&format, view.data, sizeof(GLenum));
+        glProgramBinary(_progID,
+                        format,
+                        view.data + sizeof(GLenum),
+                        (GLsizei)(view.size - sizeof(GLenum)));
+        glGetProgramiv(_progID, GL_LINK_STATUS, &linked);
+    }
+    view.release();
+
+    // clear a possible error of a rejected binary
+    while (glGetError() != GL_NO_ERROR) {}
+
+    if (!linked)
+    {
+        SL_LOG("Program binary rejected: %s", cacheFile.c_str());
+        Utils::removeFile(cacheFile);
+        return false;
+    }
+    return true;
+#else
+    return false;
+#endif
+}
+//-----------------------------------------------------------------------------
+//! Writes the binary of the linked program into the cache file
+void SLGLProgram::saveBinary(const SLstring& cacheFile)
+{
+#ifndef SL_EMSCRIPTEN
+    SLint length = 0;
+    glGetProgramiv(_progID, GL_PROGRAM_BINARY_LENGTH, &length);
+    GET_GL_ERROR;
+    if (length <= 0)
+        return;
+
+    SLstring data(sizeof(GLenum) + (size_t)length, '\0');
+    GLenum   format = 0;
+    glGetProgramBinary(_progID,
+                       length,
+                       nullptr,
+                       &format,
+                       &data[sizeof(GLenum)]);
+    GET_GL_ERROR;
+    memcpy(&data[0], &format, sizeof(GLenum));
+
+    SLstring dir = Utils::getPath(cacheFile);
+    if (!Utils::dirExists(dir))
+        Utils::makeDirRecurse(dir);
+
+    SLFileStorage::writeString(cacheFile, IOK_config, data);
+#endif
+}
+//-----------------------------------------------------------------------------
 /*! SLGLProgram::useProgram inits the first time the program and then uses it.
 Call this initialization if you pass your own custom uniform variables.
 */
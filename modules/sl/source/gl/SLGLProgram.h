@@ -48,6 +48,11 @@ node for execution. An SLGLProgram object can hold an vector of uniform
 variable that can transfer variables from the CPU program to the GPU program.
 For more details on GLSL please refer to official GLSL documentation and to
 SLGLShader.<br>
+Linked programs are stored as program binaries in the folder cache/programs
+of SLGLProgramManager::configPath. The cache file name is a hash over the
+final shader code and the OpenGL vendor, renderer and version strings, so a
+changed shader or driver never loads a stale binary. A program found in the
+cache is loaded with glProgramBinary without compiling and linking.<br>
 All shader files are located in the directory data/shaders. For OSX, iOS and
 Android applications they are copied to the appropriate file system locations.
 */
@@ -86,6 +91,7 @@ public:
 
     // Getters
     SLuint       progID() const { return _progID; }
+    SLbool       isLinked() const { return _isLinked; }
     SLVGLShader& shaders() { return _shaders; }
 
     // Variable location getters
@@ -138,6 +144,10 @@ public:
                            GLboolean      transpose = false) const;
 
 protected:
+    SLstring binaryCacheFile(SLVLight* lights);
+    SLbool   loadBinary(const SLstring& cacheFile);
+    void     saveBinary(const SLstring& cacheFile);
+
     SLuint       _progID;     //!< OpenGL shader program object ID
     SLbool       _isLinked;   //!< Flag if program is linked
     SLVGLShader  _shaders;    //!< Vector of all shader objects
@@ -79,6 +79,22 @@ SLGLShader::~SLGLShader()
     GET_GL_ERROR;
 }
 //-----------------------------------------------------------------------------
+/*! Returns the code that gets compiled: the GLSL version statement followed
+by the code with the resolved define pragmas.
+*/
+SLstring SLGLShader::finalCode(SLVLight* lights)
+{
+    // Build version string as the first statement
+    SLGLState* state      = SLGLState::instance();
+    SLstring   verGLSL    = state->glSLVersionNO();
+    SLstring   srcVersion = "#version " + verGLSL;
+    if (state->glIsES3()) srcVersion += " es";
+    srcVersion += "\n";
+
+    // Concatenate final code string
+    return srcVersion + preprocessDefinePragmas(_code, lights);
+}
+//-----------------------------------------------------------------------------
 //! SLGLShader::createAndCompile creates & compiles the OpenGL shader object
 /*!
 @return true if compilation was successful
@@ -119,17 +135,7 @@ SLbool SLGLShader::createAndCompile(SLVLight* lights)
     }
     GET_GL_ERROR;
 
-    // Build version string as the first statement
-    SLGLState* state      = SLGLState::instance();
-    SLstring   verGLSL    = state->glSLVersionNO();
-    SLstring   srcVersion = "#version " + verGLSL;
-    if (state->glIsES3()) srcVersion += " es";
-    srcVersion += "\n";
-
-    _code = preprocessDefinePragmas(_code, lights);
-
-    // Concatenate final code string
-    _code = srcVersion + _code;
+    _code = finalCode(lights);
 
     const char* src = _code.c_str();
     glShaderSource(_shaderID, 1, &src, nullptr);
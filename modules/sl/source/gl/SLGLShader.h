@@ -47,6 +47,7 @@ public:
 
 private:
     SLbool   createAndCompile(SLVLight* lights);
+    SLstring finalCode(SLVLight* lights);
     SLstring preprocessIncludePragmas(SLstring inCode);
     SLstring preprocessDefinePragmas(SLstring inCode, SLVLight* lights);
 
@@ -15,6 +15,10 @@
 #include "SLFileStorage.h"
 #include <Utils.h>
 #include <Profiler.h>
+#include <HighResTimer.h>
+#include <cstring>
+#include <cstdio>
+#include <thread>
 
 #ifdef SL_HAS_OPTIX
 #    include <cuda.h>
@@ -29,6 +33,17 @@ SLfloat SLGLTexture::maxAnisotropy = -1.0f;
 
 //! NO. of texture byte allocated on GPU
 SLuint SLGLTexture::totalNumBytesOnGPU = 0;
+
+//! The KTX2 texture cache is off by default
+SLstring SLGLTexture::ktxCachePath;
+
+//! Texture streaming is off by default
+SLbool                SLGLTexture::streamingEnabled     = false;
+SLuint                SLGLTexture::streamBytesPerFrame  = 4 * 1024 * 1024;
+SLuint                SLGLTexture::streamGPUBudgetBytes = 0;
+vector<SLGLTexture*> SLGLTexture::_streamedTextures;
+SLuint                SLGLTexture::_streamFrameNo = 0;
+SLuint                SLGLTexture::_streamPBO     = 0;
 //-----------------------------------------------------------------------------
 /*! Default ctor for all stack instances such as the video textures in SLScene
 or the textures inherited by SLRaytracer. All other constructors add the this
@@ -196,7 +211,12 @@ SLGLTexture::SLGLTexture(SLAssetManager* assetMgr,
 
     _texType = type == TT_unknown ? detectType(filename) : type;
 
-    load(filename);
+    // Load the image transcoded to KTX2 from the cache if possible
+#ifdef SL_BUILD_WITH_KTX
+    SLstring ktxFile = ktxCacheFile(filename);
+    if (ktxFile.empty() || !loadKTX2(ktxFile))
+#endif
+        load(filename);
 
     if (!_images.empty())
     {
@@ -213,7 +233,7 @@ SLGLTexture::SLGLTexture(SLAssetManager* assetMgr,
         _width       = _ktxTexture->baseWidth;
         _height      = _ktxTexture->baseHeight;
         _depth       = _ktxTexture->numDimensions == 3 ? _ktxTexture->baseDepth : 1;
-        _bytesInFile = Utils::getFileSize(filename);
+        _bytesInFile = Utils::getFileSize(ktxFile.empty() ? filename : ktxFile);
 #endif
     }
 
@@ -231,6 +251,15 @@ SLGLTexture::SLGLTexture(SLAssetManager* assetMgr,
     _bytesOnGPU            = 0;
     _deleteImageAfterBuild = false;
 
+    // Build the mip levels for the streaming here on the loader thread
+    if (streamingEnabled &&
+        _images.size() == 1 &&
+        _texType != TT_hdr &&
+        _min_filter >= GL_NEAREST_MIPMAP_NEAREST &&
+        _images[0]->cvMat().depth() == CV_8U &&
+        std::max(_width, _height) > _streamTailSize)
+        CVImage::buildMipmaps(_images[0]->cvMat(), _mipLevels);
+
 #ifdef SL_HAS_OPTIX
     _cudaGraphicsResource = nullptr;
     _cudaTextureObject    = 0;
@@ -556,6 +585,10 @@ void SLGLTexture::deleteImages()
         img = nullptr;
     }
     _images.clear();
+
+    // Without the CPU mip levels there is nothing left to stream
+    _mipLevels.clear();
+    stopStreaming();
 }
 //-----------------------------------------------------------------------------
 //! Deletes the OpenGL texture objects and releases the memory on the GPU
@@ -565,6 +598,19 @@ void SLGLTexture::deleteDataGpu()
 {
     glDeleteTextures(1, &_texID);
     _texID = 0;
+
+    if (_pboIDs[0])
+    {
+        glDeleteBuffers(2, _pboIDs);
+        _pboIDs[0] = _pboIDs[1] = 0;
+        _pboBytes               = 0;
+        _pboFilled              = -1;
+    }
+
+    stopStreaming();
+    if (_streamedTextures.empty())
+        deleteStreamPBO();
+
     totalNumBytesOnGPU -= _bytesOnGPU;
     _bytesOnGPU = 0;
     _vaoSprite.clearAttribs();
@@ -595,68 +641,11 @@ void SLGLTexture::load(const SLstring& filename,
     if (ext == "ktx2")
     {
 #ifdef SL_BUILD_WITH_KTX
-        _ktxFileName       = filename;
-        _compressedTexture = true;
-
-        SLIOBuffer     buffer = SLFileStorage::readIntoBuffer(filename, IOK_image);
-        KTX_error_code error  = ktxTexture_CreateFromMemory(buffer.data,
-                                                           buffer.size,
-                                                           KTX_TEXTURE_CREATE_NO_FLAGS,
-                                                           (ktxTexture**)&_ktxTexture);
-        // KTX apparently takes ownership of the data, so no deallocation
-
-        if (error != KTX_SUCCESS)
+        if (!loadKTX2(filename))
         {
-            string errStr = "Error in SLGLTexture::load: " +
-                            ktxErrorStr(error) + " in file: " + filename;
+            string errStr = "Error in SLGLTexture::load: Failed to load KTX2 file: " + filename;
             SL_EXIT_MSG(errStr.c_str());
         }
-
-#    ifdef SL_EMSCRIPTEN
-        // WebGL doesn't support generating mipmaps for compressed textures
-        _ktxTexture->generateMipmaps = false;
-#    endif
-
-        if (ktxTexture2_NeedsTranscoding(_ktxTexture))
-        {
-#    if 0
-            // NOTE(dgj1): The following lines are for reading out supported compressed texture formats 
-            // from the openGL driver. I have the suspicion that the enabled compression format (KTX_TTF_ETC2_RGBA)
-            // is not supported on the tested device and that the reason the textures are not displayed on
-            // these devices is this. However, this could not be verified.
-            GLint numCompressedTextureFormats = 0;
-            glGetIntegerv(GL_NUM_COMPRESSED_TEXTURE_FORMATS, &numCompressedTextureFormats);
-            std::vector<GLint> compressedTextureFormats(numCompressedTextureFormats, 0);
-            glGetIntegerv(GL_COMPRESSED_TEXTURE_FORMATS, &compressedTextureFormats[0]);
-#    endif
-
-#    if defined(SL_OS_MACIOS)
-            _compressionFormat = KTX_TTF_PVRTC1_4_RGB;
-#    elif defined(SL_OS_ANDROID)
-            _compressionFormat = KTX_TTF_ETC2_RGBA;
-#    elif defined(SL_EMSCRIPTEN)
-            // The executable might run on desktop or on mobile, so we have to check
-            // the available compression extensions to pick the right format.
-            if (SLGLState::instance()->hasExtension("WEBGL_compressed_texture_s3tc"))
-                _compressionFormat = KTX_TTF_BC3_RGBA;
-            else if (SLGLState::instance()->hasExtension("WEBGL_compressed_texture_etc"))
-                _compressionFormat = KTX_TTF_ETC2_RGBA;
-            else
-                SL_EXIT_MSG("No valid compression format found for this WebGL context");
-#    else
-            _compressionFormat = KTX_TTF_BC3_RGBA;
-#    endif
-            error = ktxTexture2_TranscodeBasis(_ktxTexture, _compressionFormat, 0);
-
-            if (error != KTX_SUCCESS || _ktxTexture->pData == nullptr)
-            {
-                string errStr = "Error in SLGLTexture::load: " +
-                                ktxErrorStr(error) +
-                                "\nwhile transcoding file: " + filename +
-                                "\nto format: " + compressionFormatStr(_compressionFormat);
-                SL_EXIT_MSG(errStr.c_str());
-            }
-        }
 #else
         SL_EXIT_MSG("Ktx files are not supported. You have to build with SL_BUILD_WITH_KTX flag enabled.");
 #endif
@@ -669,6 +658,105 @@ void SLGLTexture::load(const SLstring& filename,
         _images.push_back(image);
     }
 }
+#ifdef SL_BUILD_WITH_KTX
+//-----------------------------------------------------------------------------
+/*! Loads a KTX2 file. Basis Universal compressed files get transcoded into the
+best compression format of the GPU (see bestCompressionFormat). Returns false
+with a log message on errors.
+*/
+SLbool SLGLTexture::loadKTX2(const SLstring& filename)
+{
+    SLIOBuffer     buffer = SLFileStorage::readIntoBuffer(filename, IOK_image);
+    KTX_error_code error  = ktxTexture_CreateFromMemory(buffer.data,
+                                                       buffer.size,
+                                                       KTX_TEXTURE_CREATE_NO_FLAGS,
+                                                       (ktxTexture**)&_ktxTexture);
+    // KTX apparently takes ownership of the data, so no deallocation
+
+    if (error != KTX_SUCCESS)
+    {
+        SL_LOG("SLGLTexture::loadKTX2: %s in file: %s",
+               ktxErrorStr(error).c_str(),
+               filename.c_str());
+        _ktxTexture = nullptr;
+        return false;
+    }
+
+#    ifdef SL_EMSCRIPTEN
+    // WebGL doesn't support generating mipmaps for compressed textures
+    _ktxTexture->generateMipmaps = false;
+#    endif
+
+    if (ktxTexture2_NeedsTranscoding(_ktxTexture))
+    {
+        SLbool hasAlpha    = ktxTexture2_GetNumComponents(_ktxTexture) == 4;
+        _compressionFormat = (ktx_transcode_fmt_e)bestCompressionFormat(hasAlpha,
+                                                                        (SLint)_ktxTexture->baseWidth,
+                                                                        (SLint)_ktxTexture->baseHeight);
+
+        error = ktxTexture2_TranscodeBasis(_ktxTexture, _compressionFormat, 0);
+
+        if (error != KTX_SUCCESS || _ktxTexture->pData == nullptr)
+        {
+            SL_LOG("SLGLTexture::loadKTX2: %s while transcoding file: %s to format: %s",
+                   ktxErrorStr(error).c_str(),
+                   filename.c_str(),
+                   compressionFormatStr(_compressionFormat).c_str());
+            ktxTexture_Destroy((ktxTexture*)_ktxTexture);
+            _ktxTexture = nullptr;
+            return false;
+        }
+    }
+
+    _ktxFileName       = filename;
+    _compressedTexture = true;
+    return true;
+}
+//-----------------------------------------------------------------------------
+/*! Returns the file in the KTX2 cache (see ktxCachePath) for an image file. If
+the image was not transcoded yet this is done now once. Returns an empty
+string if the texture should be loaded from the image file: if the cache is
+off, for HDR, font and video textures or if the GPU has no compressed format.
+Normal maps are transcoded in the UASTC mode that keeps their precision, all
+others in the much smaller ETC1S mode. The cache file name contains a hash
+of the file content, so changed image files are transcoded again.
+*/
+SLstring SLGLTexture::ktxCacheFile(const SLstring& filename)
+{
+#    if defined(SL_STORAGE_FS)
+    if (ktxCachePath.empty() ||
+        Utils::getFileExt(filename) == "ktx2" ||
+        _texType == TT_hdr ||
+        _texType == TT_font ||
+        _texType == TT_videoBkgd ||
+        bestCompressionFormat(true, 4, 4) == KTX_TTF_RGBA32)
+        return "";
+
+    PROFILE_FUNCTION();
+
+    SLbool   uastc = _texType == TT_normal;
+    SLIOView view  = SLFileStorage::readIntoView(filename, IOK_image);
+
+    uint64_t key  = uastc;
+    uint64_t hash = Utils::hashFNV1a(view.data, view.size);
+    hash          = Utils::hashFNV1a(&key, sizeof(key), hash);
+    view.release();
+
+    char hex[17];
+    snprintf(hex, sizeof(hex), "%016llx", (unsigned long long)hash);
+    SLstring ktxFile = Utils::unifySlashes(ktxCachePath) +
+                       Utils::getFileNameWOExt(filename) + "_" + hex + ".ktx2";
+
+    if (!SLFileStorage::exists(ktxFile, IOK_image) &&
+        !transcodeToKTX2(filename, ktxFile, uastc))
+        return "";
+
+    return ktxFile;
+#    else
+    return "";
+#    endif
+}
+#endif
 //-----------------------------------------------------------------------------
 //! Loads the 1D color data into an image of height 1
 void SLGLTexture::load(const SLVCol4f& colors)
@@ -787,6 +875,137 @@ SLbool SLGLTexture::copyVideoImage(SLint           camWidth,
     return needsBuild;
 }
 
+//-----------------------------------------------------------------------------
+//! Streams a video frame over pixel buffer objects into the texture
+/*! In contrast to copyVideoImage the frame is not copied into the CVImage of
+the texture. The rows are written directly from the frame into a mapped pixel
+buffer object (PBO), converted to RGB and flipped on the way. The next
+bindActive uploads from this PBO, which the driver can do asynchronously.
+Two PBOs are used alternately, so writing the next frame does not wait for the
+upload of the previous one.
+The frame may be a view (ROI) into a larger image because its rows are
+addressed by its step. The CVImage only holds the size and format of the
+texture, so a streamed video texture can't be ray traced.
+Must be called on the thread with the OpenGL context like copyVideoImage.
+@param frame Frame with 3 or 4 channels (e.g. CVCapture::lastFrame)
+@param srcFormat Pixel format of the frame
+@param isTopLeft Flag if the first row of the frame is the top row
+@return Returns true if the texture was rebuilt
+*/
+SLbool SLGLTexture::streamVideoImage(const CVMat&    frame,
+                                     CVPixelFormatGL srcFormat,
+                                     SLbool          isTopLeft)
+{
+    PROFILE_FUNCTION();
+
+#ifdef SL_EMSCRIPTEN
+    // WebGL 2 can't map buffers. The copy must be continuous for CVImage::load.
+    CVMat continuous = frame.isContinuous() ? frame : frame.clone();
+    return copyVideoImage(continuous.cols,
+                          continuous.rows,
+                          srcFormat,
+                          continuous.data,
+                          true,
+                          isTopLeft);
+#else
+    int cvtCode = -1;
+    if (srcFormat == PF_bgr)
+        cvtCode = cv::COLOR_BGR2RGB;
+    else if (srcFormat == PF_bgra)
+        cvtCode = cv::COLOR_BGRA2RGB;
+    else if (srcFormat == PF_rgba)
+        cvtCode = cv::COLOR_RGBA2RGB;
+    else if (srcFormat != PF_rgb)
+        SL_EXIT_MSG("SLGLTexture::streamVideoImage: Pixel format not supported");
+
+    // Add or resize the image that defines the texture size & format
+    bool needsBuild = false;
+    if (_images.empty())
+    {
+        _images.push_back(new CVImage(frame.cols,
+                                      frame.rows,
+                                      PF_rgb,
+                                      "LiveVideoImageFromMemory"));
+        needsBuild = true;
+    }
+    else
+        needsBuild = _images[0]->allocate(frame.cols, frame.rows, PF_rgb, false);
+
+    _width         = (SLint)_images[0]->width();
+    _height        = (SLint)_images[0]->height();
+    _depth         = (SLint)_images.size();
+    _bytesPerPixel = (SLint)_images[0]->bytesPerPixel();
+
+    // OpenGL ES 2 only can resize non-power-of-two texture with clamp to edge
+    _wrap_s = GL_CLAMP_TO_EDGE;
+    _wrap_t = GL_CLAMP_TO_EDGE;
+
+    if (needsBuild || _texID == 0)
+        build(0);
+
+    // (Re)create the PBOs with tightly packed rows. SLGLState sets the unpack
+    // alignment to 1, so GL reads the rows without padding.
+    _pboBPL         = frame.cols * 3;
+    size_t numBytes = (size_t)_pboBPL * (size_t)frame.rows;
+    if (!_pboIDs[0] || _pboBytes != numBytes)
+    {
+        if (!_pboIDs[0])
+            glGenBuffers(2, _pboIDs);
+        for (SLuint pbo : _pboIDs)
+        {
+            glBindBuffer(GL_PIXEL_UNPACK_BUFFER, pbo);
+            glBufferData(GL_PIXEL_UNPACK_BUFFER, (GLsizeiptr)numBytes, nullptr, GL_STREAM_DRAW);
+        }
+        _pboBytes  = numBytes;
+        _pboFilled = -1;
+    }
+
+    // Write the frame directly into the mapped PBO. Mapped memory is often
+    // write-combined, so it is only written and never read.
+    glBindBuffer(GL_PIXEL_UNPACK_BUFFER, _pboIDs[_pboNext]);
+    auto* pboData = (uchar*)glMapBufferRange(GL_PIXEL_UNPACK_BUFFER,
+                                             0,
+                                             (GLsizeiptr)_pboBytes,
+                                             GL_MAP_WRITE_BIT | GL_MAP_INVALIDATE_BUFFER_BIT);
+    if (pboData)
+    {
+        CVMat pbo(frame.rows, frame.cols, CV_8UC3, pboData, (size_t)_pboBPL);
+
+        // GL textures start with the bottom row. Top-left frames are flipped
+        // on the way: a stripe is converted into a temporary and flipped once
+        // into the mirrored stripe of the PBO.
+        if (!isTopLeft)
+        {
+            if (cvtCode >= 0)
+                cv::cvtColor(frame, pbo, cvtCode);
+            else
+                frame.copyTo(pbo);
+        }
+        else if (cvtCode < 0)
+            cv::flip(frame, pbo, 0);
+        else
+        {
+            const int stripeRows = 64;
+            CVMat     converted;
+            for (int y0 = 0; y0 < frame.rows; y0 += stripeRows)
+            {
+                int   y1      = std::min(y0 + stripeRows, frame.rows);
+                CVMat dstRows = pbo.rowRange(frame.rows - y1, frame.rows - y0);
+                cv::cvtColor(frame.rowRange(y0, y1), converted, cvtCode);
+                cv::flip(converted, dstRows, 0);
+            }
+        }
+        glUnmapBuffer(GL_PIXEL_UNPACK_BUFFER);
+        _pboFilled = (SLint)_pboNext;
+        _pboNext   = 1 - _pboNext;
+    }
+    glBindBuffer(GL_PIXEL_UNPACK_BUFFER, 0);
+    GET_GL_ERROR;
+
+    _needsUpdate = true;
+    return needsBuild;
+#endif
+}
 //-----------------------------------------------------------------------------
 /*!
 Builds an OpenGL texture object with the according OpenGL commands.
@@ -1030,39 +1249,47 @@ void SLGLTexture::build(SLint texUnit)
         // Build textures
         if (_target == GL_TEXTURE_2D)
         {
-            GLenum format = _images[0]->format();
+            // Streamed textures need GL_TEXTURE_BASE_LEVEL of GL 3 or ES 3
+            if (!_mipLevels.empty() && !_resizeToPow2 &&
+                (stateGL->glIsES3() || (!stateGL->glIsES2() && stateGL->glVersionNOf() >= 3.0f)))
+                buildStreamed();
+            else
+            {
+                _mipLevels.clear();
+                GLenum format = _images[0]->format();
 
-            //////////////////////////////////////////////////////////////
-            glTexImage2D(GL_TEXTURE_2D,
-                         0,
-                         _internalFormat,
-                         (SLsizei)_images[0]->width(),
-                         (SLsizei)_images[0]->height(),
-                         0,
-                         format,
-                         _texType == TT_hdr ? SL_HDR_GL_TYPE : GL_UNSIGNED_BYTE,
-                         (GLvoid*)_images[0]->data());
-            /////////////////////////////////////////////////////////////
+                //////////////////////////////////////////////////////////////
+                glTexImage2D(GL_TEXTURE_2D,
+                             0,
+                             _internalFormat,
+                             (SLsizei)_images[0]->width(),
+                             (SLsizei)_images[0]->height(),
+                             0,
+                             format,
+                             _texType == TT_hdr ? SL_HDR_GL_TYPE : GL_UNSIGNED_BYTE,
+                             (GLvoid*)_images[0]->data());
+                /////////////////////////////////////////////////////////////
 
-            GET_GL_ERROR;
+                GET_GL_ERROR;
 
-            _bytesOnGPU = _images[0]->bytesPerImage();
+                _bytesOnGPU = _images[0]->bytesPerImage();
 
-            if (_min_filter >= GL_NEAREST_MIPMAP_NEAREST)
-            {
-                if (stateGL->glIsES2() ||
-                    stateGL->glIsES3() ||
-                    stateGL->glVersionNOf() >= 3.0)
-                    glGenerateMipmap(GL_TEXTURE_2D);
-                else
-                    build2DMipmaps(GL_TEXTURE_2D, 0);
+                if (_min_filter >= GL_NEAREST_MIPMAP_NEAREST)
+                {
+                    if (stateGL->glIsES2() ||
+                        stateGL->glIsES3() ||
+                        stateGL->glVersionNOf() >= 3.0)
+                        glGenerateMipmap(GL_TEXTURE_2D);
+                    else
+                        build2DMipmaps(GL_TEXTURE_2D, 0);
+
+                    // Mipmaps use 1/3 more memory on GPU
+                    _bytesOnGPU = (SLuint)((SLfloat)_bytesOnGPU * 1.333333333f);
+                    GET_GL_ERROR;
+                }
 
-                // Mipmaps use 1/3 more memory on GPU
-                _bytesOnGPU = (SLuint)((SLfloat)_bytesOnGPU * 1.333333333f);
-                GET_GL_ERROR;
+                totalNumBytesOnGPU += _bytesOnGPU;
             }
-
-            totalNumBytesOnGPU += _bytesOnGPU;
         }
         else if (_target == GL_TEXTURE_3D)
         {
@@ -1124,8 +1351,9 @@ void SLGLTexture::build(SLint texUnit)
             }
         }
 
-        // If the images get deleted they only are on the GPU side
-        if (_deleteImageAfterBuild)
+        // If the images get deleted they only are on the GPU side.
+        // Streamed textures need them until all levels are uploaded.
+        if (_deleteImageAfterBuild && _streamLevel <= 0)
             deleteImages();
     }
 
@@ -1191,6 +1419,8 @@ void SLGLTexture::bindActive(SLuint texUnit)
     if (!_texID)
         build(texUnit);
 
+    _lastBindFrame = _streamFrameNo;
+
     if (_texID)
     {
         SLGLState* stateGL = SLGLState::instance();
@@ -1228,6 +1458,27 @@ void SLGLTexture::fullUpdate()
 {
     PROFILE_FUNCTION();
 
+#ifndef SL_EMSCRIPTEN
+    // Upload a frame of streamVideoImage from its PBO
+    if (_texID && _pboFilled >= 0 && _target == GL_TEXTURE_2D)
+    {
+        glBindBuffer(GL_PIXEL_UNPACK_BUFFER, _pboIDs[_pboFilled]);
+        glTexSubImage2D(_target,
+                        0,
+                        0,
+                        0,
+                        _width,
+                        _height,
+                        PF_rgb,
+                        GL_UNSIGNED_BYTE,
+                        nullptr);
+        glBindBuffer(GL_PIXEL_UNPACK_BUFFER, 0);
+        _pboFilled = -1;
+        GET_GL_ERROR;
+        return;
+    }
+#endif
+
     if (_texID &&
         !_images.empty() &&
         _images[0]->data() &&
@@ -1259,6 +1510,276 @@ void SLGLTexture::fullUpdate()
     GET_GL_ERROR;
 }
 //-----------------------------------------------------------------------------
+/*! Uploads only the mip tail of a streamed texture in build. These are the
+levels not bigger than _streamTailSize that take only a few KB. The finer
+levels get uploaded by updateStreaming. GL_TEXTURE_BASE_LEVEL restricts the
+sampling to the levels that are complete on the GPU.
+*/
+void SLGLTexture::buildStreamed()
+{
+    SLint  numLevels = (SLint)_mipLevels.size() + 1;
+    GLenum format    = _images[0]->format();
+
+    SLint tail = numLevels - 1;
+    while (tail > 0)
+    {
+        CVMat finer = streamLevelMat(tail - 1);
+        if (std::max(finer.cols, finer.rows) > _streamTailSize)
+            break;
+        tail--;
+    }
+
+    for (SLint level = numLevels - 1; level >= tail; --level)
+    {
+        CVMat mat = streamLevelMat(level);
+        glTexImage2D(GL_TEXTURE_2D,
+                     level,
+                     _internalFormat,
+                     mat.cols,
+                     mat.rows,
+                     0,
+                     format,
+                     GL_UNSIGNED_BYTE,
+                     mat.data);
+        _bytesOnGPU += streamLevelBytes(level);
+    }
+
+    glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_BASE_LEVEL, tail);
+    glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_MAX_LEVEL, numLevels - 1);
+    totalNumBytesOnGPU += _bytesOnGPU;
+    GET_GL_ERROR;
+
+    _streamLevel     = tail;
+    _streamTailLevel = tail;
+    _streamRow       = 0;
+    _lastBindFrame   = _streamFrameNo;
+
+    if (tail > 0 &&
+        std::find(_streamedTextures.begin(),
+                  _streamedTextures.end(),
+                  this) == _streamedTextures.end())
+        _streamedTextures.push_back(this);
+}
+//-----------------------------------------------------------------------------
+/*! Updates the streamed textures and must be called once per frame on the
+main thread after rendering. If the GPU memory is over streamGPUBudgetBytes
+the finest levels of the least recently used textures get evicted. Then the
+next finer levels of the textures used in the last frames get uploaded within
+streamBytesPerFrame, the textures with the coarsest level first. Returns true
+if something was uploaded and another frame should be rendered.
+*/
+SLbool SLGLTexture::updateStreaming()
+{
+    PROFILE_FUNCTION();
+
+    _streamFrameNo++;
+
+    if (_streamedTextures.empty())
+    {
+        deleteStreamPBO();
+        return false;
+    }
+
+    if (streamGPUBudgetBytes > 0)
+    {
+        while (totalNumBytesOnGPU > streamGPUBudgetBytes)
+        {
+            SLGLTexture* lru = nullptr;
+            for (SLGLTexture* t : _streamedTextures)
+            {
+                if (t->_streamLevel < t->_streamTailLevel &&
+                    t->_lastBindFrame + _streamKeepFrames < _streamFrameNo &&
+                    (!lru || t->_lastBindFrame < lru->_lastBindFrame))
+                    lru = t;
+            }
+            if (!lru)
+                break;
+            lru->evictFinestLevel();
+        }
+    }
+
+    vector<SLGLTexture*> used;
+    for (SLGLTexture* t : _streamedTextures)
+        if (t->_streamLevel > 0 &&
+            t->_lastBindFrame + _streamKeepFrames >= _streamFrameNo)
+            used.push_back(t);
+
+    std::stable_sort(used.begin(),
+                     used.end(),
+                     [](SLGLTexture* a, SLGLTexture* b)
+                     { return a->_streamLevel > b->_streamLevel; });
+
+    SLuint budget = std::max(streamBytesPerFrame, 1u);
+    for (SLGLTexture* t : used)
+    {
+        if (budget == 0)
+            break;
+
+        // Don't start a level that would exceed the GPU budget
+        if (streamGPUBudgetBytes > 0 &&
+            t->_streamRow == 0 &&
+            totalNumBytesOnGPU + t->streamLevelBytes(t->_streamLevel - 1) > streamGPUBudgetBytes)
+            continue;
+
+        t->streamNextStripe(budget);
+    }
+
+    return budget < std::max(streamBytesPerFrame, 1u);
+}
+//-----------------------------------------------------------------------------
+/*! Uploads the next stripe of rows of the next finer level within budget and
+at least one row. The stripe is copied into an orphaned PBO, so the transfer
+to the GPU does not stall the main thread. A complete level becomes the new
+GL_TEXTURE_BASE_LEVEL.
+*/
+void SLGLTexture::streamNextStripe(SLuint& budget)
+{
+    SLint  level  = _streamLevel - 1;
+    CVMat  mat    = streamLevelMat(level);
+    GLenum format = _images[0]->format();
+    SLuint bpl    = (SLuint)(mat.cols * mat.elemSize());
+
+    SLGLState::instance()->bindTexture(GL_TEXTURE_2D, _texID);
+
+    // Allocate the level with the first stripe
+    if (_streamRow == 0)
+        glTexImage2D(GL_TEXTURE_2D,
+                     level,
+                     _internalFormat,
+                     mat.cols,
+                     mat.rows,
+                     0,
+                     format,
+                     GL_UNSIGNED_BYTE,
+                     nullptr);
+
+    SLint  numRows  = std::min(mat.rows - _streamRow,
+                              std::max(1, (SLint)(budget / bpl)));
+    SLuint numBytes = (SLuint)numRows * bpl;
+
+    const GLvoid* pixels = mat.ptr(_streamRow);
+
+#ifndef SL_EMSCRIPTEN
+    if (!_streamPBO)
+        glGenBuffers(1, &_streamPBO);
+
+    glBindBuffer(GL_PIXEL_UNPACK_BUFFER, _streamPBO);
+    glBufferData(GL_PIXEL_UNPACK_BUFFER, (GLsizeiptr)numBytes, nullptr, GL_STREAM_DRAW);
+    void* pboData = glMapBufferRange(GL_PIXEL_UNPACK_BUFFER,
+                                     0,
+                                     (GLsizeiptr)numBytes,
+                                     GL_MAP_WRITE_BIT | GL_MAP_INVALIDATE_BUFFER_BIT);
+    if (pboData)
+    {
+        memcpy(pboData, pixels, numBytes);
+        glUnmapBuffer(GL_PIXEL_UNPACK_BUFFER);
+        pixels = nullptr; // offset 0 in the PBO
+    }
+    else
+        glBindBuffer(GL_PIXEL_UNPACK_BUFFER, 0);
+#endif
+
+    glTexSubImage2D(GL_TEXTURE_2D,
+                    level,
+                    0,
+                    _streamRow,
+                    mat.cols,
+                    numRows,
+                    format,
+                    GL_UNSIGNED_BYTE,
+                    pixels);
+
+#ifndef SL_EMSCRIPTEN
+    glBindBuffer(GL_PIXEL_UNPACK_BUFFER, 0);
+#endif
+    GET_GL_ERROR;
+
+    _streamRow += numRows;
+    budget -= std::min(budget, numBytes);
+
+    if (_streamRow == mat.rows)
+    {
+        glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_BASE_LEVEL, level);
+        _streamLevel = level;
+        _streamRow   = 0;
+
+        SLuint levelBytes = streamLevelBytes(level);
+        _bytesOnGPU += levelBytes;
+        totalNumBytesOnGPU += levelBytes;
+
+        // Without eviction the images are not needed anymore
+        if (level == 0 && _deleteImageAfterBuild && streamGPUBudgetBytes == 0)
+            deleteImages();
+    }
+}
+//-----------------------------------------------------------------------------
+/*! Releases the finest level on the GPU by redefining it with size zero. The
+level gets streamed in again when the texture is used again.
+*/
+void SLGLTexture::evictFinestLevel()
+{
+    GLenum format = _images[0]->format();
+
+    SLGLState::instance()->bindTexture(GL_TEXTURE_2D, _texID);
+
+    // Drop a partially uploaded finer level
+    if (_streamRow > 0)
+    {
+        glTexImage2D(GL_TEXTURE_2D, _streamLevel - 1, _internalFormat, 0, 0, 0, format, GL_UNSIGNED_BYTE, nullptr);
+        _streamRow = 0;
+    }
+
+    glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_BASE_LEVEL, _streamLevel + 1);
+    glTexImage2D(GL_TEXTURE_2D, _streamLevel, _internalFormat, 0, 0, 0, format, GL_UNSIGNED_BYTE, nullptr);
+    GET_GL_ERROR;
+
+    SLuint levelBytes = streamLevelBytes(_streamLevel);
+    _bytesOnGPU -= levelBytes;
+    totalNumBytesOnGPU -= levelBytes;
+    _streamLevel++;
+}
+//-----------------------------------------------------------------------------
+//! Removes the texture from the streamed textures
+void SLGLTexture::stopStreaming()
+{
+    auto it = std::find(_streamedTextures.begin(), _streamedTextures.end(), this);
+    if (it != _streamedTextures.end())
+        _streamedTextures.erase(it);
+
+    _streamLevel     = -1;
+    _streamTailLevel = -1;
+    _streamRow       = 0;
+}
+//-----------------------------------------------------------------------------
+/*! Deletes the PBO of the streamed stripes. It is called when the last
+streamed texture is released and must be called before the OpenGL context is
+destroyed, so that a new context does not reuse a stale buffer ID. Call it
+only from the main thread where OpenGL calls are allowed.
+*/
+void SLGLTexture::deleteStreamPBO()
+{
+#ifndef SL_EMSCRIPTEN
+    if (_streamPBO)
+    {
+        glDeleteBuffers(1, &_streamPBO);
+        _streamPBO = 0;
+    }
+#endif
+}
+//-----------------------------------------------------------------------------
+//! Returns the image of a mip level of a streamed texture
+CVMat SLGLTexture::streamLevelMat(SLint level)
+{
+    return level == 0 ? _images[0]->cvMat() : _mipLevels[(size_t)level - 1];
+}
+//-----------------------------------------------------------------------------
+//! Returns the NO. of bytes of a mip level of a streamed texture
+SLuint SLGLTexture::streamLevelBytes(SLint level)
+{
+    CVMat mat = streamLevelMat(level);
+    return (SLuint)(mat.total() * mat.elemSize());
+}
+//-----------------------------------------------------------------------------
 //! Draws the texture as 2D sprite with OpenGL buffers
 /*! Draws the texture as a flat 2D sprite with a height and a width on two
 triangles with zero in the bottom left corner: <br>
@@ -1883,6 +2404,157 @@ void SLGLTexture::cubeXYZ2UV(SLfloat  x,
 }
 #ifdef SL_BUILD_WITH_KTX
 //------------------------------------------------------------------------------
+/*! Returns the best KTX transcoding format supported by the GPU. ASTC and BC7
+keep most of the quality, BC1/3, ETC and PVRTC are the fallbacks. The
+extensions are read from SLGLState, so this can be called on the loader
+thread. Returns KTX_TTF_RGBA32 (uncompressed) if no format is supported.
+*/
+int SLGLTexture::bestCompressionFormat(SLbool hasAlpha, SLint width, SLint height)
+{
+    SLGLState* stateGL = SLGLState::instance();
+
+    if (stateGL->hasExtension("texture_compression_astc_ldr") ||
+        stateGL->hasExtension("compressed_texture_astc"))
+        return KTX_TTF_ASTC_4x4_RGBA;
+
+    if (stateGL->hasExtension("texture_compression_bptc"))
+        return KTX_TTF_BC7_RGBA;
+
+    if (stateGL->hasExtension("texture_compression_s3tc") ||
+        stateGL->hasExtension("compressed_texture_s3tc"))
+        return hasAlpha ? KTX_TTF_BC3_RGBA : KTX_TTF_BC1_RGB;
+
+#    ifdef SL_EMSCRIPTEN
+    SLbool hasETC2 = stateGL->hasExtension("WEBGL_compressed_texture_etc");
+#    else
+    SLbool hasETC2 = stateGL->glIsES3() || stateGL->hasExtension("ES3_compatibility");
+#    endif
+    if (hasETC2)
+        return hasAlpha ? KTX_TTF_ETC2_RGBA : KTX_TTF_ETC1_RGB;
+
+    // PVRTC1 only works for square power of 2 textures
+    if ((stateGL->hasExtension("texture_compression_pvrtc") ||
+         stateGL->hasExtension("compressed_texture_pvrtc")) &&
+        width == height &&
+        Utils::isPowerOf2((unsigned)width))
+        return hasAlpha ? KTX_TTF_PVRTC1_4_RGBA : KTX_TTF_PVRTC1_4_RGB;
+
+    return KTX_TTF_RGBA32;
+}
+//------------------------------------------------------------------------------
+/*! Converts an image file into a KTX2 file with all mip levels that are Basis
+Universal compressed in the UASTC mode (high quality) or in the ETC1S mode
+(small). The image is flipped vertically as in load, so the KTX2 texture has
+the same orientation as the image texture. UASTC files get additionally
+Zstandard supercompressed. The file is first written under a temporary name,
+so an interrupted write never leaves a broken file behind.
+This is used for the KTX2 cache (see ktxCachePath) but can also be called
+offline to convert the textures of an app once.
+*/
+SLbool SLGLTexture::transcodeToKTX2(const SLstring& imageFile,
+                                    const SLstring& ktxFile,
+                                    SLbool          uastc)
+{
+    PROFILE_FUNCTION();
+
+    HighResTimer timer;
+    CVImage      image(imageFile, true, false);
+    CVMat        level0 = image.cvMat();
+
+    ktx_uint32_t vkFormat;
+    switch (image.format())
+    {
+        case PF_red: vkFormat = 9; break;   // VK_FORMAT_R8_UNORM
+        case PF_rgb: vkFormat = 23; break;  // VK_FORMAT_R8G8B8_UNORM
+        case PF_rgba: vkFormat = 37; break; // VK_FORMAT_R8G8B8A8_UNORM
+        default: return false;
+    }
+    if (level0.empty() || level0.depth() != CV_8U)
+        return false;
+    if (!level0.isContinuous())
+        level0 = level0.clone();
+
+    CVVMat levels;
+    CVImage::buildMipmaps(level0, levels);
+
+    ktxTextureCreateInfo createInfo = {};
+    createInfo.vkFormat             = vkFormat;
+    createInfo.baseWidth            = (ktx_uint32_t)level0.cols;
+    createInfo.baseHeight           = (ktx_uint32_t)level0.rows;
+    createInfo.baseDepth            = 1;
+    createInfo.numDimensions        = 2;
+    createInfo.numLevels            = (ktx_uint32_t)levels.size() + 1;
+    createInfo.numLayers            = 1;
+    createInfo.numFaces             = 1;
+    createInfo.isArray              = KTX_FALSE;
+    createInfo.generateMipmaps      = KTX_FALSE;
+
+    ktxTexture2*   texture = nullptr;
+    KTX_error_code error   = ktxTexture2_Create(&createInfo,
+                                              KTX_TEXTURE_CREATE_ALLOC_STORAGE,
+                                              &texture);
+
+    for (ktx_uint32_t l = 0; error == KTX_SUCCESS && l < createInfo.numLevels; ++l)
+    {
+        const CVMat& mat = l == 0 ? level0 : levels[l - 1];
+        error            = ktxTexture_SetImageFromMemory((ktxTexture*)texture,
+                                                         l,
+                                                         0,
+                                                         0,
+                                                         mat.data,
+                                                         mat.total() * mat.elemSize());
+    }
+
+    if (error == KTX_SUCCESS)
+    {
+        ktxBasisParams params = {};
+        params.structSize     = sizeof(params);
+        params.uastc          = uastc ? KTX_TRUE : KTX_FALSE;
+        params.threadCount    = Utils::maxThreads();
+        if (uastc)
+            params.uastcFlags = KTX_PACK_UASTC_LEVEL_DEFAULT;
+        else
+        {
+            params.compressionLevel = KTX_ETC1S_DEFAULT_COMPRESSION_LEVEL;
+            params.qualityLevel     = 128;
+        }
+        error = ktxTexture2_CompressBasisEx(texture, &params);
+    }
+
+    if (error == KTX_SUCCESS && uastc)
+        error = ktxTexture2_DeflateZstd(texture, 10);
+
+    SLstring dir = Utils::getPath(ktxFile);
+    if (!dir.empty() && !Utils::dirExists(dir))
+        Utils::makeDirRecurse(dir);
+
+    // The thread id in the temporary name allows parallel loader threads
+    SLstring tmpFile = ktxFile + "." +
+                       std::to_string(std::hash<std::thread::id>()(std::this_thread::get_id())) +
+                       ".tmp";
+    if (error == KTX_SUCCESS)
+        error = ktxTexture_WriteToNamedFile((ktxTexture*)texture, tmpFile.c_str());
+
+    if (texture)
+        ktxTexture_Destroy((ktxTexture*)texture);
+
+    if (error != KTX_SUCCESS ||
+        std::rename(tmpFile.c_str(), ktxFile.c_str()) != 0)
+    {
+        SL_LOG("SLGLTexture::transcodeToKTX2: %s while transcoding: %s",
+               ktxErrorStr(error).c_str(),
+               imageFile.c_str());
+        Utils::removeFile(tmpFile);
+        return false;
+    }
+
+    SL_LOG("Transcoded to KTX2 (%s) : %s in %.0f ms",
+           uastc ? "UASTC" : "ETC1S",
+           Utils::getFileName(imageFile).c_str(),
+           timer.elapsedTimeInMilliSec());
+    return true;
+}
+//------------------------------------------------------------------------------
 //! Returns the KTX transcoding compression format as string
 string SLGLTexture::compressionFormatStr(int compressionFormat)
 {
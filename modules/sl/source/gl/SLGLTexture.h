@@ -105,6 +105,15 @@ enum SLTextureType
  The images are not released after the OpenGL texture creation unless you set the
  flag _deleteImageAfterBuild to true. If the images get deleted after build,
  you won't be able to ray trace the scene.
+ With SLGLTexture::streamingEnabled set before loading, mipmapped 2D textures
+ are streamed in: The mip levels are built on the CPU in the constructor,
+ build uploads only the small mip tail and updateStreaming uploads the finer
+ levels stripe by stripe within a per frame byte budget. Under a GPU memory
+ budget the finest levels of textures that are not used anymore are evicted.
+ With a ktxCachePath image files of 2D textures are transcoded once into
+ Basis Universal compressed KTX2 files with mips (see transcodeToKTX2). At load
+ time these get transcoded into the best compressed format of the GPU. Like
+ with deleted images, compressed textures can't be ray traced.
 */
 class SLGLTexture : public SLObject
 {
@@ -263,6 +272,10 @@ public:
 #ifdef SL_BUILD_WITH_KTX
     static string compressionFormatStr(int compressionFormat);
     static string ktxErrorStr(int ktxErrorCode);
+    static int    bestCompressionFormat(SLbool hasAlpha, SLint width, SLint height);
+    static SLbool transcodeToKTX2(const SLstring& imageFile,
+                                  const SLstring& ktxFile,
+                                  SLbool          uastc);
 #endif
     static string internalFormatStr(int internalFormat);
 
@@ -282,6 +295,13 @@ public:
                           SLbool          isContinuous,
                           SLbool          isTopLeft);
 
+    SLbool streamVideoImage(const CVMat&    frame,
+                            CVPixelFormatGL srcFormat,
+                            SLbool          isTopLeft = true);
+
+    static SLbool updateStreaming();
+    static void   deleteStreamPBO();
+
     void calc3DGradients(SLint sampleRadius, const function<void(int)>& onUpdateProgress = nullptr);
     void smooth3DGradients(SLint smoothRadius, function<void(int)> onUpdateProgress = nullptr);
 
@@ -289,8 +309,13 @@ public:
     SLVec2f dudv(SLfloat u, SLfloat v); //! Returns the derivation as [s,t]
 
     // Statics
-    static SLfloat maxAnisotropy;      //!< max. anisotropy available
-    static SLuint  totalNumBytesOnGPU; //!< Total NO. of bytes used for textures on GPU
+    static SLfloat  maxAnisotropy;      //!< max. anisotropy available
+    static SLuint   totalNumBytesOnGPU; //!< Total NO. of bytes used for textures on GPU
+    static SLstring ktxCachePath;       //!< Path of the KTX2 cache for transcoded image files (empty = off)
+
+    static SLbool streamingEnabled;     //!< Flag if mipmapped 2D textures get streamed in
+    static SLuint streamBytesPerFrame;  //!< Max. NO. of bytes uploaded per frame by updateStreaming
+    static SLuint streamGPUBudgetBytes; //!< GPU memory budget for the eviction of streamed levels (0 = none)
 
 protected:
     // loading the image files
@@ -298,6 +323,18 @@ protected:
               SLbool          flipVertical           = true,
               SLbool          loadGrayscaleIntoAlpha = false);
     void load(const SLVCol4f& colors);
+#ifdef SL_BUILD_WITH_KTX
+    SLbool   loadKTX2(const SLstring& filename);
+    SLstring ktxCacheFile(const SLstring& filename);
+#endif
+
+    // texture streaming
+    void   buildStreamed();
+    void   streamNextStripe(SLuint& budget);
+    void   evictFinestLevel();
+    void   stopStreaming();
+    CVMat  streamLevelMat(SLint level);
+    SLuint streamLevelBytes(SLint level);
 
     CVVImage          _images;         //!< Vector of CVImage pointers
     SLuint            _texID;          //!< OpenGL texture ID
@@ -326,6 +363,24 @@ protected:
     SLbool _deleteImageAfterBuild;     //!< Flag if images should be deleted after build on GPU
     SLbool _compressedTexture = false; //!< True for compressed texture format on GPU
 
+    SLuint _pboIDs[2]  = {0, 0}; //!< Pixel buffer objects for streamed video images (ping-pong)
+    SLint  _pboFilled  = -1;     //!< Index of the PBO with a frame to upload or -1
+    SLuint _pboNext    = 0;      //!< Index of the PBO to fill next
+    size_t _pboBytes   = 0;      //!< Size in bytes of each PBO
+    SLint  _pboBPL     = 0;      //!< Bytes per line in the PBOs
+
+    vector<CVMat> _mipLevels;            //!< CPU mip levels 1-n of a streamed texture
+    SLint         _streamLevel     = -1; //!< Finest mip level on the GPU of a streamed texture (-1 = not streamed)
+    SLint         _streamTailLevel = -1; //!< Finest level of the mip tail that never gets evicted
+    SLint         _streamRow       = 0;  //!< NO. of rows of the next finer level already uploaded
+    SLuint        _lastBindFrame   = 0;  //!< Frame number of updateStreaming at the last bindActive
+
+    static vector<SLGLTexture*> _streamedTextures; //!< Textures with levels to stream or evict
+    static SLuint               _streamFrameNo;    //!< Frame counter of updateStreaming
+    static SLuint               _streamPBO;        //!< Pixel buffer object for the streamed stripes
+    static const SLint          _streamTailSize   = 64; //!< Max. size in pixels of the levels uploaded in build
+    static const SLuint         _streamKeepFrames = 60; //!< NO. of frames a texture counts as used after bindActive
+
 #ifdef SL_BUILD_WITH_KTX
     ktxTexture2*        _ktxTexture        = nullptr;             //!< Pointer to the KTX texture after loading
     ktx_transcode_fmt_e _compressionFormat = KTX_TTF_NOSELECTION; //!< compression format on GPU
@@ -10,9 +10,23 @@
 #include <SLAssetManager.h>
 #include <SLScene.h>
 #include <SLGLTextureIBL.h>
+#include <SLFileStorage.h>
+#include <HighResTimer.h>
+#include <Profiler.h>
+#include <cstdio>
 
 //-----------------------------------------------------------------------------
-const SLint ROUGHNESS_NUM_MIP_LEVELS = 5; //! Number of mip levels for roughness cubemaps
+const SLint  ROUGHNESS_NUM_MIP_LEVELS = 5;    //! Number of mip levels for roughness cubemaps
+const SLint  IBL_CACHE_VERSION        = 1;    //! Version of the cache files (increase if the shaders change)
+const SLuint IBL_SAMPLE_COUNT         = 1024; //! Number of importance samples as in the shaders
+//-----------------------------------------------------------------------------
+SLstring SLGLTextureIBL::cachePath;
+//-----------------------------------------------------------------------------
+//! Number of mip levels stored in the cache for a texture type
+static SLint cacheMipLevels(SLTextureType texType)
+{
+    return texType == TT_roughnessCubemap ? ROUGHNESS_NUM_MIP_LEVELS : 1;
+}
 //-----------------------------------------------------------------------------
 //! ctor for generated textures from hdr textures
 SLGLTextureIBL::SLGLTextureIBL(SLAssetManager* am,
@@ -116,6 +130,18 @@ void SLGLTextureIBL::build(SLint texUnit)
         deleteImages();
     bool saveReadbackTextures = false;
 
+    // Upload the maps from the cache if they were generated before
+    SLstring cacheFile = cacheFileName();
+    if (!cacheFile.empty() && loadCache(cacheFile))
+        return;
+
+    // Otherwise the rendered maps get read back for the cache
+    CVMat cacheMaps;
+    if (!cacheFile.empty())
+        cacheMaps = CVMat::zeros(cacheRowOffset(_texType, _height, cacheMipLevels(_texType), 0),
+                                 _width,
+                                 CV_32FC3);
+
     glGenTextures(1, &_texID);
     glBindTexture(_target, _texID);
 
@@ -198,6 +224,9 @@ void SLGLTextureIBL::build(SLint texUnit)
                            name,
                            saveReadbackTextures);
             }
+
+            if (!cacheMaps.empty())
+                readPixelsToCache(cacheMaps, 0, (SLint)i, _width, _height);
         }
 
         glBindFramebuffer(GL_FRAMEBUFFER, 0);
@@ -295,6 +324,9 @@ void SLGLTextureIBL::build(SLint texUnit)
                                name,
                                saveReadbackTextures);
                 }
+
+                if (!cacheMaps.empty())
+                    readPixelsToCache(cacheMaps, mipLevel, (SLint)i, mipWidth, mipHeight);
             }
 
             glBindFramebuffer(GL_FRAMEBUFFER, 0);
@@ -347,12 +379,18 @@ void SLGLTextureIBL::build(SLint texUnit)
                        saveReadbackTextures);
         }
 
+        if (!cacheMaps.empty())
+            readPixelsToCache(cacheMaps, 0, 0, _width, _height);
+
         glBindFramebuffer(GL_FRAMEBUFFER, 0);
     }
 
     glDeleteFramebuffers(1, &fboID);
     glDeleteRenderbuffers(1, &rboID);
 
+    if (!cacheMaps.empty())
+        writeCache(cacheMaps, cacheFile);
+
     // Reset the viewport
     SLGLState* state = SLGLState::instance();
     auto       vp    = state->viewport();
@@ -520,3 +558,664 @@ void SLGLTextureIBL::logFramebufferStatus()
 #endif
 }
 //-----------------------------------------------------------------------------
+/*! Returns the cache file name of this texture or an empty string if there is
+ no cache path. The environment, irradiance and roughness maps are keyed on
+ the HDR image at the root of the source textures.
+*/
+SLstring SLGLTextureIBL::cacheFileName()
+{
+    if (cachePath.empty())
+        return "";
+
+    if (_texType == TT_brdfLUT)
+        return cacheFileName("", 0, _texType, _width, 0);
+
+    if (!_sourceTexture || _width != _height)
+        return "";
+
+    // Find the HDR texture the maps are generated from
+    SLGLTextureIBL* ibl = this;
+    while (ibl && ibl->_sourceTexture && ibl->_sourceTexture->texType() != TT_hdr)
+        ibl = dynamic_cast<SLGLTextureIBL*>(ibl->_sourceTexture);
+
+    if (!ibl || !ibl->_sourceTexture || ibl->_sourceTexture->url().empty())
+        return "";
+
+    // The HDR image gets hashed only once for all maps generated from it
+    const SLstring& hdrImageFile = ibl->_sourceTexture->url();
+    if (!ibl->_hdrHashed)
+        ibl->_hdrHashed = hashHdrFile(hdrImageFile, ibl->_hdrHash);
+    if (!ibl->_hdrHashed)
+        return "";
+
+    SLint sourceSize = _texType == TT_environmentCubemap ? 0 : _sourceTexture->width();
+    return cacheFileName(hdrImageFile, ibl->_hdrHash, _texType, _width, sourceSize);
+}
+//-----------------------------------------------------------------------------
+/*! Hashes the content of the HDR image file into hash. Returns false if the
+ file doesn't exist.
+*/
+SLbool SLGLTextureIBL::hashHdrFile(const SLstring& hdrImageFile, uint64_t& hash)
+{
+#if defined(SL_STORAGE_FS)
+    PROFILE_FUNCTION();
+
+    if (!SLFileStorage::exists(hdrImageFile, IOK_image))
+        return false;
+
+    SLIOView view = SLFileStorage::readIntoView(hdrImageFile, IOK_image);
+    hash          = Utils::hashFNV1a(view.data, view.size);
+    view.release();
+    return true;
+#else
+    return false;
+#endif
+}
+//-----------------------------------------------------------------------------
+/*! Returns the cache file name for the maps of the given type and size. The
+ name contains a hash over the hash of the HDR image file (see hashHdrFile),
+ the texture type, the size and the size of the source environment cube map.
+ The BRDF LUT doesn't depend on an image and gets an empty hdrImageFile.
+*/
+SLstring SLGLTextureIBL::cacheFileName(const SLstring& hdrImageFile,
+                                       uint64_t        hdrHash,
+                                       SLTextureType   texType,
+                                       SLint           size,
+                                       SLint           sourceSize)
+{
+#if defined(SL_STORAGE_FS)
+    if (cachePath.empty())
+        return "";
+
+    uint64_t keys[] = {hdrHash,
+                       (uint64_t)texType,
+                       (uint64_t)size,
+                       (uint64_t)sourceSize,
+                       (uint64_t)cacheMipLevels(texType),
+                       (uint64_t)IBL_CACHE_VERSION};
+    uint64_t hash   = Utils::hashFNV1a(keys, sizeof(keys));
+
+    SLstring name;
+    switch (texType)
+    {
+        case TT_environmentCubemap: name = Utils::getFileNameWOExt(hdrImageFile) + "_environment"; break;
+        case TT_irradianceCubemap: name = Utils::getFileNameWOExt(hdrImageFile) + "_irradiance"; break;
+        case TT_roughnessCubemap: name = Utils::getFileNameWOExt(hdrImageFile) + "_roughness"; break;
+        case TT_brdfLUT: name = "brdfLUT"; break;
+        default: return "";
+    }
+
+    char hex[17];
+    snprintf(hex, sizeof(hex), "%016llx", (unsigned long long)hash);
+    return Utils::unifySlashes(cachePath) + name + "_" + hex + ".hdr";
+#else
+    return "";
+#endif
+}
+//-----------------------------------------------------------------------------
+/*! Returns the first row of a face of a mip level in the cache image. All
+ faces of all mip levels are stacked vertically in the order face 0-5 of mip
+ level 0, face 0-5 of mip level 1 and so on. The BRDF LUT has only one face.
+*/
+SLint SLGLTextureIBL::cacheRowOffset(SLTextureType texType,
+                                     SLint         height,
+                                     SLint         mipLevel,
+                                     SLint         face)
+{
+    SLint numFaces = texType == TT_brdfLUT ? 1 : 6;
+    SLint rows     = 0;
+    for (SLint m = 0; m < mipLevel; ++m)
+        rows += numFaces * (height >> m);
+    return rows + face * (height >> mipLevel);
+}
+//-----------------------------------------------------------------------------
+/*! Reads back the float pixels of the current framebuffer into the cache
+ image. RGBA is the only float read format that is guaranteed on OpenGL ES.
+*/
+void SLGLTextureIBL::readPixelsToCache(CVMat& maps,
+                                       SLint  mipLevel,
+                                       SLint  face,
+                                       SLint  width,
+                                       SLint  height)
+{
+    CVMat rgba(height, width, CV_32FC4);
+    glReadPixels(0, 0, width, height, GL_RGBA, GL_FLOAT, rgba.data);
+    GET_GL_ERROR;
+
+    SLint row = cacheRowOffset(_texType, _height, mipLevel, face);
+    CVMat dst = maps(CVRect(0, row, width, height));
+    cv::cvtColor(rgba, dst, cv::COLOR_RGBA2RGB);
+}
+//-----------------------------------------------------------------------------
+/*! Uploads the maps from the cache file onto the GPU. Returns false if the
+ file doesn't exist or doesn't match. If the texture reads its pixels back the
+ images are created as they would be read back from the rendered maps.
+*/
+SLbool SLGLTextureIBL::loadCache(const SLstring& cacheFile)
+{
+#if defined(SL_STORAGE_FS)
+    if (!Utils::fileExists(cacheFile))
+        return false;
+
+    PROFILE_FUNCTION();
+
+    HighResTimer timer;
+    SLint        numMips  = cacheMipLevels(_texType);
+    SLint        numFaces = _texType == TT_brdfLUT ? 1 : 6;
+    CVMat        maps     = cv::imread(cacheFile, cv::IMREAD_ANYDEPTH | cv::IMREAD_ANYCOLOR);
+
+    if (maps.type() != CV_32FC3 ||
+        maps.cols != _width ||
+        maps.rows != cacheRowOffset(_texType, _height, numMips, 0))
+    {
+        // Broken cache file: generate the maps again and replace it
+        SL_LOG("Invalid IBL cache file: %s", cacheFile.c_str());
+        Utils::removeFile(cacheFile);
+        return false;
+    }
+
+    cv::cvtColor(maps, maps, cv::COLOR_BGR2RGB);
+
+    glGenTextures(1, &_texID);
+    glBindTexture(_target, _texID);
+
+    if (_texType == TT_brdfLUT)
+    {
+        _bytesPerPixel  = SL_BRDF_LUT_PIXEL_BYTES;
+        _internalFormat = SL_BRDF_LUT_GL_INTERNAL_FORMAT;
+    }
+    else
+    {
+        _bytesPerPixel  = SL_HDR_PIXEL_BYTES;
+        _internalFormat = SL_HDR_GL_INTERNAL_FORMAT;
+    }
+
+    for (SLint mipLevel = 0; mipLevel < numMips; ++mipLevel)
+    {
+        SLint mipWidth  = _width / (1 << mipLevel);
+        SLint mipHeight = _height / (1 << mipLevel);
+
+        for (SLint i = 0; i < numFaces; ++i)
+        {
+            SLint row  = cacheRowOffset(_texType, _height, mipLevel, i);
+            CVMat face = maps(CVRect(0, row, mipWidth, mipHeight)).clone();
+
+            if (_texType == TT_brdfLUT)
+            {
+                CVMat rg(mipHeight, mipWidth, CV_32FC2);
+                int   fromTo[] = {0, 0, 1, 1};
+                cv::mixChannels(&face, 1, &rg, 1, fromTo, 2);
+                glTexImage2D(_target,
+                             0,
+                             _internalFormat,
+                             mipWidth,
+                             mipHeight,
+                             0,
+                             SL_BRDF_LUT_GL_FORMAT,
+                             SL_BRDF_LUT_GL_TYPE,
+                             rg.data);
+            }
+            else
+            {
+                glTexImage2D(GL_TEXTURE_CUBE_MAP_POSITIVE_X + i,
+                             mipLevel,
+                             _internalFormat,
+                             mipWidth,
+                             mipHeight,
+                             0,
+                             SL_HDR_GL_FORMAT,
+                             SL_HDR_GL_TYPE,
+                             face.data);
+            }
+
+            // Create the images as readPixels would read them from the framebuffer
+            if (_readBackPixels)
+            {
+                CVImage* image = new CVImage(mipWidth,
+                                             mipHeight,
+                                             SL_READ_PIXELS_CV_FORMAT,
+                                             name());
+                CVMat    pixels = image->cvMat();
+                face.convertTo(pixels, CV_8UC3, 255.0);
+                _images.push_back(image);
+            }
+        }
+    }
+
+    if (_texType == TT_roughnessCubemap)
+    {
+        glTexParameteri(_target, GL_TEXTURE_WRAP_S, GL_CLAMP_TO_EDGE);
+        glTexParameteri(_target, GL_TEXTURE_WRAP_T, GL_CLAMP_TO_EDGE);
+        glTexParameteri(_target, GL_TEXTURE_WRAP_R, GL_CLAMP_TO_EDGE);
+        glTexParameteri(_target, GL_TEXTURE_MIN_FILTER, GL_LINEAR_MIPMAP_LINEAR);
+        glTexParameteri(_target, GL_TEXTURE_MAG_FILTER, GL_LINEAR);
+        glTexParameteri(_target, GL_TEXTURE_BASE_LEVEL, 0);
+        glTexParameteri(_target, GL_TEXTURE_MAX_LEVEL, ROUGHNESS_NUM_MIP_LEVELS - 1);
+    }
+    else
+    {
+        glTexParameteri(_target, GL_TEXTURE_WRAP_S, _wrap_s);
+        glTexParameteri(_target, GL_TEXTURE_WRAP_T, _wrap_t);
+        if (_target == GL_TEXTURE_CUBE_MAP)
+            glTexParameteri(_target, GL_TEXTURE_WRAP_R, _wrap_t);
+        glTexParameteri(_target, GL_TEXTURE_MIN_FILTER, _min_filter);
+        glTexParameteri(_target, GL_TEXTURE_MAG_FILTER, _mag_filter);
+    }
+
+    if (_texType == TT_environmentCubemap)
+        glGenerateMipmap(GL_TEXTURE_CUBE_MAP);
+
+    GET_GL_ERROR;
+
+    SL_LOG("IBL maps read from cache in %.1f ms: %s",
+           timer.elapsedTimeInMilliSec(),
+           cacheFile.c_str());
+    return true;
+#else
+    return false;
+#endif
+}
+//-----------------------------------------------------------------------------
+/*! Writes the maps as Radiance RGBE image (run-length encoded by OpenCV) into
+ the cache. The file is first written under a temporary name, so an
+ interrupted write never leaves a broken cache file behind.
+*/
+SLbool SLGLTextureIBL::writeCache(const CVMat& maps, const SLstring& cacheFile)
+{
+#if defined(SL_STORAGE_FS)
+    PROFILE_FUNCTION();
+
+    SLstring dir = Utils::getPath(cacheFile);
+    if (!Utils::dirExists(dir))
+        Utils::makeDirRecurse(dir);
+
+    // The temporary file needs the extension for the OpenCV encoder
+    SLstring tmpFile = dir + Utils::getFileNameWOExt(cacheFile) + "_tmp.hdr";
+    CVMat    bgr;
+    cv::cvtColor(maps, bgr, cv::COLOR_RGB2BGR);
+
+    if (!cv::imwrite(tmpFile, bgr) ||
+        std::rename(tmpFile.c_str(), cacheFile.c_str()) != 0)
+    {
+        SL_LOG("Failed to write IBL cache file: %s", cacheFile.c_str());
+        Utils::removeFile(tmpFile);
+        return false;
+    }
+    return true;
+#else
+    return false;
+#endif
+}
+//-----------------------------------------------------------------------------
+/*! Returns the direction through the center of the texel (x, y) of a cube map
+ face. The faces follow the OpenGL cube map convention (first row at t = 0) in
+ which they get rendered with the capture views.
+*/
+static SLVec3f cubeTexelDir(SLint face, SLint x, SLint y, SLint size)
+{
+    SLfloat sc = 2.0f * ((SLfloat)x + 0.5f) / (SLfloat)size - 1.0f;
+    SLfloat tc = 2.0f * ((SLfloat)y + 0.5f) / (SLfloat)size - 1.0f;
+
+    switch (face)
+    {
+        case 0: return SLVec3f(1.0f, -tc, -sc);
+        case 1: return SLVec3f(-1.0f, -tc, sc);
+        case 2: return SLVec3f(sc, 1.0f, tc);
+        case 3: return SLVec3f(sc, -1.0f, -tc);
+        case 4: return SLVec3f(sc, -tc, 1.0f);
+        default: return SLVec3f(-sc, -tc, -1.0f);
+    }
+}
+//-----------------------------------------------------------------------------
+//! Bilinear lookup with clamp to edge in a float RGB image at u, v in [0, 1]
+static SLVec3f sampleBilinear(const CVMat& image, SLfloat u, SLfloat v)
+{
+    SLfloat fx = u * (SLfloat)image.cols - 0.5f;
+    SLfloat fy = v * (SLfloat)image.rows - 0.5f;
+    SLfloat x0 = std::floor(fx);
+    SLfloat y0 = std::floor(fy);
+    SLfloat ax = fx - x0;
+    SLfloat ay = fy - y0;
+
+    SLint c0 = Utils::clamp((SLint)x0, 0, image.cols - 1);
+    SLint c1 = Utils::clamp((SLint)x0 + 1, 0, image.cols - 1);
+    SLint r0 = Utils::clamp((SLint)y0, 0, image.rows - 1);
+    SLint r1 = Utils::clamp((SLint)y0 + 1, 0, image.rows - 1);
+
+    auto texel = [&](SLint r, SLint c)
+    {
+        const cv::Vec3f& p = image.at<cv::Vec3f>(r, c);
+        return SLVec3f(p[0], p[1], p[2]);
+    };
+
+    return (texel(r0, c0) * (1.0f - ax) + texel(r0, c1) * ax) * (1.0f - ay) +
+           (texel(r1, c0) * (1.0f - ax) + texel(r1, c1) * ax) * ay;
+}
+//-----------------------------------------------------------------------------
+/*! Trilinear lookup in a cube map with the faces of all mip levels in
+ levels[mipLevel][face]. The face selection follows the OpenGL specification.
+ Like textureLod the lookup doesn't filter across the face edges.
+*/
+static SLVec3f sampleCube(const vector<CVVMat>& levels,
+                          const SLVec3f&        dir,
+                          SLfloat               lod)
+{
+    SLfloat ax = std::abs(dir.x);
+    SLfloat ay = std::abs(dir.y);
+    SLfloat az = std::abs(dir.z);
+    SLint   face;
+    SLfloat sc, tc, ma;
+
+    if (ax >= ay && ax >= az)
+    {
+        face = dir.x > 0.0f ? 0 : 1;
+        sc   = dir.x > 0.0f ? -dir.z : dir.z;
+        tc   = -dir.y;
+        ma   = ax;
+    }
+    else if (ay >= az)
+    {
+        face = dir.y > 0.0f ? 2 : 3;
+        sc   = dir.x;
+        tc   = dir.y > 0.0f ? dir.z : -dir.z;
+        ma   = ay;
+    }
+    else
+    {
+        face = dir.z > 0.0f ? 4 : 5;
+        sc   = dir.z > 0.0f ? dir.x : -dir.x;
+        tc   = -dir.y;
+        ma   = az;
+    }
+
+    SLfloat s = 0.5f * (sc / ma + 1.0f);
+    SLfloat t = 0.5f * (tc / ma + 1.0f);
+
+    SLint maxLevel = (SLint)levels.size() - 1;
+    lod            = Utils::clamp(lod, 0.0f, (SLfloat)maxLevel);
+    SLint   l0     = (SLint)lod;
+    SLint   l1     = std::min(l0 + 1, maxLevel);
+    SLfloat a      = lod - (SLfloat)l0;
+
+    SLVec3f c = sampleBilinear(levels[(size_t)l0][(size_t)face], s, t);
+    if (a > 0.0f)
+        c = c * (1.0f - a) + sampleBilinear(levels[(size_t)l1][(size_t)face], s, t) * a;
+    return c;
+}
+//-----------------------------------------------------------------------------
+//! Hammersley point i of n with the bit reversed radical inverse
+static SLVec2f hammersley(SLuint i, SLuint n)
+{
+    SLuint bits = i;
+    bits        = (bits << 16u) | (bits >> 16u);
+    bits        = ((bits & 0x55555555u) << 1u) | ((bits & 0xAAAAAAAAu) >> 1u);
+    bits        = ((bits & 0x33333333u) << 2u) | ((bits & 0xCCCCCCCCu) >> 2u);
+    bits        = ((bits & 0x0F0F0F0Fu) << 4u) | ((bits & 0xF0F0F0F0u) >> 4u);
+    bits        = ((bits & 0x00FF00FFu) << 8u) | ((bits & 0xFF00FF00u) >> 8u);
+    return SLVec2f((SLfloat)i / (SLfloat)n, (SLfloat)bits * 2.3283064365386963e-10f);
+}
+//-----------------------------------------------------------------------------
+//! GGX importance sampled half vector in tangent space (z is the normal)
+static SLVec3f importanceSampleGGX(const SLVec2f& xi, SLfloat roughness)
+{
+    SLfloat a        = roughness * roughness;
+    SLfloat phi      = 2.0f * Utils::PI * xi.x;
+    SLfloat cosTheta = std::sqrt((1.0f - xi.y) / (1.0f + (a * a - 1.0f) * xi.y));
+    SLfloat sinTheta = std::sqrt(1.0f - cosTheta * cosTheta);
+    return SLVec3f(std::cos(phi) * sinTheta, std::sin(phi) * sinTheta, cosTheta);
+}
+//-----------------------------------------------------------------------------
+//! Schlick-GGX geometry term with k = roughness^2 / 2 for IBL
+static SLfloat geometrySchlickGGX(SLfloat NdotV, SLfloat roughness)
+{
+    SLfloat k = (roughness * roughness) / 2.0f;
+    return NdotV / (NdotV * (1.0f - k) + k);
+}
+//-----------------------------------------------------------------------------
+/*! Computes the environment, irradiance and roughness cube maps of an HDR
+ image and the BRDF LUT on the CPU and writes them into the cache. So an
+ application without a GPU (e.g. a headless build step) can produce the cache
+ that SLGLTextureIBL::build reads. The sizes must be the ones of the textures
+ created by SLSkybox. The maps are computed with the same sampling as the
+ shaders on all hardware threads. Only the irradiance convolution samples the
+ environment at a fixed mip level that approximates the implicit level of
+ the GPU. Maps that are already in the cache are not computed again.
+*/
+SLbool SLGLTextureIBL::buildCacheCPU(const SLstring& hdrImageFile,
+                                     SLint           envSize,
+                                     SLint           irradianceSize,
+                                     SLint           roughnessSize,
+                                     SLint           brdfLUTSize)
+{
+    PROFILE_FUNCTION();
+
+    uint64_t hdrHash = 0;
+    if (cachePath.empty() || !hashHdrFile(hdrImageFile, hdrHash))
+    {
+        SL_LOG("SLGLTextureIBL::buildCacheCPU: No cache path or HDR image: %s",
+               hdrImageFile.c_str());
+        return false;
+    }
+
+    SLstring envFile   = cacheFileName(hdrImageFile, hdrHash, TT_environmentCubemap, envSize, 0);
+    SLstring irrFile   = cacheFileName(hdrImageFile, hdrHash, TT_irradianceCubemap, irradianceSize, envSize);
+    SLstring roughFile = cacheFileName(hdrImageFile, hdrHash, TT_roughnessCubemap, roughnessSize, envSize);
+    SLstring brdfFile  = cacheFileName("", 0, TT_brdfLUT, brdfLUTSize, 0);
+
+    if (envFile.empty() || brdfFile.empty())
+    {
+        SL_LOG("SLGLTextureIBL::buildCacheCPU: No cache path or HDR image: %s",
+               hdrImageFile.c_str());
+        return false;
+    }
+
+    HighResTimer timer;
+    SLbool       ok = true;
+
+    if (!Utils::fileExists(envFile) ||
+        !Utils::fileExists(irrFile) ||
+        !Utils::fileExists(roughFile))
+    {
+        CVImage hdr(hdrImageFile);
+        CVMat   equirect = hdr.cvMat();
+        if (equirect.type() != CV_32FC3)
+        {
+            SL_LOG("SLGLTextureIBL::buildCacheCPU: No float RGB image: %s",
+                   hdrImageFile.c_str());
+            return false;
+        }
+
+        // Environment cube map: equirectangular lookup as in PBR_CylinderToCubeMap.frag
+        CVMat envMaps = CVMat::zeros(6 * envSize, envSize, CV_32FC3);
+        Utils::parallelFor(6 * envSize,
+                           [&](SLint i)
+                           {
+                               SLint      face = i / envSize;
+                               SLint      y    = i % envSize;
+                               cv::Vec3f* row  = envMaps.ptr<cv::Vec3f>(i);
+                               for (SLint x = 0; x < envSize; ++x)
+                               {
+                                   SLVec3f v = cubeTexelDir(face, x, y, envSize).normalized();
+                                   SLfloat s = std::atan2(v.z, v.x) * 0.1591f + 0.5f;
+                                   SLfloat t = std::asin(v.y) * 0.3183f + 0.5f;
+                                   SLVec3f c = sampleBilinear(equirect, s, t);
+                                   row[x]    = cv::Vec3f(c.x, c.y, c.z);
+                               }
+                           },
+                           "SLGLTextureIBL");
+
+        if (!Utils::fileExists(envFile))
+            ok = writeCache(envMaps, envFile) && ok;
+
+        // Mip levels as glGenerateMipmap creates them: env[mipLevel][face]
+        vector<CVVMat> env(1);
+        CVVMat         faceMips[6];
+        for (SLint face = 0; face < 6; ++face)
+        {
+            env[0].push_back(envMaps.rowRange(face * envSize, (face + 1) * envSize));
+            CVImage::buildMipmaps(env[0].back(), faceMips[face]);
+        }
+        for (size_t m = 0; m < faceMips[0].size(); ++m)
+        {
+            env.push_back(CVVMat());
+            for (SLint face = 0; face < 6; ++face)
+                env.back().push_back(faceMips[face][m]);
+        }
+
+        // Irradiance: uniform hemisphere grid as in PBR_IrradianceConvolution.frag
+        if (!Utils::fileExists(irrFile))
+        {
+            const SLfloat sampleDelta = 0.025f;
+            SLVVec4f      samples; // tangent space direction and weight
+            for (SLfloat phi = 0.0f; phi < 2.0f * Utils::PI; phi += sampleDelta)
+                for (SLfloat theta = 0.0f; theta < 0.5f * Utils::PI; theta += sampleDelta)
+                    samples.push_back(SLVec4f(std::sin(theta) * std::cos(phi),
+                                              std::sin(theta) * std::sin(phi),
+                                              std::cos(theta),
+                                              std::cos(theta) * std::sin(theta)));
+
+            SLfloat lod     = std::max(0.0f, std::log2((SLfloat)envSize / (SLfloat)irradianceSize));
+            CVMat   irrMaps = CVMat::zeros(6 * irradianceSize, irradianceSize, CV_32FC3);
+            Utils::parallelFor(6 * irradianceSize,
+                               [&](SLint i)
+                               {
+                                   SLint      face = i / irradianceSize;
+                                   SLint      y    = i % irradianceSize;
+                                   cv::Vec3f* row  = irrMaps.ptr<cv::Vec3f>(i);
+                                   for (SLint x = 0; x < irradianceSize; ++x)
+                                   {
+                                       // Same (not normalized) tangent frame as the shader
+                                       SLVec3f N     = cubeTexelDir(face, x, y, irradianceSize).normalized();
+                                       SLVec3f right = SLVec3f(0, 1, 0) ^ N;
+                                       SLVec3f up    = N ^ right;
+                                       SLVec3f irradiance(0, 0, 0);
+                                       for (const SLVec4f& s : samples)
+                                           irradiance += sampleCube(env, right * s.x + up * s.y + N * s.z, lod) * s.w;
+                                       irradiance *= Utils::PI / (SLfloat)samples.size();
+                                       row[x] = cv::Vec3f(irradiance.x, irradiance.y, irradiance.z);
+                                   }
+                               },
+                               "SLGLTextureIBL");
+            ok = writeCache(irrMaps, irrFile) && ok;
+        }
+
+        // Prefiltered roughness: GGX importance sampling as in PBR_PrefilterRoughness.frag
+        if (!Utils::fileExists(roughFile))
+        {
+            CVMat   roughMaps = CVMat::zeros(cacheRowOffset(TT_roughnessCubemap,
+                                                          roughnessSize,
+                                                          ROUGHNESS_NUM_MIP_LEVELS,
+                                                          0),
+                                           roughnessSize,
+                                           CV_32FC3);
+            SLfloat saTexel   = 4.0f * Utils::PI / (6.0f * (SLfloat)envSize * (SLfloat)envSize);
+
+            for (SLint mipLevel = 0; mipLevel < ROUGHNESS_NUM_MIP_LEVELS; ++mipLevel)
+            {
+                SLint   mipSize   = roughnessSize >> mipLevel;
+                SLfloat roughness = (SLfloat)mipLevel / (SLfloat)(ROUGHNESS_NUM_MIP_LEVELS - 1);
+
+                // With V = R = N the light directions, their weights and mip
+                // levels are the same for all texels in tangent space.
+                SLVVec4f samples; // tangent space light direction and mip level
+                for (SLuint i = 0; i < IBL_SAMPLE_COUNT; ++i)
+                {
+                    SLVec3f H     = importanceSampleGGX(hammersley(i, IBL_SAMPLE_COUNT), roughness);
+                    SLVec3f L     = SLVec3f(2.0f * H.z * H.x, 2.0f * H.z * H.y, 2.0f * H.z * H.z - 1.0f);
+                    SLfloat NdotL = L.z;
+                    if (NdotL <= 0.0f)
+                        continue;
+
+                    SLfloat a        = roughness * roughness;
+                    SLfloat NdotH    = std::max(H.z, 0.0f);
+                    SLfloat denom    = NdotH * NdotH * (a * a - 1.0f) + 1.0f;
+                    SLfloat D        = a * a / (Utils::PI * denom * denom);
+                    SLfloat pdf      = D * NdotH / (4.0f * NdotH) + 0.0001f;
+                    SLfloat saSample = 1.0f / ((SLfloat)IBL_SAMPLE_COUNT * pdf + 0.0001f);
+                    SLfloat lod      = roughness == 0.0f ? 0.0f : 0.5f * std::log2(saSample / saTexel);
+                    L.normalize();
+                    samples.push_back(SLVec4f(L.x, L.y, L.z, lod));
+                }
+
+                Utils::parallelFor(6 * mipSize,
+                                   [&](SLint i)
+                                   {
+                                       SLint      face = i / mipSize;
+                                       SLint      y    = i % mipSize;
+                                       SLint      r    = cacheRowOffset(TT_roughnessCubemap, roughnessSize, mipLevel, face);
+                                       cv::Vec3f* row  = roughMaps.ptr<cv::Vec3f>(r + y);
+                                       for (SLint x = 0; x < mipSize; ++x)
+                                       {
+                                           SLVec3f N         = cubeTexelDir(face, x, y, mipSize).normalized();
+                                           SLVec3f up        = std::abs(N.z) < 0.999f ? SLVec3f(0, 0, 1) : SLVec3f(1, 0, 0);
+                                           SLVec3f tangent   = (up ^ N).normalized();
+                                           SLVec3f bitangent = N ^ tangent;
+                                           SLVec3f color(0, 0, 0);
+                                           SLfloat weight = 0.0f;
+                                           for (const SLVec4f& s : samples)
+                                           {
+                                               SLVec3f L = tangent * s.x + bitangent * s.y + N * s.z;
+                                               color += sampleCube(env, L, s.w) * s.z;
+                                               weight += s.z;
+                                           }
+                                           color *= 1.0f / weight;
+                                           row[x] = cv::Vec3f(color.x, color.y, color.z);
+                                       }
+                                   },
+                                   "SLGLTextureIBL");
+            }
+            ok = writeCache(roughMaps, roughFile) && ok;
+        }
+    }
+
+    // BRDF LUT: split sum integration as in PBR_BRDFIntegration.frag
+    if (!Utils::fileExists(brdfFile))
+    {
+        CVMat brdfMaps = CVMat::zeros(brdfLUTSize, brdfLUTSize, CV_32FC3);
+        Utils::parallelFor(brdfLUTSize,
+                           [&](SLint y)
+                           {
+                               // The half vectors only depend on the roughness of the row
+                               SLfloat  roughness = ((SLfloat)y + 0.5f) / (SLfloat)brdfLUTSize;
+                               SLVVec3f halfVectors;
+                               for (SLuint i = 0; i < IBL_SAMPLE_COUNT; ++i)
+                                   halfVectors.push_back(importanceSampleGGX(hammersley(i, IBL_SAMPLE_COUNT), roughness));
+
+                               cv::Vec3f* row = brdfMaps.ptr<cv::Vec3f>(y);
+                               for (SLint x = 0; x < brdfLUTSize; ++x)
+                               {
+                                   SLfloat NdotV = ((SLfloat)x + 0.5f) / (SLfloat)brdfLUTSize;
+                                   SLVec3f V(std::sqrt(1.0f - NdotV * NdotV), 0.0f, NdotV);
+                                   SLfloat A = 0.0f;
+                                   SLfloat B = 0.0f;
+                                   for (const SLVec3f& H : halfVectors)
+                                   {
+                                       SLVec3f L     = (H * (2.0f * V.dot(H)) - V).normalized();
+                                       SLfloat NdotL = std::max(L.z, 0.0f);
+                                       SLfloat NdotH = std::max(H.z, 0.0f);
+                                       SLfloat VdotH = std::max(V.dot(H), 0.0f);
+                                       if (NdotL > 0.0f)
+                                       {
+                                           SLfloat G     = geometrySchlickGGX(NdotV, roughness) *
+                                                           geometrySchlickGGX(NdotL, roughness);
+                                           SLfloat G_Vis = (G * VdotH) / (NdotH * NdotV);
+                                           SLfloat Fc    = std::pow(1.0f - VdotH, 5.0f);
+                                           A += (1.0f - Fc) * G_Vis;
+                                           B += Fc * G_Vis;
+                                       }
+                                   }
+                                   row[x] = cv::Vec3f(A / (SLfloat)IBL_SAMPLE_COUNT,
+                                                      B / (SLfloat)IBL_SAMPLE_COUNT,
+                                                      0.0f);
+                               }
+                           },
+                           "SLGLTextureIBL");
+        ok = writeCache(brdfMaps, brdfFile) && ok;
+    }
+
+    SL_LOG("IBL maps of %s computed on the CPU in %.0f ms",
+           hdrImageFile.c_str(),
+           timer.elapsedTimeInMilliSec());
+    return ok;
+}
+//-----------------------------------------------------------------------------
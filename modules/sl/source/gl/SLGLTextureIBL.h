@@ -27,6 +27,14 @@
  SLGLFrameBuffer class to render the scene into a cube map. These generated
  textures only exist on the GPU. There are no images in the SLGLTexture::_images
  vector.
+ With a cachePath the generated maps are read back after rendering and stored
+ as Radiance RGBE files (run-length encoded) with all faces and mip levels
+ stacked vertically. The file name contains a hash of the source HDR file, the
+ texture type and the resolutions, so a changed HDR image or resolution gives a
+ new cache file. On the next scene load build uploads the cached maps directly
+ and skips the rendering. The cache can also be produced without a GPU by
+ buildCacheCPU, which computes the same maps with the same sampling as the
+ shaders on all CPU cores.
 */
 class SLGLTextureIBL : public SLGLTexture
 {
@@ -50,6 +58,14 @@ public:
     virtual void build(SLint texID = 0);
     void         logFramebufferStatus();
 
+    static SLbool buildCacheCPU(const SLstring& hdrImageFile,
+                                SLint           envSize,
+                                SLint           irradianceSize = 32,
+                                SLint           roughnessSize  = 128,
+                                SLint           brdfLUTSize    = 512);
+
+    static SLstring cachePath; //!< Directory of the IBL map cache (empty = no caching)
+
 protected:
     // converting the hdr image file to cubemap
     void renderCube();
@@ -59,6 +75,26 @@ protected:
                     string name,
                     bool   savePNG);
 
+    // IBL map cache
+    SLstring        cacheFileName();
+    SLbool          loadCache(const SLstring& cacheFile);
+    void            readPixelsToCache(CVMat& maps,
+                                      SLint  mipLevel,
+                                      SLint  face,
+                                      SLint  width,
+                                      SLint  height);
+    static SLbool   hashHdrFile(const SLstring& hdrImageFile, uint64_t& hash);
+    static SLstring cacheFileName(const SLstring& hdrImageFile,
+                                  uint64_t        hdrHash,
+                                  SLTextureType   texType,
+                                  SLint           size,
+                                  SLint           sourceSize);
+    static SLint    cacheRowOffset(SLTextureType texType,
+                                   SLint         height,
+                                   SLint         mipLevel,
+                                   SLint         face);
+    static SLbool   writeCache(const CVMat& maps, const SLstring& cacheFile);
+
     SLuint _cubeVAO = 0;
     SLuint _cubeVBO = 0;
     SLuint _quadVAO = 0;
@@ -69,6 +105,8 @@ protected:
     SLMat4f      _captureProjection; //!< Projection matrix for capturing the textures
     SLVMat4f     _captureViews;      //!< All 6 positions of the views that represent the 6 sides of the cube map
     SLbool       _readBackPixels;    //!< Flag if generated texture should be read back from GPU into cvMat
+    SLbool       _hdrHashed = false; //!< Flag if _hdrHash is computed (only on the map generated from the HDR texture)
+    uint64_t     _hdrHash   = 0;     //!< Hash over the content of the HDR image file
 };
 //-----------------------------------------------------------------------------
 #endif
@@ -11,6 +11,8 @@
 
 #include <mutex>
 #include <iostream>
+#include <deque>
+#include <algorithm>
 
 #include "SLFileStorage.h"
 #include "SLGLProgramManager.h"
@@ -20,6 +22,8 @@
 #include "SLScene.h"
 #include "SLAssetManager.h"
 #include "SLDeviceLocation.h"
+#include <HighResTimer.h>
+#include <Profiler.h>
 
 //-----------------------------------------------------------------------------
 using std::unique_lock;
@@ -32,6 +36,9 @@ SLAssetLoader::SLAssetLoader(SLstring modelPath,
     _texturePath(texturePath),
     _shaderPath(shaderPath),
     _fontPath(fontPath),
+    _lastExclusiveTask(-1),
+    _numTasksDone(0),
+    _lastLoadTimeMS(0.0f),
     _state(State::IDLE)
 {
     auto workerFunc = [this]()
@@ -49,8 +56,7 @@ SLAssetLoader::SLAssetLoader(SLstring modelPath,
             if (_state == State::SUBMITTED)
             {
                 // Process the tasks defined by the main thread.
-                for (SLAssetLoadTask& task : _loadTasks)
-                    task();
+                runTasks();
 
                 // Notify the main thread that the worker thread is done.
                 // The main thread checks this in checkIfAsyncLoadingIsDone.
@@ -86,103 +92,104 @@ SLAssetLoader::~SLAssetLoader()
     _worker.join();
 }
 //-----------------------------------------------------------------------------
-void SLAssetLoader::addRawDataToLoad(SLIOBuffer&    buffer,
-                                     SLstring       filename,
-                                     SLIOStreamKind kind)
+SLAssetLoadTaskID SLAssetLoader::addRawDataToLoad(SLIOBuffer&    buffer,
+                                                  SLstring       filename,
+                                                  SLIOStreamKind kind)
 {
-    _loadTasks.push_back([this, &buffer, filename, kind]
-                         { buffer = SLFileStorage::readIntoBuffer(filename, kind); });
+    return addTask("Raw data " + Utils::getFileName(filename),
+                   [&buffer, filename, kind](SLAssetManager*)
+                   { buffer = SLFileStorage::readIntoBuffer(filename, kind); });
 }
 //-----------------------------------------------------------------------------
-void SLAssetLoader::addTextureToLoad(SLGLTexture*&   texture,
-                                     const SLstring& path,
-                                     SLint           min_filter,
-                                     SLint           mag_filter,
-                                     SLTextureType   type,
-                                     SLint           wrapS,
-                                     SLint           wrapT)
+SLAssetLoadTaskID SLAssetLoader::addTextureToLoad(SLGLTexture*&   texture,
+                                                  const SLstring& path,
+                                                  SLint           min_filter,
+                                                  SLint           mag_filter,
+                                                  SLTextureType   type,
+                                                  SLint           wrapS,
+                                                  SLint           wrapT)
 {
-    _loadTasks.push_back([this,
-                          &texture,
-                          path,
-                          min_filter,
-                          mag_filter,
-                          type,
-                          wrapS,
-                          wrapT]
-                         { texture = new SLGLTexture(_scene->assetManager(),
-                                                     path,
-                                                     min_filter,
-                                                     mag_filter,
-                                                     type,
-                                                     wrapS,
-                                                     wrapT); });
+    return addTask("Texture " + Utils::getFileName(path),
+                   [&texture,
+                    path,
+                    min_filter,
+                    mag_filter,
+                    type,
+                    wrapS,
+                    wrapT](SLAssetManager* am)
+                   { texture = new SLGLTexture(am,
+                                               path,
+                                               min_filter,
+                                               mag_filter,
+                                               type,
+                                               wrapS,
+                                               wrapT); });
 }
 //-----------------------------------------------------------------------------
-void SLAssetLoader::addTextureToLoad(SLGLTexture*&   texture,
-                                     const SLstring& filenameXPos,
-                                     const SLstring& filenameXNeg,
-                                     const SLstring& filenameYPos,
-                                     const SLstring& filenameYNeg,
-                                     const SLstring& filenameZPos,
-                                     const SLstring& filenameZNeg,
-                                     SLint           min_filter,
-                                     SLint           mag_filter,
-                                     SLTextureType   type)
+SLAssetLoadTaskID SLAssetLoader::addTextureToLoad(SLGLTexture*&   texture,
+                                                  const SLstring& filenameXPos,
+                                                  const SLstring& filenameXNeg,
+                                                  const SLstring& filenameYPos,
+                                                  const SLstring& filenameYNeg,
+                                                  const SLstring& filenameZPos,
+                                                  const SLstring& filenameZNeg,
+                                                  SLint           min_filter,
+                                                  SLint           mag_filter,
+                                                  SLTextureType   type)
 {
-    _loadTasks.push_back([this,
-                          &texture,
-                          filenameXPos,
-                          filenameXNeg,
-                          filenameYPos,
-                          filenameYNeg,
-                          filenameZPos,
-                          filenameZNeg,
-                          min_filter,
-                          mag_filter,
-                          type]
-                         { texture = new SLGLTexture(_scene->assetManager(),
-                                                     filenameXPos,
-                                                     filenameXNeg,
-                                                     filenameYPos,
-                                                     filenameYNeg,
-                                                     filenameZPos,
-                                                     filenameZNeg,
-                                                     min_filter,
-                                                     mag_filter,
-                                                     type); });
+    return addTask("Cube map " + Utils::getFileName(filenameXPos),
+                   [&texture,
+                    filenameXPos,
+                    filenameXNeg,
+                    filenameYPos,
+                    filenameYNeg,
+                    filenameZPos,
+                    filenameZNeg,
+                    min_filter,
+                    mag_filter,
+                    type](SLAssetManager* am)
+                   { texture = new SLGLTexture(am,
+                                               filenameXPos,
+                                               filenameXNeg,
+                                               filenameYPos,
+                                               filenameYNeg,
+                                               filenameZPos,
+                                               filenameZNeg,
+                                               min_filter,
+                                               mag_filter,
+                                               type); });
 }
 //-----------------------------------------------------------------------------
-void SLAssetLoader::addTextureToLoad(SLGLTexture*&   texture,
-                                     SLint           depth,
-                                     const SLstring& imagePath,
-                                     SLint           min_filter,
-                                     SLint           mag_filter,
-                                     SLint           wrapS,
-                                     SLint           wrapT,
-                                     const SLstring& name,
-                                     SLbool          loadGrayscaleIntoAlpha)
+SLAssetLoadTaskID SLAssetLoader::addTextureToLoad(SLGLTexture*&   texture,
+                                                  SLint           depth,
+                                                  const SLstring& imagePath,
+                                                  SLint           min_filter,
+                                                  SLint           mag_filter,
+                                                  SLint           wrapS,
+                                                  SLint           wrapT,
+                                                  const SLstring& name,
+                                                  SLbool          loadGrayscaleIntoAlpha)
 
 {
-    _loadTasks.push_back([this,
-                          &texture,
-                          depth,
-                          imagePath,
-                          min_filter,
-                          mag_filter,
-                          wrapS,
-                          wrapT,
-                          name,
-                          loadGrayscaleIntoAlpha]
-                         { texture = new SLGLTexture(_scene->assetManager(),
-                                                     depth,
-                                                     imagePath,
-                                                     min_filter,
-                                                     mag_filter,
-                                                     wrapS,
-                                                     wrapT,
-                                                     name,
-                                                     loadGrayscaleIntoAlpha); });
+    return addTask("3D texture " + Utils::getFileName(imagePath),
+                   [&texture,
+                    depth,
+                    imagePath,
+                    min_filter,
+                    mag_filter,
+                    wrapS,
+                    wrapT,
+                    name,
+                    loadGrayscaleIntoAlpha](SLAssetManager* am)
+                   { texture = new SLGLTexture(am,
+                                               depth,
+                                               imagePath,
+                                               min_filter,
+                                               mag_filter,
+                                               wrapS,
+                                               wrapT,
+                                               name,
+                                               loadGrayscaleIntoAlpha); });
 }
 //-----------------------------------------------------------------------------
 /*! Method for adding a 3D texture from a vector of images to load in parallel
@@ -198,80 +205,83 @@ void SLAssetLoader::addTextureToLoad(SLGLTexture*&   texture,
  * \param loadGrayscaleIntoAlpha Flag if grayscale image should be loaded into
  * alpha channel.
  */
-void SLAssetLoader::addTextureToLoad(SLGLTexture*&    texture,
-                                     const SLVstring& imagePaths,
-                                     SLint            min_filter,
-                                     SLint            mag_filter,
-                                     SLint            wrapS,
-                                     SLint            wrapT,
-                                     const SLstring&  name,
-                                     SLbool           loadGrayscaleIntoAlpha)
+SLAssetLoadTaskID SLAssetLoader::addTextureToLoad(SLGLTexture*&    texture,
+                                                  const SLVstring& imagePaths,
+                                                  SLint            min_filter,
+                                                  SLint            mag_filter,
+                                                  SLint            wrapS,
+                                                  SLint            wrapT,
+                                                  const SLstring&  name,
+                                                  SLbool           loadGrayscaleIntoAlpha)
 {
-    _loadTasks.push_back([this,
-                          &texture,
-                          imagePaths,
-                          min_filter,
-                          mag_filter,
-                          wrapS,
-                          wrapT,
-                          name,
-                          loadGrayscaleIntoAlpha]
-                         { texture = new SLGLTexture(_scene->assetManager(),
-                                                     imagePaths,
-                                                     min_filter,
-                                                     mag_filter,
-                                                     wrapS,
-                                                     wrapT,
-                                                     name,
-                                                     loadGrayscaleIntoAlpha); });
+    return addTask("3D texture " + name,
+                   [&texture,
+                    imagePaths,
+                    min_filter,
+                    mag_filter,
+                    wrapS,
+                    wrapT,
+                    name,
+                    loadGrayscaleIntoAlpha](SLAssetManager* am)
+                   { texture = new SLGLTexture(am,
+                                               imagePaths,
+                                               min_filter,
+                                               mag_filter,
+                                               wrapS,
+                                               wrapT,
+                                               name,
+                                               loadGrayscaleIntoAlpha); });
 }
 //-----------------------------------------------------------------------------
-void SLAssetLoader::addGeoTiffToLoad(SLDeviceLocation& devLoc,
-                                     const SLstring&   imageFileWithPath)
+SLAssetLoadTaskID SLAssetLoader::addGeoTiffToLoad(SLDeviceLocation& devLoc,
+                                                  const SLstring&   imageFileWithPath)
 {
-    _loadTasks.push_back([this,
-                          &devLoc,
-                          imageFileWithPath]
-                         { devLoc.loadGeoTiff(imageFileWithPath); });
+    return addTask("GeoTiff " + Utils::getFileName(imageFileWithPath),
+                   [&devLoc,
+                    imageFileWithPath](SLAssetManager*)
+                   { devLoc.loadGeoTiff(imageFileWithPath); });
 }
 //-----------------------------------------------------------------------------
-void SLAssetLoader::addProgramToLoad(SLGLProgram*&   program,
-                                     const SLstring& vertShaderPath,
-                                     const SLstring& fragShaderPath)
+SLAssetLoadTaskID SLAssetLoader::addProgramToLoad(SLGLProgram*&   program,
+                                                  const SLstring& vertShaderPath,
+                                                  const SLstring& fragShaderPath)
 {
-    _loadTasks.push_back([this,
-                          &program,
-                          vertShaderPath,
-                          fragShaderPath]
-                         { program = new SLGLProgramGeneric(_scene->assetManager(),
-                                                            vertShaderPath,
-                                                            fragShaderPath); });
+    return addTask("Program " + Utils::getFileName(fragShaderPath),
+                   [&program,
+                    vertShaderPath,
+                    fragShaderPath](SLAssetManager* am)
+                   { program = new SLGLProgramGeneric(am,
+                                                      vertShaderPath,
+                                                      fragShaderPath); });
 }
 //-----------------------------------------------------------------------------
-void SLAssetLoader::addNodeToLoad(SLNode*&        node,
-                                  const SLstring& modelPath,
-                                  SLSkybox*       skybox,
-                                  SLbool          deleteTexImgAfterBuild,
-                                  SLbool          loadMeshesOnly,
-                                  SLMaterial*     overrideMat,
-                                  float           ambientFactor,
-                                  SLbool          forceCookTorranceRM,
-                                  SLuint          flags)
+SLAssetLoadTaskID SLAssetLoader::addNodeToLoad(SLNode*&        node,
+                                               const SLstring& modelPath,
+                                               SLSkybox*       skybox,
+                                               SLbool          deleteTexImgAfterBuild,
+                                               SLbool          loadMeshesOnly,
+                                               SLMaterial*     overrideMat,
+                                               float           ambientFactor,
+                                               SLbool          forceCookTorranceRM,
+                                               SLuint          flags)
 {
-    _loadTasks.push_back([this,
-                          &node,
-                          modelPath,
-                          skybox,
-                          deleteTexImgAfterBuild,
-                          loadMeshesOnly,
-                          overrideMat,
-                          ambientFactor,
-                          forceCookTorranceRM,
-                          flags]
-                         {
+    return addTask("Model " + Utils::getFileName(modelPath),
+                   [this,
+                    &node,
+                    modelPath,
+                    skybox,
+                    deleteTexImgAfterBuild,
+                    loadMeshesOnly,
+                    overrideMat,
+                    ambientFactor,
+                    forceCookTorranceRM,
+                    flags](SLAssetManager* am)
+                   {
+        // Every task has its own importer. The importer locks the shared
+        // SLAnimManager only while it registers skeletons and animations.
         SLAssimpImporter importer;
         node = importer.load(_scene->animManager(),
-                             _scene->assetManager(),
+                             am,
                              modelPath,
                              _texturePath,
                              skybox,
@@ -284,60 +294,260 @@ void SLAssetLoader::addNodeToLoad(SLNode*&        node,
                              flags); });
 }
 //-----------------------------------------------------------------------------
-void SLAssetLoader::addSkyboxToLoad(SLSkybox*&      skybox,
-                                    const SLstring& hdrImageWithFullPath,
-                                    SLVec2i         resolution,
-                                    SLstring        name)
+SLAssetLoadTaskID SLAssetLoader::addSkyboxToLoad(SLSkybox*&      skybox,
+                                                 const SLstring& hdrImageWithFullPath,
+                                                 SLVec2i         resolution,
+                                                 SLstring        name)
 {
-    _loadTasks.push_back([this,
-                          &skybox,
-                          hdrImageWithFullPath,
-                          resolution,
-                          name]
-                         { skybox = new SLSkybox(_scene->assetManager(),
-                                                 _shaderPath,
-                                                 hdrImageWithFullPath,
-                                                 resolution,
-                                                 name); });
+    return addTask("Skybox " + Utils::getFileName(hdrImageWithFullPath),
+                   [this,
+                    &skybox,
+                    hdrImageWithFullPath,
+                    resolution,
+                    name](SLAssetManager* am)
+                   { skybox = new SLSkybox(am,
+                                           _shaderPath,
+                                           hdrImageWithFullPath,
+                                           resolution,
+                                           name); });
 }
 //-----------------------------------------------------------------------------
-void SLAssetLoader::addLoadTask(SLAssetLoadTask task)
+/*! Adds a generic task. Without dependencies the task waits for all tasks
+ * added before and all tasks added after wait for it, so it runs alone as in
+ * the former sequential loading. With dependencies the task runs in parallel
+ * to other tasks as soon as its dependencies are done. It must then not
+ * register assets in the asset manager of the scene.
+ */
+SLAssetLoadTaskID SLAssetLoader::addLoadTask(SLAssetLoadTask           task,
+                                             const SLstring&           name,
+                                             vector<SLAssetLoadTaskID> dependencies)
 {
-    _loadTasks.push_back(task);
+    SLAssetLoadTaskID id        = (SLAssetLoadTaskID)_loadTasks.size();
+    SLbool            exclusive = dependencies.empty();
+
+    if (exclusive)
+    {
+        for (SLAssetLoadTaskID i = 0; i < id; ++i)
+            dependencies.push_back(i);
+        _lastExclusiveTask = id;
+    }
+
+    _loadTasks.push_back({[task](SLAssetManager*)
+                          { task(); },
+                          name,
+                          dependencies,
+                          exclusive,
+                          0.0f});
+    return id;
 }
 //-----------------------------------------------------------------------------
-void SLAssetLoader::addSkyboxToLoad(SLSkybox*&      skybox,
-                                    const SLstring& cubeMapXPos,
-                                    const SLstring& cubeMapXNeg,
-                                    const SLstring& cubeMapYPos,
-                                    const SLstring& cubeMapYNeg,
-                                    const SLstring& cubeMapZPos,
-                                    const SLstring& cubeMapZNeg)
+//! Adds a typed task that registers its assets in the passed asset manager
+SLAssetLoadTaskID SLAssetLoader::addTask(const SLstring&                 name,
+                                         function<void(SLAssetManager*)> func)
 {
-    _loadTasks.push_back([this,
-                          &skybox,
-                          cubeMapXPos,
-                          cubeMapXNeg,
-                          cubeMapYPos,
-                          cubeMapYNeg,
-                          cubeMapZPos,
-                          cubeMapZNeg]
-                         { skybox = new SLSkybox(_scene->assetManager(),
-                                                 _shaderPath,
-                                                 _texturePath + cubeMapXPos,
-                                                 _texturePath + cubeMapXNeg,
-                                                 _texturePath + cubeMapYPos,
-                                                 _texturePath + cubeMapYNeg,
-                                                 _texturePath + cubeMapZPos,
-                                                 _texturePath + cubeMapZNeg); });
+    SLAssetLoadTaskID         id = (SLAssetLoadTaskID)_loadTasks.size();
+    vector<SLAssetLoadTaskID> dependencies;
+    if (_lastExclusiveTask >= 0)
+        dependencies.push_back(_lastExclusiveTask);
+
+    _loadTasks.push_back({func, name, dependencies, false, 0.0f});
+    return id;
 }
 //-----------------------------------------------------------------------------
-void SLAssetLoader::loadAssetsSync()
+/*! Lets a task wait for another task (e.g. a model task for a texture task
+ * that its material uses). The dependency must be added before the task.
+ */
+void SLAssetLoader::dependsOn(SLAssetLoadTaskID task, SLAssetLoadTaskID dependency)
 {
-    for (const SLAssetLoadTask& task : _loadTasks)
-        task();
+    assert(task >= 0 && task < (SLAssetLoadTaskID)_loadTasks.size() &&
+           "SLAssetLoader::dependsOn: invalid task");
+    assert(dependency >= 0 && dependency < task &&
+           "SLAssetLoader::dependsOn: dependency must be added before the task");
 
+    if (dependency >= 0 && dependency < task && task < (SLAssetLoadTaskID)_loadTasks.size())
+        _loadTasks[task].dependencies.push_back(dependency);
+}
+//-----------------------------------------------------------------------------
+SLAssetLoadTaskID SLAssetLoader::addSkyboxToLoad(SLSkybox*&      skybox,
+                                                 const SLstring& cubeMapXPos,
+                                                 const SLstring& cubeMapXNeg,
+                                                 const SLstring& cubeMapYPos,
+                                                 const SLstring& cubeMapYNeg,
+                                                 const SLstring& cubeMapZPos,
+                                                 const SLstring& cubeMapZNeg)
+{
+    return addTask("Skybox " + Utils::getFileName(cubeMapXPos),
+                   [this,
+                    &skybox,
+                    cubeMapXPos,
+                    cubeMapXNeg,
+                    cubeMapYPos,
+                    cubeMapYNeg,
+                    cubeMapZPos,
+                    cubeMapZNeg](SLAssetManager* am)
+                   { skybox = new SLSkybox(am,
+                                           _shaderPath,
+                                           _texturePath + cubeMapXPos,
+                                           _texturePath + cubeMapXNeg,
+                                           _texturePath + cubeMapYPos,
+                                           _texturePath + cubeMapYNeg,
+                                           _texturePath + cubeMapZPos,
+                                           _texturePath + cubeMapZNeg); });
+}
+//-----------------------------------------------------------------------------
+void SLAssetLoader::loadAssetsSync()
+{
+    runTasks();
     _loadTasks.clear();
+    _lastExclusiveTask = -1;
+}
+//-----------------------------------------------------------------------------
+/*! Executes the task graph on Utils::maxThreads threads. The calling thread
+ * is one of them. A task gets ready as soon as all its dependencies are done.
+ * The typed tasks get an own asset manager that is merged into the scene
+ * asset manager in task order before an exclusive task and at the end. At
+ * these points no other task runs, so the merge needs no further locking.
+ * For the lookup of already loaded textures a typed task can read the scene
+ * asset manager and the asset managers of all tasks that finished before it
+ * started. None of them changes while the task runs.
+ */
+void SLAssetLoader::runTasks()
+{
+    PROFILE_FUNCTION();
+
+    HighResTimer timer;
+    size_t       numTasks = _loadTasks.size();
+    _numTasksDone         = 0;
+
+    SLAssetManager* sceneAM = _scene ? _scene->assetManager() : nullptr;
+
+    vector<SLint>                           numOpenDeps(numTasks, 0);
+    vector<vector<SLAssetLoadTaskID>>       dependents(numTasks);
+    vector<std::unique_ptr<SLAssetManager>> taskAMs(numTasks);
+    vector<SLAssetManager*>                 doneAMs;
+    std::deque<SLAssetLoadTaskID>           ready;
+
+    for (size_t i = 0; i < numTasks; ++i)
+    {
+        for (SLAssetLoadTaskID d : _loadTasks[i].dependencies)
+        {
+            numOpenDeps[i]++;
+            dependents[d].push_back((SLAssetLoadTaskID)i);
+        }
+        if (numOpenDeps[i] == 0)
+            ready.push_back((SLAssetLoadTaskID)i);
+    }
+
+    mutex              graphMutex;
+    condition_variable graphCondVar;
+    size_t             numDone   = 0;
+    size_t             numMerged = 0;
+
+    // Merges the task asset managers of all tasks before end in task order
+    auto mergeTaskAMs = [&](size_t end)
+    {
+        for (; numMerged < end; ++numMerged)
+        {
+            if (taskAMs[numMerged] && sceneAM)
+                sceneAM->merge(*taskAMs[numMerged]);
+            taskAMs[numMerged].reset();
+        }
+        doneAMs.clear();
+    };
+
+    auto worker = [&]()
+    {
+        unique_lock lock(graphMutex);
+        while (true)
+        {
+            graphCondVar.wait(lock, [&]()
+                              { return !ready.empty() || numDone == numTasks; });
+            if (ready.empty())
+                break;
+
+            SLAssetLoadTaskID id   = ready.front();
+            Task&             task = _loadTasks[id];
+            ready.pop_front();
+
+            SLAssetManager* am = sceneAM;
+            if (task.exclusive)
+                mergeTaskAMs((size_t)id);
+            else
+            {
+                taskAMs[id] = std::make_unique<SLAssetManager>();
+                am          = taskAMs[id].get();
+
+                vector<SLAssetManager*> lookupAMs(doneAMs);
+                if (sceneAM)
+                    lookupAMs.insert(lookupAMs.begin(), sceneAM);
+                am->lookupAssetManagers(lookupAMs);
+            }
+            lock.unlock();
+
+            HighResTimer taskTimer;
+            task.func(am);
+            task.timeMS = taskTimer.elapsedTimeInMilliSec();
+
+            lock.lock();
+            if (taskAMs[id])
+                doneAMs.push_back(taskAMs[id].get());
+            numDone++;
+            _numTasksDone = (SLint)numDone;
+            for (SLAssetLoadTaskID d : dependents[id])
+                if (--numOpenDeps[d] == 0)
+                    ready.push_back(d);
+            graphCondVar.notify_all();
+        }
+    };
+
+    SLuint         numThreads = std::max(1u, std::min(Utils::maxThreads(), (SLuint)numTasks));
+    vector<thread> threads;
+    for (SLuint t = 1; t < numThreads; ++t)
+    {
+        threads.emplace_back([&]()
+                             {
+                                 PROFILE_THREAD("AssetLoader");
+                                 worker();
+                             });
+    }
+    worker();
+    for (thread& t : threads)
+        t.join();
+
+    mergeTaskAMs(numTasks);
+
+    _lastLoadTimeMS = timer.elapsedTimeInMilliSec();
+    logTimings(_lastLoadTimeMS);
+}
+//-----------------------------------------------------------------------------
+//! Logs the wall clock time, the sum of all task times and the slowest tasks
+void SLAssetLoader::logTimings(SLfloat totalMS)
+{
+    if (_loadTasks.empty())
+        return;
+
+    SLfloat        sumMS = 0.0f;
+    vector<size_t> order(_loadTasks.size());
+    for (size_t i = 0; i < _loadTasks.size(); ++i)
+    {
+        order[i] = i;
+        sumMS += _loadTasks[i].timeMS;
+    }
+
+    SL_LOG("SLAssetLoader: %d tasks in %.1f ms (sum of task times: %.1f ms)",
+           (SLint)_loadTasks.size(),
+           totalMS,
+           sumMS);
+
+    std::sort(order.begin(),
+              order.end(),
+              [this](size_t a, size_t b)
+              { return _loadTasks[a].timeMS > _loadTasks[b].timeMS; });
+
+    for (size_t i = 0; i < std::min((size_t)5, order.size()); ++i)
+        SL_LOG("  %8.1f ms: %s",
+               _loadTasks[order[i]].timeMS,
+               _loadTasks[order[i]].name.c_str());
 }
 //-----------------------------------------------------------------------------
 void SLAssetLoader::loadAssetsAsync(function<void()> onDoneLoading)
@@ -360,6 +570,7 @@ void SLAssetLoader::checkIfAsyncLoadingIsDone()
     {
         _state = State::IDLE;
         _loadTasks.clear();
+        _lastExclusiveTask = -1;
 
         _onDoneLoading();
     }
@@ -40,7 +40,24 @@ using std::thread;
 //-----------------------------------------------------------------------------
 typedef function<void()>        SLAssetLoadTask;
 typedef vector<SLAssetLoadTask> SLVAssetLoadTask;
+typedef SLint                   SLAssetLoadTaskID; //!< Index of a task in the task graph
 //-----------------------------------------------------------------------------
+//! Loads the assets of a scene on a pool of worker threads
+/*! The load tasks form a task graph that is executed by Utils::maxThreads
+ * threads. A task starts as soon as all its dependencies are done. The
+ * dependencies are either added with dependsOn or implicit for generic tasks:
+ * A generic task added with addLoadTask without dependencies waits for all
+ * tasks added before it and all tasks added after it wait for it. So the
+ * generic tasks keep their sequential semantics and run alone.
+ * The typed tasks (textures, programs, models, skyboxes, ...) register their
+ * assets in a task local SLAssetManager. These are merged in task order into
+ * the asset manager of the scene before a generic task runs and after the
+ * last task, so the assets are in the same order as with sequential loading.
+ * Model imports are serialized among themselves because the importer
+ * registers skeletons and animations in the shared SLAnimManager.
+ * No task is allowed to make OpenGL calls. The GL objects are built after
+ * loading in the main thread (see checkIfAsyncLoadingIsDone).
+ */
 class SLAssetLoader
 {
 private:
@@ -66,114 +83,141 @@ public:
 
     // Getters
     bool     isLoading() const { return _state != State::IDLE; }
+    SLint    numTasks() const { return (SLint)_loadTasks.size(); }
+    SLint    numTasksDone() const { return _numTasksDone; }
+    SLfloat  lastLoadTimeMS() const { return _lastLoadTimeMS; }
     SLstring modelPath() const { return _modelPath; }
     SLstring shaderPath() const { return _shaderPath; }
     SLstring texturePath() const { return _texturePath; }
 
-    void addRawDataToLoad(SLIOBuffer&    buffer,
-                          SLstring       filename,
-                          SLIOStreamKind kind);
+    SLAssetLoadTaskID addRawDataToLoad(SLIOBuffer&    buffer,
+                                       SLstring       filename,
+                                       SLIOStreamKind kind);
 
     //! Add 2D textures with internal image allocation
-    void addTextureToLoad(SLGLTexture*&   texture,
-                          const SLstring& path,
-                          SLint           min_filter = GL_LINEAR_MIPMAP_LINEAR,
-                          SLint           mag_filter = GL_LINEAR,
-                          SLTextureType   type       = TT_unknown,
-                          SLint           wrapS      = GL_REPEAT,
-                          SLint           wrapT      = GL_REPEAT);
+    SLAssetLoadTaskID addTextureToLoad(SLGLTexture*&   texture,
+                                       const SLstring& path,
+                                       SLint           min_filter = GL_LINEAR_MIPMAP_LINEAR,
+                                       SLint           mag_filter = GL_LINEAR,
+                                       SLTextureType   type       = TT_unknown,
+                                       SLint           wrapS      = GL_REPEAT,
+                                       SLint           wrapT      = GL_REPEAT);
 
     //! Add cube map texture with internal image allocation
-    void addTextureToLoad(SLGLTexture*&   texture,
-                          const SLstring& imageFilenameXPos,
-                          const SLstring& imageFilenameXNeg,
-                          const SLstring& imageFilenameYPos,
-                          const SLstring& imageFilenameYNeg,
-                          const SLstring& imageFilenameZPos,
-                          const SLstring& imageFilenameZNeg,
-                          SLint           min_filter = GL_LINEAR,
-                          SLint           mag_filter = GL_LINEAR,
-                          SLTextureType   type       = TT_unknown);
+    SLAssetLoadTaskID addTextureToLoad(SLGLTexture*&   texture,
+                                       const SLstring& imageFilenameXPos,
+                                       const SLstring& imageFilenameXNeg,
+                                       const SLstring& imageFilenameYPos,
+                                       const SLstring& imageFilenameYNeg,
+                                       const SLstring& imageFilenameZPos,
+                                       const SLstring& imageFilenameZNeg,
+                                       SLint           min_filter = GL_LINEAR,
+                                       SLint           mag_filter = GL_LINEAR,
+                                       SLTextureType   type       = TT_unknown);
 
     //! Add 3D texture from a single file with depth as 3rd dimension
-    void addTextureToLoad(SLGLTexture*&   texture,
-                          SLint           depth,
-                          const SLstring& path,
-                          SLint           min_filter             = GL_LINEAR,
-                          SLint           mag_filter             = GL_LINEAR,
-                          SLint           wrapS                  = GL_REPEAT,
-                          SLint           wrapT                  = GL_REPEAT,
-                          const SLstring& name                   = "3D-Texture",
-                          SLbool          loadGrayscaleIntoAlpha = false);
+    SLAssetLoadTaskID addTextureToLoad(SLGLTexture*&   texture,
+                                       SLint           depth,
+                                       const SLstring& path,
+                                       SLint           min_filter             = GL_LINEAR,
+                                       SLint           mag_filter             = GL_LINEAR,
+                                       SLint           wrapS                  = GL_REPEAT,
+                                       SLint           wrapT                  = GL_REPEAT,
+                                       const SLstring& name                   = "3D-Texture",
+                                       SLbool          loadGrayscaleIntoAlpha = false);
 
     //! Add 3D texture from a vector of files
-    void addTextureToLoad(SLGLTexture*&    texture,
-                          const SLVstring& imagePaths,
-                          SLint            min_filter,
-                          SLint            mag_filter,
-                          SLint            wrapS,
-                          SLint            wrapT,
-                          const SLstring&  name,
-                          SLbool           loadGrayscaleIntoAlpha);
+    SLAssetLoadTaskID addTextureToLoad(SLGLTexture*&    texture,
+                                       const SLVstring& imagePaths,
+                                       SLint            min_filter,
+                                       SLint            mag_filter,
+                                       SLint            wrapS,
+                                       SLint            wrapT,
+                                       const SLstring&  name,
+                                       SLbool           loadGrayscaleIntoAlpha);
 
     //! Add GeoTiff file to load for the SLDevLocation
-    void addGeoTiffToLoad(SLDeviceLocation& devLoc,
-                          const SLstring&   imageFileWithPath);
+    SLAssetLoadTaskID addGeoTiffToLoad(SLDeviceLocation& devLoc,
+                                       const SLstring&   imageFileWithPath);
 
     //! Add mesh from file to load via assimp loader
-    void addNodeToLoad(SLNode*&        node,
-                       const SLstring& modelPath,
-                       SLSkybox*       skybox                 = nullptr,
-                       SLbool          deleteTexImgAfterBuild = false,
-                       SLbool          loadMeshesOnly         = true,
-                       SLMaterial*     overrideMat            = nullptr,
-                       float           ambientFactor          = 0.5f,
-                       SLbool          forceCookTorranceRM    = false,
-                       SLuint          flags =
-                         SLProcess_Triangulate |
-                         SLProcess_JoinIdenticalVertices |
-                         SLProcess_RemoveRedundantMaterials |
-                         SLProcess_FindDegenerates |
-                         SLProcess_FindInvalidData |
-                         SLProcess_SplitLargeMeshes);
+    SLAssetLoadTaskID addNodeToLoad(SLNode*&        node,
+                                    const SLstring& modelPath,
+                                    SLSkybox*       skybox                 = nullptr,
+                                    SLbool          deleteTexImgAfterBuild = false,
+                                    SLbool          loadMeshesOnly         = true,
+                                    SLMaterial*     overrideMat            = nullptr,
+                                    float           ambientFactor          = 0.5f,
+                                    SLbool          forceCookTorranceRM    = false,
+                                    SLuint          flags =
+                                      SLProcess_Triangulate |
+                                      SLProcess_JoinIdenticalVertices |
+                                      SLProcess_RemoveRedundantMaterials |
+                                      SLProcess_FindDegenerates |
+                                      SLProcess_FindInvalidData |
+                                      SLProcess_SplitLargeMeshes);
 
     //! Add generic GLSL program with shader files to load
-    void addProgramToLoad(SLGLProgram*&   program,
-                          const SLstring& vertShaderFile,
-                          const SLstring& fragShaderFile);
+    SLAssetLoadTaskID addProgramToLoad(SLGLProgram*&   program,
+                                       const SLstring& vertShaderFile,
+                                       const SLstring& fragShaderFile);
 
     //! Add skybox with HDR texture to load
-    void addSkyboxToLoad(SLSkybox*&      skybox,
-                         const SLstring& path,
-                         SLVec2i         resolution,
-                         SLstring        name);
+    SLAssetLoadTaskID addSkyboxToLoad(SLSkybox*&      skybox,
+                                      const SLstring& path,
+                                      SLVec2i         resolution,
+                                      SLstring        name);
 
     //! Add skybox with 6 textures for a cubemap to load
-    void addSkyboxToLoad(SLSkybox*&      skybox,
-                         const SLstring& cubeMapXPos,
-                         const SLstring& cubeMapXNeg,
-                         const SLstring& cubeMapYPos,
-                         const SLstring& cubeMapYNeg,
-                         const SLstring& cubeMapZPos,
-                         const SLstring& cubeMapZNeg);
+    SLAssetLoadTaskID addSkyboxToLoad(SLSkybox*&      skybox,
+                                      const SLstring& cubeMapXPos,
+                                      const SLstring& cubeMapXNeg,
+                                      const SLstring& cubeMapYPos,
+                                      const SLstring& cubeMapYNeg,
+                                      const SLstring& cubeMapZPos,
+                                      const SLstring& cubeMapZNeg);
 
     //! Add generic task
-    void addLoadTask(SLAssetLoadTask task);
+    SLAssetLoadTaskID addLoadTask(SLAssetLoadTask           task,
+                                  const SLstring&           name         = "Task",
+                                  vector<SLAssetLoadTaskID> dependencies = {});
+
+    //! Let a task wait for another task added before it
+    void dependsOn(SLAssetLoadTaskID task, SLAssetLoadTaskID dependency);
 
     void loadAssetsSync();
     void loadAssetsAsync(function<void()> onDone);
     void checkIfAsyncLoadingIsDone();
 
 public:
+    //! Node of the task graph
+    struct Task
+    {
+        function<void(SLAssetManager*)> func;         //!< Load function with the asset manager to register in
+        SLstring                        name;         //!< Name for the timing log
+        vector<SLAssetLoadTaskID>       dependencies; //!< Tasks that have to be done before
+        SLbool                          exclusive;    //!< Flag if task runs alone with the scene asset manager
+        SLfloat                         timeMS;       //!< Execution time of the task
+    };
+
+    SLAssetLoadTaskID addTask(const SLstring&                 name,
+                              function<void(SLAssetManager*)> func);
+    void              runTasks();
+    void              logTimings(SLfloat totalMS);
+
     SLScene*         _scene;
     SLAssetManager*  _am;
     SLstring         _modelPath;
     SLstring         _texturePath;
     SLstring         _shaderPath;
     SLstring         _fontPath;
-    SLVAssetLoadTask _loadTasks;
+    vector<Task>     _loadTasks;
     function<void()> _onDoneLoading; //!< Callback after threaded loading
 
+    SLAssetLoadTaskID _lastExclusiveTask; //!< Last generic task that all later tasks wait for
+    atomic<SLint>     _numTasksDone;      //!< No. of finished tasks for progress display
+    SLfloat           _lastLoadTimeMS;    //!< Wall clock time of the last loading
+
     thread             _worker;         //!< worker thread for parallel loading
     atomic<State>      _state;          //!< current state (used for communication between threads)
     mutex              _messageMutex;   //!< mutex protecting state between threads
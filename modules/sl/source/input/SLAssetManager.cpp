@@ -129,7 +129,25 @@ SLGLProgram* SLAssetManager::getProgramByName(const string& programName)
             return sp;
     return nullptr;
 }
+//-----------------------------------------------------------------------------
+/*! Returns the texture with the url or nullptr. The own textures are searched
+ first, then the textures of the lookup asset managers. These are only read,
+ so they must not change while this asset manager is used (see
+ SLAssetLoader::runTasks).
+ */
+SLGLTexture* SLAssetManager::findTexture(const SLstring& url)
+{
+    for (auto* tex : _textures)
+        if (tex->url() == url)
+            return tex;
+
+    for (auto* am : _lookupAMs)
+        for (auto* tex : am->textures())
+            if (tex->url() == url)
+                return tex;
 
+    return nullptr;
+}
 //-----------------------------------------------------------------------------
 //! merge other asset manager into this
 void SLAssetManager::merge(SLAssetManager& other)
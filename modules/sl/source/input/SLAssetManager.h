@@ -50,6 +50,12 @@ public:
     //! Returns the pointer to shader program if found by name
     SLGLProgram* getProgramByName(const string& programName);
 
+    //! Returns the texture with the url from this or a lookup asset manager
+    SLGLTexture* findTexture(const SLstring& url);
+
+    //! Sets asset managers that findTexture searches read only (see SLAssetLoader)
+    void lookupAssetManagers(const vector<SLAssetManager*>& ams) { _lookupAMs = ams; }
+
     //! merge other asset manager into this
     void merge(SLAssetManager& other);
 
@@ -83,6 +89,8 @@ protected:
     SLVMaterial  _materials; //!< Vector of all materials pointers
     SLVGLTexture _textures;  //!< Vector of all texture pointers
     SLVGLProgram _programs;  //!< Vector of all shader program pointers
+
+    vector<SLAssetManager*> _lookupAMs; //!< Asset managers only read by findTexture
 };
 //-----------------------------------------------------------------------------
 #endif // SLASSETMANAGER_H
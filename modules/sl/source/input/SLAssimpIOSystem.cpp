@@ -81,6 +81,8 @@ Assimp::IOStream* SLAssimpIOSystem::Open(const char* pFile, const char* pMode)
     else if (pMode[0] == 'w')
         streamMode = IOM_write;
 
+    // Local files are memory mapped for reading, so the reads of Assimp
+    // are plain copies out of the mapping without any system calls.
     SLIOStream* stream = SLFileStorage::open(pFile, IOK_model, streamMode);
     return new SLAssimpIOStream(stream);
 }
@@ -13,6 +13,8 @@
 #ifdef SL_BUILD_WITH_ASSIMP
 
 #include <cstddef>
+#include <cstdio>
+#include <cstring>
 #    include <Utils.h>
 
 #    include <SLAnimation.h>
@@ -25,11 +27,16 @@
 #    include <Profiler.h>
 #    include <SLAssimpProgressHandler.h>
 #    include <SLAssimpIOSystem.h>
+#    include <HighResTimer.h>
+#    include <type_traits>
+#    include <thread>
 
 // assimp is only included in the source file to not expose it to the rest of the framework
 #    include <assimp/Importer.hpp>
+#    include <assimp/Exporter.hpp>
 #    include <assimp/scene.h>
 #    include <assimp/pbrmaterial.h>
+#    include <assimp/version.h>
 
 //-----------------------------------------------------------------------------
 //! Temporary struct to hold keyframe data during assimp import.
@@ -266,12 +273,16 @@ SLQuat4f getRotation(SLfloat time, const KeyframeMap& keyframes)
     return SLQuat4f(result.x, result.y, result.z, result.w);
 }
 
+//-----------------------------------------------------------------------------
+SLstring SLAssimpImporter::cachePath;
+std::mutex SLAssimpImporter::_aniManMutex;
 //-----------------------------------------------------------------------------
 /*! Loads the scene from a file and creates materials with textures, the
 meshes and the nodes for the scene graph. Materials, textures and meshes are
 added to the according vectors of SLScene for later deallocation. If an
 override material is provided it will be assigned to all meshes and all
-materials within the file are ignored.
+materials within the file are ignored. With a cachePath the post-processed
+assimp scene is read from or written to the binary scene cache.
 */
 SLNode* SLAssimpImporter::load(SLAnimManager&     aniMan,                 //!< Reference to the animation manager
                                SLAssetManager*    assetMgr,               //!< Pointer to the asset manager
@@ -289,6 +300,9 @@ SLNode* SLAssimpImporter::load(SLAnimManager&     aniMan,                 //!< R
 {
     PROFILE_FUNCTION();
 
+    HighResTimer timer;
+    SLfloat      readMS, scanMS, convertMS, nodesMS, animMS;
+
     // clear the intermediate data
     clear();
 
@@ -307,10 +321,20 @@ SLNode* SLAssimpImporter::load(SLAnimManager&     aniMan,                 //!< R
     if (progressHandler)
         ai.SetProgressHandler((Assimp::ProgressHandler*)progressHandler);
 
-    ///////////////////////////////////////////////////////////////////////
-    ai.SetIOHandler(new SLAssimpIOSystem());
-    const aiScene* scene = ai.ReadFile(pathAndFile, (SLuint)flags);
-    ///////////////////////////////////////////////////////////////////////
+    // Try the binary scene cache first
+    SLstring       cacheFile = cacheFileName(pathAndFile, flags);
+    const aiScene* scene     = cacheFile.empty() ? nullptr : readCache(ai, cacheFile);
+
+    if (!scene)
+    {
+        ///////////////////////////////////////////////////////////////////////
+        ai.SetIOHandler(new SLAssimpIOSystem());
+        scene = ai.ReadFile(pathAndFile, (SLuint)flags);
+        ///////////////////////////////////////////////////////////////////////
+
+        if (scene && !cacheFile.empty())
+            writeCache(scene, cacheFile);
+    }
 
     if (!scene)
     {
@@ -320,36 +344,66 @@ SLNode* SLAssimpImporter::load(SLAnimManager&     aniMan,                 //!< R
         return nullptr;
     }
 
+    readMS = timer.elapsedTimeInMilliSec();
+
     // initial scan of the scene
     performInitialScan(scene);
 
     // load skeleton
-    loadSkeleton(aniMan, nullptr, _skeletonRoot);
+    {
+        std::lock_guard<std::mutex> lock(_aniManMutex);
+        loadSkeleton(aniMan, nullptr, _skeletonRoot);
+    }
 
-    // load materials
-    SLstring    modelPath = Utils::getPath(pathAndFile);
-    SLVMaterial materials;
-    if (!overrideMat)
+    scanMS = timer.elapsedTimeInMilliSec() - readMS;
+
+    // Convert the materials and the meshes in parallel. The materials come
+    // first so that the texture decoding starts as early as possible.
+    // The new assets are created without asset manager because it is not
+    // thread safe. They get registered below in the order of the file.
+    SLstring        modelPath    = Utils::getPath(pathAndFile);
+    SLint           numMaterials = overrideMat ? 0 : (SLint)scene->mNumMaterials;
+    SLint           numMeshes    = (SLint)scene->mNumMeshes;
+    SLVMaterial     materials((size_t)numMaterials, nullptr);
+    vector<SLMesh*> meshes((size_t)numMeshes, nullptr);
+
+    Utils::parallelFor(numMaterials + numMeshes,
+                       [&](SLint i)
+                       {
+                           if (i < numMaterials)
+                               materials[(size_t)i] = loadMaterial(assetMgr,
+                                                                   i,
+                                                                   scene->mMaterials[i],
+                                                                   modelPath,
+                                                                   texturePath,
+                                                                   skybox,
+                                                                   ambientFactor,
+                                                                   forceCookTorranceRM,
+                                                                   deleteTexImgAfterBuild);
+                           else
+                               meshes[(size_t)(i - numMaterials)] = loadMesh(nullptr, scene->mMeshes[i - numMaterials]);
+                       },
+                       "SLAssimpImporter");
+
+    // Register the new textures, materials and meshes
+    for (auto& texFuture : _texFutures)
+        assetMgr->textures().push_back(texFuture.second.get());
+    for (SLMaterial* mat : materials)
     {
-        for (SLint i = 0; i < (SLint)scene->mNumMaterials; i++)
-            materials.push_back(loadMaterial(assetMgr,
-                                             i,
-                                             scene->mMaterials[i],
-                                             modelPath,
-                                             texturePath,
-                                             skybox,
-                                             ambientFactor,
-                                             forceCookTorranceRM,
-                                             deleteTexImgAfterBuild));
+        mat->assetManager(assetMgr);
+        assetMgr->materials().push_back(mat);
     }
 
-    // load meshes & set their material
+    // set the material of the meshes
     std::map<int, SLMesh*> meshMap; // map from the ai index to our mesh
-    for (SLint i = 0; i < (SLint)scene->mNumMeshes; i++)
+    for (SLint i = 0; i < numMeshes; i++)
     {
-        SLMesh* mesh = loadMesh(assetMgr, scene->mMeshes[i]);
+        SLMesh* mesh = meshes[(size_t)i];
         if (mesh != nullptr)
         {
+            assetMgr->meshes().push_back(mesh);
+            if (mesh->skeleton())
+                _skinnedMeshes.push_back(mesh);
             if (overrideMat)
                 mesh->mat(overrideMat);
             else
@@ -363,16 +417,34 @@ SLNode* SLAssimpImporter::load(SLAnimManager&     aniMan,                 //!< R
                    modelPath.c_str());
     }
 
+    convertMS = timer.elapsedTimeInMilliSec() - readMS - scanMS;
+
     // load the scene nodes recursively
     _sceneRoot = loadNodesRec(nullptr, scene->mRootNode, meshMap, loadMeshesOnly);
 
-    // load animations
+    nodesMS = timer.elapsedTimeInMilliSec() - readMS - scanMS - convertMS;
+
+    // load animations (sequential because they change the animation manager)
     vector<SLAnimation*> animations;
-    for (SLint i = 0; i < (SLint)scene->mNumAnimations; i++)
-        animations.push_back(loadAnimation(aniMan, scene->mAnimations[i]));
+    {
+        std::lock_guard<std::mutex> lock(_aniManMutex);
+        for (SLint i = 0; i < (SLint)scene->mNumAnimations; i++)
+            animations.push_back(loadAnimation(aniMan, scene->mAnimations[i]));
+    }
+
+    animMS = timer.elapsedTimeInMilliSec() - readMS - scanMS - convertMS - nodesMS;
 
     logMessage(LV_minimal, "\n---------------------------\n\n");
 
+    SL_LOG("SLAssimpImporter: %s: %.1f ms (read: %.1f, scan: %.1f, materials & meshes: %.1f, nodes: %.1f, animations: %.1f)",
+           Utils::getFileName(pathAndFile).c_str(),
+           timer.elapsedTimeInMilliSec(),
+           readMS,
+           scanMS,
+           convertMS,
+           nodesMS,
+           animMS);
+
     // Rename root node to the more meaningfull filename
     if (_sceneRoot)
         _sceneRoot->name(Utils::getFileName(pathAndFile));
@@ -388,6 +460,100 @@ void SLAssimpImporter::clear()
     _skeletonRoot = nullptr;
     _skeleton     = nullptr;
     _skinnedMeshes.clear();
+    _texFutures.clear();
+}
+//-----------------------------------------------------------------------------
+/*! Returns the cache file name for a model file and import flags or an empty
+string if there is no cache. The name contains a 64-bit hash over the file
+content, the flags and the assimp version, so every change of them gives a new
+cache file.
+*/
+SLstring SLAssimpImporter::cacheFileName(const SLstring& pathAndFile,
+                                         SLuint          flags)
+{
+#    if defined(SL_STORAGE_FS)
+    if (cachePath.empty())
+        return "";
+
+    PROFILE_FUNCTION();
+
+    SLIOView view = SLFileStorage::readIntoView(pathAndFile, IOK_model);
+
+    uint64_t keys[] = {flags,
+                       aiGetVersionMajor(),
+                       aiGetVersionMinor(),
+                       aiGetVersionRevision()};
+    uint64_t hash   = Utils::hashFNV1a(view.data, view.size);
+    hash            = Utils::hashFNV1a(keys, sizeof(keys), hash);
+    view.release();
+
+    char hex[17];
+    snprintf(hex, sizeof(hex), "%016llx", (unsigned long long)hash);
+    return Utils::unifySlashes(cachePath) +
+           Utils::getFileNameWOExt(pathAndFile) + "_" + hex + ".assbin";
+#    else
+    return "";
+#    endif
+}
+//-----------------------------------------------------------------------------
+/*! Reads a cached scene from memory. The post-processing steps were already
+applied before the scene was cached, so no steps are run here.
+*/
+const aiScene* SLAssimpImporter::readCache(Assimp::Importer& ai,
+                                           const SLstring&   cacheFile)
+{
+    if (!Utils::fileExists(cacheFile))
+        return nullptr;
+
+    PROFILE_FUNCTION();
+
+    // Assimp parses the assbin file directly from the mapped file
+    SLIOView       view  = SLFileStorage::readIntoView(cacheFile, IOK_generic);
+    const aiScene* scene = ai.ReadFileFromMemory(view.data,
+                                                 view.size,
+                                                 0,
+                                                 "assbin");
+    view.release();
+
+    if (scene)
+        logMessage(LV_normal, "Scene read from cache: %s\n", cacheFile.c_str());
+    else
+    {
+        // Outdated or broken cache file: import again and replace it
+        logMessage(LV_minimal, "Invalid scene cache file: %s\n", cacheFile.c_str());
+        Utils::removeFile(cacheFile);
+    }
+
+    return scene;
+}
+//-----------------------------------------------------------------------------
+/*! Writes the post-processed scene in the assbin format into the cache. The
+file is first written under a temporary name per thread, so an interrupted
+write never leaves a broken cache file behind and concurrent imports of the
+same file don't write into the same temporary file.
+*/
+void SLAssimpImporter::writeCache(const aiScene*  scene,
+                                  const SLstring& cacheFile)
+{
+    PROFILE_FUNCTION();
+
+    SLstring dir = Utils::getPath(cacheFile);
+    if (!Utils::dirExists(dir))
+        Utils::makeDirRecurse(dir);
+
+    Assimp::Exporter exporter;
+    SLstring         tmpFile = cacheFile + "." +
+                       std::to_string(std::hash<std::thread::id>()(std::this_thread::get_id())) +
+                       ".tmp";
+    if (exporter.Export(scene, "assbin", tmpFile) != aiReturn_SUCCESS ||
+        std::rename(tmpFile.c_str(), cacheFile.c_str()) != 0)
+    {
+        logMessage(LV_minimal,
+                   "Failed to write scene cache file: %s (%s)\n",
+                   cacheFile.c_str(),
+                   exporter.GetErrorString());
+        Utils::removeFile(tmpFile);
+    }
 }
 //-----------------------------------------------------------------------------
 //! Return an aiNode ptr if name exists, or null if it doesn't
@@ -688,8 +854,9 @@ SLMaterial* SLAssimpImporter::loadMaterial(SLAssetManager* am,
     SLstring name = matName.data;
     if (name.empty()) name = "Import Material";
 
-    // Create SLMaterial instance. It is also added to the SLScene::_materials vector
-    SLMaterial* slMat = new SLMaterial(am, name.c_str());
+    // Create SLMaterial instance. It gets registered in the asset manager by
+    // the caller because this function runs in parallel threads.
+    SLMaterial* slMat = new SLMaterial(nullptr, name.c_str());
 
     // load all the textures for this aiMat and add it to the aiMat vector
     for (int tt = aiTextureType_NONE; tt <= aiTextureType_UNKNOWN; ++tt)
@@ -890,7 +1057,10 @@ SLMaterial* SLAssimpImporter::loadMaterial(SLAssetManager* am,
 }
 //-----------------------------------------------------------------------------
 /*!
-SLAssimpImporter::loadTexture loads the AssImp texture an returns the SLGLTexture
+SLAssimpImporter::loadTexture loads the AssImp texture an returns the SLGLTexture.
+The function is called in parallel by multiple materials. The image of a new
+texture is decoded only once; other threads that request the same file wait
+for it. The new textures get registered in the asset manager by the caller.
 */
 SLGLTexture* SLAssimpImporter::loadTexture(SLAssetManager* assetMgr,
                                            SLstring&       textureFile,
@@ -900,34 +1070,57 @@ SLGLTexture* SLAssimpImporter::loadTexture(SLAssetManager* assetMgr,
 {
     PROFILE_FUNCTION();
 
-    SLVGLTexture& allLoadedTex = assetMgr->textures();
+    // return if a texture with the same file already exists in the asset
+    // manager of the task or in the scene (they are only read here)
+    SLGLTexture* loadedTex = assetMgr->findTexture(textureFile);
+    if (loadedTex)
+        return loadedTex;
 
-    // return if a texture with the same file already exists
-    for (auto& i : allLoadedTex)
-        if (i->url() == textureFile)
-            return i;
+    // return or wait for the texture if it was already requested in this import
+    std::promise<SLGLTexture*> promise;
+    {
+        std::unique_lock<std::mutex> lock(_texMutex);
+        auto                         it = _texFutures.find(textureFile);
+        if (it != _texFutures.end())
+        {
+            std::shared_future<SLGLTexture*> future = it->second;
+            lock.unlock();
+            return future.get();
+        }
+        _texFutures[textureFile] = promise.get_future().share();
+    }
 
     SLint minificationFilter = texType == TT_occlusion ? GL_LINEAR : SL_ANISOTROPY_MAX;
 
-    // Create the new texture. It is also push back to SLScene::_textures
-    SLGLTexture* texture = new SLGLTexture(assetMgr,
-                                           textureFile,
-                                           minificationFilter,
-                                           GL_LINEAR,
-                                           texType);
+    // Create the new texture and decode its image
+    SLGLTexture* texture = nullptr;
+    try
+    {
+        texture = new SLGLTexture(nullptr,
+                                  textureFile,
+                                  minificationFilter,
+                                  GL_LINEAR,
+                                  texType);
+    }
+    catch (...)
+    {
+        promise.set_exception(std::current_exception());
+        throw;
+    }
     texture->uvIndex((SLbyte)uvIndex);
 
     // if texture images get deleted after build you can't do ray tracing
     if (deleteTexImgAfterBuild)
         texture->deleteImageAfterBuild(true);
 
+    promise.set_value(texture);
     return texture;
 }
 //-----------------------------------------------------------------------------
 /*!
 SLAssimpImporter::loadMesh creates a new SLMesh an copies the meshs vertex data and
 triangle face indices. Normals & tangents are not loaded. They are calculated
-in SLMesh.
+in SLMesh. The function is called in parallel for all meshes of a file.
 */
 SLMesh* SLAssimpImporter::loadMesh(SLAssetManager* am, aiMesh* mesh)
 {
@@ -1022,16 +1215,31 @@ SLMesh* SLAssimpImporter::loadMesh(SLAssetManager* am, aiMesh* mesh)
         m->UV[1].resize(m->P.size());
     }
 
-    // copy vertex positions & tex. coord.
-    for (SLuint i = 0; i < m->P.size(); ++i)
+    // copy vertex positions & normals in one block if the layouts match
+    if (std::is_same<ai_real, SLfloat>::value &&
+        sizeof(aiVector3D) == sizeof(SLVec3f))
     {
-        m->P[i].set(mesh->mVertices[i].x,
-                    mesh->mVertices[i].y,
-                    mesh->mVertices[i].z);
+        memcpy(m->P.data(), mesh->mVertices, m->P.size() * sizeof(SLVec3f));
         if (!m->N.empty())
-            m->N[i].set(mesh->mNormals[i].x,
-                        mesh->mNormals[i].y,
-                        mesh->mNormals[i].z);
+            memcpy(m->N.data(), mesh->mNormals, m->N.size() * sizeof(SLVec3f));
+    }
+    else
+    {
+        for (SLuint i = 0; i < m->P.size(); ++i)
+        {
+            m->P[i].set(mesh->mVertices[i].x,
+                        mesh->mVertices[i].y,
+                        mesh->mVertices[i].z);
+            if (!m->N.empty())
+                m->N[i].set(mesh->mNormals[i].x,
+                            mesh->mNormals[i].y,
+                            mesh->mNormals[i].z);
+        }
+    }
+
+    // copy tex. coord. (assimp stores them as 3D vectors)
+    for (SLuint i = 0; i < m->P.size(); ++i)
+    {
         if (!m->UV[0].empty())
             m->UV[0][i].set(mesh->mTextureCoords[0][i].x,
                             mesh->mTextureCoords[0][i].y);
@@ -1130,15 +1338,25 @@ SLMesh* SLAssimpImporter::loadMesh(SLAssetManager* am, aiMesh* mesh)
     if (!mesh->HasNormals() && numTriangles)
         m->calcNormals();
 
-    // load joints
+    // load joints (the skinned meshes are collected by the caller)
     if (mesh->HasBones())
     {
-        _skinnedMeshes.push_back(m);
         m->skeleton(_skeleton);
 
         m->Ji.resize(m->P.size());
         m->Jw.resize(m->P.size());
 
+        // reserve the per vertex weight vectors to avoid reallocations
+        vector<SLuint> numWeights(m->P.size(), 0);
+        for (SLuint i = 0; i < mesh->mNumBones; i++)
+            for (SLuint nW = 0; nW < mesh->mBones[i]->mNumWeights; nW++)
+                numWeights[mesh->mBones[i]->mWeights[nW].mVertexId]++;
+        for (SLuint v = 0; v < m->P.size(); ++v)
+        {
+            m->Ji[v].reserve(numWeights[v]);
+            m->Jw[v].reserve(numWeights[v]);
+        }
+
         for (SLuint i = 0; i < mesh->mNumBones; i++)
         {
             aiBone*  joint   = mesh->mBones[i];
@@ -1147,6 +1365,10 @@ SLMesh* SLAssimpImporter::loadMesh(SLAssetManager* am, aiMesh* mesh)
             // @todo On OSX it happens from time to time that slJoint is nullptr
             if (slJoint)
             {
+                // vertex with the max. distance in joint space
+                SLfloat maxLength = -1.0f;
+                SLVec3f maxVertex;
+
                 for (SLuint nW = 0; nW < joint->mNumWeights; nW++)
                 {
                     // add the weight
@@ -1156,13 +1378,25 @@ SLMesh* SLAssimpImporter::loadMesh(SLAssetManager* am, aiMesh* mesh)
                     m->Ji[vertId].push_back((SLuchar)slJoint->id());
                     m->Jw[vertId].push_back(weight);
 
-                    // check if the bones max radius changed
-                    // @todo this is very specific to this loaded mesh,
-                    //       when we add a skeleton instances class this radius
-                    //       calculation has to be done on the instance!
-                    slJoint->calcMaxRadius(SLVec3f(mesh->mVertices[vertId].x,
-                                                   mesh->mVertices[vertId].y,
-                                                   mesh->mVertices[vertId].z));
+                    SLVec3f vertex(mesh->mVertices[vertId].x,
+                                   mesh->mVertices[vertId].y,
+                                   mesh->mVertices[vertId].z);
+                    SLfloat length = (slJoint->offsetMat() * vertex).length();
+                    if (length > maxLength)
+                    {
+                        maxLength = length;
+                        maxVertex = vertex;
+                    }
+                }
+
+                // check if the bones max radius changed
+                // @todo this is very specific to this loaded mesh,
+                //       when we add a skeleton instances class this radius
+                //       calculation has to be done on the instance!
+                if (maxLength >= 0.0f)
+                {
+                    std::lock_guard<std::mutex> lock(_jointMutex);
+                    slJoint->calcMaxRadius(maxVertex);
                 }
             }
             else
@@ -14,6 +14,8 @@
 
 #    include <SLGLTexture.h>
 #    include <SLImporter.h>
+#    include <future>
+#    include <mutex>
 
 // forward declarations of assimp types
 struct aiScene;
@@ -21,6 +23,10 @@ struct aiNode;
 struct aiMaterial;
 struct aiAnimation;
 struct aiMesh;
+namespace Assimp
+{
+class Importer;
+}
 
 class SLAssetManager;
 class SLAnimManager;
@@ -33,6 +39,15 @@ typedef std::map<int, SLMesh*> SLMeshMap;
 //! Small class interface into the AssImp library for importing 3D assets.
 /*! See AssImp library (http://assimp.sourceforge.net/) documentation for
 supported file formats and the import processing options.
+If cachePath is set, the post-processed assimp scene of every imported file is
+written once in the binary assbin format of assimp to this folder. Repeated
+loads read this file from memory without parsing the source format and without
+running the post-processing steps again. The cache file name contains a hash
+of the source file content and of the import flags, so a changed model or
+other flags never hit a stale cache file.
+The materials and meshes of a file are converted in parallel. The textures are
+decoded as soon as a material references them. The new assets are registered
+in the asset manager in file order after the parallel conversion.
 */
 class SLAssimpImporter : public SLImporter
 {
@@ -84,6 +99,8 @@ public:
                  //|SLProcess_Dejoint
     );
 
+    static SLstring cachePath; //!< Folder of the binary scene cache (empty = no cache)
+
 protected:
     // intermediate containers
     typedef std::map<SLstring, aiNode*> SLNodeMap;
@@ -100,6 +117,15 @@ protected:
     SLuint   _jointIndex{};  //!< index counter used when iterating over joints
     MeshList _skinnedMeshes; //!< list containing all of the skinned meshes, used to assign the skinned materials
 
+    // parallel conversion
+    typedef std::map<SLstring, std::shared_future<SLGLTexture*>> SLTextureFutureMap;
+
+    SLTextureFutureMap _texFutures; //!< textures of this import by file name
+    std::mutex         _texMutex;   //!< mutex protecting _texFutures
+    std::mutex         _jointMutex; //!< mutex protecting the joint radii
+
+    static std::mutex _aniManMutex; //!< mutex protecting the animation manager shared by concurrent imports
+
     // loading helper
     aiNode* getNodeByName(const SLstring& name);   // return an aiNode ptr if name exists, or null if it doesn't
     SLMat4f getOffsetMat(const SLstring& name);    // return an aiJoint ptr if name exists, or null if it doesn't
@@ -114,7 +140,7 @@ protected:
     void                loadSkeleton(SLAnimManager& animManager,
                                      SLJoint*       parent,
                                      aiNode*        node);
-    static SLMaterial*  loadMaterial(SLAssetManager* am,
+    SLMaterial*         loadMaterial(SLAssetManager* am,
                                      SLint           index,
                                      aiMaterial*     aiMat,
                                      const SLstring& modelPath,
@@ -123,7 +149,7 @@ protected:
                                      float           ambientFactor          = 0.0f,
                                      SLbool          forceCookTorranceLM    = false,
                                      SLbool          deleteTexImgAfterBuild = false);
-    static SLGLTexture* loadTexture(SLAssetManager* assetMgr,
+    SLGLTexture*        loadTexture(SLAssetManager* assetMgr,
                                     SLstring&       path,
                                     SLTextureType   texType,
                                     SLuint          uvIndex,
@@ -141,6 +167,11 @@ protected:
                                       bool            showWarning = true);
     SLbool              aiNodeHasMesh(aiNode* node);
 
+    // binary scene cache
+    static SLstring cacheFileName(const SLstring& pathAndFile, SLuint flags);
+    const aiScene*  readCache(Assimp::Importer& ai, const SLstring& cacheFile);
+    void            writeCache(const aiScene* scene, const SLstring& cacheFile);
+
     // misc helper
     void clear();
 };
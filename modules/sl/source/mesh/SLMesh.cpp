@@ -1658,7 +1658,7 @@ void SLMesh::transformSkin(bool                                forceCPUSkinning,
 }
 //-----------------------------------------------------------------------------
 #ifdef SL_HAS_OPTIX
-unsigned int SLMesh::meshIndex = 0;
+std::atomic<unsigned int> SLMesh::meshIndex(0);
 //-----------------------------------------------------------------------------
 void SLMesh::allocAndUploadData()
 {
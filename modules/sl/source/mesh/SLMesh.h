@@ -10,6 +10,7 @@
 #ifndef SLMESH_H
 #define SLMESH_H
 
+#include <atomic>
 #include <SLAABBox.h>
 #include <SLEnums.h>
 #include <SLGLVertexArray.h>
@@ -170,7 +171,8 @@ public:
     virtual void        updateMeshAccelerationStructure();
     virtual ortHitData  createHitData();
     unsigned int        sbtIndex() const { return _sbtIndex; }
-    static unsigned int meshIndex;
+
+    static std::atomic<unsigned int> meshIndex; //!< Meshes may be built by parallel load tasks
 #endif
 
     // Getters
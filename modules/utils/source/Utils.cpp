@@ -9,6 +9,7 @@
 */
 
 #include <Utils.h>
+#include <Profiler.h>
 #include <cstddef>
 #include <iostream>
 #include <fstream>
@@ -21,6 +22,7 @@
 #include <vector>
 #include <algorithm>
 #include <thread>
+#include <atomic>
 
 #ifndef __EMSCRIPTEN__
 #    include <asio.hpp>
@@ -1197,6 +1199,62 @@ unsigned int maxThreads()
 #endif
 }
 //-----------------------------------------------------------------------------
+/*! Calls func(i) for all i in [0, num). The indices are handed out one by one
+ to the calling thread and up to maxThreads() - 1 additional threads, so
+ items of different cost are balanced. The function returns when all are done.
+ */
+void parallelFor(int                        num,
+                 const function<void(int)>& func,
+                 const char*                threadName)
+{
+    std::atomic<int> next(0);
+    auto             worker = [&]()
+    {
+        for (int i = next++; i < num; i = next++)
+            func(i);
+    };
+
+    unsigned int        numThreads = std::min(maxThreads(), (unsigned int)std::max(num, 1));
+    vector<std::thread> threads;
+    for (unsigned int t = 1; t < numThreads; ++t)
+    {
+        threads.emplace_back([&]()
+                             {
+                                 PROFILE_THREAD(threadName);
+                                 worker();
+                             });
+    }
+    worker();
+    for (auto& thread : threads)
+        thread.join();
+}
+//-----------------------------------------------------------------------------
+/*! FNV-1a style hash that processes 8 bytes per step, which is much faster
+ than the byte wise original. The size is hashed at the end, so blocks that
+ only differ in trailing zeros get different hashes. Pass the result of a
+ previous call as seed to hash several blocks.
+ */
+uint64_t hashFNV1a(const void* data,
+                   size_t      size,
+                   uint64_t    seed)
+{
+    const uint64_t prime = 1099511628211ULL;
+    const uint8_t* bytes = (const uint8_t*)data;
+    uint64_t       hash  = seed;
+    size_t         i     = 0;
+
+    for (; i + 8 <= size; i += 8)
+    {
+        uint64_t word;
+        memcpy(&word, bytes + i, 8);
+        hash = (hash ^ word) * prime;
+    }
+    for (; i < size; ++i)
+        hash = (hash ^ bytes[i]) * prime;
+
+    return (hash ^ (uint64_t)size) * prime;
+}
+//-----------------------------------------------------------------------------
 
 ////////////////////
 // Math Utilities //
@@ -13,6 +13,7 @@
 #include <string>
 #include <vector>
 #include <cfloat>
+#include <cstdint>
 #include <memory>
 #include <FileLog.h>
 #include <CustomLog.h>
@@ -230,6 +231,16 @@ void errorMsg(const char* tag,
 //! Returns in release config the max. NO. of threads otherwise 1
 unsigned int maxThreads();
 
+//! Calls func(i) for all i in [0, num) on up to maxThreads() threads
+void parallelFor(int                        num,
+                 const function<void(int)>& func,
+                 const char*                threadName = "parallelFor");
+
+//! FNV-1a hash over the 64-bit words of a memory block starting with seed
+uint64_t hashFNV1a(const void* data,
+                   size_t      size,
+                   uint64_t    seed = 14695981039346656037ULL);
+
 //////////////////////////////////
 // Math Constants and Functions //
 //////////////////////////////////
@@ -8,10 +8,17 @@
 */
 
 #include <cstring>
+#include <cstdio>
 #include <string>
 #include <iostream>
 #include <functional>
+#include <algorithm>
+#include <atomic>
+#include <mutex>
+#include <thread>
+#include <climits>
 #include <Utils.h>
+#include <ZipUtils.h>
 #include <minizip/unzip.h>
 #include <minizip/zip.h>
 
@@ -138,6 +145,80 @@ static bool zip_add_file(zipFile zfile,
                         zipPath);
 }
 //-----------------------------------------------------------------------------
+//! Entry of the central directory of a zip file
+struct ZipEntry
+{
+    string         name;             //!< Path of the entry inside the zip file
+    unz64_file_pos pos;              //!< Position of the entry for random access
+    ZPOS64_T       uncompressedSize; //!< Size of the decompressed entry
+    bool           isDir;            //!< Flag if the entry is a directory
+};
+//-----------------------------------------------------------------------------
+/*! Reads the central directory of the zip file without decompressing anything.
+ The entries can then be opened in any order with unzGoToFilePos64.
+ */
+static bool listEntries(unzFile uzfile, vector<ZipEntry>& entries)
+{
+    int err = unzGoToFirstFile(uzfile);
+    while (err == UNZ_OK)
+    {
+        unz_file_info64 finfo;
+        char            name[256];
+        ZipEntry        entry;
+
+        if (unzGetCurrentFileInfo64(uzfile, &finfo, name, sizeof(name), NULL, 0, NULL, 0) != UNZ_OK ||
+            unzGetFilePos64(uzfile, &entry.pos) != UNZ_OK)
+            return false;
+
+        size_t len             = strlen(name);
+        entry.name             = name;
+        entry.uncompressedSize = finfo.uncompressed_size;
+        entry.isDir            = len > 0 && name[len - 1] == '/';
+        entries.push_back(entry);
+
+        err = unzGoToNextFile(uzfile);
+    }
+    return err == UNZ_END_OF_LIST_OF_FILE;
+}
+//-----------------------------------------------------------------------------
+/*! Decompresses the current entry directly into the destination file. The
+ file is unbuffered, so each decompressed chunk is written without another
+ copy into a stream buffer.
+ */
+static bool extractCurrentFile(unzFile       uzfile,
+                               const string& filepath,
+                               vector<char>& buf)
+{
+    if (unzOpenCurrentFile(uzfile) != UNZ_OK)
+        return false;
+
+    FILE* file = fopen(filepath.c_str(), "wb");
+    if (!file)
+    {
+        unzCloseCurrentFile(uzfile);
+        return false;
+    }
+    setvbuf(file, nullptr, _IONBF, 0);
+
+    bool ret = true;
+    int  n   = 0;
+    while ((n = unzReadCurrentFile(uzfile, buf.data(), (unsigned)buf.size())) > 0)
+    {
+        if (fwrite(buf.data(), 1, (size_t)n, file) != (size_t)n)
+        {
+            ret = false;
+            break;
+        }
+    }
+
+    fclose(file);
+
+    // unzCloseCurrentFile also checks the CRC of the entry
+    if (unzCloseCurrentFile(uzfile) != UNZ_OK || n < 0)
+        ret = false;
+    return ret;
+}
+//-----------------------------------------------------------------------------
 /*!
  *
  @param zipfile ???
@@ -151,11 +232,11 @@ bool unzip(string                                         zipfile,
            function<bool(string path, string filename)>   processFile,
            function<bool(const char* data, size_t len)>   writeChunk,
            function<bool(string path)>                    processDir,
-           function<int(int currentFile, int totalFiles)> progress = nullptr)
+           function<int(int currentFile, int totalFiles)> progress)
 {
     unzFile uzfile;
     bool    ret = true;
-    size_t  n;
+    int     n   = 0;
     char    name[256];
     int     nbProcessedFile = 0;
 
@@ -216,7 +297,7 @@ bool unzip(string                                         zipfile,
         {
             while ((n = unzReadCurrentFile(uzfile, buf, sizeof(buf))) > 0)
             {
-                if (!writeChunk((const char*)buf, n))
+                if (!writeChunk((const char*)buf, (size_t)n))
                 {
                     unzCloseCurrentFile(uzfile);
                     ret = false;
@@ -304,57 +385,186 @@ bool zip(string path, string zipname)
 }
 //-----------------------------------------------------------------------------
 /*!
- Unzips a zip file
- @param path ???
- @param dest ???
+ Unzips a zip file with multiple threads. The central directory is read once,
+ then all directories are created and the files are distributed over the
+ threads, largest files first. Every thread has its own handle on the zip
+ file because minizip handles can't be shared, and decompresses its entries
+ directly into the destination files.
+ @param path Path of the zip file
+ @param dest Destination directory
  @param override Overrides existing files on destination
- @param progress Progress function to call for progress visualization
+ @param progress Progress function to call for progress visualization. It is
+ called from the worker threads (one at a time) and cancels the extraction
+ if it returns a nonzero value.
+ @param numThreads No. of threads (0 = Utils::maxThreads())
  @return Returns true on success
  */
 bool unzip(string                                         path,
            string                                         dest,
            bool                                           override,
-           function<int(int currentFile, int totalFiles)> progress)
+           function<int(int currentFile, int totalFiles)> progress,
+           int                                            numThreads)
 {
-    std::ofstream fs;
+    unzFile uzfile = unzOpen64(path.c_str());
+    if (uzfile == NULL)
+        return false;
+
+    vector<ZipEntry> entries;
+    bool             listed = listEntries(uzfile, entries);
+    unzClose(uzfile);
+    if (!listed)
+        return false;
 
     dest = Utils::unifySlashes(dest);
-    unzip(
-      path,
-      [&fs, &override, dest](string path, string filename) -> bool
-      {
-          if (override || !Utils::fileExists(dest + path + filename))
-          {
-              fs.open(dest + path + filename, std::ios::binary);
-              return true;
-          }
-          return false;
-      },
-      [&fs](const char* data, size_t len) -> bool
-      {
-          if (data != nullptr)
-          {
-              try
-              {
-                  fs.write(data, len);
-              }
-              catch (std::exception& e)
-              {
-                  std::cout << e.what() << std::endl;
-                  return false;
-              }
-          }
-          else
-              fs.close();
-          return true;
-      },
-      [dest](string path) -> bool
-      {
-          if (!Utils::dirExists(dest + path))
-              return Utils::makeDir(dest + path);
-          return true;
-      },
-      progress);
+
+    // Create the directories and collect the files to extract
+    vector<const ZipEntry*> files;
+    for (const ZipEntry& entry : entries)
+    {
+        string dirname = dest + Utils::getDirName(Utils::trimRightString(entry.name, "/"));
+        if (entry.isDir)
+            dirname = dest + entry.name;
+        if (!Utils::dirExists(dirname) && !Utils::makeDirRecurse(dirname))
+            return false;
+
+        if (!entry.isDir && (override || !Utils::fileExists(dest + entry.name)))
+            files.push_back(&entry);
+    }
+
+    std::sort(files.begin(),
+              files.end(),
+              [](const ZipEntry* a, const ZipEntry* b)
+              { return a->uncompressedSize > b->uncompressedSize; });
+
+    int totalFiles = (int)entries.size();
+    int skipped    = totalFiles - (int)files.size();
+
+    std::atomic<int>  nextFile(0);
+    std::atomic<int>  numDone(skipped);
+    std::atomic<bool> ok(true);
+    std::mutex        progressMutex;
+
+    auto worker = [&]()
+    {
+        unzFile uz = unzOpen64(path.c_str());
+        if (uz == NULL)
+        {
+            ok = false;
+            return;
+        }
+
+        vector<char> buf(1 << 18);
+        int          i;
+        while (ok && (i = nextFile++) < (int)files.size())
+        {
+            const ZipEntry* entry = files[(size_t)i];
+            unz64_file_pos  pos   = entry->pos;
+            if (unzGoToFilePos64(uz, &pos) != UNZ_OK ||
+                !extractCurrentFile(uz, dest + entry->name, buf))
+            {
+                ok = false;
+                break;
+            }
+
+            int done = ++numDone;
+            if (progress != nullptr)
+            {
+                std::lock_guard<std::mutex> lock(progressMutex);
+                if (progress(done, totalFiles))
+                    ok = false;
+            }
+        }
+        unzClose(uz);
+    };
+
+    if (numThreads <= 0)
+        numThreads = (int)Utils::maxThreads();
+    numThreads = std::max(1, std::min(numThreads, (int)files.size()));
+
+    vector<std::thread> threads;
+    for (int t = 1; t < numThreads; ++t)
+        threads.emplace_back(worker);
+    worker();
+    for (auto& thread : threads)
+        thread.join();
+
+    return ok;
+}
+//-----------------------------------------------------------------------------
+//! Returns the paths of all files in the zip file without the directories
+vector<string> listFiles(string zipfile)
+{
+    vector<string> files;
+
+    unzFile uzfile = unzOpen64(zipfile.c_str());
+    if (uzfile == NULL)
+        return files;
+
+    vector<ZipEntry> entries;
+    listEntries(uzfile, entries);
+    unzClose(uzfile);
+
+    for (const ZipEntry& entry : entries)
+        if (!entry.isDir)
+            files.push_back(entry.name);
+    return files;
+}
+//-----------------------------------------------------------------------------
+/*!
+ Reads a single file of a zip file into a buffer without extracting the
+ others. The entry is located in the central directory and decompressed
+ directly into the buffer.
+ The buffer is owned by the caller and must be deallocated with
+ SLIOBuffer::deallocate after usage.
+ @param zipfile Path of the zip file
+ @param filename Path of the file inside the zip file
+ @param buffer Buffer that receives the decompressed file
+ @return Returns true on success
+ */
+bool readFile(string      zipfile,
+              string      filename,
+              SLIOBuffer& buffer)
+{
+    buffer = SLIOBuffer{nullptr, 0};
+
+    unzFile uzfile = unzOpen64(zipfile.c_str());
+    if (uzfile == NULL)
+        return false;
+
+    unz_file_info64 finfo;
+    if (unzLocateFile(uzfile, filename.c_str(), 1) != UNZ_OK ||
+        unzGetCurrentFileInfo64(uzfile, &finfo, NULL, 0, NULL, 0, NULL, 0) != UNZ_OK ||
+        unzOpenCurrentFile(uzfile) != UNZ_OK)
+    {
+        unzClose(uzfile);
+        return false;
+    }
+
+    size_t         size = (size_t)finfo.uncompressed_size;
+    unsigned char* data = new unsigned char[size];
+    size_t         read = 0;
+    int            n    = 0;
+
+    while (read < size)
+    {
+        unsigned chunk = (unsigned)std::min(size - read, (size_t)INT_MAX);
+        n              = unzReadCurrentFile(uzfile, data + read, chunk);
+        if (n <= 0)
+            break;
+        read += (size_t)n;
+    }
+
+    // unzCloseCurrentFile also checks the CRC of the entry
+    bool ret = read == size && n >= 0 && unzCloseCurrentFile(uzfile) == UNZ_OK;
+    unzClose(uzfile);
+
+    if (!ret)
+    {
+        delete[] data;
+        return false;
+    }
+
+    buffer = SLIOBuffer{data, size};
     return true;
 }
 //-----------------------------------------------------------------------------
@@ -12,6 +12,7 @@
 
 #include <string>
 #include <functional>
+#include <SLFileStorage.h>
 
 //! ZipUtils provides compressing & decompressing files and folders
 namespace ZipUtils
@@ -25,8 +26,15 @@ bool unzip(string                                         zipfile,
            function<int(int currentFile, int totalFiles)> progress = nullptr);
 
 bool unzip(string                                         path,
-           string                                         dest     = "",
-           bool                                           override = true,
-           function<int(int currentFile, int totalFiles)> progress = nullptr);
+           string                                         dest       = "",
+           bool                                           override   = true,
+           function<int(int currentFile, int totalFiles)> progress   = nullptr,
+           int                                            numThreads = 0);
+
+vector<string> listFiles(string zipfile);
+
+bool readFile(string      zipfile,
+              string      filename,
+              SLIOBuffer& buffer);
 }
 #endif
@@ -35,6 +35,19 @@ void SLIOBuffer::deallocate()
     delete[] data;
 }
 //-----------------------------------------------------------------------------
+//! Closes the stream or deallocates the copy that holds the data of the view
+void SLIOView::release()
+{
+    if (stream)
+        SLFileStorage::close(stream);
+    else
+        delete[] data;
+
+    data   = nullptr;
+    size   = 0;
+    stream = nullptr;
+}
+//-----------------------------------------------------------------------------
 //! Opens a file stream for I/O operations
 /*!
  * Opens a file stream and prepares it for reading or writing. After usage,
@@ -42,18 +55,30 @@ void SLIOBuffer::deallocate()
  * uses the kind and the mode  to determine which kind of stream it should
  * create. For example, in a web browser, configuration files are written to
  * local storage.
+ * Native files are opened for reading as memory mapped files. If the file
+ * can't be mapped (e.g. it is empty or not a regular file), a stream that
+ * reads with std::ifstream is returned instead.
  * \param path Path to file
  * \param kind Kind of file
  * \param mode Mode to open the stream in
+ * \param access Expected access pattern as hint for memory mapped files
  * \return Opened stream ready for I/O
  */
 SLIOStream* SLFileStorage::open(std::string    path,
                                 SLIOStreamKind kind,
-                                SLIOStreamMode mode)
+                                SLIOStreamMode mode,
+                                SLIOAccessHint access)
 {
 #if defined(SL_STORAGE_FS)
     if (mode == IOM_read)
+    {
+        SLIOReaderMapped* mapped = new SLIOReaderMapped(path, access);
+        if (mapped->isMapped())
+            return mapped;
+
+        delete mapped;
         return new SLIOReaderNative(path);
+    }
     else if (mode == IOM_write)
         return new SLIOWriterNative(path);
     else
@@ -156,6 +181,37 @@ SLIOBuffer SLFileStorage::readIntoBuffer(std::string path, SLIOStreamKind kind)
     return SLIOBuffer{data, size};
 }
 //-----------------------------------------------------------------------------
+//! Returns a read only view on the content of a file
+/*!
+ * Opens a stream from the path provided in read mode. If the stream is backed
+ * by memory (e.g. a memory mapped native file), the view points directly into
+ * it without copying and the stream stays open. Otherwise the content is read
+ * into a buffer owned by the view. After usage the view must be released with
+ * a call to SLIOView::release.
+ * \param path Path to the file to read
+ * \param kind Kind of the file to read
+ * \param access Expected access pattern as hint for memory mapped files
+ * \return View on the file contents
+ */
+SLIOView SLFileStorage::readIntoView(std::string    path,
+                                     SLIOStreamKind kind,
+                                     SLIOAccessHint access)
+{
+    SLIOStream* stream = open(path, kind, IOM_read, access);
+    if (!stream)
+        return SLIOView{nullptr, 0, nullptr};
+
+    if (stream->data())
+        return SLIOView{stream->data(), stream->size(), stream};
+
+    size_t         size = stream->size();
+    unsigned char* data = new unsigned char[size];
+    stream->read(data, size);
+    close(stream);
+
+    return SLIOView{data, size, nullptr};
+}
+//-----------------------------------------------------------------------------
 //! Reads an entire file into a string
 /*!
  * Opens a stream from the path provided in read mode, allocates a strings
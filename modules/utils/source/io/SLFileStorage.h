@@ -51,6 +51,13 @@ enum SLIOStreamMode
     IOM_write
 };
 //-----------------------------------------------------------------------------
+//! Enum of access patterns used as hint for memory mapped files
+enum SLIOAccessHint
+{
+    IOA_sequential,
+    IOA_random
+};
+//-----------------------------------------------------------------------------
 //! Interface for accessing external data using streams
 /*!
  * SLIOStream provides an interface to access files which may be stored in the
@@ -75,15 +82,41 @@ public:
     virtual bool   seek(size_t offset, Origin origin) { return false; }
     virtual size_t size() { return 0; }
     virtual void   flush() {}
+
+    //! Returns the whole content if the stream is backed by memory or nullptr
+    virtual const unsigned char* data() { return nullptr; }
+};
+//-----------------------------------------------------------------------------
+//! Read only view on the content of a file
+/*!
+ * SLIOView is returned by SLFileStorage::readIntoView. If the stream of the
+ * file is backed by memory (e.g. a memory mapped file), the view points
+ * directly into it and the stream stays open until release is called.
+ * Otherwise the content is read into a buffer that is owned by the view.
+ * In both cases the data is valid until release is called.
+ */
+struct SLIOView
+{
+    const unsigned char* data;
+    size_t               size;
+    SLIOStream*          stream; //!< Stream backing the data or nullptr if the view owns a copy
+
+    void release();
 };
 //-----------------------------------------------------------------------------
 //! Collection of functions to open, use and close streams
 namespace SLFileStorage
 {
-SLIOStream* open(std::string path, SLIOStreamKind kind, SLIOStreamMode mode);
+SLIOStream* open(std::string    path,
+                 SLIOStreamKind kind,
+                 SLIOStreamMode mode,
+                 SLIOAccessHint access = IOA_sequential);
 void        close(SLIOStream* stream);
 bool        exists(std::string path, SLIOStreamKind kind);
 SLIOBuffer  readIntoBuffer(std::string path, SLIOStreamKind kind);
+SLIOView    readIntoView(std::string    path,
+                         SLIOStreamKind kind,
+                         SLIOAccessHint access = IOA_sequential);
 std::string readIntoString(std::string path, SLIOStreamKind kind);
 void        writeString(std::string path, SLIOStreamKind kind, const std::string& string);
 }
@@ -78,6 +78,12 @@ size_t SLIOReaderMemory::size()
     return memoryFiles[_path].size();
 }
 //-----------------------------------------------------------------------------
+//! Returns the file in memory, so views on it need no copy
+const unsigned char* SLIOReaderMemory::data()
+{
+    return (const unsigned char*)memoryFiles[_path].data();
+}
+//-----------------------------------------------------------------------------
 SLIOWriterMemory::SLIOWriterMemory(std::string path)
   : _path(path),
     _position(0)
@@ -28,10 +28,11 @@ class SLIOReaderMemory : public SLIOStream
 {
 public:
     SLIOReaderMemory(std::string path);
-    size_t read(void* buffer, size_t size);
-    size_t tell();
-    bool   seek(size_t offset, Origin origin);
-    size_t size();
+    size_t               read(void* buffer, size_t size);
+    size_t               tell();
+    bool                 seek(size_t offset, Origin origin);
+    size_t               size();
+    const unsigned char* data();
 
 protected:
     std::string _path;
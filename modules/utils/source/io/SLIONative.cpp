@@ -10,6 +10,16 @@
 #include <SLIONative.h>
 
 #ifdef SL_STORAGE_FS
+#    include <algorithm>
+#    include <cstring>
+#    ifdef _WIN32
+#        include <windows.h>
+#    else
+#        include <fcntl.h>
+#        include <sys/mman.h>
+#        include <sys/stat.h>
+#        include <unistd.h>
+#    endif
 //-----------------------------------------------------------------------------
 SLIOReaderNative::SLIOReaderNative(std::string path)
   : _stream(path, std::ios::binary)
@@ -50,6 +60,130 @@ size_t SLIOReaderNative::size()
     return size;
 }
 //-----------------------------------------------------------------------------
+/*! Maps the file read only. Empty files, files that are not regular files and
+ files that don't fit into the address space are not mapped.
+*/
+SLIOReaderMapped::SLIOReaderMapped(std::string path, SLIOAccessHint access)
+  : _data(nullptr),
+    _size(0),
+    _position(0)
+{
+#    ifdef _WIN32
+    _mapping = nullptr;
+
+    DWORD  flags = access == IOA_random ? FILE_FLAG_RANDOM_ACCESS : FILE_FLAG_SEQUENTIAL_SCAN;
+    HANDLE file  = CreateFileA(path.c_str(),
+                              GENERIC_READ,
+                              FILE_SHARE_READ,
+                              nullptr,
+                              OPEN_EXISTING,
+                              FILE_ATTRIBUTE_NORMAL | flags,
+                              nullptr);
+    if (file == INVALID_HANDLE_VALUE)
+        return;
+
+    LARGE_INTEGER fileSize;
+    if (GetFileSizeEx(file, &fileSize) &&
+        fileSize.QuadPart > 0 &&
+        (unsigned long long)fileSize.QuadPart <= (unsigned long long)SIZE_MAX)
+    {
+        _mapping = CreateFileMappingA(file, nullptr, PAGE_READONLY, 0, 0, nullptr);
+        if (_mapping)
+        {
+            _data = (const unsigned char*)MapViewOfFile(_mapping, FILE_MAP_READ, 0, 0, 0);
+            if (_data)
+                _size = (size_t)fileSize.QuadPart;
+            else
+            {
+                CloseHandle(_mapping);
+                _mapping = nullptr;
+            }
+        }
+    }
+
+    // The mapping keeps the file open
+    CloseHandle(file);
+#    else
+    int fd = ::open(path.c_str(), O_RDONLY | O_CLOEXEC);
+    if (fd < 0)
+        return;
+
+    struct stat st;
+    if (fstat(fd, &st) == 0 &&
+        S_ISREG(st.st_mode) &&
+        st.st_size > 0 &&
+        (unsigned long long)st.st_size <= (unsigned long long)SIZE_MAX)
+    {
+        void* addr = mmap(nullptr, (size_t)st.st_size, PROT_READ, MAP_PRIVATE, fd, 0);
+        if (addr != MAP_FAILED)
+        {
+            _data = (const unsigned char*)addr;
+            _size = (size_t)st.st_size;
+
+            // Sequentially read files get aggressive read-ahead and are
+            // prefetched, random access files only load the touched pages.
+            if (access == IOA_random)
+                madvise(addr, _size, MADV_RANDOM);
+            else
+            {
+                madvise(addr, _size, MADV_SEQUENTIAL);
+                madvise(addr, _size, MADV_WILLNEED);
+            }
+        }
+    }
+
+    // The mapping keeps the file open
+    ::close(fd);
+#    endif
+}
+//-----------------------------------------------------------------------------
+SLIOReaderMapped::~SLIOReaderMapped()
+{
+    if (!_data)
+        return;
+
+#    ifdef _WIN32
+    UnmapViewOfFile(_data);
+    CloseHandle(_mapping);
+#    else
+    munmap((void*)_data, _size);
+#    endif
+}
+//-----------------------------------------------------------------------------
+size_t SLIOReaderMapped::read(void* buffer, size_t size)
+{
+    size_t numBytes = std::min(size, _size - _position);
+    std::memcpy(buffer, _data + _position, numBytes);
+    _position += numBytes;
+    return numBytes;
+}
+//-----------------------------------------------------------------------------
+size_t SLIOReaderMapped::tell()
+{
+    return _position;
+}
+//-----------------------------------------------------------------------------
+//! Sets the read position like std::istream::seekg, also for negative offsets
+bool SLIOReaderMapped::seek(size_t offset, Origin origin)
+{
+    size_t position = offset;
+    if (origin == IOO_cur)
+        position = _position + offset;
+    else if (origin == IOO_end)
+        position = _size + offset;
+
+    if (position > _size)
+        return false;
+
+    _position = position;
+    return true;
+}
+//-----------------------------------------------------------------------------
+size_t SLIOReaderMapped::size()
+{
+    return _size;
+}
+//-----------------------------------------------------------------------------
 SLIOWriterNative::SLIOWriterNative(std::string path)
   : _stream(path, std::ios::binary)
 {
@@ -28,6 +28,36 @@ private:
     std::ifstream _stream;
 };
 //-----------------------------------------------------------------------------
+//! SLIOStream implementation for reading from memory mapped native files
+/*!
+ * The whole file is mapped read only into the address space, so reading
+ * needs no system call and no stream buffer and data() gives direct access
+ * to the content. The access hint is passed to the OS (madvise on POSIX, the
+ * scan flags of CreateFile on Windows) to select the read-ahead strategy.
+ * If the file can't be mapped, isMapped returns false and the stream must
+ * not be used.
+ */
+class SLIOReaderMapped : public SLIOStream
+{
+public:
+    SLIOReaderMapped(std::string path, SLIOAccessHint access);
+    ~SLIOReaderMapped();
+    size_t               read(void* buffer, size_t size);
+    size_t               tell();
+    bool                 seek(size_t offset, Origin origin);
+    size_t               size();
+    const unsigned char* data() { return _data; }
+    bool                 isMapped() const { return _data != nullptr; }
+
+private:
+    const unsigned char* _data;     //!< Start of the mapping or nullptr
+    size_t               _size;     //!< Size of the file and the mapping
+    size_t               _position; //!< Current read position
+#    ifdef _WIN32
+    void* _mapping; //!< Handle of the file mapping object
+#    endif
+};
+//-----------------------------------------------------------------------------
 //! SLIOStream implementation for writing to native files
 class SLIOWriterNative : public SLIOStream
 {
@@ -4,6 +4,9 @@
 #include <limits>
 #include <cstdint>
 #include <algorithm>
+#include <cstdio>
+#include <thread>
+#include <vector>
 
 namespace fbow
 {
@@ -45,60 +48,124 @@ void Vocabulary::setParams(int aligment, int k, int desc_type, int desc_size, in
     _data               = std::unique_ptr<char[], decltype(&AlignedFree)>((char*)AlignedAlloc((int)_params._aligment, (int)_params._total_size), &AlignedFree);
 
     memset(_data.get(), 0, _params._total_size);
+    initCpuInfo();
 }
 
-void Vocabulary::transform(const cv::Mat& features, int level, fBow& result, fBow2& result2)
+void Vocabulary::initCpuInfo()
 {
-    if (features.rows == 0) throw std::runtime_error("Vocabulary::transform No input data");
-    if (features.type() != _params._desc_type) throw std::runtime_error("Vocabulary::transform features are of different type than vocabulary");
-    if (features.cols * features.elemSize() != size_t(_params._desc_size)) throw std::runtime_error("Vocabulary::transform features are of different size than the vocabulary ones");
-
-    //get host info to decide the version to execute
     if (!cpu_info)
     {
         cpu_info = std::make_shared<cpu>();
         cpu_info->detect_host();
     }
+}
 
+void Vocabulary::checkParams(const params& p)
+{
+    if (p._aligment == 0 || p._aligment >= 256 || p._nblocks == 0 || p._m_k == 0 ||
+        p._block_size_bytes_wp == 0 || p._block_size_bytes_wp % p._aligment != 0 ||
+        p._total_size != p._block_size_bytes_wp * p._nblocks ||
+        p._total_size > (uint64_t)std::numeric_limits<int>::max())
+        throw std::runtime_error("Vocabulary: invalid header");
+}
+
+void Vocabulary::checkFeatures(const cv::Mat& features) const
+{
+    if (features.rows == 0) throw std::runtime_error("Vocabulary::transform No input data");
+    if (features.type() != _params._desc_type) throw std::runtime_error("Vocabulary::transform features are of different type than vocabulary");
+    if (features.cols * features.elemSize() != size_t(_params._desc_size)) throw std::runtime_error("Vocabulary::transform features are of different size than the vocabulary ones");
+}
+
+void Vocabulary::transformRows(const cv::Mat& features, int rowBegin, int rowEnd, int level, fBow& result, fBow2& result2)
+{
     //decide the version to employ according to the type of features, aligment and cpu capabilities
     if (_params._desc_type == CV_8UC1)
     {
-        //orb
-        if (cpu_info->HW_x64)
+        //orb: the 32 byte version only needs 64 bit words, so it is also used on 64 bit arm (android, ios)
+        //where the cpu detection does not report x64 and the compiler maps the popcount to neon instructions
+        if (_params._desc_size == 32)
+            _transform2<L1_32bytes>(features, rowBegin, rowEnd, level, result, result2);
+        else if (cpu_info->HW_x64)
         {
-            if (_params._desc_size == 32)
-                _transform2<L1_32bytes>(features, level, result, result2);
             //full akaze
-            else if (_params._desc_size == 61 && _params._aligment % 8 == 0)
-                _transform2<L1_61bytes>(features, level, result, result2);
+            if (_params._desc_size == 61 && _params._aligment % 8 == 0)
+                _transform2<L1_61bytes>(features, rowBegin, rowEnd, level, result, result2);
             //generic
             else
-                _transform2<L1_x64>(features, level, result, result2);
+                _transform2<L1_x64>(features, rowBegin, rowEnd, level, result, result2);
         }
         else
-            _transform2<L1_x32>(features, level, result, result2);
+            _transform2<L1_x32>(features, rowBegin, rowEnd, level, result, result2);
     }
     else if (features.type() == CV_32FC1)
     {
         if (cpu_info->isSafeAVX() && _params._aligment % 32 == 0)
         { //AVX version
             if (_params._desc_size == 256)
-                _transform2<L2_avx_8w>(features, level, result, result2); //specific for surf 256 bytes
+                _transform2<L2_avx_8w>(features, rowBegin, rowEnd, level, result, result2); //specific for surf 256 bytes
             else
-                _transform2<L2_avx_generic>(features, level, result, result2); //any other
+                _transform2<L2_avx_generic>(features, rowBegin, rowEnd, level, result, result2); //any other
         }
-        if (cpu_info->isSafeSSE() && _params._aligment % 16 == 0)
+        else if (cpu_info->isSafeSSE() && _params._aligment % 16 == 0)
         { //SSE version
             if (_params._desc_size == 256)
-                _transform2<L2_sse3_16w>(features, level, result, result2); //specific for surf 256 bytes
+                _transform2<L2_sse3_16w>(features, rowBegin, rowEnd, level, result, result2); //specific for surf 256 bytes
             else
-                _transform2<L2_se3_generic>(features, level, result, result2); //any other
+                _transform2<L2_se3_generic>(features, rowBegin, rowEnd, level, result, result2); //any other
         }
-        //generic version
-        _transform2<L2_generic>(features, level, result, result2);
+        else //generic version
+            _transform2<L2_generic>(features, rowBegin, rowEnd, level, result, result2);
     }
     else
         throw std::runtime_error("Vocabulary::transform invalid feature type. Should be CV_8UC1 or CV_32FC1");
+}
+
+void Vocabulary::transform(const cv::Mat& features, int level, fBow& result, fBow2& result2)
+{
+    transform(features, level, result, result2, 1);
+}
+
+void Vocabulary::transform(const cv::Mat& features, int level, fBow& result, fBow2& result2, int nthreads, int minRowsPerThread)
+{
+    checkFeatures(features);
+
+    //get host info to decide the version to execute
+    initCpuInfo();
+
+    result.clear();
+    result2.clear();
+
+    int nblocks = std::min(nthreads, features.rows / std::max(minRowsPerThread, 1));
+    if (nblocks <= 1)
+        transformRows(features, 0, features.rows, level, result, result2);
+    else
+    {
+        //every thread fills its own bags that are merged in row order,
+        //so the feature indices in result2 stay sorted like in the serial version
+        int                      rowsPerBlock = (features.rows + nblocks - 1) / nblocks;
+        std::vector<fBow>        results(nblocks - 1);
+        std::vector<fBow2>       results2(nblocks - 1);
+        std::vector<std::thread> threads;
+        for (int b = 1; b < nblocks; b++)
+        {
+            int rowBegin = b * rowsPerBlock;
+            int rowEnd   = std::min(features.rows, rowBegin + rowsPerBlock);
+            threads.emplace_back([&, b, rowBegin, rowEnd]()
+                                 { transformRows(features, rowBegin, rowEnd, level, results[b - 1], results2[b - 1]); });
+        }
+        transformRows(features, 0, rowsPerBlock, level, result, result2);
+        for (auto& t : threads) t.join();
+
+        for (int b = 0; b < nblocks - 1; b++)
+        {
+            for (const auto& e : results[b]) result[e.first] += e.second;
+            for (const auto& e : results2[b])
+            {
+                auto& indices = result2[e.first];
+                indices.insert(indices.end(), e.second.begin(), e.second.end());
+            }
+        }
+    }
 
     //normalize
     double norm = 0;
@@ -113,16 +180,10 @@ void Vocabulary::transform(const cv::Mat& features, int level, fBow& result, fBo
 
 fBow Vocabulary::transform(const cv::Mat& features)
 {
-    if (features.rows == 0) throw std::runtime_error("Vocabulary::transform No input data");
-    if (features.type() != _params._desc_type) throw std::runtime_error("Vocabulary::transform features are of different type than vocabulary");
-    if (features.cols * features.elemSize() != size_t(_params._desc_size)) throw std::runtime_error("Vocabulary::transform features are of different size than the vocabulary ones");
+    checkFeatures(features);
 
     //get host info to decide the version to execute
-    if (!cpu_info)
-    {
-        cpu_info = std::make_shared<cpu>();
-        cpu_info->detect_host();
-    }
+    initCpuInfo();
 
     fBow result;
     //decide the version to employ according to the type of features, aligment and cpu capabilities
@@ -186,11 +247,70 @@ void Vocabulary::clear()
 }
 
 //loads/saves from a file
+//The file is read unbuffered: the header with one small read and all blocks of the
+//flattened tree with one read directly into the aligned memory used by transform
 void Vocabulary::readFromFile(const std::string& filepath)
 {
-    std::ifstream file(filepath, std::ios::binary);
+    FILE* file = fopen(filepath.c_str(), "rb");
     if (!file) throw std::runtime_error("Vocabulary::readFromFile could not open:" + filepath);
-    fromStream(file);
+    setvbuf(file, nullptr, _IONBF, 0);
+
+    uint64_t sig = 0;
+    params   p;
+    if (fread(&sig, sizeof(sig), 1, file) != 1 || sig != 55824124 ||
+        fread(&p, sizeof(params), 1, file) != 1)
+    {
+        fclose(file);
+        throw std::runtime_error("Vocabulary::readFromFile invalid signature:" + filepath);
+    }
+
+    try
+    {
+        checkParams(p);
+    }
+    catch (std::exception&)
+    {
+        fclose(file);
+        throw std::runtime_error("Vocabulary::readFromFile invalid header:" + filepath);
+    }
+
+    std::unique_ptr<char[], decltype(&AlignedFree)> data((char*)AlignedAlloc((int)p._aligment, (int)p._total_size), &AlignedFree);
+    if (data.get() == nullptr)
+    {
+        fclose(file);
+        throw std::runtime_error("Vocabulary::readFromFile Could not allocate data");
+    }
+
+    size_t nread = fread(data.get(), 1, p._total_size, file);
+    fclose(file);
+    if (nread != p._total_size) throw std::runtime_error("Vocabulary::readFromFile file is truncated:" + filepath);
+
+    _params = p;
+    _data   = std::move(data);
+    initCpuInfo();
+}
+
+void Vocabulary::readFromMemory(const void* data, size_t size)
+{
+    const char* content = (const char*)data;
+    uint64_t    sig     = 0;
+    params      p;
+    if (content == nullptr || size < sizeof(sig) + sizeof(params))
+        throw std::runtime_error("Vocabulary::readFromMemory invalid signature");
+    memcpy(&sig, content, sizeof(sig));
+    memcpy(&p, content + sizeof(sig), sizeof(params));
+    if (sig != 55824124) throw std::runtime_error("Vocabulary::readFromMemory invalid signature");
+    checkParams(p);
+    if (size - sizeof(sig) - sizeof(params) < p._total_size) throw std::runtime_error("Vocabulary::readFromMemory data is truncated");
+
+    //the blocks in the file are not aligned, so they are copied once into the aligned memory used by transform
+    std::unique_ptr<char[], decltype(&AlignedFree)> blocks((char*)AlignedAlloc((int)p._aligment, (int)p._total_size), &AlignedFree);
+    if (blocks.get() == nullptr) throw std::runtime_error("Vocabulary::readFromMemory Could not allocate data");
+    memcpy(blocks.get(), content + sizeof(sig) + sizeof(params), p._total_size);
+
+    _params = p;
+    _data   = std::move(blocks);
+    initCpuInfo();
 }
 
 void Vocabulary::saveToFile(const std::string& filepath)
@@ -218,9 +338,11 @@ void Vocabulary::fromStream(std::istream& str)
     if (sig != 55824124) throw std::runtime_error("Vocabulary::fromStream invalid signature");
     //read string
     str.read((char*)&_params, sizeof(params));
+    checkParams(_params);
     _data = std::unique_ptr<char[], decltype(&AlignedFree)>((char*)AlignedAlloc((int)_params._aligment, (int)_params._total_size), &AlignedFree);
     if (_data.get() == nullptr) throw std::runtime_error("Vocabulary::fromStream Could not allocate data");
     str.read(_data.get(), _params._total_size);
+    initCpuInfo();
 }
 
 double fBow::score(const fBow& v1, const fBow& v2)
@@ -102,9 +102,14 @@ public:
     //transform the features stored as rows in the returned BagOfWords
     fBow transform(const cv::Mat& features);
     void transform(const cv::Mat& features, int level, fBow& result, fBow2& result2);
+    //same as above, but the rows are split in blocks that are transformed by up to nthreads threads.
+    //Blocks have at least minRowsPerThread rows, so small inputs are transformed on the calling thread
+    void transform(const cv::Mat& features, int level, fBow& result, fBow2& result2, int nthreads, int minRowsPerThread = 256);
 
     //loads/saves from a file
     void readFromFile(const std::string& filepath);
+    //reads from a file content in memory (e.g. a memory mapped file). The blocks are copied once into aligned memory
+    void readFromMemory(const void* data, size_t size);
     void saveToFile(const std::string& filepath);
     ///save/load to binary streams
     void toStream(std::ostream& str) const;
@@ -143,6 +148,15 @@ private:
     params                                          _params;
     std::unique_ptr<char[], decltype(&AlignedFree)> _data;
 
+    //detects the cpu features once, before the vocabulary is used by several threads
+    void initCpuInfo();
+    //throws if the header read from a file or stream does not describe a valid vocabulary
+    static void checkParams(const params& p);
+    //checks that the features match the vocabulary
+    void checkFeatures(const cv::Mat& features) const;
+    //transforms the rows [rowBegin,rowEnd) with the distance computer that fits the descriptor and the cpu. Does not normalize
+    void transformRows(const cv::Mat& features, int rowBegin, int rowEnd, int level, fBow& result, fBow2& result2);
+
     //structure represeting a information about node in a block
     struct block_node_info
     {
@@ -460,21 +474,20 @@ private:
         }
         return result;
     }
+    //adds the rows [rowBegin,rowEnd) to r1 and r2 (they are not cleared)
     template<typename Computer>
-    void _transform2(const cv::Mat& features, uint32_t storeLevel, fBow& r1, fBow2& r2)
+    void _transform2(const cv::Mat& features, int rowBegin, int rowEnd, uint32_t storeLevel, fBow& r1, fBow2& r2)
     {
         Computer comp;
         comp.setParams(_params._desc_size, (int)_params._desc_size_bytes_wp);
         using DType = typename Computer::DType; //distance type
         using TData = typename Computer::TData; //data type
 
-        r1.clear();
-        r2.clear();
         std::pair<DType, uint32_t> best_dist_idx(std::numeric_limits<uint32_t>::max(), 0); //minimum distance found
         block_node_info*           bn_info;
 
         int nbits = (int)ceil(log2(_params._m_k));
-        for (int cur_feature = 0; cur_feature < features.rows; cur_feature++)
+        for (int cur_feature = rowBegin; cur_feature < rowEnd; cur_feature++)
         {
             comp.startwithfeature(features.ptr<TData>(cur_feature));
             //ensure feature is in a
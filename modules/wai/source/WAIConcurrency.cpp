@@ -0,0 +1,61 @@
+/**
+ * \file      WAIConcurrency.cpp
+ * \brief     Lock free published values and instrumented mutexes for WAI
+ * \date      October 2026
+ * \remarks   Please use clangformat to format the code. See more code style on
+ *            https://github.com/cpvrlab/SLProject4/wiki/SLProject-Coding-Style
+ * \copyright http://opensource.org/licenses/GPL-3.0
+ */
+
+#include <WAIConcurrency.h>
+#include <Utils.h>
+
+#include <chrono>
+
+//-----------------------------------------------------------------------------
+void WAIInstrumentedMutex::lock()
+{
+    if (!_mutex.try_lock())
+    {
+        auto start = std::chrono::steady_clock::now();
+        _mutex.lock();
+        auto waited = std::chrono::steady_clock::now() - start;
+
+        _contentions.fetch_add(1, std::memory_order_relaxed);
+        _waitNS.fetch_add((uint64_t)std::chrono::duration_cast<std::chrono::nanoseconds>(waited).count(),
+                          std::memory_order_relaxed);
+    }
+    _acquisitions.fetch_add(1, std::memory_order_relaxed);
+}
+//-----------------------------------------------------------------------------
+bool WAIInstrumentedMutex::try_lock()
+{
+    if (!_mutex.try_lock())
+        return false;
+
+    _acquisitions.fetch_add(1, std::memory_order_relaxed);
+    return true;
+}
+//-----------------------------------------------------------------------------
+void WAIInstrumentedMutex::resetStats()
+{
+    _acquisitions = 0;
+    _contentions  = 0;
+    _waitNS       = 0;
+}
+//-----------------------------------------------------------------------------
+//! Returns one line with the lock counts, the contention rate and the waiting time
+std::string WAIInstrumentedMutex::statsString() const
+{
+    uint64_t acq  = acquisitions();
+    uint64_t cont = contentions();
+    double   perc = acq ? 100.0 * (double)cont / (double)acq : 0.0;
+
+    return Utils::formatString("%-20s locks: %10llu, contended: %8llu (%5.2f%%), waited: %9.2f ms",
+                               _name,
+                               (unsigned long long)acq,
+                               (unsigned long long)cont,
+                               perc,
+                               waitTimeMS());
+}
+//-----------------------------------------------------------------------------
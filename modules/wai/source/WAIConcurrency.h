@@ -0,0 +1,108 @@
+/**
+ * \file      WAIConcurrency.h
+ * \brief     Lock free published values and instrumented mutexes for WAI
+ * \date      October 2026
+ * \remarks   Please use clangformat to format the code. See more code style on
+ *            https://github.com/cpvrlab/SLProject4/wiki/SLProject-Coding-Style
+ * \copyright http://opensource.org/licenses/GPL-3.0
+ */
+
+#ifndef WAI_CONCURRENCY_H
+#define WAI_CONCURRENCY_H
+
+#include <atomic>
+#include <cstdint>
+#include <mutex>
+#include <string>
+#include <thread>
+
+#include <WAIHelper.h>
+
+//-----------------------------------------------------------------------------
+//! Fixed size float array with a lock free read path (sequence lock)
+/*! Writers publish a new version of the values, readers copy them without
+ taking a mutex and retry if a writer was active during the copy. This is the
+ read side of an epoch scheme: the sequence counter is odd while a writer is
+ publishing and the published version is sequence / 2.
+ Writers must be serialized by the owner (e.g. WAIMapPoint::mMutexPos).
+ */
+template<int N>
+class WAIPublished
+{
+public:
+    //! Publishes a new version of the N values
+    void publish(const float* values)
+    {
+        uint32_t seq = _seq.load(std::memory_order_relaxed);
+        _seq.store(seq + 1, std::memory_order_relaxed);
+        std::atomic_thread_fence(std::memory_order_release);
+
+        for (int i = 0; i < N; i++)
+            _values[i].store(values[i], std::memory_order_relaxed);
+
+        _seq.store(seq + 2, std::memory_order_release);
+    }
+
+    //! Copies the latest consistent version into values and returns its version (0 = never published)
+    uint32_t read(float* values) const
+    {
+        while (true)
+        {
+            uint32_t seq0 = _seq.load(std::memory_order_acquire);
+            if (seq0 & 1)
+            {
+                std::this_thread::yield();
+                continue;
+            }
+
+            for (int i = 0; i < N; i++)
+                values[i] = _values[i].load(std::memory_order_relaxed);
+
+            std::atomic_thread_fence(std::memory_order_acquire);
+            if (_seq.load(std::memory_order_relaxed) == seq0)
+                return seq0 >> 1;
+        }
+    }
+
+    uint32_t version() const { return _seq.load(std::memory_order_acquire) >> 1; }
+
+private:
+    std::atomic<uint32_t> _seq{0};
+    std::atomic<float>    _values[N] = {};
+};
+//-----------------------------------------------------------------------------
+//! Mutex that counts acquisitions, contended acquisitions and waiting time
+/*! It satisfies the Lockable requirements and can be used with
+ std::unique_lock<WAIInstrumentedMutex>. An uncontended lock costs one
+ try_lock and two relaxed increments, the clock is only read when the lock is
+ contended.
+ */
+class WAI_API WAIInstrumentedMutex
+{
+public:
+    explicit WAIInstrumentedMutex(const char* name = "") : _name(name) {}
+
+    WAIInstrumentedMutex(const WAIInstrumentedMutex&)            = delete;
+    WAIInstrumentedMutex& operator=(const WAIInstrumentedMutex&) = delete;
+
+    void lock();
+    bool try_lock();
+    void unlock() { _mutex.unlock(); }
+
+    void        resetStats();
+    std::string statsString() const;
+
+    const char* name() const { return _name; }
+    uint64_t    acquisitions() const { return _acquisitions.load(std::memory_order_relaxed); }
+    uint64_t    contentions() const { return _contentions.load(std::memory_order_relaxed); }
+    double      waitTimeMS() const { return (double)_waitNS.load(std::memory_order_relaxed) / 1.0e6; }
+
+private:
+    std::mutex            _mutex;
+    const char*           _name;
+    std::atomic<uint64_t> _acquisitions{0}; //!< number of successful lock calls
+    std::atomic<uint64_t> _contentions{0};  //!< number of lock calls that had to wait
+    std::atomic<uint64_t> _waitNS{0};       //!< accumulated waiting time in nanoseconds
+};
+//-----------------------------------------------------------------------------
+#endif // WAI_CONCURRENCY_H
@@ -31,21 +31,19 @@ WAI_API void wai_getMapPoints(WAIMapPointCoordinate** mapPointCoordinatePtr,
         return;
     }
 
-    std::vector<WAIMapPoint*> mapPoints       = mode->getMapPoints();
-    *mapPointCoordinatePtr                    = (WAIMapPointCoordinate*)malloc(mapPoints.size() * sizeof(WAIMapPointCoordinate));
+    // The snapshot is only rebuilt if the map changed since the last call
+    WAIMapSnapshotPtr      snapshot           = mode->getMapSnapshot();
+    *mapPointCoordinatePtr                    = (WAIMapPointCoordinate*)malloc(snapshot->mapPoints.size() * sizeof(WAIMapPointCoordinate));
     WAIMapPointCoordinate* mapPointCoordinate = *mapPointCoordinatePtr;
 
     int count = 0;
 
-    for (WAIMapPoint* mapPoint : mapPoints)
+    for (size_t i = 0; i < snapshot->mapPoints.size(); i++)
     {
-        if (!mapPoint->isBad())
+        if (!snapshot->mapPoints[i]->isBad())
         {
-            *mapPointCoordinate = {
-              mapPoint->worldPosVec().x,
-              mapPoint->worldPosVec().y,
-              mapPoint->worldPosVec().z,
-            };
+            const WAI::V3& pos  = snapshot->mapPointPositions[i];
+            *mapPointCoordinate = {pos.x, pos.y, pos.z};
 
             mapPointCoordinate++;
             count++;
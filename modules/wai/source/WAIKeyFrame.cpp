@@ -33,6 +33,9 @@
 #include <orb_slam/Converter.h>
 #include <Profiler.h>
 
+#include <cassert>
+#include <cstring>
+
 long unsigned int WAIKeyFrame::nNextId = 0;
 
 //-----------------------------------------------------------------------------
@@ -112,7 +115,8 @@ WAIKeyFrame::WAIKeyFrame(const cv::Mat&                   Tcw,
     SetPose(Tcw);
 
     //compute mBowVec and mFeatVec
-    ComputeBoW(vocabulary);
+    if (vocabulary)
+        ComputeBoW(vocabulary);
 
     //assign features to grid
     AssignFeaturesToGrid();
@@ -213,6 +217,28 @@ void WAIKeyFrame::ComputeBoW(WAIOrbVocabulary* vocabulary)
     }
 }
 //-----------------------------------------------------------------------------
+//! Computes the BoW of all keyframes that have none with one batched transform
+void WAIKeyFrame::ComputeBoW(const vector<WAIKeyFrame*>& keyFrames,
+                             WAIOrbVocabulary*           vocabulary)
+{
+    PROFILE_SCOPE("WAI::WAIKeyFrame::ComputeBoW(batch)");
+
+    vector<const cv::Mat*> descriptors;
+    vector<WAIBowVector*>  bows;
+    vector<WAIFeatVector*> feats;
+    for (WAIKeyFrame* kf : keyFrames)
+    {
+        if (kf->mBowVec.data.empty() || kf->mFeatVec.data.empty())
+        {
+            descriptors.push_back(&kf->mDescriptors);
+            bows.push_back(&kf->mBowVec);
+            feats.push_back(&kf->mFeatVec);
+        }
+    }
+
+    vocabulary->transform(descriptors, bows, feats);
+}
+//-----------------------------------------------------------------------------
 void WAIKeyFrame::SetPose(const cv::Mat& Tcw)
 {
     PROFILE_SCOPE("WAI::WAIKeyFrame::SetPose");
@@ -230,36 +256,61 @@ void WAIKeyFrame::SetPose(const cv::Mat& Tcw)
     //ghm1: unused code fragments because of monocular usage
     //cv::Mat center = (cv::Mat_<float>(4, 1) << mHalfBaseline, 0, 0, 1);
     //Cw = Twc*center;
+
+    // publish Tcw and Twc for the lock free getters below (poses are always CV_32F)
+    assert(_Tcw.type() == CV_32F);
+    float pose[32];
+    memcpy(pose, _Tcw.ptr<float>(), 16 * sizeof(float));
+    memcpy(pose + 16, _Twc.ptr<float>(), 16 * sizeof(float));
+    _publishedPose.publish(pose);
+}
+//-----------------------------------------------------------------------------
+/*! Copies the last published Tcw (first 16 floats) and Twc (last 16 floats)
+ without locking mMutexPose. Returns false if no pose was set yet.
+ */
+bool WAIKeyFrame::readPublishedPose(float* pose) const
+{
+    return _publishedPose.read(pose) != 0;
 }
 //-----------------------------------------------------------------------------
 cv::Mat WAIKeyFrame::GetPose()
 {
-    unique_lock<mutex> lock(mMutexPose);
-    return _Tcw.clone();
+    float pose[32];
+    if (!readPublishedPose(pose))
+        return cv::Mat();
+    return cv::Mat(4, 4, CV_32F, pose).clone();
 }
 //-----------------------------------------------------------------------------
 cv::Mat WAIKeyFrame::GetPoseInverse()
 {
-    unique_lock<mutex> lock(mMutexPose);
-    return _Twc.clone();
+    float pose[32];
+    if (!readPublishedPose(pose))
+        return cv::Mat();
+    return cv::Mat(4, 4, CV_32F, pose + 16).clone();
 }
 //-----------------------------------------------------------------------------
 cv::Mat WAIKeyFrame::GetCameraCenter()
 {
-    unique_lock<mutex> lock(mMutexPose);
-    return Ow.clone();
+    float pose[32];
+    if (!readPublishedPose(pose))
+        return cv::Mat();
+    return cv::Mat(4, 4, CV_32F, pose + 16).rowRange(0, 3).col(3).clone();
 }
 //-----------------------------------------------------------------------------
 cv::Mat WAIKeyFrame::GetRotation()
 {
-    unique_lock<mutex> lock(mMutexPose);
-    return _Tcw.rowRange(0, 3).colRange(0, 3).clone();
+    float pose[32];
+    if (!readPublishedPose(pose))
+        return cv::Mat();
+    return cv::Mat(4, 4, CV_32F, pose).rowRange(0, 3).colRange(0, 3).clone();
 }
 //-----------------------------------------------------------------------------
 cv::Mat WAIKeyFrame::GetTranslation()
 {
-    unique_lock<mutex> lock(mMutexPose);
-    return _Tcw.rowRange(0, 3).col(3).clone();
+    float pose[32];
+    if (!readPublishedPose(pose))
+        return cv::Mat();
+    return cv::Mat(4, 4, CV_32F, pose).rowRange(0, 3).col(3).clone();
 }
 //-----------------------------------------------------------------------------
 void WAIKeyFrame::AddConnection(WAIKeyFrame* pKF, int weight)
@@ -42,6 +42,8 @@
 #include <WAIOrbVocabulary.h>
 #include <WAIFrame.h>
 #include <WAIMath.h>
+#include <WAISlotMap.h>
+#include <WAIConcurrency.h>
 
 using namespace ORB_SLAM2;
 
@@ -59,7 +61,7 @@ keypoints.
 class WAI_API WAIKeyFrame
 {
 public:
-    //!keyframe generation during map loading
+    //!keyframe generation during map loading (vocabulary may be NULL to compute the BoW of all keyframes later)
     WAIKeyFrame(const cv::Mat&                   Tcw,
                 unsigned long                    id,
                 bool                             fixKF,
@@ -94,7 +96,8 @@ public:
     cv::Mat GetTranslation();
 
     // Bag of Words Representation
-    void ComputeBoW(WAIOrbVocabulary* vocabulary);
+    void        ComputeBoW(WAIOrbVocabulary* vocabulary);
+    static void ComputeBoW(const std::vector<WAIKeyFrame*>& keyFrames, WAIOrbVocabulary* vocabulary);
     void SetBowVector(WAIBowVector& bow);
 
     // Covisibility graph functions
@@ -174,6 +177,8 @@ public:
     static long unsigned int nNextId;
     long unsigned int        mnId;
     const long unsigned int  mnFrameId;
+    //! handle of this keyframe in the map storage (only accessed under the map mutex)
+    WAISlotHandle mMapSlot;
 
     const double mTimeStamp;
 
@@ -258,6 +263,10 @@ protected:
                   //! camera center
     cv::Mat Ow;
 
+    //! Tcw and Twc published by SetPose for lock free reads in the pose getters
+    WAIPublished<32> _publishedPose;
+    bool             readPublishedPose(float* pose) const;
+
     // MapPoints associated to keypoints (this array contains NULL for every
     //unassociated keypoint from original frame)
     std::vector<WAIMapPoint*> mvpMapPoints;
@@ -48,8 +48,12 @@ WAIMap::~WAIMap()
 //-----------------------------------------------------------------------------
 void WAIMap::AddKeyFrame(WAIKeyFrame* pKF)
 {
-    unique_lock<mutex> lock(mMutexMap);
-    mspKeyFrames.insert(pKF);
+    unique_lock<WAIInstrumentedMutex> lock(mMutexMap);
+    if (_keyFrames.get(pKF->mMapSlot) != pKF)
+    {
+        pKF->mMapSlot = _keyFrames.insert(pKF);
+        _version++;
+    }
     if (pKF->mnId > mnMaxKFid)
         mnMaxKFid = pKF->mnId;
     //mKfDB->add(pKF);
@@ -57,14 +61,23 @@ void WAIMap::AddKeyFrame(WAIKeyFrame* pKF)
 //-----------------------------------------------------------------------------
 void WAIMap::AddMapPoint(WAIMapPoint* pMP)
 {
-    unique_lock<mutex> lock(mMutexMap);
-    mspMapPoints.insert(pMP);
+    unique_lock<WAIInstrumentedMutex> lock(mMutexMap);
+    if (_mapPoints.get(pMP->mMapSlot) != pMP)
+    {
+        pMP->mMapSlot = _mapPoints.insert(pMP);
+        _version++;
+    }
 }
 //-----------------------------------------------------------------------------
 void WAIMap::EraseMapPoint(WAIMapPoint* pMP)
 {
-    unique_lock<mutex> lock(mMutexMap);
-    mspMapPoints.erase(pMP);
+    unique_lock<WAIInstrumentedMutex> lock(mMutexMap);
+    if (_mapPoints.get(pMP->mMapSlot) == pMP)
+    {
+        _mapPoints.erase(pMP->mMapSlot);
+        pMP->mMapSlot = WAISlotHandle();
+        _version++;
+    }
 
     // TODO: This only erase the pointer.
     // Delete the MapPoint
@@ -73,8 +86,13 @@ void WAIMap::EraseMapPoint(WAIMapPoint* pMP)
 //-----------------------------------------------------------------------------
 void WAIMap::EraseKeyFrame(WAIKeyFrame* pKF)
 {
-    unique_lock<mutex> lock(mMutexMap);
-    mspKeyFrames.erase(pKF);
+    unique_lock<WAIInstrumentedMutex> lock(mMutexMap);
+    if (_keyFrames.get(pKF->mMapSlot) == pKF)
+    {
+        _keyFrames.erase(pKF->mMapSlot);
+        pKF->mMapSlot = WAISlotHandle();
+        _version++;
+    }
     mKfDB->erase(pKF);
 
     //_deletedKeyFrames.push_back(pKF);
@@ -85,70 +103,117 @@ void WAIMap::EraseKeyFrame(WAIKeyFrame* pKF)
 //-----------------------------------------------------------------------------
 void WAIMap::SetReferenceMapPoints(const vector<WAIMapPoint*>& vpMPs)
 {
-    unique_lock<mutex> lock(mMutexMap);
+    unique_lock<WAIInstrumentedMutex> lock(mMutexMap);
     mvpReferenceMapPoints = vpMPs;
 }
 //-----------------------------------------------------------------------------
 void WAIMap::InformNewBigChange()
 {
-    unique_lock<mutex> lock(mMutexMap);
+    unique_lock<WAIInstrumentedMutex> lock(mMutexMap);
     mnBigChangeIdx++;
+    _version++;
 }
 //-----------------------------------------------------------------------------
 int WAIMap::GetLastBigChangeIdx()
 {
-    unique_lock<mutex> lock(mMutexMap);
+    unique_lock<WAIInstrumentedMutex> lock(mMutexMap);
     return mnBigChangeIdx;
 }
 //-----------------------------------------------------------------------------
 std::vector<WAIKeyFrame*> WAIMap::GetAllKeyFrames()
 {
-    unique_lock<mutex> lock(mMutexMap);
-    return vector<WAIKeyFrame*>(mspKeyFrames.begin(), mspKeyFrames.end());
+    unique_lock<WAIInstrumentedMutex> lock(mMutexMap);
+    return _keyFrames.elements();
 }
 //-----------------------------------------------------------------------------
 vector<WAIMapPoint*> WAIMap::GetAllMapPoints()
 {
-    unique_lock<mutex> lock(mMutexMap);
-    return vector<WAIMapPoint*>(mspMapPoints.begin(), mspMapPoints.end());
+    unique_lock<WAIInstrumentedMutex> lock(mMutexMap);
+    return _mapPoints.elements();
 }
 //-----------------------------------------------------------------------------
 long unsigned int WAIMap::KeyFramesInMap()
 {
-    unique_lock<mutex> lock(mMutexMap);
-    return (unsigned int)mspKeyFrames.size();
+    unique_lock<WAIInstrumentedMutex> lock(mMutexMap);
+    return (unsigned int)_keyFrames.size();
 }
 //-----------------------------------------------------------------------------
 long unsigned int WAIMap::MapPointsInMap()
 {
-    unique_lock<mutex> lock(mMutexMap);
-    return (unsigned int)mspMapPoints.size();
+    unique_lock<WAIInstrumentedMutex> lock(mMutexMap);
+    return (unsigned int)_mapPoints.size();
 }
 //-----------------------------------------------------------------------------
 long unsigned int WAIMap::GetMaxKFid()
 {
-    unique_lock<mutex> lock(mMutexMap);
+    unique_lock<WAIInstrumentedMutex> lock(mMutexMap);
     return mnMaxKFid;
 }
-
-float WAIMap::GetSize()
+//-----------------------------------------------------------------------------
+/*! The snapshot is rebuilt only if the map version changed since the last
+ call. Otherwise all callers share the same immutable snapshot, so calling this
+ every frame from the render thread costs a mutex and a shared_ptr copy.
+ */
+WAIMapSnapshotPtr WAIMap::getSnapshot()
 {
-    std::vector<WAIMapPoint*> mpv = GetAllMapPoints();
-    WAI::V3                   a   = mpv[0]->worldPosVec();
-    WAI::V3                   b   = a;
+    unique_lock<mutex> lockSnapshot(_mutexSnapshot);
+    uint64_t           version = _version;
+    if (_snapshot && _snapshot->version == version)
+        return _snapshot;
 
-    for (WAIMapPoint* mp : mpv)
+    std::shared_ptr<WAIMapSnapshot> snapshot = std::make_shared<WAIMapSnapshot>();
+    snapshot->version                        = version;
     {
-        WAI::V3 v = mp->worldPosVec();
-        a.x       = fmax(v.x, a.x);
-        a.y       = fmax(v.y, a.y);
-        a.z       = fmax(v.z, a.z);
-
-        b.x = fmin(v.x, b.x);
-        b.y = fmin(v.y, b.y);
-        b.z = fmin(v.z, b.z);
+        unique_lock<WAIInstrumentedMutex> lock(mMutexMap);
+        snapshot->mapPoints = _mapPoints.elements();
+        snapshot->keyFrames = _keyFrames.elements();
     }
 
+    snapshot->mapPointPositions.reserve(snapshot->mapPoints.size());
+    for (WAIMapPoint* mp : snapshot->mapPoints)
+        snapshot->mapPointPositions.push_back(mp->worldPosVec());
+
+    snapshot->keyFramePoses.reserve(snapshot->keyFrames.size());
+    for (WAIKeyFrame* kf : snapshot->keyFrames)
+    {
+        cv::Mat   Twc = kf->GetPoseInverse();
+        WAI::M4x4 pose;
+        for (int r = 0; r < 4; r++)
+            for (int c = 0; c < 4; c++)
+                pose.e[r][c] = Twc.at<float>(r, c);
+        snapshot->keyFramePoses.push_back(pose);
+    }
+
+    _snapshot = snapshot;
+    return _snapshot;
+}
+
+float WAIMap::GetSize()
+{
+    WAI::V3 a     = WAI::v3(0, 0, 0);
+    WAI::V3 b     = a;
+    bool    first = true;
+
+    // Iterates the slots directly instead of copying all map points
+    forEachMapPoint([&](WAIMapPoint* mp)
+                    {
+                        WAI::V3 v = mp->worldPosVec();
+                        if (first)
+                        {
+                            a     = v;
+                            b     = v;
+                            first = false;
+                        }
+
+                        a.x = fmax(v.x, a.x);
+                        a.y = fmax(v.y, a.y);
+                        a.z = fmax(v.z, a.z);
+
+                        b.x = fmin(v.x, b.x);
+                        b.y = fmin(v.y, b.y);
+                        b.z = fmin(v.z, b.z);
+                    });
+
     a = WAI::v3(a.x - b.x, a.y - b.y, a.z - b.z);
 
     return sqrt(a.x * a.x + a.y * a.y + a.z * a.z);
@@ -157,18 +222,19 @@ float WAIMap::GetSize()
 //-----------------------------------------------------------------------------
 void WAIMap::clear()
 {
-    for (auto* pt : mspMapPoints)
+    for (auto* pt : _mapPoints)
     {
         if (pt)
             delete pt;
     }
-    for (auto* kf : mspKeyFrames)
+    for (auto* kf : _keyFrames)
     {
         if (kf)
             delete kf;
     }
-    mspMapPoints.clear();
-    mspKeyFrames.clear();
+    _mapPoints.clear();
+    _keyFrames.clear();
+    _version++;
     mnMaxKFid = 0;
     mvpReferenceMapPoints.clear();
     mvpKeyFrameOrigins.clear();
@@ -206,7 +272,7 @@ void WAIMap::transform(cv::Mat transform)
 
     Mat Twc;
     Mat Tcw;
-    for (auto& kf : mspKeyFrames)
+    for (auto& kf : _keyFrames)
     {
         //get and rotate
         Tcw = kf->GetPose();
@@ -221,7 +287,7 @@ void WAIMap::transform(cv::Mat transform)
 
     int i = 0;
     //transform keypoints
-    for (auto& pt : mspMapPoints)
+    for (auto& pt : _mapPoints)
     {
         cv::Mat p  = (cv::Mat_<float>(4, 1) << 0, 0, 0, 1.0f);
         cv::Mat wp = pt->GetWorldPos();
@@ -231,12 +297,14 @@ void WAIMap::transform(cv::Mat transform)
         pt->SetWorldPos(wp);
     }
 
-    for (auto& mp : mspMapPoints)
+    for (auto& mp : _mapPoints)
     {
         //mean viewing direction and depth
         mp->UpdateNormalAndDepth();
         mp->ComputeDistinctiveDescriptors();
     }
+
+    markPosesChanged();
 }
 
 void WAIMap::rotate(float degVal, int type)
@@ -249,7 +317,7 @@ void WAIMap::rotate(float degVal, int type)
 
     //rotate keyframes
     Mat Twc;
-    for (auto& kf : mspKeyFrames)
+    for (auto& kf : _keyFrames)
     {
         //get and rotate
         Twc = kf->GetPose().inv();
@@ -261,7 +329,7 @@ void WAIMap::rotate(float degVal, int type)
     //rotate keypoints
     Mat Pw;
     Mat rot33 = rot.rowRange(0, 3).colRange(0, 3);
-    for (auto& pt : mspMapPoints)
+    for (auto& pt : _mapPoints)
     {
         Pw = rot33 * pt->GetWorldPos();
         pt->SetWorldPos(rot33 * pt->GetWorldPos());
@@ -276,7 +344,7 @@ void WAIMap::translate(float value, int type)
 
     //rotate keyframes
     Mat Twc;
-    for (auto& kf : mspKeyFrames)
+    for (auto& kf : _keyFrames)
     {
         //get and translate
         cv::Mat Twc = kf->GetPose().inv();
@@ -286,7 +354,7 @@ void WAIMap::translate(float value, int type)
     }
 
     //rotate keypoints
-    for (auto& pt : mspMapPoints)
+    for (auto& pt : _mapPoints)
     {
         pt->SetWorldPos(trans + pt->GetWorldPos());
     }
@@ -294,7 +362,7 @@ void WAIMap::translate(float value, int type)
 //-----------------------------------------------------------------------------
 void WAIMap::scale(float value)
 {
-    for (auto& kf : mspKeyFrames)
+    for (auto& kf : _keyFrames)
     {
         //get and translate
         cv::Mat Tcw = kf->GetPose();
@@ -311,7 +379,7 @@ void WAIMap::scale(float value)
     }
 
     //rotate keypoints
-    for (auto& pt : mspMapPoints)
+    for (auto& pt : _mapPoints)
     {
         pt->SetWorldPos(value * pt->GetWorldPos());
     }
@@ -348,13 +416,15 @@ void WAIMap::applyTransformation(double value, TransformType type)
     }
 
     //compute resulting values for map points
-    for (auto& mp : mspMapPoints)
+    for (auto& mp : _mapPoints)
     {
         //mean viewing direction and depth
         mp->UpdateNormalAndDepth();
         mp->ComputeDistinctiveDescriptors();
     }
 
+    markPosesChanged();
+
 #if 0
     //update scene objects
     //exchange all Keyframes (also change name)
@@ -430,14 +500,14 @@ size_t WAIMap::getSizeOf()
 
     //size of map points
     std::size_t sizeOfMapPoints = 0;
-    for (auto mp : mspMapPoints)
+    for (auto mp : _mapPoints)
     {
         sizeOfMapPoints += mp->getSizeOf();
     }
 
     //size of key frames
     std::size_t sizeOfKeyFrames = 0;
-    for (auto kf : mspKeyFrames)
+    for (auto kf : _keyFrames)
     {
         sizeOfKeyFrames += kf->getSizeOf();
     }
@@ -456,8 +526,8 @@ size_t WAIMap::getSizeOf()
 //-----------------------------------------------------------------------------
 bool WAIMap::isKeyFrameInMap(WAIKeyFrame* pKF)
 {
-    bool result = (mspKeyFrames.find(pKF) != mspKeyFrames.end());
-    return result;
+    unique_lock<WAIInstrumentedMutex> lock(mMutexMap);
+    return _keyFrames.get(pKF->mMapSlot) == pKF;
 }
 //-----------------------------------------------------------------------------
 void WAIMap::incNumLoopClosings()
@@ -477,3 +547,19 @@ int WAIMap::getNumLoopClosings()
     unique_lock<mutex> lock(_mutexLoopClosings);
     return _numberOfLoopClosings;
 }
+//-----------------------------------------------------------------------------
+std::string WAIMap::getLockStatistics()
+{
+    std::string stats;
+    stats += mMutexMap.statsString() + "\n";
+    stats += mMutexMapUpdate.statsString() + "\n";
+    stats += WAIMapPoint::mGlobalMutex.statsString() + "\n";
+    return stats;
+}
+//-----------------------------------------------------------------------------
+void WAIMap::resetLockStatistics()
+{
+    mMutexMap.resetStats();
+    mMutexMapUpdate.resetStats();
+    WAIMapPoint::mGlobalMutex.resetStats();
+}
@@ -34,6 +34,8 @@
 #include <string>
 #include <mutex>
 #include <set>
+#include <atomic>
+#include <memory>
 
 #include <opencv2/core.hpp>
 
@@ -41,9 +43,29 @@
 #include <WAIKeyFrameDB.h>
 #include <WAIKeyFrame.h>
 #include <WAIHelper.h>
+#include <WAIMath.h>
+#include <WAISlotMap.h>
+#include <WAIConcurrency.h>
 
 using namespace std;
 
+//-----------------------------------------------------------------------------
+//! Immutable copy of the map geometry for rendering
+/*! The snapshot is built by WAIMap::getSnapshot when the map version changed
+ and is shared between all readers. The position and pose arrays are parallel
+ to the pointer arrays and stored contiguously, so a renderer can upload them
+ without touching the map point or keyframe mutexes again.
+ */
+struct WAIMapSnapshot
+{
+    uint64_t                  version = 0; //!< map version the snapshot was built from
+    std::vector<WAIMapPoint*> mapPoints;
+    std::vector<WAI::V3>      mapPointPositions; //!< world positions parallel to mapPoints
+    std::vector<WAIKeyFrame*> keyFrames;
+    std::vector<WAI::M4x4>    keyFramePoses; //!< camera to world poses (Twc) parallel to keyFrames
+};
+typedef std::shared_ptr<const WAIMapSnapshot> WAIMapSnapshotPtr;
+
 //-----------------------------------------------------------------------------
 //!
 /*!
@@ -80,6 +102,33 @@ public:
     long unsigned int MapPointsInMap();
     long unsigned int KeyFramesInMap();
 
+    //! Calls func for every map point without copying the container.
+    /*! The map mutex is held during the iteration, so func must not call
+     back into the map. */
+    template<typename Func>
+    void forEachMapPoint(Func func)
+    {
+        unique_lock<WAIInstrumentedMutex> lock(mMutexMap);
+        for (WAIMapPoint* mp : _mapPoints)
+            func(mp);
+    }
+
+    //! Calls func for every keyframe without copying the container.
+    template<typename Func>
+    void forEachKeyFrame(Func func)
+    {
+        unique_lock<WAIInstrumentedMutex> lock(mMutexMap);
+        for (WAIKeyFrame* kf : _keyFrames)
+            func(kf);
+    }
+
+    //! Flags that keyframe poses or map point positions were changed (e.g. after bundle adjustment)
+    void     markPosesChanged() { _version++; }
+    uint64_t getVersion() const { return _version; }
+
+    //! Returns a snapshot of all map points and keyframes for rendering
+    WAIMapSnapshotPtr getSnapshot();
+
     long unsigned int GetMaxKFid();
 
     float GetSize();
@@ -87,10 +136,11 @@ public:
 
     vector<WAIKeyFrame*> mvpKeyFrameOrigins;
 
-    std::mutex mMutexMapUpdate;
+    WAIInstrumentedMutex mMutexMapUpdate{"Map update"};
 
-    // This avoid that two points are created simultaneously in separate threads (id conflict)
-    std::mutex mMutexPointCreation;
+    //! Lock statistics of the map mutexes (one line per mutex)
+    std::string getLockStatistics();
+    void        resetLockStatistics();
 
     //transformation functions
     void    transform(cv::Mat transform);
@@ -110,8 +160,8 @@ public:
     int  getNumLoopClosings();
 
 protected:
-    std::set<WAIMapPoint*>    mspMapPoints;
-    std::set<WAIKeyFrame*>    mspKeyFrames;
+    WAISlotMap<WAIMapPoint>   _mapPoints;
+    WAISlotMap<WAIKeyFrame>   _keyFrames;
     std::vector<WAIKeyFrame*> _deletedKeyFrames;
     WAIKeyFrameDB*            mKfDB{nullptr};
 
@@ -122,11 +172,16 @@ protected:
     // Index related to a big change in the map (loop closure, global BA)
     int mnBigChangeIdx;
 
-    std::mutex mMutexMap;
+    WAIInstrumentedMutex mMutexMap{"Map"};
 
     std::mutex _mutexLoopClosings;
     int        _numberOfLoopClosings = 0;
     int        _numOfKeyframes;
+
+    //! Incremented on every structural change and on markPosesChanged
+    std::atomic<uint64_t> _version{1};
+    std::mutex            _mutexSnapshot;
+    WAIMapSnapshotPtr     _snapshot;
 };
 
 #endif // !WAIMAP_H
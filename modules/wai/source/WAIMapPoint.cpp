@@ -14,8 +14,8 @@
 #include <mutex>
 
 long unsigned int WAIMapPoint::nNextId = 0;
-mutex             WAIMapPoint::mGlobalMutex;
-mutex             WAIMapPoint::mMutexMapPointCreation;
+WAIInstrumentedMutex WAIMapPoint::mGlobalMutex("MapPoint global");
+mutex                WAIMapPoint::mMutexMapPointCreation;
 
 //-----------------------------------------------------------------------------
 //!constructor used during map loading
@@ -94,11 +94,9 @@ WAIMapPoint::WAIMapPoint(const cv::Mat& Pos,
 //-----------------------------------------------------------------------------
 WAI::V3 WAIMapPoint::worldPosVec()
 {
-    unique_lock<mutex> lock(mMutexPos);
-    WAI::V3            vec;
-    vec.x = mWorldPos.at<float>(0, 0);
-    vec.y = mWorldPos.at<float>(1, 0);
-    vec.z = mWorldPos.at<float>(2, 0);
+    // lock free read of the last published position
+    WAI::V3 vec;
+    _publishedPos.read(vec.e);
     return vec;
 }
 //-----------------------------------------------------------------------------
@@ -108,6 +106,7 @@ void WAIMapPoint::worldPosVec(WAI::V3 vec)
     mWorldPos.at<float>(0, 0) = vec.x;
     mWorldPos.at<float>(1, 0) = vec.y;
     mWorldPos.at<float>(2, 0) = vec.z;
+    _publishedPos.publish(vec.e);
 }
 //-----------------------------------------------------------------------------
 WAI::V3 WAIMapPoint::normalVec()
@@ -125,15 +124,21 @@ WAI::V3 WAIMapPoint::normalVec()
 //-----------------------------------------------------------------------------
 void WAIMapPoint::SetWorldPos(const cv::Mat& Pos)
 {
-    unique_lock<mutex> lock2(mGlobalMutex);
-    unique_lock<mutex> lock(mMutexPos);
+    unique_lock<WAIInstrumentedMutex> lock2(mGlobalMutex);
+    unique_lock<mutex>                lock(mMutexPos);
     Pos.copyTo(mWorldPos);
+    _publishedPos.publish(mWorldPos.ptr<float>());
 }
 //-----------------------------------------------------------------------------
+/*! The tracking thread calls this for every map point of the local map. It
+ reads the last published position without locking mMutexPos, so it never
+ waits for local mapping or loop closing updating the point.
+ */
 cv::Mat WAIMapPoint::GetWorldPos()
 {
-    unique_lock<mutex> lock(mMutexPos);
-    return mWorldPos.clone();
+    cv::Mat pos(3, 1, CV_32F);
+    _publishedPos.read(pos.ptr<float>());
+    return pos;
 }
 //-----------------------------------------------------------------------------
 cv::Mat WAIMapPoint::GetNormal()
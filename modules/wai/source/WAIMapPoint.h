@@ -19,6 +19,8 @@
 #include <opencv2/core/core.hpp>
 
 #include <WAIMath.h>
+#include <WAISlotMap.h>
+#include <WAIConcurrency.h>
 
 class WAIKeyFrame;
 class WAIFrame;
@@ -110,6 +112,8 @@ public:
     static long unsigned int nNextId;
     long int                 mnFirstKFid;
     int                      nObs = 0;
+    //! handle of this point in the map storage (only accessed under the map mutex)
+    WAISlotHandle mMapSlot;
 
     // Variables used by the tracking
     //ghm1: projection point
@@ -134,8 +138,8 @@ public:
     cv::Mat           mPosGBA;
     //long unsigned int mnBAGlobalForKF;
 
-    static std::mutex mGlobalMutex;
-    static std::mutex mMutexMapPointCreation;
+    static WAIInstrumentedMutex mGlobalMutex;
+    static std::mutex           mMutexMapPointCreation;
 
     float GetMaxDistance();
     float GetMinDistance();
@@ -152,6 +156,8 @@ protected:
     //open cv coordinate representation: z-axis points to principlal point,
     // x-axis to the right and y-axis down
     cv::Mat mWorldPos;
+    //! copy of mWorldPos for lock free reads, published on every write of mWorldPos
+    WAIPublished<3> _publishedPos;
 
     // Keyframes observing the point and associated index in keyframe
     std::map<WAIKeyFrame*, size_t> mObservations;
@@ -331,6 +331,13 @@ std::vector<WAIMapPoint*> WAI::ModeOrbSlam2::getMapPoints()
     return result;
 }
 
+WAIMapSnapshotPtr WAI::ModeOrbSlam2::getMapSnapshot()
+{
+    std::lock_guard<std::mutex> guard(_mapLock);
+
+    return _map->getSnapshot();
+}
+
 std::vector<WAIMapPoint*> WAI::ModeOrbSlam2::getMarkerCornerMapPoints()
 {
     std::vector<WAIMapPoint*> result;
@@ -574,7 +581,7 @@ void WAI::ModeOrbSlam2::initialize(cv::Mat& imageGray, cv::Mat& imageRGB)
     int matchesNeeded = 100;
 
     // Get Map Mutex -> Map cannot be changed
-    std::unique_lock<std::mutex> lock(_map->mMutexMapUpdate, std::defer_lock);
+    std::unique_lock<WAIInstrumentedMutex> lock(_map->mMutexMapUpdate, std::defer_lock);
     if (!_params.serial)
     {
         lock.lock();
@@ -760,7 +767,7 @@ void WAI::ModeOrbSlam2::track3DPts(cv::Mat& imageGray, cv::Mat& imageRGB)
                              _params.retainImg);
 
     // Get Map Mutex -> Map cannot be changed
-    std::unique_lock<std::mutex> lock(_map->mMutexMapUpdate, std::defer_lock);
+    std::unique_lock<WAIInstrumentedMutex> lock(_map->mMutexMapUpdate, std::defer_lock);
     if (!_params.serial)
     {
         lock.lock();
@@ -1114,6 +1121,7 @@ bool WAI::ModeOrbSlam2::createInitialMapMonocular(int mapPointsNeeded)
             pMP->SetWorldPos(pMP->GetWorldPos() * invMedianDepth);
         }
     }
+    _map->markPosesChanged();
 
     mpLocalMapper->InsertKeyFrame(pKFini);
     mpLocalMapper->InsertKeyFrame(pKFcur);
@@ -121,6 +121,7 @@ public:
     std::vector<WAIMapPoint*>                                 getLocalMapPoints();
     std::vector<WAIMapPoint*>                                 getMarkerCornerMapPoints();
     std::vector<WAIKeyFrame*>                                 getKeyFrames();
+    WAIMapSnapshotPtr                                         getMapSnapshot();
     std::pair<std::vector<cv::Vec3f>, std::vector<cv::Vec2f>> getMatchedCorrespondances();
     std::pair<std::vector<cv::Vec3f>, std::vector<cv::Vec2f>> getCorrespondances();
 
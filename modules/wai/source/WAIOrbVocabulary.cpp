@@ -10,6 +10,8 @@
 #include <orb_slam/Converter.h>
 #include <WAIOrbVocabulary.h>
 #include <Utils.h>
+#include <SLFileStorage.h>
+#include <cassert>
 
 WAIOrbVocabulary::WAIOrbVocabulary(int layer)
 {
@@ -47,12 +49,22 @@ void WAIOrbVocabulary::loadFromFile(std::string strVocFile)
     }
 
 #if USE_FBOW
+    // The vocabulary is parsed from the memory mapped file
+    if (!SLFileStorage::exists(strVocFile, IOK_generic))
+    {
+        std::string err = "WAIOrbVocabulary::loadFromFile: vocabulary not found " + strVocFile;
+        throw std::runtime_error(err);
+    }
+
+    SLIOView view = SLFileStorage::readIntoView(strVocFile, IOK_generic);
     try
     {
-        _vocabulary->readFromFile(strVocFile);
+        _vocabulary->readFromMemory(view.data, view.size);
+        view.release();
     }
     catch (std::exception& e)
     {
+        view.release();
         std::string err = "WAIOrbVocabulary::loadFromFile: failed to load vocabulary " + 
             strVocFile + ", exception:" + e.what();
         throw std::runtime_error(err);
@@ -84,6 +96,15 @@ WAIBowVector::WAIBowVector(std::vector<int> wid, std::vector<float> values)
 }
 
 void WAIOrbVocabulary::transform(const cv::Mat& descriptors, WAIBowVector& bow, WAIFeatVector& feat)
+{
+    transform(descriptors, bow, feat, _numThreads);
+}
+//-----------------------------------------------------------------------------
+//! Transforms the descriptors of one frame splitting them onto numThreads threads
+void WAIOrbVocabulary::transform(const cv::Mat& descriptors,
+                                 WAIBowVector&  bow,
+                                 WAIFeatVector& feat,
+                                 int            numThreads)
 {
     bow.isFill  = true;
     feat.isFill = true;
@@ -92,12 +113,30 @@ void WAIOrbVocabulary::transform(const cv::Mat& descriptors, WAIBowVector& bow,
         return;
 
 #if USE_FBOW
-    _vocabulary->transform(descriptors, _layer, bow.data, feat.data);
+    _vocabulary->transform(descriptors, _layer, bow.data, feat.data, numThreads);
 #else
     vector<cv::Mat> vCurrentDesc = ORB_SLAM2::Converter::toDescriptorVector(descriptors);
     _vocabulary->transform(vCurrentDesc, bow.data, feat.data, _vocabulary->getDepthLevels() - _layer);
 #endif
 }
+//-----------------------------------------------------------------------------
+/*! Transforms the descriptors of many frames (e.g. all keyframes of a loaded
+ map) in parallel. Every thread takes the next frame that is not transformed
+ yet, so frames with many descriptors do not stall the others. The vocabulary
+ tree is only read and can be shared by all threads.
+ */
+void WAIOrbVocabulary::transform(const std::vector<const cv::Mat*>& descriptors,
+                                 const std::vector<WAIBowVector*>&  bows,
+                                 const std::vector<WAIFeatVector*>& feats)
+{
+    assert(descriptors.size() == bows.size() && descriptors.size() == feats.size());
+
+    // The frames are already spread over all threads, so each is transformed serially
+    Utils::parallelFor((int)descriptors.size(),
+                       [&](int i)
+                       { transform(*descriptors[i], *bows[i], *feats[i], 1); },
+                       "WAIOrbVocabulary");
+}
 
 double WAIOrbVocabulary::score(WAIBowVector& bow1, WAIBowVector& bow2)
 {
@@ -11,6 +11,7 @@
 #define WAI_ORBVOCABULARY_H
 #define USE_FBOW 1
 
+#include <algorithm>
 #include <string>
 #include <WAIHelper.h>
 
@@ -62,13 +63,23 @@ public:
     ORB_SLAM2::ORBVocabulary* _vocabulary = nullptr;
 #endif
     void   transform(const cv::Mat& descriptors, WAIBowVector& bow, WAIFeatVector& feat);
+    void   transform(const std::vector<const cv::Mat*>& descriptors,
+                     const std::vector<WAIBowVector*>&  bows,
+                     const std::vector<WAIFeatVector*>& feats);
     double score(WAIBowVector& bow1, WAIBowVector& bow2);
     size_t size();
     void   save(std::string path);
     void   setLayer(int layer) { _layer = layer; }
+    void   setNumThreads(int numThreads) { _numThreads = std::max(1, numThreads); }
 
 private:
+    void transform(const cv::Mat& descriptors,
+                   WAIBowVector&  bow,
+                   WAIFeatVector& feat,
+                   int            numThreads);
+
     int _layer;
+    int _numThreads = 1; //!< threads that split the descriptors of a single transform
 };
 
 #endif // !WAI_ORBVOCABULARY_H
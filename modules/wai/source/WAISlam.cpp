@@ -33,6 +33,7 @@ WAISlam::WAISlam(const cv::Mat&          intrinsic,
     _distortion      = distortion.clone();
     _cameraIntrinsic = intrinsic.clone();
     _voc             = voc;
+    _voc->setNumThreads(std::min(_params.bowThreads, (int)Utils::maxThreads()));
 
     _extractor      = extractor;
     _relocExtractor = relocExtractor;
@@ -69,7 +70,9 @@ WAISlam::WAISlam(const cv::Mat&          intrinsic,
                                               false);
 
     _localMapping->SetLoopCloser(_loopClosing);
+    _localMapping->SetReuseLocalBAGraph(_params.reuseLocalBAGraph);
     _loopClosing->SetLocalMapper(_localMapping);
+    _loopClosing->SetIterativeGBASolver(_params.iterativeGBASolver);
 
     if (!_params.onlyTracking && !_params.serial)
     {
@@ -196,11 +199,12 @@ void WAISlam::createFrame(WAIFrame& frame, cv::Mat& imageGray)
 /* Separate Pose update thread */
 void WAISlam::flushQueue()
 {
-    std::unique_lock<std::mutex> lock(_lastFrameMutex);
+    std::unique_lock<std::mutex> lock(_frameQueueMutex);
     while (!_framesQueue.empty())
     {
         _framesQueue.pop();
     }
+    _frameQueueNotFull.notify_all();
 }
 //-----------------------------------------------------------------------------
 void WAISlam::updateState(WAITrackingState state)
@@ -209,16 +213,34 @@ void WAISlam::updateState(WAITrackingState state)
     _state = state;
 }
 //-----------------------------------------------------------------------------
-int WAISlam::getNextFrame(WAIFrame& frame)
+/*! Waits up to 25ms for a queued frame so that the pose update thread does
+ not spin while the queue is empty. Returns the number of frames that were in
+ the queue (0 if none arrived).
+ */
+int WAISlam::getNextFrame(WAIFrame& frame, HighResTimePoint& updateStart)
 {
     int                          nbFrameInQueue;
     std::unique_lock<std::mutex> lock(_frameQueueMutex);
+    _frameQueueNotEmpty.wait_for(lock, 25ms, [this] { return !_framesQueue.empty(); });
+
     nbFrameInQueue = (int)_framesQueue.size();
     if (nbFrameInQueue == 0)
         return 0;
 
-    frame = _framesQueue.front();
+    QueuedFrame& queued = _framesQueue.front();
+    frame               = std::move(queued.frame);
+    updateStart         = queued.updateStart;
+
+    float waitMS = (float)duration_cast<microseconds>(HighResClock::now() - queued.enqueued).count() / 1000.0f;
     _framesQueue.pop();
+    lock.unlock();
+    _frameQueueNotFull.notify_one();
+
+    {
+        std::unique_lock<std::mutex> timingsLock(_timingsMutex);
+        _queueWaitMS.set(waitMS);
+    }
+
     return nbFrameInQueue;
 }
 //-----------------------------------------------------------------------------
@@ -258,14 +280,10 @@ void WAISlam::updatePoseThread(WAISlam* ptr)
 {
     while (1)
     {
-        WAIFrame f;
-        while (ptr->getNextFrame(f) && !ptr->finishRequested())
-        {
-            if (ptr->_params.ensureKFIntegration)
-                ptr->updatePoseKFIntegration(f);
-            else
-                ptr->updatePose(f);
-        }
+        WAIFrame         f;
+        HighResTimePoint updateStart;
+        while (!ptr->finishRequested() && ptr->getNextFrame(f, updateStart))
+            ptr->trackFrame(f, updateStart);
 
         if (ptr->finishRequested())
         {
@@ -273,6 +291,7 @@ void WAISlam::updatePoseThread(WAISlam* ptr)
 
             while (!ptr->_framesQueue.empty())
                 ptr->_framesQueue.pop();
+            ptr->_frameQueueNotFull.notify_all();
 
             break;
         }
@@ -468,23 +487,88 @@ WAIFrame* WAISlam::getLastFramePtr()
     return &_lastFrame;
 }
 //-----------------------------------------------------------------------------
-bool WAISlam::update(cv::Mat& imageGray)
+//! Tracks one frame and updates the tracking and latency timings
+void WAISlam::trackFrame(WAIFrame& frame, HighResTimePoint updateStart)
 {
-    WAIFrame frame;
-    createFrame(frame, imageGray);
+    HighResTimePoint trackingStart = HighResClock::now();
 
-#if MULTI_THREAD_FRAME_PROCESSING
-    std::unique_lock<std::mutex> lock(_frameQueueMutex);
-    _framesQueue.push(frame);
-#else
     if (_params.ensureKFIntegration)
         updatePoseKFIntegration(frame);
     else
         updatePose(frame);
+
+    HighResTimePoint trackingEnd = HighResClock::now();
+
+    std::unique_lock<std::mutex> lock(_timingsMutex);
+    _trackingMS.set((float)duration_cast<microseconds>(trackingEnd - trackingStart).count() / 1000.0f);
+    _latencyMS.set((float)duration_cast<microseconds>(trackingEnd - updateStart).count() / 1000.0f);
+}
+//-----------------------------------------------------------------------------
+/*! Extracts the features of the image on the calling thread. In pipelined
+ mode (Params::frameQueueSize > 0) the frame is handed over to the pose update
+ thread, so the extraction of the next image overlaps with the tracking of
+ this one. The returned tracking state therefore can be one frame behind.
+ */
+bool WAISlam::update(cv::Mat& imageGray)
+{
+    HighResTimePoint updateStart = HighResClock::now();
+
+    WAIFrame frame;
+    createFrame(frame, imageGray);
+
+    float extractionMS = (float)duration_cast<microseconds>(HighResClock::now() - updateStart).count() / 1000.0f;
+    {
+        std::unique_lock<std::mutex> lock(_timingsMutex);
+        _extractionMS.set(extractionMS);
+    }
+
+#if MULTI_THREAD_FRAME_PROCESSING
+    if (_params.frameQueueSize > 0)
+    {
+        std::unique_lock<std::mutex> lock(_frameQueueMutex);
+        if (_params.dropOldestFrame)
+        {
+            while ((int)_framesQueue.size() >= _params.frameQueueSize)
+            {
+                _framesQueue.pop();
+                _droppedFrames++;
+            }
+        }
+        else
+        {
+            _frameQueueNotFull.wait(lock, [this]
+                                    { return (int)_framesQueue.size() < _params.frameQueueSize || finishRequested(); });
+        }
+
+        _framesQueue.push({frame, updateStart, HighResClock::now()});
+        lock.unlock();
+        _frameQueueNotEmpty.notify_one();
+        return isTracking();
+    }
 #endif
+
+    trackFrame(frame, updateStart);
     return isTracking();
 }
 //-----------------------------------------------------------------------------
+WAISlam::PipelineTimings WAISlam::getPipelineTimings()
+{
+    PipelineTimings timings;
+    {
+        std::unique_lock<std::mutex> lock(_timingsMutex);
+        timings.extractionMS = _extractionMS.average();
+        timings.queueWaitMS  = _queueWaitMS.average();
+        timings.trackingMS   = _trackingMS.average();
+        timings.latencyMS    = _latencyMS.average();
+    }
+    {
+        std::unique_lock<std::mutex> lock(_frameQueueMutex);
+        timings.queuedFrames = (int)_framesQueue.size();
+    }
+    timings.droppedFrames = (unsigned int)_droppedFrames;
+    return timings;
+}
+//-----------------------------------------------------------------------------
 void WAISlam::drawInfo(cv::Mat& imageBGR,
                        float    scale,
                        bool     showInitLine,
@@ -17,6 +17,10 @@
 #include <WAIMapPoint.h>
 #include <WAIKeyFrame.h>
 #include <memory>
+#include <atomic>
+#include <condition_variable>
+#include <Averaged.h>
+#include <HighResTimer.h>
 
 //-----------------------------------------------------------------------------
 /*
@@ -53,6 +57,37 @@ public:
 
         // Min acceleration score filter in detectRelocalizationCandidates
         bool minAccScoreFilter = false;
+
+        // pipelined tracking: update() extracts the features of frame N+1 on the
+        // caller thread while the pose update thread tracks frame N.
+        // Max. number of extracted frames waiting for tracking. 0 disables the
+        // pipeline and tracks on the caller thread (lowest latency, no overlap).
+        int frameQueueSize = 1;
+        // false: update() blocks until there is space (every frame is tracked)
+        // true: a full queue drops its oldest frame (latency stays bounded).
+        // Live camera apps can opt in, offline evaluations need every frame.
+        bool dropOldestFrame = false;
+
+        // keep the local bundle adjustment graph between keyframes and only
+        // update the vertices and edges that entered or left the local window
+        bool reuseLocalBAGraph = true;
+        // solve the global bundle adjustment after loop closing with PCG
+        // instead of a sparse Cholesky factorization (faster for large maps)
+        bool iterativeGBASolver = false;
+        // No. of threads that split the descriptors of one frame in the BoW
+        // transform of new keyframes and relocalization (1 = serial)
+        int bowThreads = 4;
+    };
+
+    //! Averaged per stage timings of the tracking pipeline in ms
+    struct PipelineTimings
+    {
+        float        extractionMS  = 0.0f; //!< ORB extraction and frame creation on the caller thread
+        float        queueWaitMS   = 0.0f; //!< time a frame waited in the queue for the pose thread
+        float        trackingMS    = 0.0f; //!< pose estimation, local map tracking and mapping decision
+        float        latencyMS     = 0.0f; //!< from the start of update() until the pose was estimated
+        int          queuedFrames  = 0;    //!< frames currently waiting in the queue
+        unsigned int droppedFrames = 0;    //!< frames dropped because the queue was full
     };
 
     WAISlam(const cv::Mat&          intrinsic,
@@ -110,6 +145,14 @@ public:
         return std::vector<WAIKeyFrame*>();
     }
 
+    //! Map geometry for rendering. Only rebuilt when the map changed since the last call.
+    virtual WAIMapSnapshotPtr getMapSnapshot()
+    {
+        if (_globalMap != nullptr)
+            return _globalMap->getSnapshot();
+        return std::make_shared<const WAIMapSnapshot>();
+    }
+
     virtual std::string getPrintableState()
     {
         switch (_state)
@@ -163,6 +206,16 @@ public:
 
     std::string getLoopCloseStatus();
 
+    PipelineTimings getPipelineTimings();
+
+    //! Acquisitions, contentions and waiting times of the map mutexes
+    std::string getLockStatistics()
+    {
+        if (_globalMap != nullptr)
+            return _globalMap->getLockStatistics();
+        return std::string();
+    }
+
     int getLoopCloseCount();
 
     int getKeyFramesInLoopCloseQueueCount();
@@ -179,7 +232,7 @@ protected:
     bool        isStop();
     bool        isFinished();
     void        flushQueue();
-    int         getNextFrame(WAIFrame& frame);
+    int         getNextFrame(WAIFrame& frame, HighResTimePoint& updateStart);
     static void updatePoseThread(WAISlam* ptr);
 
     WAITrackingState _state = WAITrackingState::Idle;
@@ -198,8 +251,27 @@ protected:
     KPextractor*         _iniExtractor        = nullptr;
     int                  _infoMatchedInliners = 0;
     std::thread*         _poseUpdateThread;
-    std::queue<WAIFrame> _framesQueue;
-    std::mutex           _frameQueueMutex;
+
+    //! extracted frame waiting for the pose update thread
+    struct QueuedFrame
+    {
+        WAIFrame         frame;
+        HighResTimePoint updateStart; //!< start of the update() call that created the frame
+        HighResTimePoint enqueued;
+    };
+    std::queue<QueuedFrame> _framesQueue;
+    std::mutex              _frameQueueMutex;
+    std::condition_variable _frameQueueNotEmpty;
+    std::condition_variable _frameQueueNotFull;
+
+    void trackFrame(WAIFrame& frame, HighResTimePoint updateStart);
+
+    std::mutex       _timingsMutex;
+    Utils::AvgFloat  _extractionMS{60, 0.0f};
+    Utils::AvgFloat  _queueWaitMS{60, 0.0f};
+    Utils::AvgFloat  _trackingMS{60, 0.0f};
+    Utils::AvgFloat  _latencyMS{60, 0.0f};
+    std::atomic<int> _droppedFrames{0};
 };
 //-----------------------------------------------------------------------------
 #endif
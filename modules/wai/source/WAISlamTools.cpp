@@ -243,7 +243,7 @@ bool WAISlamTools::genInitialMap(WAIMap*       map,
     if (localMap.keyFrames.size() != 2)
         return false;
 
-    std::unique_lock<std::mutex> lock(map->mMutexMapUpdate, std::defer_lock);
+    std::unique_lock<WAIInstrumentedMutex> lock(map->mMutexMapUpdate, std::defer_lock);
     lock.lock();
     // Insert KFs in the map
     map->AddKeyFrame(localMap.keyFrames[0]);
@@ -278,7 +278,7 @@ bool WAISlamTools::oldInitialize(WAIFrame&           frame,
     int matchesNeeded = mapPointsNeeded;
 
     // Get Map Mutex -> Map cannot be changed
-    std::unique_lock<std::mutex> lock(map->mMutexMapUpdate, std::defer_lock);
+    std::unique_lock<WAIInstrumentedMutex> lock(map->mMutexMapUpdate, std::defer_lock);
     lock.lock();
 
     if (!iniData.initializer)
@@ -436,13 +436,14 @@ bool WAISlamTools::oldInitialize(WAIFrame&           frame,
             pMP->SetWorldPos(pMP->GetWorldPos() * invMedianDepth);
         }
     }
+    map->markPosesChanged();
 
     localMapper->InsertKeyFrame(pKFini);
     localMapper->InsertKeyFrame(pKFcur);
 
     frame.SetPose(pKFcur->GetPose());
     localMap.refKF     = pKFcur;
-    localMap.mapPoints = map->GetAllMapPoints();
+    localMap.mapPoints = map->getSnapshot()->mapPoints;
 
     frame.mpReferenceKF = pKFcur;
 
@@ -1481,7 +1482,10 @@ bool WAISlamTools::doMarkerMapPreprocessing(std::string       markerFile,
                                              voc);
 
     // 1.b Find keyframes with enough matches to marker image
-    std::vector<WAIKeyFrame*> kfs = map->GetAllKeyFrames();
+    // The snapshot is shared with the renderer and holds the map point
+    // positions contiguously, so they are read below without locking each point.
+    WAIMapSnapshotPtr                snapshot = map->getSnapshot();
+    const std::vector<WAIKeyFrame*>& kfs      = snapshot->keyFrames;
 
     WAIKeyFrame* matchedKf1 = nullptr;
     WAIKeyFrame* matchedKf2 = nullptr;
@@ -1692,7 +1696,7 @@ bool WAISlamTools::doMarkerMapPreprocessing(std::string       markerFile,
     }
 
     // 5. Cull mappoints outside of marker
-    std::vector<WAIMapPoint*> mapPoints = map->GetAllMapPoints();
+    const std::vector<WAIMapPoint*>& mapPoints = snapshot->mapPoints;
 
     cv::Mat system = cv::Mat::zeros(3, 3, CV_32F);
     AC.copyTo(system.rowRange(0, 3).col(0));
@@ -1707,7 +1711,8 @@ bool WAISlamTools::doMarkerMapPreprocessing(std::string       markerFile,
 
         if (mp->isBad()) continue;
 
-        cv::Mat sol = systemInv * (mp->GetWorldPos() - ul3D);
+        const WAI::V3& p   = snapshot->mapPointPositions[i];
+        cv::Mat        sol = systemInv * (cv::Mat(cv::Point3f(p.x, p.y, p.z)) - ul3D);
 
         if (sol.at<float>(0, 0) < 0 || sol.at<float>(0, 0) > 1 ||
             sol.at<float>(1, 0) < 0 || sol.at<float>(1, 0) > 1 ||
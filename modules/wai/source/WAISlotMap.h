@@ -0,0 +1,155 @@
+/**
+ * \file      WAISlotMap.h
+ * \brief     Index based slot storage with stable handles for WAIMap
+ * \date      October 2026
+ * \remarks   Please use clangformat to format the code. See more code style on
+ *            https://github.com/cpvrlab/SLProject4/wiki/SLProject-Coding-Style
+ * \copyright http://opensource.org/licenses/GPL-3.0
+ */
+
+#ifndef WAI_SLOTMAP_H
+#define WAI_SLOTMAP_H
+
+#include <cstddef>
+#include <cstdint>
+#include <vector>
+
+//-----------------------------------------------------------------------------
+//! Stable handle into a WAISlotMap
+/*! The index addresses a slot, the generation is incremented every time a slot
+ is freed. A handle whose generation does not match the slot generation is
+ stale and resolves to nullptr.
+ */
+struct WAISlotHandle
+{
+    static constexpr uint32_t invalidIndex = 0xFFFFFFFF;
+
+    uint32_t index      = invalidIndex;
+    uint32_t generation = 0;
+
+    bool isValid() const { return index != invalidIndex; }
+    bool operator==(const WAISlotHandle& o) const { return index == o.index && generation == o.generation; }
+    bool operator!=(const WAISlotHandle& o) const { return !(*this == o); }
+};
+//-----------------------------------------------------------------------------
+//! Slot storage for non-owned object pointers with contiguous iteration
+/*! The live elements are kept densely packed in one vector so iterating over
+ all map points or keyframes walks a single contiguous array instead of the
+ nodes of a std::set. Removing an element swaps the last dense element into
+ the freed position (O(1)), so the dense order is not stable. Freed slots are
+ recycled over a free list and their generation counter is increased so that
+ old handles can be detected.
+ The class is not thread safe. The owner (WAIMap) protects it with its mutex.
+ */
+template<typename T>
+class WAISlotMap
+{
+public:
+    //! Inserts the element and returns its handle
+    WAISlotHandle insert(T* element)
+    {
+        uint32_t index;
+        if (!_freeList.empty())
+        {
+            index = _freeList.back();
+            _freeList.pop_back();
+        }
+        else
+        {
+            index = (uint32_t)_slots.size();
+            _slots.push_back(Slot());
+        }
+
+        Slot& slot    = _slots[index];
+        slot.denseIdx = (uint32_t)_dense.size();
+        slot.occupied = true;
+        _dense.push_back(element);
+        _denseToSlot.push_back(index);
+
+        WAISlotHandle handle;
+        handle.index      = index;
+        handle.generation = slot.generation;
+        return handle;
+    }
+
+    //! Removes the element of the handle. Returns false for stale handles.
+    bool erase(const WAISlotHandle& handle)
+    {
+        if (!contains(handle))
+            return false;
+
+        Slot&    slot     = _slots[handle.index];
+        uint32_t denseIdx = slot.denseIdx;
+        uint32_t lastIdx  = (uint32_t)_dense.size() - 1;
+
+        if (denseIdx != lastIdx)
+        {
+            _dense[denseIdx]                        = _dense[lastIdx];
+            _denseToSlot[denseIdx]                  = _denseToSlot[lastIdx];
+            _slots[_denseToSlot[denseIdx]].denseIdx = denseIdx;
+        }
+        _dense.pop_back();
+        _denseToSlot.pop_back();
+
+        slot.occupied = false;
+        slot.generation++;
+        _freeList.push_back(handle.index);
+        return true;
+    }
+
+    //! Returns the element of the handle or nullptr if the handle is stale
+    T* get(const WAISlotHandle& handle) const
+    {
+        if (!contains(handle))
+            return nullptr;
+        return _dense[_slots[handle.index].denseIdx];
+    }
+
+    bool contains(const WAISlotHandle& handle) const
+    {
+        return handle.index < _slots.size() &&
+               _slots[handle.index].occupied &&
+               _slots[handle.index].generation == handle.generation;
+    }
+
+    //! Removes all elements. Handles of cleared slots become stale.
+    void clear()
+    {
+        _dense.clear();
+        _denseToSlot.clear();
+        _freeList.clear();
+        for (uint32_t i = 0; i < _slots.size(); i++)
+        {
+            if (_slots[i].occupied)
+            {
+                _slots[i].occupied = false;
+                _slots[i].generation++;
+            }
+            _freeList.push_back(i);
+        }
+    }
+
+    //! Densely packed live elements (order changes on erase)
+    const std::vector<T*>& elements() const { return _dense; }
+
+    size_t size() const { return _dense.size(); }
+    bool   empty() const { return _dense.empty(); }
+
+    typename std::vector<T*>::const_iterator begin() const { return _dense.begin(); }
+    typename std::vector<T*>::const_iterator end() const { return _dense.end(); }
+
+private:
+    struct Slot
+    {
+        uint32_t denseIdx   = 0;
+        uint32_t generation = 0;
+        bool     occupied   = false;
+    };
+
+    std::vector<Slot>     _slots;       //!< sparse slots addressed by handle index
+    std::vector<T*>       _dense;       //!< densely packed live elements
+    std::vector<uint32_t> _denseToSlot; //!< slot index of every dense element
+    std::vector<uint32_t> _freeList;    //!< indices of free slots for reuse
+};
+//-----------------------------------------------------------------------------
+#endif // WAI_SLOTMAP_H
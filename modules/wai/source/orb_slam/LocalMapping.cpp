@@ -53,11 +53,35 @@ LocalMapping::LocalMapping(WAIMap*           pMap,
 {
 }
 
+LocalMapping::~LocalMapping()
+{
+    delete _localBAGraph;
+}
+
 void LocalMapping::SetLoopCloser(LoopClosing* pLoopCloser)
 {
     mpLoopCloser = pLoopCloser;
 }
 
+void LocalMapping::SetReuseLocalBAGraph(bool reuse)
+{
+    if (reuse && !_localBAGraph)
+        _localBAGraph = new LocalBAGraph();
+    else if (!reuse && _localBAGraph)
+    {
+        delete _localBAGraph;
+        _localBAGraph = NULL;
+    }
+}
+
+void LocalMapping::LocalBundleAdjustment(WAIKeyFrame* frame)
+{
+    if (_localBAGraph)
+        Optimizer::LocalBundleAdjustment(_localBAGraph, frame, &mbAbortBA, mpMap);
+    else
+        Optimizer::LocalBundleAdjustment(frame, &mbAbortBA, mpMap);
+}
+
 void LocalMapping::Run()
 {
     while (1)
@@ -91,7 +115,7 @@ void LocalMapping::Run()
             {
                 // Local BA
                 if (mpMap->KeyFramesInMap() > 2)
-                    Optimizer::LocalBundleAdjustment(frame, &mbAbortBA, mpMap);
+                    LocalBundleAdjustment(frame);
                 KeyFrameCulling(frame);
             }
 
@@ -167,7 +191,7 @@ void LocalMapping::Run2()
 
                     // Local BA
                     if (mpMap->KeyFramesInMap() > 2)
-                        Optimizer::LocalBundleAdjustment(frame, &mbAbortBA, mpMap);
+                        LocalBundleAdjustment(frame);
                     KeyFrameCulling(frame);
                 }
             }
@@ -221,7 +245,7 @@ void LocalMapping::RunOnce()
         // Local BA
         if (mpMap->KeyFramesInMap() > 2)
         {
-            Optimizer::LocalBundleAdjustment(frame, &mbAbortBA, mpMap);
+            LocalBundleAdjustment(frame);
         }
 
         // Check redundant local Keyframes
@@ -960,6 +984,8 @@ void LocalMapping::Reset()
     unique_lock<mutex> lock2(mMutexNewKFs);
     mlNewKeyFrames.clear();
     mlpRecentAddedMapPoints.clear();
+    if (_localBAGraph)
+        _localBAGraph->clear();
     mbResetRequested  = false;
     mbFinishRequested = false;
     mbPauseRequested  = false;
@@ -40,13 +40,18 @@ namespace ORB_SLAM2
 
 //class Tracking;
 class LoopClosing;
+struct LocalBAGraph;
 
 class LocalMapping
 {
 public:
     LocalMapping(WAIMap* pMap, WAIOrbVocabulary* vocabulary, float cullRedundantPerc = 0.9);
+    ~LocalMapping();
     void SetLoopCloser(LoopClosing* pLoopCloser);
 
+    // Keep the local bundle adjustment graph between keyframes and update it incrementally
+    void SetReuseLocalBAGraph(bool reuse);
+
     // Main function
     void Run();
     void Run2();
@@ -105,6 +110,8 @@ protected:
 
     cv::Mat SkewSymmetricMatrix(const cv::Mat& v);
 
+    void LocalBundleAdjustment(WAIKeyFrame* frame);
+
     WAIMap* mpMap;
 
     std::mutex mMutexMapping;
@@ -139,6 +146,8 @@ protected:
 
     WAIOrbVocabulary* _vocabulary = NULL;
 
+    LocalBAGraph* _localBAGraph = NULL; //!< persistent local BA graph (NULL = rebuild every time)
+
     // A keyframe is considered redundant if the _cullRedundantPerc of the MapPoints it sees, are seen
     // in at least other 3 keyframes (in the same or finer scale)
     const float _cullRedundantPerc;
@@ -52,6 +52,9 @@ class LoopClosing
     void SetLocalMapper(LocalMapping* pLocalMapper);
     void SetVocabulary(WAIOrbVocabulary* voc);
 
+    // Solve the global bundle adjustment with PCG instead of a sparse Cholesky factorization (faster for large maps)
+    void SetIterativeGBASolver(bool iterative) { mbIterativeGBASolver = iterative; }
+
     // Main function
     void Run();
     bool RunOnce();
@@ -132,6 +135,8 @@ class LoopClosing
 
     LocalMapping* mpLocalMapper;
 
+    bool mbIterativeGBASolver = false;
+
     std::list<WAIKeyFrame*> mlpLoopKeyFrameQueue;
     std::mutex              mMutexLoopQueue;
 
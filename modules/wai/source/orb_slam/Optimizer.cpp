@@ -38,11 +38,15 @@ void Optimizer::GlobalBundleAdjustemnt(WAIMap*             pMap,
                                        int                 nIterations,
                                        bool*               pbStopFlag,
                                        const unsigned long nLoopKF,
-                                       const bool          bRobust)
+                                       const bool          bRobust,
+                                       const bool          bIterativeSolver)
 {
     vector<WAIKeyFrame*> vpKFs = pMap->GetAllKeyFrames();
     vector<WAIMapPoint*> vpMP  = pMap->GetAllMapPoints();
-    BundleAdjustment(vpKFs, vpMP, nIterations, pbStopFlag, nLoopKF, bRobust);
+    BundleAdjustment(vpKFs, vpMP, nIterations, pbStopFlag, nLoopKF, bRobust, bIterativeSolver);
+
+    if (nLoopKF == 0)
+        pMap->markPosesChanged();
 }
 
 void Optimizer::BundleAdjustment(const vector<WAIKeyFrame*>& vpKFs,
@@ -50,15 +54,23 @@ void Optimizer::BundleAdjustment(const vector<WAIKeyFrame*>& vpKFs,
                                  int                         nIterations,
                                  bool*                       pbStopFlag,
                                  const unsigned long         nLoopKF,
-                                 const bool                  bRobust)
+                                 const bool                  bRobust,
+                                 const bool                  bIterativeSolver)
 {
+    AVERAGE_TIMING_START("GlobalBA");
+
     vector<bool> vbNotIncludedMP;
     vbNotIncludedMP.resize(vpMP.size());
 
     g2o::SparseOptimizer                    optimizer;
     g2o::BlockSolver_6_3::LinearSolverType* linearSolver;
 
-    linearSolver = new g2o::LinearSolverEigen<g2o::BlockSolver_6_3::PoseMatrixType>();
+    // The point blocks are marginalized by the Schur complement in BlockSolver_6_3.
+    // For large maps the reduced camera system is solved faster iteratively.
+    if (bIterativeSolver)
+        linearSolver = new g2o::LinearSolverPCG<g2o::BlockSolver_6_3::PoseMatrixType>();
+    else
+        linearSolver = new g2o::LinearSolverEigen<g2o::BlockSolver_6_3::PoseMatrixType>();
 
     g2o::BlockSolver_6_3* solver_ptr = new g2o::BlockSolver_6_3(linearSolver);
 
@@ -202,6 +214,8 @@ void Optimizer::BundleAdjustment(const vector<WAIKeyFrame*>& vpKFs,
             pMP->mnMarker[BA_GLOBAL_KF] = (int)nLoopKF;
         }
     }
+
+    AVERAGE_TIMING_STOP("GlobalBA");
 }
 
 /*
@@ -243,7 +257,7 @@ int Optimizer::PoseOptimization(WAIFrame* pFrame)
     const float deltaMono = sqrt(5.991);
 
     {
-        unique_lock<mutex> lock(WAIMapPoint::mGlobalMutex);
+        unique_lock<WAIInstrumentedMutex> lock(WAIMapPoint::mGlobalMutex);
 
         for (int i = 0; i < N; i++)
         {
@@ -450,7 +464,7 @@ int Optimizer::PoseOptimization(WAIFrame* pFrame, vector<bool>& vbOutliers)
 
     const float deltaMono = sqrt(CHI2_1);
     {
-        unique_lock<mutex> lock(WAIMapPoint::mGlobalMutex);
+        unique_lock<WAIInstrumentedMutex> lock(WAIMapPoint::mGlobalMutex);
 
         for (int i = 0; i < N; i++)
         {
@@ -587,7 +601,7 @@ int Optimizer::PoseOptimization(WAIFrame* pFrame)
     AVERAGE_TIMING_START("PoseOpt.Part1");
     const float deltaMono = sqrt(CHI2_1);
     {
-        unique_lock<mutex> lock(WAIMapPoint::mGlobalMutex);
+        unique_lock<WAIInstrumentedMutex> lock(WAIMapPoint::mGlobalMutex);
 
         for (int i = 0; i < N; i++)
         {
@@ -932,7 +946,7 @@ void Optimizer::OptimizeEssentialGraph(WAIMap*
     optimizer.initializeOptimization();
     optimizer.optimize(20);
 
-    unique_lock<mutex> lock(pMap->mMutexMapUpdate);
+    unique_lock<WAIInstrumentedMutex> lock(pMap->mMutexMapUpdate);
 
     // SE3 Pose Recovering. Sim3:[sR t;0 1] -> SE3:[R t/s;0 1]
     for (size_t i = 0; i < vpKFs.size(); i++)
@@ -986,6 +1000,8 @@ void Optimizer::OptimizeEssentialGraph(WAIMap*
 
         pMP->UpdateNormalAndDepth();
     }
+
+    pMap->markPosesChanged();
 }
 
 void Optimizer::initOptimizerStruct(OptimizerStruct* os, WAIKeyFrame* pKF, WorkingSet& wc)
@@ -1200,7 +1216,7 @@ void Optimizer::applyBundleAdjustment(OptimizerStruct* os, WAIMap* pMap)
     }
 
     // Get WAIMap Mutex
-    unique_lock<mutex> lock(pMap->mMutexMapUpdate);
+    unique_lock<WAIInstrumentedMutex> lock(pMap->mMutexMapUpdate);
 
     if (!vToErase.empty())
     {
@@ -1230,6 +1246,8 @@ void Optimizer::applyBundleAdjustment(OptimizerStruct* os, WAIMap* pMap)
         pMP->SetWorldPos(Converter::toCvMat(vPoint->estimate()));
         pMP->UpdateNormalAndDepth();
     }
+
+    pMap->markPosesChanged();
 }
 
 void Optimizer::optimizerLocalMap(LocalMap& lmap, WAIKeyFrame* pKF)
@@ -1486,7 +1504,7 @@ void Optimizer::LocalBundleAdjustment(WAIKeyFrame* pKF,
     */
 
     // Get WAIMap Mutex
-    unique_lock<mutex> lock(pMap->mMutexMapUpdate);
+    unique_lock<WAIInstrumentedMutex> lock(pMap->mMutexMapUpdate);
 
     if (!vToErase.empty())
     {
@@ -1519,6 +1537,274 @@ void Optimizer::LocalBundleAdjustment(WAIKeyFrame* pKF,
         pMP->SetWorldPos(Converter::toCvMat(vPoint->estimate()));
         pMP->UpdateNormalAndDepth();
     }
+
+    pMap->markPosesChanged();
+}
+
+//-----------------------------------------------------------------------------
+LocalBAGraph::LocalBAGraph()
+{
+    g2o::BlockSolver_6_3::LinearSolverType* linearSolver = new g2o::LinearSolverEigen<g2o::BlockSolver_6_3::PoseMatrixType>();
+    g2o::BlockSolver_6_3*                   solver_ptr   = new g2o::BlockSolver_6_3(linearSolver);
+    optimizer.setAlgorithm(new g2o::OptimizationAlgorithmLevenberg(solver_ptr));
+}
+//-----------------------------------------------------------------------------
+void LocalBAGraph::clear()
+{
+    optimizer.clear();
+    localKFIds.clear();
+    edges.clear();
+}
+//-----------------------------------------------------------------------------
+static inline int keyFrameVertexId(WAIKeyFrame* pKF) { return (int)(2 * pKF->mnId); }
+static inline int mapPointVertexId(WAIMapPoint* pMP) { return (int)(2 * pMP->mnId + 1); }
+//-----------------------------------------------------------------------------
+/*! Same optimization as LocalBundleAdjustment(pKF, pbStopFlag, pMap) but on
+ the persistent graph that is only updated for the changes of the local window.
+ */
+void Optimizer::LocalBundleAdjustment(LocalBAGraph* graph,
+                                      WAIKeyFrame*  pKF,
+                                      bool*         pbStopFlag,
+                                      WAIMap*       pMap)
+{
+    AVERAGE_TIMING_START("LocalBA");
+
+    LocalMap lmap;
+    optimizerLocalMap(lmap, pKF);
+
+    g2o::SparseOptimizer& optimizer = graph->optimizer;
+
+    // Update the graph if the local window barely changed, otherwise rebuild it
+    size_t numSharedKFs = 0;
+    for (WAIKeyFrame* pKFi : lmap.keyFrames)
+        if (graph->localKFIds.count(pKFi->mnId))
+            numSharedKFs++;
+
+    if ((float)numSharedKFs < graph->minOverlap * (float)lmap.keyFrames.size())
+    {
+        graph->clear();
+        graph->numRebuilds++;
+    }
+    else
+        graph->numUpdates++;
+
+    graph->localKFIds.clear();
+    for (WAIKeyFrame* pKFi : lmap.keyFrames)
+        graph->localKFIds.insert(pKFi->mnId);
+
+    if (pbStopFlag)
+        optimizer.setForceStopFlag(pbStopFlag);
+
+    std::set<int> windowVertexIds;
+
+    auto setKeyFrameVertex = [&](WAIKeyFrame* pKFi, bool fixed)
+    {
+        int                   id   = keyFrameVertexId(pKFi);
+        g2o::VertexSE3Expmap* vSE3 = static_cast<g2o::VertexSE3Expmap*>(optimizer.vertex(id));
+        if (!vSE3)
+        {
+            vSE3 = new g2o::VertexSE3Expmap();
+            vSE3->setId(id);
+            optimizer.addVertex(vSE3);
+        }
+        vSE3->setEstimate(Converter::toSE3Quat(pKFi->GetPose()));
+        vSE3->setFixed(fixed);
+        windowVertexIds.insert(id);
+    };
+
+    // Local and fixed WAIKeyFrame vertices
+    for (WAIKeyFrame* pKFi : lmap.keyFrames)
+        setKeyFrameVertex(pKFi, pKFi->mnId == 0 || pKFi->isFixed());
+    for (WAIKeyFrame* pKFi : lmap.secondNeighbors)
+        setKeyFrameVertex(pKFi, true);
+
+    const int nExpectedSize = (int)((lmap.keyFrames.size() + lmap.secondNeighbors.size()) * lmap.mapPoints.size());
+
+    vector<g2o::EdgeSE3ProjectXYZ*> vpEdgesMono;
+    vector<WAIKeyFrame*>            vpEdgeKFMono;
+    vector<WAIMapPoint*>            vpMapPointEdgeMono;
+    vpEdgesMono.reserve(nExpectedSize);
+    vpEdgeKFMono.reserve(nExpectedSize);
+    vpMapPointEdgeMono.reserve(nExpectedSize);
+
+    const float thHuberMono = sqrt(CHI2_1);
+
+    // WAIMapPoint vertices and edges
+    for (WAIMapPoint* pMP : lmap.mapPoints)
+    {
+        int                     id     = mapPointVertexId(pMP);
+        g2o::VertexSBAPointXYZ* vPoint = static_cast<g2o::VertexSBAPointXYZ*>(optimizer.vertex(id));
+        if (!vPoint)
+        {
+            vPoint = new g2o::VertexSBAPointXYZ();
+            vPoint->setId(id);
+            vPoint->setMarginalized(true);
+            optimizer.addVertex(vPoint);
+        }
+        vPoint->setEstimate(Converter::toVector3d(pMP->GetWorldPos()));
+        vPoint->setFixed(pMP->isFixed());
+        windowVertexIds.insert(id);
+
+        const map<WAIKeyFrame*, size_t> observations = pMP->GetObservations();
+
+        for (auto mit = observations.begin(), mend = observations.end(); mit != mend; mit++)
+        {
+            WAIKeyFrame* pKFi = mit->first;
+            if (pKFi->isBad() || !windowVertexIds.count(keyFrameVertexId(pKFi)))
+                continue;
+
+            uint64_t key = ((uint64_t)pMP->mnId << 32) | (uint64_t)pKFi->mnId;
+            auto     it  = graph->edges.find(key);
+
+            // the observation changed or the ids were reused after a reset
+            if (it != graph->edges.end() &&
+                (it->second.kf != pKFi || it->second.mp != pMP || it->second.idx != mit->second))
+            {
+                optimizer.removeEdge(it->second.edge);
+                graph->edges.erase(it);
+                it = graph->edges.end();
+            }
+
+            if (it == graph->edges.end())
+            {
+                const cv::KeyPoint& kpUn = pKFi->mvKeysUn[mit->second];
+
+                Eigen::Matrix<double, 2, 1> obs;
+                obs << kpUn.pt.x, kpUn.pt.y;
+
+                g2o::EdgeSE3ProjectXYZ* e = new g2o::EdgeSE3ProjectXYZ();
+                e->setVertex(0, dynamic_cast<g2o::OptimizableGraph::Vertex*>(vPoint));
+                e->setVertex(1, dynamic_cast<g2o::OptimizableGraph::Vertex*>(optimizer.vertex(keyFrameVertexId(pKFi))));
+                e->setMeasurement(obs);
+                const float& invSigma2 = pKFi->mvInvLevelSigma2[kpUn.octave];
+                e->setInformation(Eigen::Matrix2d::Identity() * invSigma2);
+
+                e->fx = pKFi->fx;
+                e->fy = pKFi->fy;
+                e->cx = pKFi->cx;
+                e->cy = pKFi->cy;
+
+                optimizer.addEdge(e);
+                it = graph->edges.emplace(key, LocalBAGraph::EdgeInfo{e, pKFi, pMP, mit->second, false}).first;
+            }
+
+            // Reset the outlier level and the robust kernel of the last run
+            g2o::EdgeSE3ProjectXYZ* e = it->second.edge;
+            it->second.used           = true;
+            e->setLevel(0);
+            g2o::RobustKernelHuber* rk = new g2o::RobustKernelHuber;
+            e->setRobustKernel(rk);
+            rk->setDelta(thHuberMono);
+
+            vpEdgesMono.push_back(e);
+            vpEdgeKFMono.push_back(pKFi);
+            vpMapPointEdgeMono.push_back(pMP);
+        }
+    }
+
+    // Remove the edges and vertices that left the local window
+    for (auto it = graph->edges.begin(); it != graph->edges.end();)
+    {
+        if (!it->second.used)
+        {
+            optimizer.removeEdge(it->second.edge);
+            it = graph->edges.erase(it);
+        }
+        else
+        {
+            it->second.used = false;
+            it++;
+        }
+    }
+
+    vector<g2o::HyperGraph::Vertex*> vpVerticesToRemove;
+    for (auto& idAndVertex : optimizer.vertices())
+        if (!windowVertexIds.count(idAndVertex.first))
+            vpVerticesToRemove.push_back(idAndVertex.second);
+    for (g2o::HyperGraph::Vertex* v : vpVerticesToRemove)
+        optimizer.removeVertex(v);
+
+    if ((pbStopFlag && *pbStopFlag) || vpEdgesMono.empty())
+    {
+        AVERAGE_TIMING_STOP("LocalBA");
+        return;
+    }
+
+    optimizer.initializeOptimization();
+    optimizer.optimize(5);
+
+    bool bDoMore = true;
+
+    if (pbStopFlag)
+        if (*pbStopFlag)
+            bDoMore = false;
+
+    if (bDoMore)
+    {
+        // Check inlier observations
+        for (size_t i = 0, iend = vpEdgesMono.size(); i < iend; i++)
+        {
+            g2o::EdgeSE3ProjectXYZ* e   = vpEdgesMono[i];
+            WAIMapPoint*            pMP = vpMapPointEdgeMono[i];
+
+            if (pMP->isBad())
+                continue;
+
+            if (e->chi2() > CHI2_1 || !e->isDepthPositive())
+                e->setLevel(1);
+
+            e->setRobustKernel(0);
+        }
+
+        // Optimize again without the outliers
+        optimizer.initializeOptimization(0);
+        optimizer.optimize(10);
+    }
+
+    vector<pair<WAIKeyFrame*, WAIMapPoint*>> vToErase;
+    vToErase.reserve(vpEdgesMono.size());
+
+    // Check inlier observations
+    for (size_t i = 0, iend = vpEdgesMono.size(); i < iend; i++)
+    {
+        g2o::EdgeSE3ProjectXYZ* e   = vpEdgesMono[i];
+        WAIMapPoint*            pMP = vpMapPointEdgeMono[i];
+
+        if (pMP->isBad())
+            continue;
+
+        if (e->chi2() > CHI2_1 || !e->isDepthPositive())
+            vToErase.push_back(make_pair(vpEdgeKFMono[i], pMP));
+    }
+
+    // Get WAIMap Mutex
+    unique_lock<WAIInstrumentedMutex> lock(pMap->mMutexMapUpdate);
+
+    for (size_t i = 0; i < vToErase.size(); i++)
+    {
+        WAIKeyFrame* pKFi = vToErase[i].first;
+        WAIMapPoint* pMPi = vToErase[i].second;
+        pKFi->EraseMapPointMatch(pMPi);
+        pMPi->EraseObservation(pKFi);
+    }
+
+    // Recover optimized data
+    for (WAIKeyFrame* pKFi : lmap.keyFrames)
+    {
+        g2o::VertexSE3Expmap* vSE3 = static_cast<g2o::VertexSE3Expmap*>(optimizer.vertex(keyFrameVertexId(pKFi)));
+        pKFi->SetPose(Converter::toCvMat(vSE3->estimate()));
+    }
+
+    for (WAIMapPoint* pMP : lmap.mapPoints)
+    {
+        g2o::VertexSBAPointXYZ* vPoint = static_cast<g2o::VertexSBAPointXYZ*>(optimizer.vertex(mapPointVertexId(pMP)));
+        pMP->SetWorldPos(Converter::toCvMat(vPoint->estimate()));
+        pMP->UpdateNormalAndDepth();
+    }
+
+    pMap->markPosesChanged();
+
+    AVERAGE_TIMING_STOP("LocalBA");
 }
 
 int Optimizer::OptimizeSim3(WAIKeyFrame*          pKF1,
@@ -38,6 +38,10 @@
 #include <g2o/solvers/dense/linear_solver_dense.h>
 #include <g2o/types/sim3/types_seven_dof_expmap.h>
 #include <g2o/types/sba/types_six_dof_expmap.h>
+#include <g2o/solvers/pcg/linear_solver_pcg.h>
+
+#include <set>
+#include <unordered_map>
 
 
 namespace ORB_SLAM2
@@ -55,11 +59,45 @@ struct OptimizerStruct
     int maxKFid;
     LocalMap lmap;
 };
+//-----------------------------------------------------------------------------
+//! Persistent local bundle adjustment graph that is updated incrementally
+/*! Local mapping runs a local BA for every new keyframe, and consecutive local
+ windows mostly share the same keyframes and map points. Instead of rebuilding
+ the g2o graph every time, vertices and edges that stay in the window are kept
+ and only their estimates, levels and robust kernels are reset. Vertices and
+ edges that left the window are removed. If less than minOverlap of the local
+ keyframes were local in the previous call the graph is rebuilt from scratch.
+ Keyframe vertices have the id 2*mnId, map point vertices 2*mnId+1.
+ */
+struct LocalBAGraph
+{
+    struct EdgeInfo
+    {
+        g2o::EdgeSE3ProjectXYZ* edge;
+        WAIKeyFrame*            kf;
+        WAIMapPoint*            mp;
+        size_t                  idx;  //!< keypoint index of the observation in kf
+        bool                    used; //!< edge is part of the current window
+    };
+
+    LocalBAGraph();
+    void clear();
+
+    g2o::SparseOptimizer                   optimizer;
+    std::set<unsigned long>                localKFIds; //!< ids of the local keyframes of the last call
+    std::unordered_map<uint64_t, EdgeInfo> edges;      //!< edges by (map point id << 32 | keyframe id)
+
+    float minOverlap  = 0.5f; //!< min. shared local keyframes to update instead of rebuild
+    int   numUpdates  = 0;    //!< number of incremental updates
+    int   numRebuilds = 0;    //!< number of rebuilds from scratch
+};
+//-----------------------------------------------------------------------------
 class WAI_API Optimizer
 {
 public:
-    void static BundleAdjustment(const std::vector<WAIKeyFrame*>& vpKF, const std::vector<WAIMapPoint*>& vpMP, int nIterations = 5, bool* pbStopFlag = NULL, const unsigned long nLoopKF = 0, const bool bRobust = true);
-    void static GlobalBundleAdjustemnt(WAIMap* pMap, int nIterations = 5, bool* pbStopFlag = NULL, const unsigned long nLoopKF = 0, const bool bRobust = true);
+    // if bIterativeSolver is true, the Schur complement is solved with preconditioned conjugate gradients instead of a sparse Cholesky factorization
+    void static BundleAdjustment(const std::vector<WAIKeyFrame*>& vpKF, const std::vector<WAIMapPoint*>& vpMP, int nIterations = 5, bool* pbStopFlag = NULL, const unsigned long nLoopKF = 0, const bool bRobust = true, const bool bIterativeSolver = false);
+    void static GlobalBundleAdjustemnt(WAIMap* pMap, int nIterations = 5, bool* pbStopFlag = NULL, const unsigned long nLoopKF = 0, const bool bRobust = true, const bool bIterativeSolver = false);
 
     void static initOptimizerStruct(OptimizerStruct* os, WAIKeyFrame* pKF, WorkingSet &wc);
     void static LocalBundleAdjustment(OptimizerStruct* os, bool* pbStopFlag);
@@ -67,6 +105,7 @@ public:
 
     void static optimizerLocalMap(LocalMap &lmap, WAIKeyFrame* pKF);
     void static LocalBundleAdjustment(WAIKeyFrame* pKF, bool* pbStopFlag, WAIMap* pMap);
+    void static LocalBundleAdjustment(LocalBAGraph* graph, WAIKeyFrame* pKF, bool* pbStopFlag, WAIMap* pMap);
 
 
     int static PoseOptimization(WAIFrame* pFrame, vector<bool> &vbOutliers);